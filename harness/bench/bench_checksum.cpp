@@ -0,0 +1,52 @@
+// ============================================================================
+// TopNotchNotes Harness - Checksum Benchmarks
+// XXH3-64 throughput per kernel, at capture-period and manifest-range sizes
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <print>
+#include <span>
+#include <vector>
+
+#include "bench_common.hpp"
+
+import harness;
+
+namespace
+{
+
+    void bench_xxh3(std::size_t bytes)
+    {
+        using namespace harness;
+
+        std::vector<std::byte> data(bytes);
+        for (std::size_t i = 0; i < bytes; ++i)
+            data[i] = static_cast<std::byte>(i * 31 + 7);
+        std::print(" XXH3-64, {} bytes\n", bytes);
+        bench::group = std::format("xxh3-{}", bytes);
+
+        const auto best = checksum::active_isa();
+        for (auto isa : {cpu::Isa::Scalar, cpu::Isa::Avx2})
+        {
+            if (!checksum::use_isa(isa))
+                continue;
+            bench::measure(cpu::to_string(isa), bytes, [&]
+                           {
+                               const auto hash = checksum::xxh3_64(data);
+                               bench::do_not_optimize(hash); });
+        }
+        checksum::use_isa(best);
+    }
+
+} // anonymous namespace
+
+int run_checksum_benchmarks()
+{
+    std::print("Recording checksums\n");
+    bench_xxh3(2048);                                     // One capture period as s16
+    bench_xxh3(harness::checksum::default_segment_bytes); // One manifest range
+    std::print("\n");
+    return 0;
+}
@@ -0,0 +1,84 @@
+// ============================================================================
+// TopNotchNotes Harness - Benchmark Helpers
+// ============================================================================
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <print>
+#include <string>
+#include <string_view>
+
+#ifndef HARNESS_BUILD_CONFIG
+#define HARNESS_BUILD_CONFIG "unknown"
+#endif
+
+namespace bench
+{
+
+    /// Build flavour the benchmarks were compiled with (from CMake)
+    inline constexpr std::string_view build_config = HARNESS_BUILD_CONFIG;
+
+    /// When set (--record FILE), every result is also appended as a JSON line
+    /// so runs of different build presets can be compared
+    inline std::FILE *record_file = nullptr;
+
+    /// Prefix for recorded names, set by each benchmark group
+    inline std::string group;
+
+    inline void record(std::string_view name, double value, std::string_view unit, double mb_per_s = 0.0)
+    {
+        if (!record_file)
+            return;
+        std::print(record_file, "{{\"config\":\"{}\",\"name\":\"{}/{}\",\"value\":{:.3f},\"unit\":\"{}\",\"mb_s\":{:.1f}}}\n",
+                   build_config, group, name, value, unit, mb_per_s);
+    }
+
+    /// Prevent the optimizer from discarding a computed value
+    template <typename T>
+    inline void do_not_optimize(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /// Run `fn` repeatedly for ~`budget` and report ns per call and throughput
+    template <typename Fn>
+    double measure(std::string_view name, std::size_t bytes_per_call, Fn &&fn,
+                   std::chrono::milliseconds budget = std::chrono::milliseconds(300))
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Warm caches and branch predictors
+        for (int i = 0; i < 16; ++i)
+            fn();
+
+        std::size_t calls = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < budget)
+        {
+            for (int i = 0; i < 64; ++i)
+                fn();
+            calls += 64;
+            elapsed = Clock::now() - start;
+        }
+
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count() /
+                          static_cast<double>(calls);
+        if (bytes_per_call > 0)
+        {
+            const double mb_per_s = static_cast<double>(bytes_per_call) / ns * 1e3;
+            std::print("  {:<36} {:>10.1f} ns/op {:>10.1f} MB/s\n", name, ns, mb_per_s);
+            record(name, ns, "ns/op", mb_per_s);
+        }
+        else
+        {
+            std::print("  {:<36} {:>10.1f} ns/op\n", name, ns);
+            record(name, ns, "ns/op");
+        }
+        return ns;
+    }
+
+} // namespace bench
@@ -0,0 +1,102 @@
+// ============================================================================
+// TopNotchNotes Harness - Sample Conversion Benchmarks
+// f32 -> s16 as fed to the decoder, plus the WAV and interleave paths
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <print>
+#include <vector>
+
+#include "bench_common.hpp"
+
+import harness;
+
+namespace
+{
+
+    /// The previous ASR feed conversion, kept as the baseline
+    void to_pcm16_transform(const std::vector<float> &in, std::vector<std::int16_t> &out)
+    {
+        out.resize(in.size());
+        std::transform(in.begin(), in.end(), out.begin(),
+                       [](float s) -> std::int16_t
+                       { return static_cast<std::int16_t>(std::clamp(s, -1.0f, 1.0f) * 32767.0f); });
+    }
+
+    std::vector<float> make_signal(std::size_t samples)
+    {
+        std::vector<float> signal(samples);
+        for (std::size_t i = 0; i < samples; ++i)
+            signal[i] = 1.2f * std::sin(static_cast<float>(i) * 0.031f); // Clips at the peaks
+        return signal;
+    }
+
+    void bench_s16(std::size_t samples)
+    {
+        using namespace harness::convert;
+
+        const auto signal = make_signal(samples);
+        std::vector<std::int16_t> out(samples);
+        const auto bytes = samples * sizeof(float);
+        std::print(" f32 -> s16, {} samples\n", samples);
+        bench::group = std::format("s16-{}", samples);
+
+        const double baseline = bench::measure("std::transform + clamp (baseline)", bytes, [&]
+                                               {
+                                                   to_pcm16_transform(signal, out);
+                                                   bench::do_not_optimize(out.data()); });
+
+        const auto best = active_isa();
+        for (auto isa : {Isa::Scalar, Isa::Sse41, Isa::Avx2, Isa::Avx512, Isa::Neon})
+        {
+            if (!use_isa(isa))
+                continue;
+            const double ns = bench::measure(to_string(isa), bytes, [&]
+                                             {
+                                                 f32_to_s16(signal, out);
+                                                 bench::do_not_optimize(out.data()); });
+            std::print("  {:<36} {:>10.1f}x\n", "  speedup", baseline / ns);
+        }
+        use_isa(best);
+    }
+
+    void bench_wav_formats(std::size_t samples)
+    {
+        using namespace harness::convert;
+
+        const auto signal = make_signal(samples);
+        std::vector<std::uint8_t> s24(samples * 3);
+        std::vector<float> back(samples);
+        const auto bytes = samples * sizeof(float);
+        std::print(" WAV encodings and stereo split, {} samples ({})\n", samples, to_string(active_isa()));
+        bench::group = std::format("wav-{}", samples);
+
+        bench::measure("f32 -> s24", bytes, [&]
+                       {
+                           f32_to_s24(signal, s24);
+                           bench::do_not_optimize(s24.data()); });
+        bench::measure("s24 -> f32", bytes, [&]
+                       {
+                           s24_to_f32(s24, back);
+                           bench::do_not_optimize(back.data()); });
+        bench::measure("deinterleave stereo", bytes, [&]
+                       {
+                           deinterleave(signal, 2, back);
+                           bench::do_not_optimize(back.data()); });
+    }
+
+} // anonymous namespace
+
+int run_convert_benchmarks()
+{
+    std::print("Sample conversion\n");
+    bench_s16(1024); // One capture period
+    bench_s16(48000);
+    bench_wav_formats(48000);
+    std::print("\n");
+    return 0;
+}
@@ -0,0 +1,63 @@
+// ============================================================================
+// TopNotchNotes Harness - Micro-benchmarks
+// ============================================================================
+//
+// Usage: harness_bench [--all|--telemetry|--convert|--checksum|--trace|--startup]
+//                      [--record FILE] [--harness PATH]
+//
+// --record appends every result as a JSON line tagged with the build
+// configuration, so the presets in CMakePresets.json can be compared.
+
+#include <cstdio>
+#include <print>
+#include <string_view>
+
+#include "bench_common.hpp"
+
+int run_telemetry_benchmarks();
+int run_convert_benchmarks();
+int run_checksum_benchmarks();
+int run_trace_benchmarks();
+int run_startup_benchmarks(std::string_view binary);
+
+int main(int argc, char *argv[])
+{
+    std::string_view filter = "--all";
+    std::string_view harness_path;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg(argv[i]);
+        if (arg == "--record" && i + 1 < argc)
+        {
+            bench::record_file = std::fopen(argv[++i], "a");
+            if (!bench::record_file)
+                std::print(stderr, "Cannot open {} for recording\n", argv[i]);
+        }
+        else if (arg == "--harness" && i + 1 < argc)
+        {
+            harness_path = argv[++i];
+        }
+        else
+        {
+            filter = arg;
+        }
+    }
+
+    std::print("TopNotchNotes Harness Benchmarks ({})\n", bench::build_config);
+    std::print("================================\n\n");
+
+    if (filter == "--all" || filter == "--telemetry")
+        run_telemetry_benchmarks();
+    if (filter == "--all" || filter == "--convert")
+        run_convert_benchmarks();
+    if (filter == "--all" || filter == "--checksum")
+        run_checksum_benchmarks();
+    if (filter == "--all" || filter == "--trace")
+        run_trace_benchmarks();
+    if (filter == "--all" || filter == "--startup")
+        run_startup_benchmarks(harness_path);
+
+    if (bench::record_file)
+        std::fclose(bench::record_file);
+    return 0;
+}
@@ -0,0 +1,133 @@
+// ============================================================================
+// TopNotchNotes Harness - Startup Benchmark
+// Time from exec to the harness reporting "ready", plus the binary's size
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bench_common.hpp"
+
+#ifndef HARNESS_BINARY_PATH
+#define HARNESS_BINARY_PATH "harness"
+#endif
+
+extern char **environ;
+
+namespace
+{
+
+    /// One launch: spawn, read stdout until the ready status, then stop it.
+    /// Startup covers the dynamic loader, static initialization and the
+    /// harness's own setup up to the point the pilot could send commands.
+    std::optional<std::chrono::nanoseconds> time_to_ready(const std::string &binary)
+    {
+        int out[2];
+        int in[2];
+        if (::pipe(out) != 0)
+            return std::nullopt;
+        if (::pipe(in) != 0)
+        {
+            ::close(out[0]);
+            ::close(out[1]);
+            return std::nullopt;
+        }
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addclose(&actions, in[1]);
+        posix_spawn_file_actions_addclose(&actions, out[0]);
+
+        std::vector<char *> argv{const_cast<char *>(binary.c_str()), nullptr};
+        pid_t pid = -1;
+        const auto start = std::chrono::steady_clock::now();
+        const int spawned = ::posix_spawn(&pid, binary.c_str(), &actions, nullptr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        ::close(in[0]);
+        ::close(out[1]);
+
+        std::optional<std::chrono::nanoseconds> elapsed;
+        if (spawned == 0)
+        {
+            std::string output;
+            char buffer[512];
+            while (output.find("\"ready\"") == std::string::npos)
+            {
+                const auto got = ::read(out[0], buffer, sizeof(buffer));
+                if (got <= 0)
+                    break;
+                output.append(buffer, static_cast<std::size_t>(got));
+            }
+            if (output.find("\"ready\"") != std::string::npos)
+                elapsed = std::chrono::steady_clock::now() - start;
+
+            ::kill(pid, SIGTERM);
+            ::waitpid(pid, nullptr, 0);
+        }
+        ::close(in[1]);
+        ::close(out[0]);
+        return elapsed;
+    }
+
+    void bench_startup(const std::string &binary)
+    {
+        std::print(" startup, {}\n", binary);
+        bench::group = "startup";
+
+        std::error_code error;
+        const auto size = std::filesystem::file_size(binary, error);
+        if (error)
+        {
+            std::print("  (skipped: {})\n", error.message());
+            return;
+        }
+
+        constexpr int runs = 20;
+        std::vector<double> ms;
+        for (int i = 0; i < runs + 2; ++i)
+        {
+            auto elapsed = time_to_ready(binary);
+            if (!elapsed)
+            {
+                std::print("  (skipped: harness never reported ready)\n");
+                return;
+            }
+            if (i >= 2) // First launches warm the page cache
+                ms.push_back(std::chrono::duration<double, std::milli>(*elapsed).count());
+        }
+        std::ranges::sort(ms);
+
+        std::print("  {:<36} {:>10.2f} ms\n", "time to ready (min)", ms.front());
+        std::print("  {:<36} {:>10.2f} ms\n", "time to ready (median)", ms[ms.size() / 2]);
+        std::print("  {:<36} {:>10} KiB\n", "binary size", size / 1024);
+        bench::record("ready_min", ms.front(), "ms");
+        bench::record("ready_median", ms[ms.size() / 2], "ms");
+        bench::record("binary_size", static_cast<double>(size) / 1024.0, "KiB");
+    }
+
+} // anonymous namespace
+
+int run_startup_benchmarks(std::string_view binary)
+{
+    std::print("Startup\n");
+    bench_startup(binary.empty() ? std::string(HARNESS_BINARY_PATH) : std::string(binary));
+    std::print("\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+// ============================================================================
+// TopNotchNotes Harness - Telemetry Benchmarks
+// JSON escaping and number formatting on telemetry-shaped inputs
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <print>
+#include <string>
+#include <string_view>
+
+#include "bench_common.hpp"
+
+import harness;
+
+namespace
+{
+
+    /// The previous byte-at-a-time escape, kept as the baseline
+    std::string json_escape_bytewise(std::string_view input)
+    {
+        std::string result;
+        result.reserve(input.size() + 8);
+        for (char c : input)
+        {
+            switch (c)
+            {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    std::format_to(std::back_inserter(result), "\\u{:04x}", static_cast<unsigned>(c));
+                else
+                    result += c;
+            }
+        }
+        return result;
+    }
+
+    /// A long transcript body: mostly prose, occasional quotes and newlines
+    std::string make_transcript(std::size_t bytes)
+    {
+        constexpr std::string_view sentence =
+            "so the eigenvalues of this matrix tell us how the system evolves over time, "
+            "and if you look at \"lambda one\" here it dominates after a few steps.\n";
+        std::string text;
+        while (text.size() < bytes)
+            text += sentence;
+        text.resize(bytes);
+        return text;
+    }
+
+    void bench_escape(std::size_t bytes)
+    {
+        using namespace harness::telemetry;
+
+        const auto text = make_transcript(bytes);
+        std::print(" json escape, {} byte transcript body\n", bytes);
+        bench::group = std::format("escape-{}", bytes);
+
+        bench::measure("bytewise (baseline)", bytes, [&]
+                       { bench::do_not_optimize(json_escape_bytewise(text)); });
+
+        bench::measure("json_escape (allocating)", bytes, [&]
+                       { bench::do_not_optimize(json_escape(text)); });
+
+        std::string buffer;
+        bench::measure("json_escape_to (reused buffer)", bytes, [&]
+                       {
+                           buffer.clear();
+                           json_escape_to(buffer, text);
+                           bench::do_not_optimize(buffer.data()); });
+    }
+
+    void bench_level_line()
+    {
+        using namespace harness::telemetry;
+
+        std::print(" level line formatting\n");
+        bench::group = "level-line";
+        float db = -23.4f;
+
+        bench::measure("std::format", 0, [&]
+                       {
+                           db = db < -90.0f ? 0.0f : db - 0.7f;
+                           bench::do_not_optimize(std::format("{{\"evt\":\"level\",\"db\":{:.1f}}}\n", db)); });
+
+        std::string buffer;
+        bench::measure("JsonLine + to_chars", 0, [&]
+                       {
+                           db = db < -90.0f ? 0.0f : db - 0.7f;
+                           auto line = JsonLine(buffer, EventType::Level).number("db", db, 1).finish();
+                           bench::do_not_optimize(line.data()); });
+    }
+
+} // anonymous namespace
+
+int run_telemetry_benchmarks()
+{
+    std::print("Telemetry\n");
+    bench_escape(64);
+    bench_escape(4096);
+    bench_escape(64 * 1024);
+    bench_level_line();
+    std::print("\n");
+    return 0;
+}
@@ -0,0 +1,53 @@
+// ============================================================================
+// TopNotchNotes Harness - Trace Marker Benchmarks
+// Cost of one trace::Scope with no trace running and while recording
+// ============================================================================
+
+#include <cstddef>
+#include <filesystem>
+#include <print>
+
+#include "bench_common.hpp"
+
+import harness;
+
+namespace
+{
+
+    void bench_markers()
+    {
+        using namespace harness;
+
+        std::print(" trace::Scope ({})\n", trace::compiled_in ? "compiled in" : "compiled out");
+        bench::group = "trace";
+
+        bench::measure("marker, no trace running", 0, []
+                       {
+                           trace::Scope scope("bench");
+                           bench::do_not_optimize(scope); });
+
+        // Reopen the window before the per-thread buffer fills, so every
+        // marker takes the recording path rather than the dropped one
+        std::size_t recorded = 0;
+        trace::start();
+        bench::measure("marker, recording (target < 50 ns)", 0, [&recorded]
+                       {
+                           if (++recorded % (1u << 15) == 0)
+                               trace::start();
+                           trace::Scope scope("bench");
+                           bench::do_not_optimize(scope); });
+
+        const auto path = std::filesystem::temp_directory_path() / "tnn-bench-trace.json";
+        (void)trace::stop(path);
+        std::filesystem::remove(path);
+    }
+
+} // anonymous namespace
+
+int run_trace_benchmarks()
+{
+    std::print("Trace markers\n");
+    bench_markers();
+    std::print("\n");
+    return 0;
+}
@@ -3,25 +3,83 @@
 // C++23 Audio/Video Hardware Orchestration Daemon
 // ============================================================================
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <expected>
+#include <format>
+#include <functional>
 #include <filesystem>
 #include <fstream>
-#include <iostream>
+#include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <print>
+#include <ranges>
 #include <span>
+#include <stop_token>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 import harness;
 
+// ============================================================================
+// Startup Profile
+// ============================================================================
+
+/// Time since the process started, taken during static initialization
+const auto g_process_start = std::chrono::steady_clock::now();
+
+/// Phase timestamps from process start, reported once the harness is ready.
+/// Phases finishing on background threads are marked from there.
+class StartupProfile
+{
+public:
+    std::chrono::microseconds mark(std::string_view phase)
+    {
+        const auto at = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - g_process_start);
+        std::lock_guard lock(mutex_);
+        phases_.emplace_back(std::string(phase), at);
+        return at;
+    }
+
+    /// "Startup: args 0.04 ms, decoder pool 0.31 ms, ..."
+    [[nodiscard]] std::string summary() const
+    {
+        std::lock_guard lock(mutex_);
+        std::string text = "Startup:";
+        for (const auto &[phase, at] : phases_)
+            text += std::format("{} {} {:.2f} ms", text.size() > 8 ? "," : "", phase,
+                                std::chrono::duration<double, std::milli>(at).count());
+        return text;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::pair<std::string, std::chrono::microseconds>> phases_;
+};
+
+StartupProfile g_startup;
+
 // ============================================================================
 // Global State (Atomic for lock-free access)
 // ============================================================================
@@ -29,27 +87,342 @@ import harness;
 std::atomic<harness::RecordingState> g_state{harness::RecordingState::Idle};
 std::atomic<bool> g_should_exit{false};
 
+// Decoder worker pool shared by all sessions. Declared before anything that
+// holds a scheduled engine, so it is destroyed after them.
+std::optional<harness::asr::Scheduler> g_asr;
+
+// Samples of the session WAV covered by one utterance
+struct UtteranceSpan
+{
+    std::uint64_t first_sample = 0;
+    std::uint64_t sample_count = 0;
+};
+
 // Current session information
 struct Session
 {
     std::string id;
     std::filesystem::path output_dir;
     std::chrono::steady_clock::time_point start_time;
+    std::chrono::system_clock::time_point started_at; // For the manifest
     std::unique_ptr<harness::io::WavWriter> audio_writer;
+    harness::clock::SessionClock clock{48000, {}};        // Recorded samples to session time
+    std::optional<harness::dsp::DriftResampler> retime; // --clock-correct: onto the nominal rate
+    std::vector<float> retime_buffer;
+    double retime_due = 0.0; // Output samples owed, fractional part carried
+    std::unique_ptr<harness::io::WavWriter> mic_writer; // --loopback separate: the microphone beside it
+    std::vector<float> mix_buffer;                      // --loopback mix: microphone plus system audio
+    std::optional<harness::echo::EchoCanceller> echo;   // Takes the system audio out of the microphone
+    std::vector<float> echo_buffer;
     std::unique_ptr<harness::transcribe::ITranscribeEngine> transcriber;
-    std::ofstream transcript_file;
+    std::unique_ptr<harness::transcribe::ITranscribeEngine> spotter; // Keyword spotting
+    std::shared_ptr<harness::io::TranscriptWriter> transcript;
+    std::unique_ptr<harness::postprocess::PostProcessor> postprocessor;
+    std::shared_ptr<const harness::postprocess::PunctuationModel> punctuation; // Null: rule-based
+    harness::preview::PreviewStage preview;
+    harness::transcribe::VoiceActivityDetector vad;
+    bool in_utterance = false;
+    std::uint64_t utterance_first_sample = 0;     // WAV position where the VAD opened
+    std::chrono::milliseconds utterance_start{0}; // Same, as session time
+    std::deque<UtteranceSpan> awaiting_final;     // Ended utterances the engine still decodes
+    std::uint64_t segment_count = 0;
     std::size_t frame_count = 0;
+    bool write_failed = false; // A WAV write failed; reported once
+    harness::memory::Pressure memory_pressure = harness::memory::Pressure::Normal; // As last acted on
+    std::unique_ptr<harness::memory::Watcher> memory;                              // Samples it off this thread
 };
 
 std::optional<Session> g_session;
 std::mutex g_session_mutex;
 
+// Kept across sessions (guarded by g_session_mutex): the decoder stays warm
+// and the selected course vocabulary applies to the next START as well
+std::unique_ptr<harness::transcribe::ITranscribeEngine> g_warm_engine;
+std::unique_ptr<harness::transcribe::ITranscribeEngine> g_warm_spotter;
+std::optional<harness::course::CourseLibrary> g_courses;
+std::optional<harness::course::CourseModel> g_course;
+
+// Decoder being loaded while the harness starts up, so the first START does
+// not pay for the model load. Adopted as the warm engine by start_recording.
+struct PrewarmedEngine
+{
+    std::string engine; // Registry name it was built for
+    std::future<std::unique_ptr<harness::transcribe::ITranscribeEngine>> loading;
+};
+std::optional<PrewarmedEngine> g_prewarm;
+
+// Background second pass, shared by all sessions; it keeps revising the
+// previous session's transcript after STOP
+std::unique_ptr<harness::rescore::Rescorer> g_rescorer;
+
+// Transcription backend for the next session (--engine / ENGINE)
+std::string g_engine_name = harness::transcribe::TranscribeConfig{}.engine;
+
+// Keyword spotting next to (or instead of) full decoding, from --kws
+enum class SpottingMode
+{
+    Off,
+    Alongside,
+    Only
+};
+SpottingMode g_spotting = SpottingMode::Off;
+
+// Session WAV encoding (--wav-format); float keeps the capture bit-exact
+harness::io::WavFormat g_wav_format = harness::io::WavFormat::Float32;
+
+// How session WAVs reach the disk (--wav-io) and the length to reserve space
+// for (--session-minutes); 0 reserves as the file grows
+harness::io::WriteMode g_wav_write_mode = harness::io::WriteMode::Buffered;
+unsigned g_session_minutes = 0;
+
+// What capture does while no session is open (--idle)
+enum class IdleMode
+{
+    Run,     // Keep capturing and discard the frames
+    Park,    // Stop the device until START
+    Standby  // Keep capturing for a level meter, waking the consumer a few times a second
+};
+IdleMode g_idle_mode = IdleMode::Park;
+constexpr std::uint32_t standby_meter_hz = 8;
+float g_standby_level = -100.0f; // Loudest frame of the current standby burst
+
+// System audio (--loopback), for lectures played through the speakers. Mixed
+// into the microphone, or recorded and transcribed in its place with the
+// microphone kept in a file of its own. Guarded by g_session_mutex.
+enum class LoopbackUse
+{
+    Off,
+    Mix,
+    Separate
+};
+LoopbackUse g_loopback = LoopbackUse::Off;
+
+// Cancel the speakers' echo from the microphone while system audio is
+// captured (--aec / AEC), from the next START; guarded by g_session_mutex
+bool g_echo_cancel = true;
+
+// Resample recordings from the sound card's measured rate onto the nominal
+// one (--clock-correct), so sample positions are session time
+bool g_clock_correct = false;
+
+// The capture device once started, for the idle handling; guarded by
+// g_session_mutex
+harness::audio::AudioDevice *g_device = nullptr;
+
+// Capture journal (--journal): raw callbacks and commands, for --replay
+std::unique_ptr<harness::journal::JournalWriter> g_journal;
+
+// Resident-size budget (--memory-budget); sessions degrade as they near it.
+// Evaluated under g_session_mutex; the limit is set before any thread starts.
+harness::memory::Budget g_memory_budget;
+
 // ============================================================================
 // Command Handlers (Split for reduced complexity)
 // ============================================================================
 
 namespace cmd
 {
+    // Decoder settings for the live path, which is handed capture frames;
+    // before the device is open that is the rate audio_config() asks for
+    harness::transcribe::TranscribeConfig live_transcribe_config()
+    {
+        harness::transcribe::TranscribeConfig config;
+        config.engine = g_engine_name;
+        config.input_rate = g_device ? g_device->config().sample_rate : 48000;
+        return config;
+    }
+
+    // Take over the decoder loaded at startup, waiting if it is still loading.
+    // Dropped if ENGINE picked another backend in the meantime.
+    void adopt_prewarmed_engine()
+    {
+        if (!g_prewarm)
+            return;
+        auto prewarm = std::move(*g_prewarm);
+        g_prewarm.reset();
+        auto engine = prewarm.loading.get();
+        if (engine && !g_warm_engine && prewarm.engine == g_engine_name)
+            g_warm_engine = g_asr->attach(std::move(engine));
+    }
+
+
+    // Publish a finished segment and append it to the transcript
+    void commit_segment(harness::io::TranscriptWriter &transcript, std::uint64_t id,
+                        std::string_view text)
+    {
+        harness::telemetry::global().segment(id, text);
+        transcript.append(id, text);
+    }
+
+    // Punctuation model, mapped by the first session that wants it and then
+    // shared by all of them; later configs do not reload it
+    std::shared_ptr<const harness::postprocess::PunctuationModel>
+    punctuation_model(const harness::transcribe::TranscribeConfig &config)
+    {
+        using namespace harness;
+        static std::shared_ptr<const postprocess::PunctuationModel> cached;
+        static std::once_flag attempted;
+
+        std::call_once(attempted, [&config]
+                       {
+                           if (auto model = postprocess::PunctuationModel::load(config.punctuation_model_path))
+                               cached = std::move(*model);
+                           else
+                               telemetry::emit_info(model.error() + " - using rule-based punctuation"); });
+        return cached;
+    }
+
+    // Queue a finished segment for the accurate second pass
+    void submit_rescore(Session &session, std::uint64_t id, UtteranceSpan span, std::string live_text)
+    {
+        using namespace harness;
+        if (!g_rescorer)
+            return;
+
+        // The rescorer reads the segment back from the file; the part still
+        // staged in memory goes with the job rather than being written early
+        auto &writer = *session.audio_writer;
+        const bool punctuate = session.postprocessor != nullptr;
+        g_rescorer->submit({
+            .wav_path = writer.path(),
+            .wav_rate = writer.sample_rate(),
+            .first_sample = span.first_sample,
+            .sample_count = span.sample_count,
+            .snapshot = writer.snapshot(span.first_sample),
+            .live_text = std::move(live_text),
+            // Runs on the rescorer thread, so it holds its own reference to the model
+            .on_revised = [transcript = session.transcript, model = session.punctuation, id, punctuate](std::string raw)
+            {
+                auto text = punctuate ? postprocess::punctuate(model.get(), raw, {})
+                                      : std::move(raw);
+                if (auto revised = transcript->revise(id, text); !revised)
+                {
+                    telemetry::emit_error(revised.error());
+                    return;
+                }
+                telemetry::global().revision(id, text);
+            },
+        });
+    }
+
+    // Publish keyword hits, timed relative to the session
+    void emit_keywords(const Session &session, const harness::transcribe::TranscriptSegment &hits)
+    {
+        for (const auto &hit : harness::transcribe::shifted(hits, session.utterance_start).words)
+            harness::telemetry::global().keyword(hit.text, hit.start_time, hit.confidence);
+    }
+
+    // Commit the final text of an utterance; it replaces the partials
+    void commit_final(Session &session, UtteranceSpan span, std::string text)
+    {
+        if (text.empty())
+            return;
+
+        const auto id = ++session.segment_count;
+        submit_rescore(session, id, span, text);
+        if (session.postprocessor)
+            session.postprocessor->submit(id, std::move(text));
+        else
+            commit_segment(*session.transcript, id, text);
+    }
+
+    // Publish whatever the engine has decoded so far; never blocks
+    void drain_transcriber(Session &session)
+    {
+        if (!session.transcriber)
+            return;
+
+        while (auto event = session.transcriber->poll())
+        {
+            if (!event->final)
+            {
+                // Partials are a luxury once memory is tight
+                if (session.memory_pressure == harness::memory::Pressure::Normal)
+                    harness::telemetry::global().partial(event->segment.full_text());
+                continue;
+            }
+
+            // One final per ended utterance, in order. Without one there is
+            // no span to place the text at, so it is not committed.
+            if (session.awaiting_final.empty())
+            {
+                harness::telemetry::emit_error("Transcriber returned a final without an utterance; dropped");
+                continue;
+            }
+            const auto span = session.awaiting_final.front();
+            session.awaiting_final.pop_front();
+            commit_final(session, span, event->segment.full_text());
+        }
+    }
+
+    // Close the current utterance. Chunked engines decode it in the
+    // background; its text is committed by drain_transcriber().
+    void finish_utterance(Session &session)
+    {
+        using namespace harness;
+        session.in_utterance = false;
+
+        if (session.spotter)
+        {
+            if (auto hits = session.spotter->finalize())
+                emit_keywords(session, *hits);
+        }
+
+        if (!session.transcriber)
+            return;
+        const auto end_sample = session.audio_writer->samples_written();
+        session.awaiting_final.push_back(
+            {session.utterance_first_sample, end_sample - session.utterance_first_sample});
+        session.transcriber->submit_end();
+        drain_transcriber(session);
+    }
+
+    // Shed load as the memory budget is approached: flush buffers and stop
+    // sending partials when elevated; when critical, also end the utterance
+    // early so the decoder finalizes it and releases its lattice. The
+    // session's watcher samples the resident size and trims the heap on its
+    // own thread; this only reads the level it published.
+    void check_memory(Session &session)
+    {
+        using namespace harness;
+        if (!session.memory)
+            return;
+        const auto previous = std::exchange(session.memory_pressure, session.memory->level());
+        if (session.memory_pressure == previous && session.memory_pressure != memory::Pressure::Critical)
+            return;
+
+        static auto &degradations = metrics::global().counter(
+            "harness_memory_degradations_total", "Times a session shed load to stay within its memory budget");
+        if (session.memory_pressure != previous)
+        {
+            telemetry::emit_info(std::format("Memory pressure {}: {} MiB resident of {} MiB budget",
+                                             memory::to_string(session.memory_pressure),
+                                             session.memory->resident() >> 20,
+                                             g_memory_budget.limit() >> 20));
+            if (session.memory_pressure > previous)
+            {
+                session.audio_writer->flush();
+                degradations.add();
+            }
+        }
+        if (session.memory_pressure == memory::Pressure::Critical && session.in_utterance)
+        {
+            finish_utterance(session);
+            degradations.add();
+        }
+    }
+
+    // Undo the idle handling: restart parked capture and wake the consumer
+    // for every period again (g_session_mutex held)
+    void wake_capture()
+    {
+        using namespace harness;
+        if (!g_device)
+            return;
+        g_device->set_wake_samples(0);
+        if (auto resumed = g_device->resume(); !resumed)
+            telemetry::emit_error(resumed.error());
+    }
 
     void start_recording(std::string_view output_dir)
     {
@@ -62,45 +435,199 @@ namespace cmd
             return;
         }
 
+        // First, so capture is running again while the session is set up
+        wake_capture();
+
         auto session_id = generate_session_id();
         auto session_path = output_dir.empty()
                                 ? std::filesystem::current_path() / "recordings" / session_id
                                 : std::filesystem::path(output_dir) / session_id;
 
-        std::filesystem::create_directories(session_path);
+        std::error_code dir_error;
+        const bool created_dir = std::filesystem::create_directories(session_path, dir_error);
 
         Session session;
         session.id = session_id;
         session.output_dir = session_path;
         session.start_time = std::chrono::steady_clock::now();
+        session.started_at = std::chrono::system_clock::now();
+        session.clock = clock::SessionClock(48000, session.start_time);
+        if (g_clock_correct)
+            session.retime.emplace(48000, 2 * 1024); // Two capture periods
+        session.memory = std::make_unique<memory::Watcher>(g_memory_budget.limit());
+
+        // Every file is opened before the session is committed to. If one
+        // fails, those already open are closed and removed again, so a failed
+        // START leaves neither a half-built session nor orphan files.
+        std::vector<std::filesystem::path> created;
+        auto abandon = [&](const std::string &error)
+        {
+            telemetry::emit_error(error);
+            session.audio_writer.reset();
+            session.mic_writer.reset();
+            session.transcript.reset();
+            std::error_code ec;
+            for (const auto &path : created)
+                std::filesystem::remove(path, ec);
+            if (created_dir)
+                std::filesystem::remove(session_path, ec); // Only if nothing else is in it
+        };
 
-        // Create audio writer
-        auto audio_path = session_path / (session_id + ".wav");
-        auto writer_result = io::WavWriter::create(audio_path, 48000, 1);
-        if (!writer_result)
+        const io::WriteOptions write_options{
+            .mode = g_wav_write_mode,
+            .expected_bytes = std::uint64_t{g_session_minutes} * 60 * 48000 * io::bytes_per_sample(g_wav_format)};
+        auto open_wav = [&](std::filesystem::path path) -> std::unique_ptr<io::WavWriter>
         {
-            telemetry::emit_error("Failed to create audio file: " + writer_result.error());
+            auto writer = io::WavWriter::create(path, 48000, 1, g_wav_format, write_options);
+            if (!writer)
+            {
+                abandon("Failed to create audio file: " + writer.error());
+                return nullptr;
+            }
+            created.push_back(checksum::manifest_path(path));
+            created.push_back(std::move(path));
+            return std::make_unique<io::WavWriter>(std::move(*writer));
+        };
+
+        session.audio_writer = open_wav(session_path / (session_id + ".wav"));
+        if (!session.audio_writer)
             return;
+        if (session.audio_writer->write_mode() != g_wav_write_mode)
+            telemetry::emit_info(std::format("No direct I/O on this filesystem; recording with {} writes",
+                                             io::to_string(session.audio_writer->write_mode())));
+        if (g_loopback == LoopbackUse::Separate)
+        {
+            session.mic_writer = open_wav(session_path / (session_id + ".mic.wav"));
+            if (!session.mic_writer)
+                return;
         }
-        session.audio_writer = std::make_unique<io::WavWriter>(std::move(*writer_result));
 
-        // Create transcriber
-        transcribe::TranscribeConfig tc_config;
-        session.transcriber = transcribe::create_engine(tc_config);
-
-        // Open transcript file
         auto transcript_path = session_path / (session_id + ".md");
-        session.transcript_file.open(transcript_path);
-        session.transcript_file << "# Recording Session: " << session_id << "\n\n";
-        session.transcript_file << "---\n\n";
+        auto transcript_result = io::TranscriptWriter::create(transcript_path, session_id);
+        if (!transcript_result)
+        {
+            abandon(transcript_result.error());
+            return;
+        }
+        created.push_back(std::move(transcript_path));
+        session.transcript = std::move(*transcript_result);
+
+        if (g_echo_cancel && g_loopback != LoopbackUse::Off && g_device && g_device->has_loopback())
+            session.echo.emplace(echo::EchoConfig{.reference_delay = g_device->loopback_latency()});
+
+        // Reuse the warm decoders from the previous session if there are any
+        auto tc_config = live_transcribe_config();
+        adopt_prewarmed_engine();
+        if (g_spotting != SpottingMode::Off)
+        {
+            if (g_warm_spotter)
+                session.spotter = std::move(g_warm_spotter);
+            else if (auto spotter = transcribe::KeywordSpotterEngine::create(tc_config))
+                session.spotter = std::move(*spotter);
+            else
+                telemetry::emit_info("Keyword spotting unavailable: " + spotter.error());
+        }
+        if (g_spotting != SpottingMode::Only || !session.spotter)
+        {
+            session.transcriber = g_warm_engine ? std::move(g_warm_engine)
+                                                : g_asr->attach(transcribe::create_engine(tc_config));
+        }
+        if (tc_config.enable_rescoring && !g_rescorer)
+        {
+            g_rescorer = std::make_unique<rescore::Rescorer>(
+                [config = transcribe::rescoring_config(tc_config)]() -> std::unique_ptr<transcribe::ITranscribeEngine>
+                {
+                    // No stub fallback: its text must never replace real text
+                    if (auto engine = transcribe::PocketSphinxEngine::create(config))
+                        return std::move(*engine);
+                    return nullptr;
+                },
+                tc_config.sample_rate);
+        }
+        if (g_course)
+        {
+            for (auto *engine : {session.transcriber.get(), session.spotter.get()})
+            {
+                if (!engine)
+                    continue;
+                if (auto applied = engine->use_course(*g_course); !applied)
+                    telemetry::emit_error(applied.error());
+            }
+        }
+
+        // Punctuation/truecasing runs off the audio thread
+        if (tc_config.enable_punctuation)
+        {
+            session.punctuation = punctuation_model(tc_config);
+            session.postprocessor = std::make_unique<postprocess::PostProcessor>(
+                session.punctuation,
+                [transcript = session.transcript](std::uint64_t id, std::string text)
+                { commit_segment(*transcript, id, text); },
+                tc_config.punctuation_max_latency);
+        }
 
         g_session = std::move(session);
         g_state = RecordingState::Recording;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(memory::Tag::Count); ++i)
+            memory::account(static_cast<memory::Tag>(i)).reset_peak();
 
         telemetry::global().session_start(g_session->id, session_path.string());
         telemetry::emit_status("recording");
     }
 
+    // Record samples. The first failed write of a session is reported; later
+    // frames still try, in case the disk recovers.
+    void write_audio(Session &session, harness::io::WavWriter &writer, std::span<const float> samples)
+    {
+        if (writer.write(samples) || std::exchange(session.write_failed, true))
+            return;
+        harness::telemetry::emit_error("Failed to write " + writer.path().string());
+    }
+
+    // What the retimer still holds, which no later frame pushes out
+    void flush_retime(Session &session)
+    {
+        if (!session.retime || session.retime->backlog() < 4.0)
+            return;
+        const auto count = static_cast<std::size_t>((session.retime->backlog() - 3.0) / session.retime->ratio());
+        session.retime_buffer.resize(count);
+        if (session.retime->pull(session.retime_buffer, std::chrono::steady_clock::now()))
+            write_audio(session, *session.audio_writer, session.retime_buffer);
+    }
+
+    // <id>.json beside the recording: when it started, and the session time
+    // of its samples as measured against steady_clock
+    void write_manifest(const Session &session)
+    {
+        using namespace harness;
+        const auto samples = session.audio_writer->samples_written();
+        const auto started_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(session.started_at.time_since_epoch()).count();
+        // Written beside the final name and renamed over it, so a crash
+        // never leaves a truncated manifest
+        const auto path = session.output_dir / (session.id + ".json");
+        auto tmp = path;
+        tmp += ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            out << std::format("{{\"session\":\"{}\",\"audio\":\"{}.wav\",\"started_at_ms\":{},"
+                               "\"sample_rate\":{},\"samples\":{},\"clock\":{}}}\n",
+                               telemetry::json_escape(session.id), telemetry::json_escape(session.id), started_ms,
+                               session.audio_writer->sample_rate(), samples,
+                               session.clock.manifest_json(samples, session.retime.has_value()));
+            if (!out.flush())
+            {
+                telemetry::emit_error("Failed to write session manifest for " + session.id);
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec)
+            telemetry::emit_error("Failed to replace session manifest for " + session.id + ": " + ec.message());
+    }
+
     void stop_recording()
     {
         using namespace harness;
@@ -117,12 +644,45 @@ namespace cmd
             auto duration = std::chrono::duration_cast<std::chrono::seconds>(
                 std::chrono::steady_clock::now() - g_session->start_time);
 
+            if (g_session->in_utterance)
+                finish_utterance(*g_session);
+            if (g_session->transcriber)
+            {
+                g_session->transcriber->flush(); // Wait for queued decoding
+                drain_transcriber(*g_session);
+                if (auto *scheduled = dynamic_cast<asr::ScheduledEngine *>(g_session->transcriber.get()))
+                    telemetry::emit_info(std::format("Decoding real-time factor: {:.3f}", scheduled->stats().rtf()));
+            }
+            if (g_session->echo)
+                telemetry::emit_info(std::format("Echo cancellation: {:.1f} dB", g_session->echo->erle_db()));
+            telemetry::emit_info(std::format("Memory peak: {} MiB resident, {} KiB decoder queue, {} KiB transcript",
+                                             std::max(g_session->memory->peak(), g_session->memory->resident()) >> 20,
+                                             memory::account(memory::Tag::AsrQueue).peak() >> 10,
+                                             memory::account(memory::Tag::Transcript).peak() >> 10));
+
+            g_session->postprocessor.reset(); // Delivers queued segments
+            flush_retime(*g_session);
             g_session->audio_writer->close();
-            g_session->transcript_file.close();
+            if (g_session->mic_writer)
+                g_session->mic_writer->close();
+            g_session->transcript->close();
+            write_manifest(*g_session);
+
+            if (g_session->transcriber)
+            {
+                g_session->transcriber->reset();
+                g_warm_engine = std::move(g_session->transcriber);
+            }
+            if (g_session->spotter)
+            {
+                g_session->spotter->reset();
+                g_warm_spotter = std::move(g_session->spotter);
+            }
 
             telemetry::global().session_end(
                 g_session->id,
-                g_session->audio_writer->samples_written() * sizeof(float),
+                g_session->audio_writer->samples_written() *
+                    io::bytes_per_sample(g_session->audio_writer->format()),
                 duration);
 
             g_session.reset();
@@ -160,17 +720,226 @@ namespace cmd
         }
     }
 
+    // Select the transcription backend for the next session; no name lists them
+    void select_engine(std::string_view name)
+    {
+        using namespace harness;
+        std::lock_guard lock(g_session_mutex);
+
+        auto &registry = transcribe::engines();
+        if (name.empty())
+        {
+            std::string list;
+            for (const auto &engine : registry.names())
+                list += (list.empty() ? "" : ", ") + engine;
+            telemetry::emit_info("Engine: " + g_engine_name + " (available: " + list + ")");
+            return;
+        }
+        if (!registry.contains(name))
+        {
+            telemetry::emit_error("Unknown transcription engine: " + std::string(name));
+            return;
+        }
+
+        if (name != g_engine_name)
+        {
+            g_engine_name = name;
+            g_warm_engine.reset(); // Built for the previous backend
+        }
+        telemetry::emit_info(g_session ? "Engine " + g_engine_name + " applies from the next session"
+                                       : "Engine: " + g_engine_name);
+    }
+
+    // AEC ON|OFF for the sessions from the next START; no argument reports
+    void select_echo_cancel(std::string_view arg)
+    {
+        using namespace harness;
+        std::lock_guard lock(g_session_mutex);
+
+        if (arg == "ON" || arg == "OFF")
+            g_echo_cancel = arg == "ON";
+        else if (!arg.empty())
+        {
+            telemetry::emit_error("AEC takes ON or OFF");
+            return;
+        }
+        std::string state = g_echo_cancel ? "on" : "off";
+        if (g_loopback == LoopbackUse::Off)
+            state += " (no system audio captured)";
+        else if (g_session && g_session->echo.has_value() != g_echo_cancel)
+            state += " from the next session";
+        telemetry::emit_info("Echo cancellation " + state);
+    }
+
+    // Select the course vocabulary ("" for the generic model)
+    void select_course(std::string_view course_id)
+    {
+        using namespace harness;
+        std::lock_guard lock(g_session_mutex);
+
+        if (course_id.empty())
+        {
+            g_course.reset();
+        }
+        else if (!g_courses)
+        {
+            telemetry::emit_error("No course directory configured (--courses)");
+            return;
+        }
+        else if (course::valid_course_id(course_id) &&
+                 !std::filesystem::is_directory(g_courses->courses_dir() / course_id))
+        {
+            // Most courses never get a custom vocabulary; that is not an error
+            g_course.reset();
+        }
+        else if (auto model = g_courses->resolve(course_id))
+        {
+            g_course = std::move(*model);
+        }
+        else
+        {
+            telemetry::emit_error(model.error());
+            return;
+        }
+
+        auto *engine = g_session ? g_session->transcriber.get() : g_warm_engine.get();
+        auto *spotter = g_session ? g_session->spotter.get() : g_warm_spotter.get();
+        for (auto *target : {engine, spotter})
+        {
+            if (!target)
+                continue;
+            if (auto applied = target->use_course(g_course.value_or(course::CourseModel{})); !applied)
+            {
+                telemetry::emit_error(applied.error());
+                return;
+            }
+        }
+        telemetry::emit_info(g_course ? "Course vocabulary: " + g_course->course_id
+                                      : std::string("Generic vocabulary"));
+    }
+
+    // Which SIMD variant each kernel family picked at startup
+    [[nodiscard]] std::string kernel_summary()
+    {
+        using namespace harness;
+        return std::format("Kernels: {} (cpu: {}; convert={} escape={} fft={})",
+                           cpu::to_string(cpu::best_isa()), cpu::features().describe(),
+                           cpu::to_string(convert::active_isa()), telemetry::escape_variant(),
+                           dsp::fft_variant());
+    }
+
+    // TRACE START opens a trace window; TRACE STOP [path] writes it as a
+    // Chrome trace (default: trace-<timestamp>.json in the working directory)
+    void trace_command(std::string_view arg)
+    {
+        using namespace harness;
+        if (!trace::compiled_in)
+        {
+            telemetry::emit_error("Trace markers were compiled out (HARNESS_TRACING=OFF)");
+            return;
+        }
+
+        auto space = arg.find(' ');
+        auto action = arg.substr(0, space);
+        if (action == "START")
+        {
+            trace::start();
+            telemetry::emit_info("Tracing");
+        }
+        else if (action == "STOP")
+        {
+            std::filesystem::path path = space == std::string_view::npos
+                                             ? std::filesystem::current_path() / ("trace-" + generate_session_id() + ".json")
+                                             : std::filesystem::path(arg.substr(space + 1));
+            if (auto summary = trace::stop(path))
+                telemetry::emit_info(std::format("Trace written to {} ({} events on {} threads, {} dropped)",
+                                                 path.string(), summary->events, summary->threads,
+                                                 summary->dropped));
+            else
+                telemetry::emit_error(summary.error());
+        }
+        else
+        {
+            telemetry::emit_info(trace::active() ? "Tracing" : "Not tracing");
+        }
+    }
+
+    // VERIFY <session> re-hashes a session's recordings against their
+    // .xxh3 manifests. <session> is a directory or an id under ./recordings.
+    void verify_session(std::string_view arg)
+    {
+        using namespace harness;
+        if (arg.empty())
+        {
+            telemetry::emit_error("VERIFY needs a session directory or id");
+            return;
+        }
+        std::filesystem::path dir(arg);
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec))
+            dir = std::filesystem::current_path() / "recordings" / dir;
+        if (!std::filesystem::is_directory(dir, ec))
+        {
+            telemetry::emit_error("No session at " + std::string(arg));
+            return;
+        }
+
+        std::size_t checked = 0;
+        for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            if (entry.path().extension() != checksum::manifest_extension)
+                continue;
+            ++checked;
+            auto report = checksum::verify(entry.path());
+            if (!report)
+            {
+                telemetry::emit_error(report.error());
+                continue;
+            }
+
+            const auto name = report->file.filename().string();
+            if (!report->ok())
+                telemetry::emit_error(std::format("{}: {} of {} ranges corrupt, first at byte {}", name,
+                                                  report->bad_offsets.size(), report->ranges,
+                                                  report->bad_offsets.front()));
+            else if (report->covered_bytes < report->file_bytes)
+                telemetry::emit_info(std::format("{}: {} ranges intact; last {} bytes not in the manifest "
+                                                 "(still recording, or interrupted)",
+                                                 name, report->ranges, report->file_bytes - report->covered_bytes));
+            else
+                telemetry::emit_info(std::format("{}: {} ranges intact ({} bytes)", name, report->ranges,
+                                                 report->covered_bytes));
+        }
+        if (checked == 0)
+            telemetry::emit_error("No checksum manifests in " + dir.string());
+    }
+
+    void report_status()
+    {
+        using namespace harness;
+        telemetry::emit_status(std::string(to_string(g_state.load())));
+        telemetry::emit_info(kernel_summary());
+    }
+
 } // namespace cmd
 
+// Prometheus text for METRICS and --metrics-socket
+std::string render_metrics()
+{
+    using namespace harness;
+    memory::publish(g_memory_budget.limit()); // The limit is fixed at startup
+    return metrics::global().render();
+}
+
 // Dispatch command to appropriate handler
-void handle_command(harness::Command command, std::string_view output_dir = "")
+void handle_command(harness::Command command, std::string_view arg = "")
 {
     using namespace harness;
 
     switch (command)
     {
     case Command::Start:
-        cmd::start_recording(output_dir);
+        cmd::start_recording(arg);
         break;
     case Command::Stop:
         cmd::stop_recording();
@@ -182,12 +951,42 @@ void handle_command(harness::Command command, std::string_view output_dir = "")
         cmd::resume_recording();
         break;
     case Command::Status:
-        telemetry::emit_status(std::string(to_string(g_state.load())));
+        cmd::report_status();
+        break;
+    case Command::Course:
+        cmd::select_course(arg);
+        break;
+    case Command::Engine:
+        cmd::select_engine(arg);
+        break;
+    case Command::Trace:
+        cmd::trace_command(arg);
+        break;
+    case Command::Verify:
+        cmd::verify_session(arg);
+        break;
+    case Command::Aec:
+        cmd::select_echo_cancel(arg);
+        break;
+    case Command::Metrics:
+        telemetry::emit_info(render_metrics());
+        break;
+    case Command::Subscribe:
+        if (auto subscription = telemetry::parse_subscription(arg))
+            telemetry::global().subscribe(*subscription);
+        else
+            telemetry::emit_error(subscription.error());
         break;
     case Command::Kill:
         if (g_state == RecordingState::Recording)
             cmd::stop_recording();
         g_should_exit = true;
+        {
+            // Ends the audio loop, which may be parked and never see a frame
+            std::lock_guard lock(g_session_mutex);
+            if (g_device)
+                (void)g_device->stop();
+        }
         telemetry::emit_info("Shutting down");
         break;
     case Command::Unknown:
@@ -200,71 +999,286 @@ void handle_command(harness::Command command, std::string_view output_dir = "")
 // Command Listener Thread
 // ============================================================================
 
-void command_listener()
+// Parse and dispatch one command line (stdin or control socket)
+void dispatch_command_line(std::string_view line)
 {
-    std::string line;
-    while (!g_should_exit && std::getline(std::cin, line))
-    {
-        // Trim whitespace
-        auto start = line.find_first_not_of(" \t\r\n");
-        auto end = line.find_last_not_of(" \t\r\n");
+    // Trim whitespace
+    auto start = line.find_first_not_of(" \t\r\n");
+    auto end = line.find_last_not_of(" \t\r\n");
 
-        if (start == std::string::npos)
-            continue;
+    if (start == std::string_view::npos)
+        return;
 
-        std::string_view cmd_str(line.data() + start, end - start + 1);
+    std::string_view cmd_str = line.substr(start, end - start + 1);
+    if (g_journal)
+        g_journal->record_command(cmd_str);
 
-        // Check for command with argument (e.g., "START /path/to/output")
-        auto space_pos = cmd_str.find(' ');
-        std::string_view cmd_part = cmd_str.substr(0, space_pos);
-        std::string_view arg_part = (space_pos != std::string_view::npos)
-                                        ? cmd_str.substr(space_pos + 1)
-                                        : "";
+    // Check for command with argument (e.g., "START /path/to/output")
+    auto space_pos = cmd_str.find(' ');
+    std::string_view cmd_part = cmd_str.substr(0, space_pos);
+    std::string_view arg_part = (space_pos != std::string_view::npos)
+                                    ? cmd_str.substr(space_pos + 1)
+                                    : "";
 
-        auto cmd = harness::parse_command(cmd_part);
-        handle_command(cmd, arg_part);
+    auto cmd = harness::parse_command(cmd_part);
+    handle_command(cmd, arg_part);
+}
+
+// Reads commands from stdin until EOF or EXIT. stdin is polled together
+// with an eventfd that a stop request signals, so main can always join this
+// thread rather than leave it blocked in a read during exit.
+void command_listener(std::stop_token stop)
+{
+    const int wake_fd = ::eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0)
+    {
+        harness::telemetry::emit_error(std::format("Cannot read commands: {}", std::strerror(errno)));
+        return;
     }
+
+    {
+        std::stop_callback on_stop(stop, [wake_fd]
+                                   {
+                                       std::uint64_t one = 1;
+                                       (void)::write(wake_fd, &one, sizeof(one)); });
+        std::string pending;
+        std::array<char, 4096> buffer;
+        bool open = true;
+        while (open && !g_should_exit && !stop.stop_requested())
+        {
+            std::array<pollfd, 2> fds{{{STDIN_FILENO, POLLIN, 0}, {wake_fd, POLLIN, 0}}};
+            if (::poll(fds.data(), fds.size(), -1) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            if (fds[1].revents != 0)
+                break;
+
+            const auto n = ::read(STDIN_FILENO, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR)
+                continue;
+            open = n > 0;
+            if (open)
+                pending.append(buffer.data(), static_cast<std::size_t>(n));
+            else if (!pending.empty())
+                pending += '\n'; // A last line without a newline still counts
+
+            for (auto end = pending.find('\n'); end != std::string::npos && !g_should_exit;
+                 end = pending.find('\n'))
+            {
+                dispatch_command_line(std::string_view(pending).substr(0, end));
+                pending.erase(0, end + 1);
+            }
+        }
+    }
+    ::close(wake_fd);
 }
 
 // ============================================================================
 // Audio Processing Loop
 // ============================================================================
 
+// A frame while no session is open (g_session_mutex held): park capture, or
+// in standby send the loudest level of each burst of frames
+void process_idle_frame(harness::audio::AudioFrame frame)
+{
+    using namespace harness;
+    if (!g_device)
+        return;
+
+    switch (g_idle_mode)
+    {
+    case IdleMode::Run:
+        break;
+    case IdleMode::Park:
+        if (auto parked = g_device->park(); !parked)
+        {
+            telemetry::emit_error(parked.error());
+            g_idle_mode = IdleMode::Run; // Not again for every frame
+        }
+        break;
+    case IdleMode::Standby:
+        g_device->set_wake_samples(g_device->config().sample_rate / standby_meter_hz);
+        g_standby_level = std::max(g_standby_level, audio::calculate_db_level(frame));
+        if (g_device->buffered_samples() < frame.size())
+            telemetry::global().level(std::exchange(g_standby_level, -100.0f));
+        break;
+    }
+}
+
 void process_audio_frame(harness::audio::AudioFrame frame)
 {
     using namespace harness;
+    trace::Scope scope("process_audio_frame");
+    static auto &frames = metrics::global().counter("harness_frames_processed_total",
+                                                    "Capture frames taken through the recording pipeline");
+    static auto &frame_time = metrics::global().histogram("harness_frame_seconds",
+                                                          "Time to process one capture frame");
+    const auto frame_start = std::chrono::steady_clock::now();
 
     std::lock_guard lock(g_session_mutex);
 
+    // Capture timing for the session's sample clock, paused or not; the
+    // frame ended at device frame `device_end`
+    std::uint64_t device_end = 0;
+    if (g_device)
+    {
+        std::array<clock::ClockPoint, 16> points;
+        while (const auto count = g_device->take_clock_points(points))
+        {
+            if (g_session)
+            {
+                for (const auto &point : std::span(points).first(count))
+                    g_session->clock.observe(point);
+            }
+        }
+        device_end = g_device->consumed_frames();
+    }
+
     if (!g_session || g_state != RecordingState::Recording)
     {
+        if (!g_session)
+            process_idle_frame(frame);
         return;
     }
 
-    // 1. Write audio to disk
-    g_session->audio_writer->write(frame);
+    // 0. System audio, already on the microphone's clock. The echo
+    //    canceller delays the microphone by a few tens of ms against it,
+    //    too little to matter between two different speakers.
+    if (g_loopback != LoopbackUse::Off && g_device)
+    {
+        if (const auto system = g_device->loopback_frame(); system.size() == frame.size())
+        {
+            auto mic = frame;
+            if (g_session->echo)
+            {
+                static auto &erle = metrics::global().gauge(
+                    "harness_echo_erle_db", "How far echo cancellation lowers the microphone while system audio plays");
+                g_session->echo_buffer.resize(frame.size());
+                g_session->echo->process(frame, system, g_session->echo_buffer);
+                mic = g_session->echo_buffer;
+                erle.set(g_session->echo->erle_db());
+            }
+            if (g_loopback == LoopbackUse::Mix)
+            {
+                g_session->mix_buffer.resize(frame.size());
+                // Half each: two full-scale sources must not clip the sum
+                convert::mix(mic, 0.5f, system, 0.5f, g_session->mix_buffer);
+                frame = g_session->mix_buffer;
+            }
+            else if (g_session->mic_writer)
+            {
+                cmd::write_audio(*g_session, *g_session->mic_writer, mic);
+                frame = system;
+            }
+        }
+    }
 
-    // 2. Calculate and emit level
-    float db = audio::calculate_db_level(frame);
-    if (g_session->frame_count % 5 == 0)
-    { // Emit every 5 frames (~100ms)
-        telemetry::emit_level(db);
+    // 1. Write audio to disk, with --clock-correct at the nominal rate:
+    //    the retimer takes what the measured rate says the frame is worth
+    //    and keeps two frames queued to draw the difference from. While
+    //    that queue fills, after START and after a resync, it gives silence,
+    //    which is recorded and processed like any frame but not mapped to
+    //    device time.
+    const auto recorded = g_session->audio_writer->samples_written();
+    auto device_first = static_cast<double>(device_end) - static_cast<double>(frame.size());
+    bool from_device = true;
+    if (g_session->retime)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        auto &retime = *g_session->retime;
+        retime.push(frame, now);
+        g_session->retime_due += static_cast<double>(frame.size()) * g_session->clock.estimator().nominal_rate() /
+                                 g_session->clock.estimator().rate();
+        const auto count = static_cast<std::size_t>(g_session->retime_due);
+        g_session->retime_due -= static_cast<double>(count);
+        g_session->retime_buffer.resize(count);
+        from_device = retime.pull(g_session->retime_buffer, now);
+        device_first = static_cast<double>(device_end) - retime.backlog() - static_cast<double>(count) * retime.ratio();
+        frame = g_session->retime_buffer;
     }
+    if (from_device)
+        g_session->clock.recorded(recorded, device_first);
+    cmd::write_audio(*g_session, *g_session->audio_writer, frame);
 
-    // 3. Attempt transcription
-    if (g_session->transcriber && audio::detect_voice_activity(frame))
+    static auto &drift = metrics::global().gauge(
+        "harness_clock_drift_ppm", "Sound card sample clock against steady_clock, over the last ten minutes");
+    drift.set(g_session->clock.estimator().drift_ppm());
+
+    // 2. Offer the level; the emitter sends it at each subscriber's rate
+    auto &emitter = telemetry::global();
+    emitter.level(audio::calculate_db_level(frame));
+
+    // 3. Waveform/spectrogram preview, skipped entirely while nobody watches
+    if (emitter.wants(telemetry::EventType::Waveform) ||
+        emitter.wants(telemetry::EventType::Spectrum))
     {
-        if (auto text = transcribe::transcribe(*g_session->transcriber, frame))
-        {
-            telemetry::emit_text(*text);
+        g_session->preview.process(frame);
+    }
+    if (g_session->preview.waveform_ready())
+    {
+        g_session->preview.take_waveform([](auto columns, std::size_t count)
+                                         { telemetry::global().waveform(columns, count); });
+    }
+    if (g_session->preview.spectrum_ready())
+    {
+        g_session->preview.take_spectrum([](auto slices, std::size_t bands)
+                                         { telemetry::global().spectrum(slices, bands); });
+    }
 
-            // Also write to transcript file
-            g_session->transcript_file << *text << " ";
-            g_session->transcript_file.flush();
+    // 4. Transcription: partial hypotheses while speech continues, the final
+    //    text (also written to the transcript file) once the VAD closes it.
+    //    The keyword spotter only sees speech, like the full decoder.
+    if (g_session->transcriber || g_session->spotter)
+    {
+        if (g_session->vad.process(frame))
+        {
+            if (!std::exchange(g_session->in_utterance, true))
+            {
+                g_session->utterance_first_sample = recorded;
+                g_session->utterance_start = std::chrono::milliseconds(std::llround(
+                    g_session->clock.seconds_at(g_session->utterance_first_sample) * 1000.0));
+            }
+            if (g_session->transcriber)
+                g_session->transcriber->submit(frame);
+            if (g_session->spotter)
+            {
+                if (auto hits = g_session->spotter->process(frame))
+                    cmd::emit_keywords(*g_session, *hits);
+            }
         }
+        else if (g_session->in_utterance)
+        {
+            cmd::finish_utterance(*g_session);
+        }
+        cmd::drain_transcriber(*g_session);
     }
 
     ++g_session->frame_count;
+    frames.add();
+    cmd::check_memory(*g_session);
+
+    // 5. Runtime counters, gathered only while a subscriber asks for them
+    if (emitter.wants(telemetry::EventType::Metrics))
+    {
+        asr::StreamStats decoding;
+        if (auto *scheduled = dynamic_cast<asr::ScheduledEngine *>(g_session->transcriber.get()))
+            decoding = scheduled->stats();
+        emitter.metrics({
+            {"frames", static_cast<std::int64_t>(g_session->frame_count)},
+            {"samples", static_cast<std::int64_t>(g_session->audio_writer->samples_written())},
+            {"uptime_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now() - g_session->start_time)
+                              .count()},
+            {"asr_rtf_permille", static_cast<std::int64_t>(decoding.rtf() * 1000.0)},
+            {"asr_backlog_ms", decoding.backlog().count()},
+            {"simd_level", static_cast<std::int64_t>(std::to_underlying(cpu::best_isa()))}, // cpu::Isa
+        });
+    }
+    frame_time.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frame_start).count()));
 }
 
 // ============================================================================
@@ -274,9 +1288,55 @@ void process_audio_frame(harness::audio::AudioFrame frame)
 struct AppConfig
 {
     bool verbose = false;
+    int shm_fd = -1; // Shared-memory telemetry ring passed by the pilot
+    std::string socket_path; // Optional AF_UNIX control socket
+    std::string metrics_socket_path; // Optional HTTP endpoint for metrics scrapers
+    std::size_t memory_budget_mb = 0; // Resident-size budget; 0 only accounts
+    std::string courses_dir; // Per-course vocabularies (COURSE command)
+    SpottingMode spotting = SpottingMode::Off;
+    std::string engine;      // Transcription backend by registry name
+    std::size_t asr_workers = 0; // Decoder pool size; 0 sizes it to the machine
+    harness::io::WavFormat wav_format = harness::io::WavFormat::Float32;
+    harness::io::WriteMode wav_write_mode = harness::io::WriteMode::Buffered;
+    unsigned session_minutes = 0; // Expected length, to preallocate the recording
+    std::vector<std::string> audio_backends = harness::audio::DeviceConfig{}.backends;
+    std::string journal_path; // Record a capture journal here
+    std::string replay_path;  // Take audio and commands from a journal instead
+    double replay_speed = 1.0; // 1 = recorded timing, 0 = as fast as possible
+    IdleMode idle = IdleMode::Park;
+    LoopbackUse loopback = LoopbackUse::Off;
+    bool echo_cancel = true;
+    bool clock_correct = false;
 };
 
-[[nodiscard]] AppConfig parse_args(int argc, char *argv[])
+// The whole of `text` as a number from `min` to `max`, or a usage error
+// naming `option`. Doubles go through strtod, as libc++ has no
+// floating-point from_chars yet.
+template <typename T>
+[[nodiscard]] std::expected<T, std::string> parse_number(std::string_view option, std::string_view text, T min, T max)
+{
+    T value{};
+    bool whole = false;
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        const std::string copy(text);
+        char *end = nullptr;
+        errno = 0;
+        value = static_cast<T>(std::strtod(copy.c_str(), &end));
+        whole = !copy.empty() && end == copy.c_str() + copy.size() && errno == 0 && std::isfinite(value);
+    }
+    else
+    {
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        whole = ec == std::errc{} && ptr == text.data() + text.size();
+    }
+    if (!whole || value < min || value > max)
+        return std::unexpected(std::format("{} {}: expected a number from {} to {}", option, text, min, max));
+    return value;
+}
+
+// Unknown option values are rejected rather than guessed at
+[[nodiscard]] std::expected<AppConfig, std::string> parse_args(int argc, char *argv[])
 {
     AppConfig config;
     for (int i = 1; i < argc; ++i)
@@ -286,17 +1346,214 @@ struct AppConfig
         {
             config.verbose = true;
         }
+        else if (arg == "--shm-fd" && i + 1 < argc)
+        {
+            auto fd = parse_number(arg, argv[++i], 0, std::numeric_limits<int>::max());
+            if (!fd)
+                return std::unexpected(fd.error());
+            config.shm_fd = *fd;
+        }
+        else if (arg == "--socket" && i + 1 < argc)
+        {
+            config.socket_path = argv[++i];
+        }
+        else if (arg == "--metrics-socket" && i + 1 < argc)
+        {
+            config.metrics_socket_path = argv[++i];
+        }
+        else if (arg == "--memory-budget" && i + 1 < argc)
+        {
+            auto budget = parse_number(arg, argv[++i], std::size_t{0}, std::size_t{1} << 20); // Up to 1 TiB
+            if (!budget)
+                return std::unexpected(budget.error());
+            config.memory_budget_mb = *budget;
+        }
+        else if (arg == "--courses" && i + 1 < argc)
+        {
+            config.courses_dir = argv[++i];
+        }
+        else if (arg == "--asr-workers" && i + 1 < argc)
+        {
+            auto workers = parse_number(arg, argv[++i], std::size_t{0}, std::size_t{256});
+            if (!workers)
+                return std::unexpected(workers.error());
+            config.asr_workers = *workers;
+        }
+        else if (arg == "--engine" && i + 1 < argc)
+        {
+            config.engine = argv[++i];
+        }
+        else if (arg == "--audio-backends" && i + 1 < argc)
+        {
+            // Comma-separated, in order of preference; "all" probes every backend
+            std::string_view list(argv[++i]);
+            config.audio_backends.clear();
+            for (auto name : std::views::split(list, ','))
+            {
+                std::string backend(name.begin(), name.end());
+                if (!backend.empty() && backend != "all")
+                    config.audio_backends.push_back(std::move(backend));
+            }
+        }
+        else if (arg == "--journal" && i + 1 < argc)
+        {
+            config.journal_path = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            config.replay_path = argv[++i];
+        }
+        else if (arg == "--replay-speed" && i + 1 < argc)
+        {
+            auto speed = parse_number(arg, argv[++i], 0.0, 1000.0);
+            if (!speed)
+                return std::unexpected(speed.error());
+            config.replay_speed = *speed;
+        }
+        else if (arg == "--wav-format" && i + 1 < argc)
+        {
+            std::string_view format(argv[++i]);
+            if (format == "s16")
+                config.wav_format = harness::io::WavFormat::Pcm16;
+            else if (format == "s24")
+                config.wav_format = harness::io::WavFormat::Pcm24;
+            else if (format == "f32")
+                config.wav_format = harness::io::WavFormat::Float32;
+            else
+                return std::unexpected(std::format("--wav-format {}: expected f32, s16 or s24", format));
+        }
+        else if (arg == "--wav-io" && i + 1 < argc)
+        {
+            std::string_view mode(argv[++i]);
+            if (mode == "streaming")
+                config.wav_write_mode = harness::io::WriteMode::Streaming;
+            else if (mode == "direct")
+                config.wav_write_mode = harness::io::WriteMode::Direct;
+            else if (mode == "buffered")
+                config.wav_write_mode = harness::io::WriteMode::Buffered;
+            else
+                return std::unexpected(std::format("--wav-io {}: expected buffered, streaming or direct", mode));
+        }
+        else if (arg == "--session-minutes" && i + 1 < argc)
+        {
+            auto minutes = parse_number(arg, argv[++i], 0u, 7u * 24 * 60); // Up to a week
+            if (!minutes)
+                return std::unexpected(minutes.error());
+            config.session_minutes = *minutes;
+        }
+        else if (arg == "--idle" && i + 1 < argc)
+        {
+            std::string_view mode(argv[++i]);
+            if (mode == "run")
+                config.idle = IdleMode::Run;
+            else if (mode == "standby")
+                config.idle = IdleMode::Standby;
+            else if (mode == "park")
+                config.idle = IdleMode::Park;
+            else
+                return std::unexpected(std::format("--idle {}: expected park, standby or run", mode));
+        }
+        else if (arg == "--loopback" && i + 1 < argc)
+        {
+            std::string_view mode(argv[++i]);
+            if (mode == "mix")
+                config.loopback = LoopbackUse::Mix;
+            else if (mode == "separate")
+                config.loopback = LoopbackUse::Separate;
+            else if (mode == "off")
+                config.loopback = LoopbackUse::Off;
+            else
+                return std::unexpected(std::format("--loopback {}: expected off, mix or separate", mode));
+        }
+        else if (arg == "--aec" && i + 1 < argc)
+        {
+            std::string_view mode(argv[++i]);
+            if (mode != "on" && mode != "off")
+                return std::unexpected(std::format("--aec {}: expected on or off", mode));
+            config.echo_cancel = mode == "on";
+        }
+        else if (arg == "--clock-correct")
+        {
+            config.clock_correct = true;
+        }
+        else if (arg == "--kws" && i + 1 < argc)
+        {
+            std::string_view mode(argv[++i]);
+            if (mode == "only")
+                config.spotting = SpottingMode::Only;
+            else if (mode == "alongside")
+                config.spotting = SpottingMode::Alongside;
+            else if (mode == "off")
+                config.spotting = SpottingMode::Off;
+            else
+                return std::unexpected(std::format("--kws {}: expected off, alongside or only", mode));
+        }
     }
     return config;
 }
 
-[[nodiscard]] std::expected<harness::audio::AudioDevice, std::string> init_audio()
+[[nodiscard]] harness::audio::DeviceConfig audio_config(std::vector<std::string> backends)
+{
+    return {.sample_rate = 48000,
+            .channels = 1,
+            .buffer_frames = 1024,
+            .backends = std::move(backends)};
+}
+
+// Without a loopback source the microphone alone is better than nothing
+[[nodiscard]] std::expected<harness::audio::AudioDevice, std::string> init_audio(std::vector<std::string> backends,
+                                                                               bool loopback)
 {
-    harness::audio::DeviceConfig config{
-        .sample_rate = 48000,
-        .channels = 1,
-        .buffer_frames = 1024};
-    return harness::audio::AudioDevice::create(config);
+    auto config = audio_config(std::move(backends));
+    config.enable_loopback = loopback;
+    auto device = harness::audio::AudioDevice::create(config);
+    if (!device && loopback)
+    {
+        harness::telemetry::emit_error("Loopback capture unavailable: " + device.error());
+        config.enable_loopback = false;
+        device = harness::audio::AudioDevice::create(config);
+    }
+    return device;
+}
+
+// Feed a capture journal into `device` as its callback would have, commands
+// included, then stop the device once the pipeline has taken the last frame
+void replay_journal(std::stop_token stop, harness::journal::JournalReader reader, double speed,
+                    harness::audio::AudioDevice &device)
+{
+    using namespace harness;
+    const auto channels = device.config().channels;
+    auto stats = journal::replay(
+        reader, speed,
+        {
+            .audio = [&device, channels](std::span<const float> samples)
+            { device.on_audio_data(samples.data(), samples.size() / channels); },
+            .command = [](std::string_view line)
+            { dispatch_command_line(line); },
+            .room = [&device](std::size_t samples)
+            { return device.free_samples() >= samples; },
+            .drained = [&device]
+            { return device.buffered_samples() == 0; },
+        },
+        stop);
+
+    while (device.buffered_samples() > 0 && device.is_active() && !stop.stop_requested())
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    if (!stats)
+    {
+        telemetry::emit_error("Replay failed: " + stats.error());
+    }
+    else
+    {
+        telemetry::emit_info(std::format(
+            "Replay finished: {} callbacks, {} commands, {:.1f} s of journal, {} gap samples, "
+            "max {:.1f} ms behind schedule",
+            stats->audio_blocks, stats->commands,
+            std::chrono::duration<double>(stats->journal_duration).count(), stats->gap_samples,
+            std::chrono::duration<double, std::milli>(stats->max_lateness).count()));
+    }
+    (void)device.stop();
 }
 
 void run_audio_loop(harness::audio::AudioDevice &device)
@@ -317,13 +1574,147 @@ int main(int argc, char *argv[])
 {
     using namespace harness;
 
-    auto config = parse_args(argc, argv);
+    auto parsed = parse_args(argc, argv);
+    if (!parsed)
+    {
+        telemetry::emit_error("Usage: " + parsed.error());
+        return 2;
+    }
+    auto &config = *parsed;
     if (config.verbose)
         print_banner();
+    g_startup.mark("args");
 
+    // Replays take their input from the journal instead of a capture device
+    std::optional<journal::JournalReader> replay_reader;
+    if (!config.replay_path.empty())
+    {
+        auto reader = journal::JournalReader::open(config.replay_path);
+        const auto expected = audio_config({});
+        if (reader && (reader->header().sample_rate != expected.sample_rate ||
+                       reader->header().channels != expected.channels))
+        {
+            reader = std::unexpected(std::format("Journal was captured at {} Hz with {} channels; expected {} Hz mono",
+                                                 reader->header().sample_rate, reader->header().channels,
+                                                 expected.sample_rate));
+        }
+        if (!reader)
+        {
+            telemetry::emit_error(reader.error());
+            return 1;
+        }
+        replay_reader.emplace(std::move(*reader));
+    }
+
+    // Opening the audio context probes sound servers and is the slowest
+    // step, so it runs while everything else is set up
+    auto audio_init = std::async(std::launch::async, [backends = config.audio_backends, replay = replay_reader.has_value(),
+                                                      loopback = config.loopback != LoopbackUse::Off]
+                                 {
+                                     auto device = replay ? audio::AudioDevice::create_external(audio_config({}))
+                                                          : init_audio(backends, loopback);
+                                     g_startup.mark("audio");
+                                     return device; });
+
+    if (!config.journal_path.empty())
+    {
+        const auto format = audio_config({});
+        if (auto writer = journal::JournalWriter::create(config.journal_path, format.sample_rate, format.channels))
+            g_journal = std::move(*writer);
+        else
+            telemetry::emit_error(writer.error());
+    }
+
+    if (config.shm_fd >= 0)
+    {
+        if (auto ring = shm::SharedRing::attach(config.shm_fd))
+        {
+            telemetry::global().attach_shared_ring(std::move(*ring));
+            telemetry::emit_info("Shared-memory telemetry attached");
+        }
+        else
+        {
+            telemetry::emit_error("Shared-memory telemetry unavailable: " + ring.error());
+        }
+    }
+
+    g_spotting = config.spotting;
+    g_wav_format = config.wav_format;
+    g_wav_write_mode = config.wav_write_mode;
+    g_session_minutes = config.session_minutes;
+    g_clock_correct = config.clock_correct;
+    g_idle_mode = config.idle;
+    {
+        std::lock_guard lock(g_session_mutex);
+        g_loopback = config.loopback;
+        g_echo_cancel = config.echo_cancel;
+    }
+    g_memory_budget = memory::Budget(config.memory_budget_mb << 20);
+    if (!config.engine.empty())
+    {
+        if (transcribe::engines().contains(config.engine))
+            g_engine_name = config.engine;
+        else
+            telemetry::emit_error("Unknown transcription engine: " + config.engine);
+    }
+
+    // Load the decoder for the first START in the background as well
+    if (g_spotting != SpottingMode::Only)
+    {
+        auto tc_config = cmd::live_transcribe_config();
+        g_prewarm.emplace(g_engine_name, std::async(std::launch::async, [tc_config]
+                                                    {
+                                                        auto engine = transcribe::create_engine(tc_config);
+                                                        g_startup.mark("decoder");
+                                                        return engine; }));
+    }
+
+    g_asr.emplace(config.asr_workers);
+    g_startup.mark("decoder pool");
+    if (!config.courses_dir.empty())
+    {
+        std::filesystem::path courses = config.courses_dir;
+        g_courses.emplace(courses, courses / ".cache");
+    }
+
+    std::shared_ptr<server::ControlServer> control_server;
+    if (!config.socket_path.empty())
+    {
+        if (auto created = server::ControlServer::create(config.socket_path, dispatch_command_line))
+        {
+            control_server = std::move(*created);
+            telemetry::global().set_sink(control_server);
+            telemetry::emit_info("Control socket listening on " + config.socket_path);
+        }
+        else
+        {
+            telemetry::emit_error(created.error());
+        }
+    }
+
+    std::unique_ptr<server::MetricsEndpoint> metrics_endpoint;
+    if (!config.metrics_socket_path.empty())
+    {
+        if (auto created = server::MetricsEndpoint::create(config.metrics_socket_path,
+                                                           render_metrics))
+        {
+            metrics_endpoint = std::move(*created);
+            telemetry::emit_info("Metrics endpoint listening on " + config.metrics_socket_path);
+        }
+        else
+        {
+            telemetry::emit_error(created.error());
+        }
+    }
+
+    // Commands are accepted from here on; audio may still be opening
+    std::jthread commander(command_listener);
+    g_startup.mark("ready");
     telemetry::emit_status("ready");
+    telemetry::emit_info(cmd::kernel_summary());
 
-    auto device_result = init_audio();
+    auto device_result = audio_init.get();
+    telemetry::emit_info(g_startup.summary());
     if (!device_result)
     {
         telemetry::emit_error("Failed to initialize audio device: " + device_result.error());
@@ -331,21 +1722,68 @@ int main(int argc, char *argv[])
     }
     auto &device = *device_result;
 
-    std::jthread commander(command_listener);
-
     if (auto result = device.start(); !result)
     {
         telemetry::emit_error("Failed to start audio device: " + result.error());
         return 1;
     }
-    telemetry::emit_info("Audio device started");
+    if (g_journal)
+    {
+        device.set_tap(g_journal.get());
+        telemetry::emit_info("Capture journal: " + g_journal->path().string());
+    }
+
+    std::jthread player;
+    if (replay_reader)
+    {
+        telemetry::emit_info(std::format("Replaying {} at {}", config.replay_path,
+                                         config.replay_speed > 0.0 ? std::format("{}x", config.replay_speed)
+                                                                   : std::string("full speed")));
+        player = std::jthread(replay_journal, std::move(*replay_reader), config.replay_speed, std::ref(device));
+    }
+    else
+    {
+        telemetry::emit_info(std::format("Audio device started ({}, {})", device.name(), device.backend()));
+        if (device.has_loopback())
+            telemetry::emit_info(std::format("System audio from {}", device.loopback_name()));
+    }
 
+    {
+        std::lock_guard lock(g_session_mutex);
+        g_device = &device;
+        if (!device.has_loopback())
+            g_loopback = LoopbackUse::Off;
+    }
     run_audio_loop(device);
+    {
+        std::lock_guard lock(g_session_mutex);
+        g_device = nullptr;
+    }
 
+    if (player.joinable())
+    {
+        player.request_stop();
+        player.join();
+    }
     (void)device.stop();
+    device.set_tap(nullptr);
     if (g_state == RecordingState::Recording)
         cmd::stop_recording();
+    if (g_journal)
+    {
+        g_journal->close();
+        telemetry::emit_info(std::format("Capture journal closed: {} samples in {} KiB, {} dropped",
+                                         g_journal->samples_recorded(), g_journal->bytes_written() / 1024,
+                                         g_journal->samples_dropped()));
+    }
     telemetry::emit_status("stopped");
 
+    g_rescorer.reset(); // Unfinished revisions are dropped; live text stays
+    g_warm_engine.reset();
+    g_prewarm.reset(); // Waits for a load still in flight
+    g_asr.reset();
+    telemetry::global().set_sink(nullptr);
+    control_server.reset();
+
     return 0;
 }
@@ -0,0 +1,406 @@
+// ============================================================================
+// TopNotchNotes Harness - ASR Scheduler Module
+// Shared decoder worker pool multiplexing per-session transcription engines
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+export module harness:asr;
+
+import :transcribe;
+import :course;
+import :metrics;
+import :memory;
+
+export namespace harness::asr
+{
+
+    // ============================================================================
+    // Statistics
+    // ============================================================================
+
+    /// Decoding cost of one stream
+    struct StreamStats
+    {
+        std::chrono::nanoseconds busy{0};      // Time a worker spent in the engine
+        std::uint64_t samples_decoded = 0;
+        std::uint64_t samples_queued = 0;      // Backlog not yet decoded
+        std::uint32_t sample_rate = 48000;
+
+        /// Real-time factor: decode time per second of audio (< 1 keeps up)
+        [[nodiscard]] double rtf() const noexcept
+        {
+            if (samples_decoded == 0)
+                return 0.0;
+            const double audio_s = static_cast<double>(samples_decoded) / sample_rate;
+            return std::chrono::duration<double>(busy).count() / audio_s;
+        }
+
+        [[nodiscard]] std::chrono::milliseconds backlog() const noexcept
+        {
+            return std::chrono::milliseconds(samples_queued * 1000 / sample_rate);
+        }
+    };
+
+    class ScheduledEngine;
+
+    // ============================================================================
+    // Scheduler
+    // ============================================================================
+
+    /// Worker pool shared by every session's decoder. Frames are queued per
+    /// stream; an idle worker takes the stream with the most backlog (oldest
+    /// first on ties) and decodes all of its queued frames in one batch, so the
+    /// engine's state stays hot in that core's cache. A stream is only ever
+    /// decoded by one worker at a time, since engines are not thread-safe.
+    class Scheduler
+    {
+    public:
+        static constexpr std::size_t max_batch = 64; // Frames per dispatch (~1.4 s at 1024/48 kHz)
+
+        /// `workers == 0` sizes the pool to the machine, keeping one core for
+        /// capture and I/O
+        explicit Scheduler(std::size_t workers = 0, std::uint32_t sample_rate = 48000);
+        ~Scheduler();
+
+        Scheduler(const Scheduler &) = delete;
+        Scheduler &operator=(const Scheduler &) = delete;
+
+        /// Run an engine on the pool. Engines that already decode on their
+        /// own worker (is_async) are returned unchanged.
+        [[nodiscard]] std::unique_ptr<transcribe::ITranscribeEngine>
+        attach(std::unique_ptr<transcribe::ITranscribeEngine> engine);
+
+        [[nodiscard]] std::size_t worker_count() const noexcept { return workers_.size(); }
+
+    private:
+        friend class ScheduledEngine;
+
+        struct Work
+        {
+            memory::Vector<memory::Tag::AsrQueue, float> audio;
+            bool end = false;
+        };
+
+        struct Stream
+        {
+            std::unique_ptr<transcribe::ITranscribeEngine> engine;
+            std::mutex engine_mutex; // Held while the engine runs
+
+            // Guarded by Scheduler::mutex_
+            std::deque<Work> pending;
+            std::deque<transcribe::EngineEvent> results;
+            std::chrono::steady_clock::time_point oldest{};
+            bool running = false;
+            StreamStats stats;
+        };
+
+        void enqueue(Stream &stream, Work work);
+        void wait_idle(Stream &stream);
+        void detach(Stream *stream);
+
+        [[nodiscard]] Stream *pick();
+        void run(std::stop_token stop);
+
+        std::uint32_t sample_rate_;
+        std::mutex mutex_;
+        std::condition_variable_any wake_;
+        std::condition_variable idle_;
+        std::vector<std::unique_ptr<Stream>> streams_;
+
+        // Totals across every stream; RTF over a window is
+        // rate(busy) / (rate(decoded) / sample rate)
+        metrics::Counter &busy_ = metrics::global().counter(
+            "harness_asr_busy_seconds_total", "Time decoder workers spent in an engine", 1e-9);
+        metrics::Counter &decoded_ = metrics::global().counter(
+            "harness_asr_decoded_samples_total", "Samples decoded by the scheduler");
+        metrics::Gauge &queued_ = metrics::global().gauge(
+            "harness_asr_queued_samples", "Samples queued for decoding across all streams");
+        metrics::Gauge &rtf_ = metrics::global().gauge(
+            "harness_asr_rtf", "Real-time factor of the most recently decoded stream");
+        metrics::Histogram &batch_time_ = metrics::global().histogram(
+            "harness_asr_batch_seconds", "Time to decode one dispatched batch");
+
+        std::vector<std::jthread> workers_; // Last: started after everything above exists
+    };
+
+    // ============================================================================
+    // Scheduled Engine
+    // ============================================================================
+
+    /// An engine running on the shared pool. submit() only queues the frame;
+    /// decoded results are collected with poll().
+    class ScheduledEngine : public transcribe::ITranscribeEngine
+    {
+    public:
+        ScheduledEngine(Scheduler &scheduler, Scheduler::Stream &stream)
+            : scheduler_(scheduler), stream_(stream)
+        {
+        }
+
+        ~ScheduledEngine() override { scheduler_.detach(&stream_); }
+
+        ScheduledEngine(const ScheduledEngine &) = delete;
+        ScheduledEngine &operator=(const ScheduledEngine &) = delete;
+
+        [[nodiscard]] std::optional<transcribe::TranscriptSegment> process(transcribe::AudioFrame frame) override
+        {
+            submit(frame);
+
+            std::optional<transcribe::TranscriptSegment> latest;
+            std::lock_guard lock(scheduler_.mutex_);
+            auto &results = stream_.results;
+            while (!results.empty() && !results.front().final)
+            {
+                latest = std::move(results.front().segment);
+                results.pop_front();
+            }
+            return latest;
+        }
+
+        [[nodiscard]] std::optional<transcribe::TranscriptSegment> finalize() override
+        {
+            submit_end();
+            flush();
+            while (auto event = poll())
+            {
+                if (event->final)
+                {
+                    if (event->segment.words.empty())
+                        return std::nullopt;
+                    return std::move(event->segment);
+                }
+            }
+            return std::nullopt;
+        }
+
+        void reset() override
+        {
+            {
+                std::lock_guard lock(scheduler_.mutex_);
+                stream_.pending.clear();
+                scheduler_.queued_.add(-static_cast<double>(stream_.stats.samples_queued));
+                stream_.stats.samples_queued = 0;
+            }
+            scheduler_.wait_idle(stream_);
+            {
+                std::lock_guard engine_lock(stream_.engine_mutex);
+                stream_.engine->reset();
+            }
+            std::lock_guard lock(scheduler_.mutex_);
+            stream_.results.clear();
+        }
+
+        [[nodiscard]] bool is_ready() const noexcept override { return stream_.engine->is_ready(); }
+
+        [[nodiscard]] std::expected<void, std::string> use_course(const course::CourseModel &model) override
+        {
+            std::lock_guard engine_lock(stream_.engine_mutex);
+            return stream_.engine->use_course(model);
+        }
+
+        void submit(transcribe::AudioFrame frame) override
+        {
+            scheduler_.enqueue(stream_, {{frame.begin(), frame.end()}, false});
+        }
+
+        void submit_end() override
+        {
+            scheduler_.enqueue(stream_, {{}, true});
+        }
+
+        [[nodiscard]] std::optional<transcribe::EngineEvent> poll() override
+        {
+            std::lock_guard lock(scheduler_.mutex_);
+            if (stream_.results.empty())
+                return std::nullopt;
+            auto event = std::move(stream_.results.front());
+            stream_.results.pop_front();
+            return event;
+        }
+
+        void flush() override { scheduler_.wait_idle(stream_); }
+
+        [[nodiscard]] bool is_async() const noexcept override { return true; }
+
+        [[nodiscard]] StreamStats stats() const
+        {
+            std::lock_guard lock(scheduler_.mutex_);
+            return stream_.stats;
+        }
+
+    private:
+        Scheduler &scheduler_;
+        Scheduler::Stream &stream_;
+    };
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    Scheduler::Scheduler(std::size_t workers, std::uint32_t sample_rate)
+        : sample_rate_(sample_rate)
+    {
+        if (workers == 0)
+        {
+            const auto cores = std::max(1u, std::thread::hardware_concurrency());
+            workers = std::max(1u, cores - 1);
+        }
+        workers_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i)
+        {
+            workers_.emplace_back([this](std::stop_token stop)
+                                  { run(stop); });
+        }
+    }
+
+    Scheduler::~Scheduler()
+    {
+        for (auto &worker : workers_)
+            worker.request_stop();
+        wake_.notify_all();
+        workers_.clear(); // Join before the streams go away
+    }
+
+    std::unique_ptr<transcribe::ITranscribeEngine>
+    Scheduler::attach(std::unique_ptr<transcribe::ITranscribeEngine> engine)
+    {
+        if (!engine || engine->is_async())
+            return engine;
+
+        auto stream = std::make_unique<Stream>();
+        stream->engine = std::move(engine);
+        stream->stats.sample_rate = sample_rate_;
+
+        std::lock_guard lock(mutex_);
+        auto &added = *streams_.emplace_back(std::move(stream));
+        return std::make_unique<ScheduledEngine>(*this, added);
+    }
+
+    void Scheduler::detach(Stream *stream)
+    {
+        std::unique_lock lock(mutex_);
+        stream->pending.clear();
+        idle_.wait(lock, [stream]
+                   { return !stream->running; });
+        queued_.add(-static_cast<double>(stream->stats.samples_queued));
+        std::erase_if(streams_, [stream](const auto &owned)
+                      { return owned.get() == stream; });
+    }
+
+    void Scheduler::enqueue(Stream &stream, Work work)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            if (stream.pending.empty())
+                stream.oldest = std::chrono::steady_clock::now();
+            stream.stats.samples_queued += work.audio.size();
+            queued_.add(static_cast<double>(work.audio.size()));
+            stream.pending.push_back(std::move(work));
+        }
+        wake_.notify_one();
+    }
+
+    void Scheduler::wait_idle(Stream &stream)
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [&stream]
+                   { return stream.pending.empty() && !stream.running; });
+    }
+
+    Scheduler::Stream *Scheduler::pick()
+    {
+        Stream *best = nullptr;
+        for (auto &stream : streams_)
+        {
+            if (stream->running || stream->pending.empty())
+                continue;
+            if (!best || stream->pending.size() > best->pending.size() ||
+                (stream->pending.size() == best->pending.size() && stream->oldest < best->oldest))
+                best = stream.get();
+        }
+        return best;
+    }
+
+    void Scheduler::run(std::stop_token stop)
+    {
+        std::vector<Work> batch;
+        std::vector<transcribe::EngineEvent> events;
+
+        while (true)
+        {
+            Stream *stream = nullptr;
+            {
+                std::unique_lock lock(mutex_);
+                if (!wake_.wait(lock, stop, [&]
+                                { return (stream = pick()) != nullptr; }) ||
+                    stop.stop_requested())
+                    return;
+
+                const auto count = std::min(stream->pending.size(), max_batch);
+                batch.assign(std::make_move_iterator(stream->pending.begin()),
+                             std::make_move_iterator(stream->pending.begin() + static_cast<std::ptrdiff_t>(count)));
+                stream->pending.erase(stream->pending.begin(), stream->pending.begin() + static_cast<std::ptrdiff_t>(count));
+                stream->oldest = std::chrono::steady_clock::now();
+                stream->running = true;
+            }
+
+            // Decode the batch back to back with the engine's state hot
+            std::uint64_t samples = 0;
+            const auto start = std::chrono::steady_clock::now();
+            {
+                std::lock_guard engine_lock(stream->engine_mutex);
+                for (auto &work : batch)
+                {
+                    if (work.end)
+                        stream->engine->submit_end();
+                    else
+                        stream->engine->submit(work.audio);
+                    samples += work.audio.size();
+
+                    while (auto event = stream->engine->poll())
+                        events.push_back(std::move(*event));
+                }
+            }
+            const auto busy = std::chrono::steady_clock::now() - start;
+            const auto busy_ns = static_cast<std::uint64_t>(std::chrono::nanoseconds(busy).count());
+            busy_.add(busy_ns);
+            decoded_.add(samples);
+            batch_time_.record(busy_ns);
+            batch.clear();
+
+            {
+                std::lock_guard lock(mutex_);
+                stream->running = false;
+                stream->stats.busy += busy;
+                stream->stats.samples_decoded += samples;
+                const auto dequeued = std::min(stream->stats.samples_queued, samples);
+                stream->stats.samples_queued -= dequeued;
+                queued_.add(-static_cast<double>(dequeued));
+                rtf_.set(stream->stats.rtf());
+                for (auto &event : events)
+                    stream->results.push_back(std::move(event));
+            }
+            events.clear();
+            idle_.notify_all();
+            wake_.notify_one(); // The stream may have more queued
+        }
+    }
+
+} // namespace harness::asr
@@ -1,11 +1,13 @@
 // ============================================================================
 // TopNotchNotes Harness - Audio Device Module
-// C++23 Generator-based audio streaming with miniaudio backend
+// C++23 Generator-based audio streaming with miniaudio backend, and system
+// audio (loopback) capture brought onto the microphone's clock
 // ============================================================================
 
 module;
 
 #include <cstdint>
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <string_view>
@@ -15,6 +17,7 @@ module;
 #include <expected>
 #include <span>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <coroutine>
@@ -32,6 +35,10 @@ module;
 export module harness:audio;
 
 import :ringbuffer;
+import :trace;
+import :metrics;
+import :dsp;
+import :clock;
 
 export namespace harness::audio {
 
@@ -54,9 +61,45 @@ struct DeviceConfig {
     std::uint32_t channels = 1;
     std::uint32_t buffer_frames = 1024;
     std::string device_name = "";  // Empty = default device
-    bool enable_loopback = false;
+    bool enable_loopback = false;  // Also capture what the system plays (mono only)
+
+    // Backends to try, in order (see parse_backend). Only these are probed,
+    // which keeps slow or absent ones (JACK, OSS) out of startup. Empty =
+    // miniaudio's full default list.
+    std::vector<std::string> backends = {"pipewire", "pulseaudio", "alsa"};
 };
 
+// ============================================================================
+// Backend Selection
+// ============================================================================
+
+/// Map a backend name to miniaudio's backend. miniaudio has no native
+/// PipeWire backend; PipeWire systems serve the PulseAudio protocol
+/// (pipewire-pulse), so "pipewire" selects that.
+[[nodiscard]] inline std::optional<ma_backend> parse_backend(std::string_view name) noexcept {
+    if (name == "pipewire" || name == "pulseaudio" || name == "pulse") return ma_backend_pulseaudio;
+    if (name == "alsa") return ma_backend_alsa;
+    if (name == "jack") return ma_backend_jack;
+    if (name == "oss") return ma_backend_oss;
+    if (name == "null") return ma_backend_null;
+    return std::nullopt;
+}
+
+/// Resolve a backend list, dropping duplicates and keeping the order
+[[nodiscard]] inline AudioResult<std::vector<ma_backend>> resolve_backends(const std::vector<std::string>& names) {
+    std::vector<ma_backend> backends;
+    for (const auto& name : names) {
+        auto backend = parse_backend(name);
+        if (!backend) {
+            return std::unexpected("Unknown audio backend: " + name);
+        }
+        if (std::find(backends.begin(), backends.end(), *backend) == backends.end()) {
+            backends.push_back(*backend);
+        }
+    }
+    return backends;
+}
+
 // ============================================================================
 // Audio Device Information
 // ============================================================================
@@ -76,9 +119,24 @@ struct DeviceInfo {
 
 struct DeviceHandle {
     ma_device device;
+    ma_device loopback;
     ma_context context;
     bool context_initialized = false;
     bool device_initialized = false;
+    bool loopback_initialized = false;
+};
+
+// ============================================================================
+// Capture Tap
+// ============================================================================
+
+// Sees each callback's samples before they enter the ring buffer (the capture
+// journal). Runs on the audio thread, so it must not block or allocate.
+class CaptureTap {
+public:
+    virtual ~CaptureTap() = default;
+    virtual void on_capture(std::span<const float> samples,
+                            std::chrono::steady_clock::time_point at) noexcept = 0;
 };
 
 // ============================================================================
@@ -88,6 +146,10 @@ struct DeviceHandle {
 class AudioDevice {
 public:
     static AudioResult<AudioDevice> create(const DeviceConfig& config);
+
+    // A device without hardware: frames arrive only through on_audio_data
+    // (journal replay) but flow through the same ring buffer and stream
+    static AudioResult<AudioDevice> create_external(const DeviceConfig& config);
     
     AudioDevice(AudioDevice&& other) noexcept;
     AudioDevice& operator=(AudioDevice&& other) noexcept;
@@ -99,23 +161,82 @@ public:
     [[nodiscard]] AudioResult<void> start();
     [[nodiscard]] AudioResult<void> stop();
     [[nodiscard]] bool is_active() const noexcept;
+
+    // Between sessions: park() stops the callbacks but keeps the device open,
+    // so resume() only restarts the stream, well within a period. The
+    // consumer sleeps in wait_for_data meanwhile. Call park() from the
+    // consumer thread, since it discards what is still buffered; callers
+    // serialize park() and resume(). No-ops for external devices.
+    [[nodiscard]] AudioResult<void> park();
+    [[nodiscard]] AudioResult<void> resume();
+    [[nodiscard]] bool is_parked() const noexcept { return parked_.load(std::memory_order_relaxed); }
+
+    // Wake the consumer only once this many samples are buffered, so it
+    // takes them in bursts (standby metering); 0 wakes it every callback.
+    // Ignored for external devices, whose feeders wait for the buffer to drain.
+    void set_wake_samples(std::size_t samples) noexcept {
+        if (!external_) {
+            wake_samples_.store(samples, std::memory_order_relaxed);
+        }
+    }
     
     [[nodiscard]] AudioResult<AudioFrame> wait_for_data();
     [[nodiscard]] std::optional<AudioFrame> try_get_data() noexcept;
+
+    // With enable_loopback: system audio for the frame the last wait_for_data
+    // or try_get_data returned, resampled onto the microphone's clock and
+    // sample-aligned with it. Silence until the streams have synchronized.
+    [[nodiscard]] bool has_loopback() const noexcept { return handle_ && handle_->loopback_initialized; }
+    [[nodiscard]] AudioFrame loopback_frame() const noexcept { return loopback_frame_; }
+    [[nodiscard]] std::string_view loopback_name() const noexcept { return loopback_name_; }
+
+    // How many samples the loopback frame lags the microphone frame: the
+    // resampler keeps its reserve queued ahead of what it hands out
+    [[nodiscard]] std::size_t loopback_latency() const noexcept {
+        return resampler_ ? resampler_->target() - config_.buffer_frames : 0;
+    }
     
     [[nodiscard]] const DeviceConfig& config() const noexcept { return config_; }
     [[nodiscard]] std::string_view name() const noexcept { return device_name_; }
+
+    /// Backend the context settled on, e.g. "PulseAudio"
+    [[nodiscard]] std::string_view backend() const noexcept {
+        return handle_ && handle_->context_initialized ? ma_get_backend_name(handle_->context.backend) : "none";
+    }
     
     static std::vector<DeviceInfo> enumerate_devices();
 
     // Called from audio callback
     void on_audio_data(const float* samples, std::size_t frame_count);
+    void on_loopback_data(const float* samples, std::size_t frame_count);
+
+    // Observe raw callback data from now on; nullptr detaches. The tap must
+    // outlive the device or be detached first.
+    void set_tap(CaptureTap* tap) noexcept { tap_.store(tap, std::memory_order_release); }
+
+    // Ring buffer fill, for feeding external devices without overrunning it
+    [[nodiscard]] std::size_t buffered_samples() const noexcept { return ring_buffer_.size(); }
+    [[nodiscard]] std::size_t free_samples() const noexcept { return ring_buffer_.available(); }
+
+    // Sample clock against steady_clock: a point per callback, counting the
+    // frames that reached the ring buffer, for the consumer to drain. None
+    // for external devices, whose timing is the feeder's.
+    [[nodiscard]] std::size_t take_clock_points(std::span<clock::ClockPoint> out) noexcept {
+        return clock_points_.pop(out);
+    }
+    // Frames handed out (or discarded by park) so far, on the same count:
+    // the frame last returned ended at device frame consumed_frames()
+    [[nodiscard]] std::uint64_t consumed_frames() const noexcept { return consumed_frames_; }
 
 private:
     explicit AudioDevice(const DeviceConfig& config);
+
+    AudioResult<void> init_loopback();
+    AudioFrame take_frame(std::size_t samples);
     
     DeviceConfig config_;
     std::string device_name_;
+    std::string loopback_name_;
     std::unique_ptr<DeviceHandle> handle_;
     
     // Ring buffer for lock-free audio transfer from callback
@@ -123,8 +244,26 @@ private:
     
     // Consumer-side buffer for returning frames
     std::vector<float> frame_buffer_;
-    
+
+    // Loopback callbacks fill loopback_ring_ and stamp loopback_at_ (steady
+    // clock ns); the consumer moves it through the resampler in take_frame
+    harness::AudioRingBuffer loopback_ring_;
+    std::atomic<std::int64_t> loopback_at_{0};
+    std::optional<dsp::DriftResampler> resampler_;
+    std::vector<float> loopback_scratch_;
+    std::vector<float> loopback_buffer_;
+    AudioFrame loopback_frame_;
+    std::uint64_t loopback_resyncs_ = 0;
+
+    harness::RingBuffer<clock::ClockPoint, 64> clock_points_;
+    std::uint64_t captured_frames_ = 0; // Callback thread only
+    std::uint64_t consumed_frames_ = 0; // Consumer thread only
+    
+    bool external_ = false;
+    std::atomic<CaptureTap*> tap_{nullptr};
     std::atomic<bool> active_{false};
+    std::atomic<bool> parked_{false};
+    std::atomic<std::size_t> wake_samples_{0};
     std::atomic<bool> data_ready_{false};
     std::mutex mutex_;
     std::condition_variable cv_;
@@ -145,10 +284,27 @@ inline void audio_data_callback(ma_device* pDevice, void* pOutput,
     }
 }
 
+inline void loopback_data_callback(ma_device* pDevice, void* pOutput,
+                                   const void* pInput, ma_uint32 frameCount) {
+    (void)pOutput;
+
+    auto* device = static_cast<AudioDevice*>(pDevice->pUserData);
+    if (device && pInput) {
+        device->on_loopback_data(static_cast<const float*>(pInput), frameCount);
+    }
+}
+
 // ============================================================================
 // AudioDevice Implementation
 // ============================================================================
 
+namespace detail {
+inline metrics::Gauge& parked_gauge() {
+    static auto& parked = metrics::global().gauge("harness_capture_parked", "1 while capture is parked between sessions");
+    return parked;
+}
+} // namespace detail
+
 AudioDevice::AudioDevice(const DeviceConfig& config)
     : config_(config)
     , handle_(std::make_unique<DeviceHandle>())
@@ -159,9 +315,19 @@ AudioDevice::AudioDevice(const DeviceConfig& config)
 AudioDevice::AudioDevice(AudioDevice&& other) noexcept
     : config_(std::move(other.config_))
     , device_name_(std::move(other.device_name_))
+    , loopback_name_(std::move(other.loopback_name_))
     , handle_(std::move(other.handle_))
     , frame_buffer_(std::move(other.frame_buffer_))
+    , resampler_(std::move(other.resampler_))
+    , loopback_scratch_(std::move(other.loopback_scratch_))
+    , loopback_buffer_(std::move(other.loopback_buffer_))
+    , captured_frames_(other.captured_frames_)
+    , consumed_frames_(other.consumed_frames_)
+    , external_(other.external_)
+    , tap_(other.tap_.load())
     , active_(other.active_.load())
+    , parked_(other.parked_.load())
+    , wake_samples_(other.wake_samples_.load())
 {
     other.active_ = false;
 }
@@ -173,9 +339,20 @@ AudioDevice& AudioDevice::operator=(AudioDevice&& other) noexcept {
         }
         config_ = std::move(other.config_);
         device_name_ = std::move(other.device_name_);
+        loopback_name_ = std::move(other.loopback_name_);
         handle_ = std::move(other.handle_);
         frame_buffer_ = std::move(other.frame_buffer_);
+        resampler_ = std::move(other.resampler_);
+        loopback_scratch_ = std::move(other.loopback_scratch_);
+        loopback_buffer_ = std::move(other.loopback_buffer_);
+        loopback_frame_ = {};
+        captured_frames_ = other.captured_frames_;
+        consumed_frames_ = other.consumed_frames_;
+        external_ = other.external_;
+        tap_ = other.tap_.load();
         active_ = other.active_.load();
+        parked_ = other.parked_.load();
+        wake_samples_ = other.wake_samples_.load();
         other.active_ = false;
     }
     return *this;
@@ -186,6 +363,9 @@ AudioDevice::~AudioDevice() {
         (void)stop();
     }
     if (handle_) {
+        if (handle_->loopback_initialized) {
+            ma_device_uninit(&handle_->loopback);
+        }
         if (handle_->device_initialized) {
             ma_device_uninit(&handle_->device);
         }
@@ -198,9 +378,16 @@ AudioDevice::~AudioDevice() {
 AudioResult<AudioDevice> AudioDevice::create(const DeviceConfig& config) {
     AudioDevice device(config);
     
-    // Initialize context
+    auto backends = resolve_backends(config.backends);
+    if (!backends) {
+        return std::unexpected(backends.error());
+    }
+
+    // Initialize context, trying only the configured backends
     ma_context_config ctx_config = ma_context_config_init();
-    if (ma_context_init(nullptr, 0, &ctx_config, &device.handle_->context) != MA_SUCCESS) {
+    if (ma_context_init(backends->empty() ? nullptr : backends->data(),
+                        static_cast<ma_uint32>(backends->size()),
+                        &ctx_config, &device.handle_->context) != MA_SUCCESS) {
         return std::unexpected("Failed to initialize audio context");
     }
     device.handle_->context_initialized = true;
@@ -212,7 +399,7 @@ AudioResult<AudioDevice> AudioDevice::create(const DeviceConfig& config) {
     dev_config.sampleRate = config.sample_rate;
     dev_config.periodSizeInFrames = config.buffer_frames;
     dev_config.dataCallback = audio_data_callback;
-    dev_config.pUserData = &device;
+    dev_config.pUserData = nullptr;  // Set by start(): `device` is moved out of here
     
     if (ma_device_init(&device.handle_->context, &dev_config, &device.handle_->device) != MA_SUCCESS) {
         return std::unexpected("Failed to initialize capture device");
@@ -221,15 +408,110 @@ AudioResult<AudioDevice> AudioDevice::create(const DeviceConfig& config) {
     
     // Get device name
     device.device_name_ = device.handle_->device.capture.name;
+
+    if (config.enable_loopback) {
+        if (auto loopback = device.init_loopback(); !loopback) {
+            return std::unexpected(loopback.error());
+        }
+    }
     
     return device;
 }
 
+// miniaudio's loopback device type is WASAPI-only. PulseAudio (and PipeWire
+// through pipewire-pulse) instead offers every sink's output as a capture
+// source, "<sink>.monitor": take the default sink's, or the first there is.
+AudioResult<void> AudioDevice::init_loopback() {
+    if (config_.channels != 1) {
+        return std::unexpected("Loopback capture needs a mono stream");
+    }
+
+    ma_device_config dev_config = ma_device_config_init(ma_device_type_capture);
+    ma_device_id monitor{};
+    auto& context = handle_->context;
+    switch (context.backend) {
+    case ma_backend_pulseaudio: {
+        ma_device_info* playback = nullptr;
+        ma_device_info* capture = nullptr;
+        ma_uint32 playback_count = 0;
+        ma_uint32 capture_count = 0;
+        if (ma_context_get_devices(&context, &playback, &playback_count, &capture, &capture_count) != MA_SUCCESS) {
+            return std::unexpected("Failed to list audio devices");
+        }
+        std::string wanted;
+        for (ma_uint32 i = 0; i < playback_count; ++i) {
+            if (playback[i].isDefault) {
+                wanted = std::string(playback[i].id.pulse) + ".monitor";
+            }
+        }
+        const ma_device_info* found = nullptr;
+        for (ma_uint32 i = 0; i < capture_count && (!found || found->id.pulse != wanted); ++i) {
+            const std::string_view id = capture[i].id.pulse;
+            if (id == wanted || (!found && id.ends_with(".monitor"))) {
+                found = &capture[i];
+            }
+        }
+        if (!found) {
+            return std::unexpected("No monitor source to capture system audio from");
+        }
+        monitor = found->id;
+        dev_config.capture.pDeviceID = &monitor;
+        break;
+    }
+    case ma_backend_wasapi:
+        dev_config = ma_device_config_init(ma_device_type_loopback);
+        break;
+    case ma_backend_null:
+        break; // Another silent device, for tests
+    default:
+        return std::unexpected(std::string("No loopback capture on ") + ma_get_backend_name(context.backend));
+    }
+
+    dev_config.capture.format = ma_format_f32;
+    dev_config.capture.channels = 1; // Downmixed by miniaudio
+    dev_config.sampleRate = config_.sample_rate;
+    dev_config.periodSizeInFrames = config_.buffer_frames;
+    dev_config.dataCallback = loopback_data_callback;
+    dev_config.pUserData = nullptr;
+    if (ma_device_init(&context, &dev_config, &handle_->loopback) != MA_SUCCESS) {
+        return std::unexpected("Failed to initialize loopback capture device");
+    }
+    handle_->loopback_initialized = true;
+    loopback_name_ = handle_->loopback.capture.name;
+
+    // The two periods need not match; hold two of the longer one in reserve
+    // against callback jitter, plus the frame being read
+    const std::size_t period = std::max<std::size_t>(config_.buffer_frames, handle_->loopback.capture.internalPeriodSizeInFrames);
+    resampler_.emplace(config_.sample_rate, 2 * period + config_.buffer_frames);
+    loopback_scratch_.resize(config_.buffer_frames);
+    loopback_buffer_.resize(config_.buffer_frames);
+    return {};
+}
+
+AudioResult<AudioDevice> AudioDevice::create_external(const DeviceConfig& config) {
+    AudioDevice device(config);
+    device.external_ = true;
+    device.device_name_ = "external";
+    return device;
+}
+
 AudioResult<void> AudioDevice::start() {
+    if (external_) {
+        active_ = true;
+        return {};
+    }
     if (!handle_ || !handle_->device_initialized) {
         return std::unexpected("Device not initialized");
     }
     
+    // The object may have moved since create(); callbacks must reach this one
+    handle_->device.pUserData = this;
+    if (handle_->loopback_initialized) {
+        handle_->loopback.pUserData = this;
+        if (ma_device_start(&handle_->loopback) != MA_SUCCESS) {
+            return std::unexpected("Failed to start loopback capture");
+        }
+    }
     if (ma_device_start(&handle_->device) != MA_SUCCESS) {
         return std::unexpected("Failed to start audio capture");
     }
@@ -245,25 +527,125 @@ AudioResult<void> AudioDevice::stop() {
     if (handle_ && handle_->device_initialized) {
         ma_device_stop(&handle_->device);
     }
+    if (handle_ && handle_->loopback_initialized) {
+        ma_device_stop(&handle_->loopback);
+    }
     
     return {};
 }
 
+AudioResult<void> AudioDevice::park() {
+    if (external_ || !active_ || parked_) {
+        return {};
+    }
+    if (ma_device_stop(&handle_->device) != MA_SUCCESS) {
+        return std::unexpected("Failed to park audio capture");
+    }
+    if (handle_->loopback_initialized) {
+        ma_device_stop(&handle_->loopback);
+    }
+    parked_ = true;
+    detail::parked_gauge().set(1.0);
+
+    // Nothing pushes now; the next session must not start with stale audio
+    consumed_frames_ += ring_buffer_.size() / config_.channels;
+    ring_buffer_.clear();
+    clock_points_.clear();
+    loopback_ring_.clear();
+    if (resampler_) {
+        resampler_.emplace(config_.sample_rate, resampler_->target());
+    }
+    data_ready_.store(false, std::memory_order_release);
+    return {};
+}
+
+AudioResult<void> AudioDevice::resume() {
+    if (!parked_) {
+        return {};
+    }
+    if (handle_->loopback_initialized && ma_device_start(&handle_->loopback) != MA_SUCCESS) {
+        return std::unexpected("Failed to resume loopback capture");
+    }
+    if (ma_device_start(&handle_->device) != MA_SUCCESS) {
+        return std::unexpected("Failed to resume audio capture");
+    }
+    parked_ = false;
+    detail::parked_gauge().set(0.0);
+    return {};
+}
+
 bool AudioDevice::is_active() const noexcept {
     return active_.load(std::memory_order_relaxed);
 }
 
 void AudioDevice::on_audio_data(const float* samples, std::size_t frame_count) {
+    trace::Scope scope("on_audio_data");
     // Push samples into ring buffer (lock-free, called from audio thread)
     std::size_t sample_count = frame_count * config_.channels;
-    ring_buffer_.push(std::span<const float>(samples, sample_count));
+    const auto now = std::chrono::steady_clock::now();
+    if (auto* tap = tap_.load(std::memory_order_acquire)) {
+        tap->on_capture(std::span<const float>(samples, sample_count), now);
+    }
+    const auto pushed = ring_buffer_.push(std::span<const float>(samples, sample_count));
+    if (pushed < sample_count) {
+        static auto& dropped = metrics::global().counter(
+            "harness_capture_dropped_samples_total", "Captured samples lost to a full ring buffer");
+        dropped.add(sample_count - pushed);
+    }
+    if (!external_) {
+        captured_frames_ += pushed / config_.channels;
+        (void)clock_points_.push({captured_frames_, now});
+    }
     
     // Signal that data is available
-    data_ready_.store(true, std::memory_order_release);
-    cv_.notify_one();
+    if (ring_buffer_.size() >= wake_samples_.load(std::memory_order_relaxed)) {
+        data_ready_.store(true, std::memory_order_release);
+        cv_.notify_one();
+    }
+}
+
+void AudioDevice::on_loopback_data(const float* samples, std::size_t frame_count) {
+    const auto pushed = loopback_ring_.push(std::span<const float>(samples, frame_count));
+    if (pushed < frame_count) {
+        static auto& dropped = metrics::global().counter(
+            "harness_loopback_dropped_samples_total", "System audio samples lost to a full ring buffer");
+        dropped.add(frame_count - pushed);
+    }
+    loopback_at_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_release);
+}
+
+// Pop a frame, and with loopback pull the matching system audio. The frame's
+// last sample was captured about `remaining / rate` before now.
+AudioFrame AudioDevice::take_frame(std::size_t samples) {
+    if (samples > 0) {
+        ring_buffer_.pop(std::span<float>(frame_buffer_.data(), samples));
+    }
+    consumed_frames_ += samples / config_.channels;
+    if (!resampler_) {
+        return AudioFrame(frame_buffer_.data(), samples);
+    }
+
+    using Clock = dsp::DriftResampler::Clock;
+    const Clock::time_point pushed_at{Clock::duration{loopback_at_.load(std::memory_order_acquire)}};
+    while (const auto got = loopback_ring_.pop(std::span<float>(loopback_scratch_))) {
+        resampler_->push(std::span<const float>(loopback_scratch_.data(), got), pushed_at);
+    }
+    const auto behind = std::chrono::duration<double>(static_cast<double>(ring_buffer_.size()) / config_.sample_rate);
+    const auto captured_at = Clock::now() - std::chrono::duration_cast<Clock::duration>(behind);
+    resampler_->pull(std::span<float>(loopback_buffer_.data(), samples), captured_at);
+    loopback_frame_ = AudioFrame(loopback_buffer_.data(), samples);
+
+    static auto& drift = metrics::global().gauge(
+        "harness_loopback_drift_ppm", "System audio clock against the microphone's");
+    static auto& resyncs = metrics::global().counter(
+        "harness_loopback_resyncs_total", "Times system audio ran dry or overflowed and was realigned");
+    drift.set(resampler_->drift_ppm());
+    resyncs.add(resampler_->resyncs() - std::exchange(loopback_resyncs_, resampler_->resyncs()));
+    return AudioFrame(frame_buffer_.data(), samples);
 }
 
 AudioResult<AudioFrame> AudioDevice::wait_for_data() {
+    trace::Scope scope("wait_for_data");
     std::unique_lock lock(mutex_);
     
     cv_.wait(lock, [this] { 
@@ -278,17 +660,19 @@ AudioResult<AudioFrame> AudioDevice::wait_for_data() {
     std::size_t expected_samples = config_.buffer_frames * config_.channels;
     std::size_t available = ring_buffer_.size();
     std::size_t to_read = std::min(available, expected_samples);
+    auto frame = take_frame(to_read);
     
-    if (to_read > 0) {
-        ring_buffer_.pop(std::span<float>(frame_buffer_.data(), to_read));
-    }
+    static auto& buffered = metrics::global().gauge(
+        "harness_capture_buffered_samples", "Samples waiting in the capture ring buffer");
+    const auto remaining = ring_buffer_.size();
+    buffered.set(static_cast<double>(remaining));
     
     // Check if we need more data before signaling ready again
-    if (ring_buffer_.size() < expected_samples) {
+    if (remaining < expected_samples) {
         data_ready_.store(false, std::memory_order_release);
     }
     
-    return AudioFrame(frame_buffer_.data(), to_read);
+    return frame;
 }
 
 std::optional<AudioFrame> AudioDevice::try_get_data() noexcept {
@@ -304,13 +688,13 @@ std::optional<AudioFrame> AudioDevice::try_get_data() noexcept {
     }
     
     std::size_t to_read = std::min(available, expected_samples);
-    ring_buffer_.pop(std::span<float>(frame_buffer_.data(), to_read));
+    auto frame = take_frame(to_read);
     
     if (ring_buffer_.size() < expected_samples) {
         data_ready_.store(false, std::memory_order_release);
     }
     
-    return AudioFrame(frame_buffer_.data(), to_read);
+    return frame;
 }
 
 std::vector<DeviceInfo> AudioDevice::enumerate_devices() {
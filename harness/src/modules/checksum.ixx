@@ -0,0 +1,674 @@
+// ============================================================================
+// TopNotchNotes Harness - Checksum Module
+// Streaming XXH3-64 with SIMD accumulation, per-segment sidecar manifests and
+// parallel verification of recorded files
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HARNESS_CHECKSUM_X86 1
+#else
+#define HARNESS_CHECKSUM_X86 0
+#endif
+
+export module harness:checksum;
+
+import :cpu;
+
+export namespace harness::checksum
+{
+
+    // ============================================================================
+    // XXH3-64
+    // ============================================================================
+    //
+    // Bit-compatible with XXH3_64bits() (seed 0, default secret), so any
+    // range can be cross-checked with the reference implementation. Inputs
+    // above 240 bytes run through the 64-byte stripe accumulator, which has
+    // scalar and AVX2 kernels.
+
+    namespace detail
+    {
+        inline constexpr std::size_t stripe_len = 64;
+        inline constexpr std::size_t secret_size = 192;
+        inline constexpr std::size_t stripes_per_block = (secret_size - stripe_len) / 8;
+        inline constexpr std::size_t midsize_max = 240;
+
+        inline constexpr std::uint64_t prime32_1 = 0x9E3779B1U;
+        inline constexpr std::uint64_t prime32_2 = 0x85EBCA77U;
+        inline constexpr std::uint64_t prime32_3 = 0xC2B2AE3DU;
+        inline constexpr std::uint64_t prime64_1 = 0x9E3779B185EBCA87ULL;
+        inline constexpr std::uint64_t prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+        inline constexpr std::uint64_t prime64_3 = 0x165667B19E3779F9ULL;
+        inline constexpr std::uint64_t prime64_4 = 0x85EBCA77C2B2AE63ULL;
+        inline constexpr std::uint64_t prime64_5 = 0x27D4EB2F165667C5ULL;
+        inline constexpr std::uint64_t prime_mx1 = 0x165667919E3779F9ULL;
+        inline constexpr std::uint64_t prime_mx2 = 0x9FB21C651E98DF25ULL;
+
+        alignas(64) inline constexpr std::array<std::uint8_t, secret_size> secret{
+            0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+            0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+            0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+            0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+            0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+            0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+            0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+            0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+            0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+            0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+            0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+            0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+        };
+
+        inline std::uint64_t read64(const std::uint8_t *p) noexcept
+        {
+            std::uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            if constexpr (std::endian::native == std::endian::big)
+                value = std::byteswap(value);
+            return value;
+        }
+
+        inline std::uint32_t read32(const std::uint8_t *p) noexcept
+        {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            if constexpr (std::endian::native == std::endian::big)
+                value = std::byteswap(value);
+            return value;
+        }
+
+        inline std::uint64_t mul128_fold64(std::uint64_t a, std::uint64_t b) noexcept
+        {
+            const auto product = static_cast<unsigned __int128>(a) * b;
+            return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+        }
+
+        inline std::uint64_t xxh64_avalanche(std::uint64_t h) noexcept
+        {
+            h ^= h >> 33;
+            h *= prime64_2;
+            h ^= h >> 29;
+            h *= prime64_3;
+            return h ^ (h >> 32);
+        }
+
+        inline std::uint64_t avalanche(std::uint64_t h) noexcept
+        {
+            h ^= h >> 37;
+            h *= prime_mx1;
+            return h ^ (h >> 32);
+        }
+
+        inline std::uint64_t rrmxmx(std::uint64_t h, std::uint64_t len) noexcept
+        {
+            h ^= std::rotl(h, 49) ^ std::rotl(h, 24);
+            h *= prime_mx2;
+            h ^= (h >> 35) + len;
+            h *= prime_mx2;
+            return h ^ (h >> 28);
+        }
+
+        inline std::uint64_t mix16(const std::uint8_t *in, const std::uint8_t *key) noexcept
+        {
+            return mul128_fold64(read64(in) ^ read64(key), read64(in + 8) ^ read64(key + 8));
+        }
+
+        /// Inputs of at most 240 bytes, hashed in one go
+        inline std::uint64_t hash_short(const std::uint8_t *in, std::size_t len) noexcept
+        {
+            const auto *key = secret.data();
+            const auto length = static_cast<std::uint64_t>(len);
+            if (len == 0)
+                return xxh64_avalanche(read64(key + 56) ^ read64(key + 64));
+            if (len <= 3)
+            {
+                const std::uint32_t combined = (std::uint32_t{in[0]} << 16) | (std::uint32_t{in[len >> 1]} << 24) |
+                                               std::uint32_t{in[len - 1]} | (static_cast<std::uint32_t>(len) << 8);
+                return xxh64_avalanche(combined ^ (std::uint64_t{read32(key) ^ read32(key + 4)}));
+            }
+            if (len <= 8)
+            {
+                const std::uint64_t combined = read32(in + len - 4) + (std::uint64_t{read32(in)} << 32);
+                return rrmxmx(combined ^ (read64(key + 8) ^ read64(key + 16)), length);
+            }
+            if (len <= 16)
+            {
+                const auto lo = read64(in) ^ (read64(key + 24) ^ read64(key + 32));
+                const auto hi = read64(in + len - 8) ^ (read64(key + 40) ^ read64(key + 48));
+                return avalanche(length + std::byteswap(lo) + hi + mul128_fold64(lo, hi));
+            }
+
+            std::uint64_t acc = length * prime64_1;
+            if (len <= 128)
+            {
+                if (len > 32)
+                {
+                    if (len > 64)
+                    {
+                        if (len > 96)
+                        {
+                            acc += mix16(in + 48, key + 96);
+                            acc += mix16(in + len - 64, key + 112);
+                        }
+                        acc += mix16(in + 32, key + 64);
+                        acc += mix16(in + len - 48, key + 80);
+                    }
+                    acc += mix16(in + 16, key + 32);
+                    acc += mix16(in + len - 32, key + 48);
+                }
+                acc += mix16(in, key);
+                acc += mix16(in + len - 16, key + 16);
+                return avalanche(acc);
+            }
+
+            for (std::size_t i = 0; i < 8; ++i)
+                acc += mix16(in + 16 * i, key + 16 * i);
+            acc = avalanche(acc);
+            for (std::size_t i = 8; i < len / 16; ++i)
+                acc += mix16(in + 16 * i, key + 16 * (i - 8) + 3);
+            acc += mix16(in + len - 16, key + 136 - 17);
+            return avalanche(acc);
+        }
+
+        // ---- Stripe kernels -------------------------------------------------
+
+        using Accumulators = std::array<std::uint64_t, 8>;
+
+        struct Kernels
+        {
+            cpu::Isa isa;
+            /// Fold `stripes` consecutive 64-byte stripes, stepping the key 8 bytes per stripe
+            void (*accumulate)(Accumulators &, const std::uint8_t *in, const std::uint8_t *key,
+                               std::size_t stripes) noexcept;
+            void (*scramble)(Accumulators &, const std::uint8_t *key) noexcept;
+        };
+
+        inline void scalar_accumulate(Accumulators &acc, const std::uint8_t *in, const std::uint8_t *key,
+                                      std::size_t stripes) noexcept
+        {
+            for (std::size_t s = 0; s < stripes; ++s, in += stripe_len, key += 8)
+            {
+                for (std::size_t i = 0; i < 8; ++i)
+                {
+                    const auto value = read64(in + 8 * i);
+                    const auto keyed = value ^ read64(key + 8 * i);
+                    acc[i ^ 1] += value;
+                    acc[i] += (keyed & 0xFFFFFFFFU) * (keyed >> 32);
+                }
+            }
+        }
+
+        inline void scalar_scramble(Accumulators &acc, const std::uint8_t *key) noexcept
+        {
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                auto value = acc[i];
+                value ^= value >> 47;
+                value ^= read64(key + 8 * i);
+                acc[i] = value * prime32_1;
+            }
+        }
+
+        inline constexpr Kernels scalar_kernels{cpu::Isa::Scalar, scalar_accumulate, scalar_scramble};
+
+#if HARNESS_CHECKSUM_X86
+
+        // Compiled for AVX2 regardless of the global flags; only called after
+        // the CPU has been checked. Four 64-bit lanes per register, two
+        // registers per stripe.
+
+        __attribute__((target("avx2"))) inline void avx2_accumulate(Accumulators &acc, const std::uint8_t *in,
+                                                                    const std::uint8_t *key,
+                                                                    std::size_t stripes) noexcept
+        {
+            __m256i lanes[2] = {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc.data())),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc.data() + 4))};
+            for (std::size_t s = 0; s < stripes; ++s, in += stripe_len, key += 8)
+            {
+                for (int half = 0; half < 2; ++half)
+                {
+                    const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in) + half);
+                    const __m256i keyed =
+                        _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key) + half));
+                    // Low half times high half of each keyed lane
+                    const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+                    // acc[i ^ 1] += value[i]: swap neighbouring lanes
+                    const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+                    lanes[half] = _mm256_add_epi64(lanes[half], _mm256_add_epi64(product, swapped));
+                }
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc.data()), lanes[0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc.data() + 4), lanes[1]);
+        }
+
+        __attribute__((target("avx2"))) inline void avx2_scramble(Accumulators &acc, const std::uint8_t *key) noexcept
+        {
+            const __m256i prime = _mm256_set1_epi32(static_cast<int>(prime32_1));
+            for (int half = 0; half < 2; ++half)
+            {
+                auto *lane = reinterpret_cast<__m256i *>(acc.data()) + half;
+                __m256i value = _mm256_loadu_si256(lane);
+                value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+                value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key) + half));
+                // 64x32-bit multiply from two 32x32 products
+                const __m256i low = _mm256_mul_epu32(value, prime);
+                const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+                _mm256_storeu_si256(lane, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+            }
+        }
+
+        inline constexpr Kernels avx2_kernels{cpu::Isa::Avx2, avx2_accumulate, avx2_scramble};
+
+#endif // HARNESS_CHECKSUM_X86
+
+        inline const Kernels *kernels_for(cpu::Isa isa) noexcept
+        {
+            if (!cpu::supports(isa))
+                return nullptr;
+            switch (isa)
+            {
+            case cpu::Isa::Scalar:
+                return &scalar_kernels;
+#if HARNESS_CHECKSUM_X86
+            case cpu::Isa::Avx2:
+                return &avx2_kernels;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        inline std::atomic<const Kernels *> &active() noexcept
+        {
+            static std::atomic<const Kernels *> table{[]
+                                                      {
+                                                          // AVX-512 machines run the AVX2 kernels
+                                                          if (cpu::enabled(cpu::Isa::Avx2))
+                                                              if (const auto *avx2 = kernels_for(cpu::Isa::Avx2))
+                                                                  return avx2;
+                                                          return &scalar_kernels;
+                                                      }()};
+            return table;
+        }
+
+        inline const Kernels &kernels() noexcept
+        {
+            return *active().load(std::memory_order_relaxed);
+        }
+    } // namespace detail
+
+    /// Kernels in use: AVX2 where available, else scalar
+    [[nodiscard]] inline cpu::Isa active_isa() noexcept
+    {
+        return detail::kernels().isa;
+    }
+
+    /// Force a kernel set (tests and benchmarks). Returns false, leaving the
+    /// current set, when this CPU or build does not support it.
+    inline bool use_isa(cpu::Isa isa) noexcept
+    {
+        const auto *table = detail::kernels_for(isa);
+        if (!table)
+            return false;
+        detail::active().store(table, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Incremental XXH3-64. Feeding the same bytes in any split gives the
+    /// same digest as hashing them at once.
+    class Xxh3
+    {
+    public:
+        void update(std::span<const std::byte> data) noexcept
+        {
+            const auto *in = reinterpret_cast<const std::uint8_t *>(data.data());
+            std::size_t len = data.size();
+            total_ += len;
+
+            // Keep at least one byte buffered: the final stripe is treated
+            // differently and must still be available at digest()
+            if (len <= buffer_.size() - buffered_)
+            {
+                std::memcpy(buffer_.data() + buffered_, in, len);
+                buffered_ += len;
+                return;
+            }
+
+            constexpr std::size_t buffer_stripes = buffer_size / detail::stripe_len;
+            if (buffered_ > 0)
+            {
+                const auto fill = buffer_.size() - buffered_;
+                std::memcpy(buffer_.data() + buffered_, in, fill);
+                in += fill;
+                len -= fill;
+                consume(buffer_.data(), buffer_stripes);
+                buffered_ = 0;
+            }
+            if (len > buffer_.size())
+            {
+                // Whole stripes straight from the input, keeping the last stripe
+                // for digest() in case fewer than 64 bytes end up buffered
+                const auto stripes = (len - 1) / detail::stripe_len;
+                consume(in, stripes);
+                in += stripes * detail::stripe_len;
+                len -= stripes * detail::stripe_len;
+                std::memcpy(buffer_.data() + buffer_.size() - detail::stripe_len, in - detail::stripe_len,
+                            detail::stripe_len);
+            }
+            std::memcpy(buffer_.data(), in, len);
+            buffered_ = len;
+        }
+
+        [[nodiscard]] std::uint64_t digest() const noexcept
+        {
+            using namespace detail;
+            if (total_ <= midsize_max)
+                return hash_short(buffer_.data(), static_cast<std::size_t>(total_));
+
+            auto acc = acc_;
+            auto stripes_done = stripes_done_;
+            std::array<std::uint8_t, stripe_len> last{};
+            const std::uint8_t *last_stripe = nullptr;
+            if (buffered_ >= stripe_len)
+            {
+                consume(acc, stripes_done, buffer_.data(), (buffered_ - 1) / stripe_len);
+                last_stripe = buffer_.data() + buffered_ - stripe_len;
+            }
+            else
+            {
+                // Complete the stripe with bytes already consumed
+                const auto catchup = stripe_len - buffered_;
+                std::memcpy(last.data(), buffer_.data() + buffer_.size() - catchup, catchup);
+                std::memcpy(last.data() + catchup, buffer_.data(), buffered_);
+                last_stripe = last.data();
+            }
+            kernels().accumulate(acc, last_stripe, secret.data() + secret_size - stripe_len - 7, 1);
+
+            std::uint64_t result = total_ * prime64_1;
+            for (std::size_t i = 0; i < 4; ++i)
+                result += mul128_fold64(acc[2 * i] ^ read64(secret.data() + 11 + 16 * i),
+                                        acc[2 * i + 1] ^ read64(secret.data() + 11 + 16 * i + 8));
+            return avalanche(result);
+        }
+
+        [[nodiscard]] std::uint64_t size() const noexcept { return total_; }
+
+    private:
+        static constexpr std::size_t buffer_size = 256;
+
+        static void consume(detail::Accumulators &acc, std::size_t &stripes_done, const std::uint8_t *in,
+                            std::size_t stripes) noexcept
+        {
+            using namespace detail;
+            const auto &k = kernels();
+            while (stripes > 0)
+            {
+                const auto take = std::min(stripes, stripes_per_block - stripes_done);
+                k.accumulate(acc, in, secret.data() + stripes_done * 8, take);
+                in += take * stripe_len;
+                stripes -= take;
+                stripes_done += take;
+                if (stripes_done == stripes_per_block)
+                {
+                    k.scramble(acc, secret.data() + secret_size - stripe_len);
+                    stripes_done = 0;
+                }
+            }
+        }
+
+        void consume(const std::uint8_t *in, std::size_t stripes) noexcept
+        {
+            consume(acc_, stripes_done_, in, stripes);
+        }
+
+        detail::Accumulators acc_{detail::prime32_3, detail::prime64_1, detail::prime64_2, detail::prime64_3,
+                                  detail::prime64_4, detail::prime32_2, detail::prime64_5, detail::prime32_1};
+        std::array<std::uint8_t, buffer_size> buffer_{};
+        std::size_t buffered_ = 0;
+        std::size_t stripes_done_ = 0;
+        std::uint64_t total_ = 0;
+    };
+
+    [[nodiscard]] inline std::uint64_t xxh3_64(std::span<const std::byte> data) noexcept
+    {
+        Xxh3 hasher;
+        hasher.update(data);
+        return hasher.digest();
+    }
+
+    // ============================================================================
+    // Manifests
+    // ============================================================================
+    //
+    // A recording `x.wav` gets a sidecar `x.wav.xxh3`: one line per range of
+    // the file, `<offset> <length> <xxh3-64 hex>`, plus `#` comments. Ranges
+    // are written as soon as they are complete, so after a crash everything
+    // up to the last finished range can still be checked.
+
+    inline constexpr std::string_view manifest_extension = ".xxh3";
+
+    /// Data bytes per manifest range (~22 s of mono float at 48 kHz)
+    inline constexpr std::uint64_t default_segment_bytes = std::uint64_t{4} << 20;
+
+    [[nodiscard]] inline std::filesystem::path manifest_path(const std::filesystem::path &file)
+    {
+        auto path = file;
+        path += manifest_extension;
+        return path;
+    }
+
+    /// Hashes a file's data stream in fixed-size ranges as it is written
+    class ManifestWriter
+    {
+    public:
+        /// `data_offset` is where the first byte passed to update() lands in the file
+        static std::expected<ManifestWriter, std::string> create(const std::filesystem::path &file,
+                                                                 std::uint64_t data_offset,
+                                                                 std::uint64_t segment_bytes = default_segment_bytes)
+        {
+            ManifestWriter writer;
+            writer.path_ = manifest_path(file);
+            writer.out_.open(writer.path_, std::ios::trunc);
+            if (!writer.out_.is_open())
+                return std::unexpected("Failed to create manifest: " + writer.path_.string());
+            writer.out_ << "# XXH3-64 of " << file.filename().string() << ": offset length hash\n";
+            writer.segment_start_ = data_offset;
+            writer.segment_bytes_ = std::max<std::uint64_t>(segment_bytes, 1);
+            return writer;
+        }
+
+        /// Bytes appended to the data stream
+        void update(std::span<const std::byte> data)
+        {
+            while (!data.empty())
+            {
+                const auto room = static_cast<std::size_t>(segment_bytes_ - segment_.size());
+                const auto take = std::min(room, data.size());
+                segment_.update(data.first(take));
+                data = data.subspan(take);
+                if (segment_.size() == segment_bytes_)
+                    finish_segment();
+            }
+        }
+
+        /// A range hashed on its own, e.g. a header rewritten at close. Ends
+        /// the current data range first.
+        void add_range(std::uint64_t offset, std::span<const std::byte> data)
+        {
+            if (segment_.size() > 0)
+                finish_segment();
+            write_line(offset, data.size(), xxh3_64(data));
+        }
+
+        /// Record the trailing partial range and close the file
+        void close()
+        {
+            if (!out_.is_open())
+                return;
+            if (segment_.size() > 0)
+                finish_segment();
+            out_.close();
+        }
+
+        [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+    private:
+        ManifestWriter() = default;
+
+        void finish_segment()
+        {
+            const auto length = segment_.size();
+            write_line(segment_start_, length, segment_.digest());
+            segment_start_ += length;
+            segment_ = {};
+        }
+
+        void write_line(std::uint64_t offset, std::uint64_t length, std::uint64_t hash)
+        {
+            out_ << std::format("{} {} {:016x}\n", offset, length, hash);
+            out_.flush();
+        }
+
+        std::filesystem::path path_;
+        std::ofstream out_;
+        Xxh3 segment_;
+        std::uint64_t segment_start_ = 0;
+        std::uint64_t segment_bytes_ = default_segment_bytes;
+    };
+
+    // ============================================================================
+    // Verification
+    // ============================================================================
+
+    struct VerifyReport
+    {
+        std::filesystem::path file;
+        std::size_t ranges = 0;
+        std::uint64_t covered_bytes = 0; // Bytes the manifest vouches for
+        std::uint64_t file_bytes = 0;
+        std::vector<std::uint64_t> bad_offsets; // Ranges that differ or are missing
+
+        [[nodiscard]] bool ok() const noexcept { return bad_offsets.empty(); }
+    };
+
+    /// Re-hash every range listed in a manifest. The file is mapped once and
+    /// the ranges are split across up to `threads` workers (0: one per core).
+    inline std::expected<VerifyReport, std::string> verify(const std::filesystem::path &manifest,
+                                                           unsigned threads = 0)
+    {
+        struct Range
+        {
+            std::uint64_t offset = 0;
+            std::uint64_t length = 0;
+            std::uint64_t hash = 0;
+        };
+
+        std::ifstream in(manifest);
+        if (!in.is_open())
+            return std::unexpected("Failed to open manifest: " + manifest.string());
+
+        std::vector<Range> ranges;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line.front() == '#')
+                continue;
+            Range range;
+            const char *p = line.data();
+            const char *end = line.data() + line.size();
+            auto parsed = std::from_chars(p, end, range.offset);
+            if (parsed.ec == std::errc{} && parsed.ptr < end)
+                parsed = std::from_chars(parsed.ptr + 1, end, range.length);
+            if (parsed.ec == std::errc{} && parsed.ptr < end)
+                parsed = std::from_chars(parsed.ptr + 1, end, range.hash, 16);
+            if (parsed.ec != std::errc{})
+                return std::unexpected("Malformed manifest line: " + line);
+            ranges.push_back(range);
+        }
+
+        VerifyReport report;
+        report.file = manifest;
+        report.file.replace_extension();
+        report.ranges = ranges.size();
+
+        const int fd = ::open(report.file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return std::unexpected("Failed to open " + report.file.string());
+        struct stat info{};
+        ::fstat(fd, &info);
+        report.file_bytes = static_cast<std::uint64_t>(info.st_size);
+
+        const std::uint8_t *base = nullptr;
+        if (report.file_bytes > 0)
+        {
+            void *mapped = ::mmap(nullptr, report.file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                ::close(fd);
+                return std::unexpected("Failed to map " + report.file.string());
+            }
+            base = static_cast<const std::uint8_t *>(mapped);
+            ::madvise(mapped, report.file_bytes, MADV_WILLNEED); // Workers read their ranges in parallel
+        }
+        ::close(fd); // The mapping keeps the file
+
+        std::vector<char> bad(ranges.size(), 0);
+        std::atomic<std::size_t> next{0};
+        auto work = [&]
+        {
+            for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < ranges.size();)
+            {
+                const auto &range = ranges[i];
+                bad[i] = range.offset > report.file_bytes || range.length > report.file_bytes - range.offset ||
+                         xxh3_64({reinterpret_cast<const std::byte *>(base) + range.offset,
+                                  static_cast<std::size_t>(range.length)}) != range.hash;
+            }
+        };
+        {
+            if (threads == 0)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            std::vector<std::jthread> workers;
+            for (unsigned t = 1; t < std::min<std::size_t>(threads, ranges.size()); ++t)
+                workers.emplace_back(work);
+            work();
+        }
+        if (base)
+            ::munmap(const_cast<std::uint8_t *>(base), report.file_bytes);
+
+        for (std::size_t i = 0; i < ranges.size(); ++i)
+        {
+            if (bad[i])
+                report.bad_offsets.push_back(ranges[i].offset);
+            else
+                report.covered_bytes += ranges[i].length;
+        }
+        return report;
+    }
+
+} // namespace harness::checksum
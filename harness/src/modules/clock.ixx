@@ -0,0 +1,262 @@
+// ============================================================================
+// TopNotchNotes Harness - Clock Module
+// The sound card's sample clock against steady_clock: drift estimation and
+// the mapping from recorded samples to session time
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+export module harness:clock;
+
+export namespace harness::clock
+{
+
+    using Clock = std::chrono::steady_clock;
+
+    /// One capture callback: the device's frame count after it, and when it ran
+    struct ClockPoint
+    {
+        std::uint64_t frame = 0;
+        Clock::time_point at{};
+    };
+
+    // ============================================================================
+    // Drift Estimator
+    // ============================================================================
+
+    /// Fits the device's frame count against steady_clock. Sound cards run
+    /// up to ~100 ppm off their nominal rate, seconds over a lecture.
+    ///
+    /// Callbacks only ever run late (scheduling), so each second of audio
+    /// contributes its earliest callback relative to the nominal clock, and
+    /// a least-squares line through the last ten minutes of those gives the
+    /// rate; temperature moves it slowly. Every ten seconds the fitted time
+    /// of the newest point is kept as an anchor, and times for earlier
+    /// frames interpolate between anchors, so they do not move as the fit
+    /// is refined later.
+    class DriftEstimator
+    {
+    public:
+        /// Times are seconds since `origin`
+        DriftEstimator(std::uint32_t nominal_rate, Clock::time_point origin)
+            : nominal_(nominal_rate), origin_(origin), rate_(nominal_rate)
+        {
+        }
+
+        void add(ClockPoint point);
+
+        /// Measured frames per second; nominal until ten seconds are in
+        [[nodiscard]] double rate() const noexcept { return rate_; }
+        [[nodiscard]] double drift_ppm() const noexcept { return (rate_ / nominal_ - 1.0) * 1e6; }
+        [[nodiscard]] std::uint32_t nominal_rate() const noexcept { return nominal_; }
+
+        /// When the device captured `frame`, in seconds since the origin
+        [[nodiscard]] double seconds_at(double frame) const noexcept;
+
+    private:
+        struct Sample
+        {
+            double frame;
+            double seconds;
+        };
+
+        void close_bucket();
+
+        static constexpr std::size_t window_buckets = 600; // Of one second each
+        static constexpr std::size_t min_buckets = 10;
+        static constexpr std::size_t anchor_every = 10;
+
+        std::uint32_t nominal_;
+        Clock::time_point origin_;
+        double rate_;
+        std::optional<Sample> first_;
+        std::optional<Sample> bucket_; // Earliest point of the current second
+        std::uint64_t bucket_index_ = 0;
+        std::deque<Sample> window_;
+        std::vector<Sample> anchors_;
+        std::size_t since_anchor_ = 0;
+    };
+
+    void DriftEstimator::add(ClockPoint point)
+    {
+        const Sample sample{static_cast<double>(point.frame),
+                            std::chrono::duration<double>(point.at - origin_).count()};
+        if (!first_)
+            first_ = sample;
+
+        const auto index = point.frame / nominal_;
+        if (bucket_ && index != bucket_index_)
+            close_bucket();
+        bucket_index_ = index;
+
+        // Lateness against the nominal clock; drift within a second is noise
+        const auto lateness = [this](const Sample &s) { return s.seconds - s.frame / nominal_; };
+        if (!bucket_ || lateness(sample) < lateness(*bucket_))
+            bucket_ = sample;
+    }
+
+    void DriftEstimator::close_bucket()
+    {
+        window_.push_back(*std::exchange(bucket_, std::nullopt));
+        if (window_.size() > window_buckets)
+            window_.pop_front();
+        if (window_.size() < min_buckets)
+            return;
+
+        // Least squares, relative to the oldest point for precision
+        const auto &base = window_.front();
+        double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+        for (const auto &s : window_)
+        {
+            const double x = s.frame - base.frame, y = s.seconds - base.seconds;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        const double n = static_cast<double>(window_.size());
+        const double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+        if (!(slope > 0.0))
+            return;
+        rate_ = 1.0 / slope;
+
+        if (anchors_.empty() || ++since_anchor_ >= anchor_every)
+        {
+            const auto &newest = window_.back();
+            const double intercept = (sy - slope * sx) / n;
+            anchors_.push_back({newest.frame, base.seconds + intercept + slope * (newest.frame - base.frame)});
+            since_anchor_ = 0;
+        }
+    }
+
+    double DriftEstimator::seconds_at(double frame) const noexcept
+    {
+        if (anchors_.empty())
+            return first_ ? first_->seconds + (frame - first_->frame) / rate_ : frame / nominal_;
+
+        auto after = std::upper_bound(anchors_.begin(), anchors_.end(), frame,
+                                      [](double f, const Sample &s) { return f < s.frame; });
+        if (after == anchors_.end() || after == anchors_.begin())
+        {
+            const auto &anchor = after == anchors_.end() ? anchors_.back() : anchors_.front();
+            return anchor.seconds + (frame - anchor.frame) / rate_;
+        }
+        const auto &a = *std::prev(after);
+        const auto &b = *after;
+        return a.seconds + (frame - a.frame) * (b.seconds - a.seconds) / (b.frame - a.frame);
+    }
+
+    // ============================================================================
+    // Session Clock
+    // ============================================================================
+
+    /// Maps a session's recorded samples to seconds since it started.
+    /// Recorded sample w was captured as device frame device(w): the two
+    /// advance together, with a step at each pause, or at a slight slope
+    /// when the recording is retimed to the nominal rate. Links between
+    /// them are kept every ten seconds and at every step.
+    class SessionClock
+    {
+    public:
+        SessionClock(std::uint32_t nominal_rate, Clock::time_point origin) : estimator_(nominal_rate, origin) {}
+
+        void observe(ClockPoint point) { estimator_.add(point); }
+
+        /// Recorded sample `recorded` (the first of a block) came from device
+        /// frame `device`; fractional when retimed
+        void recorded(std::uint64_t recorded, double device);
+
+        [[nodiscard]] double seconds_at(std::uint64_t recorded) const noexcept;
+        [[nodiscard]] const DriftEstimator &estimator() const noexcept { return estimator_; }
+
+        /// "clock" object of the session manifest: the measured rate and
+        /// [recorded sample, seconds] points to interpolate between
+        [[nodiscard]] std::string manifest_json(std::uint64_t total_recorded, bool retimed) const;
+
+    private:
+        struct Link
+        {
+            std::uint64_t recorded;
+            double device;
+        };
+
+        // A block further off than this from where the last one ended
+        // follows a gap; retiming moves blocks by a sample or two at most
+        static constexpr double gap_frames = 64.0;
+        static constexpr std::uint64_t link_seconds = 10;
+
+        [[nodiscard]] double device_at(std::uint64_t recorded) const noexcept;
+
+        DriftEstimator estimator_;
+        std::vector<Link> links_;
+        std::optional<Link> last_; // The previous block
+        double ratio_ = 1.0;       // Device frames per recorded sample lately
+    };
+
+    void SessionClock::recorded(std::uint64_t recorded, double device)
+    {
+        if (last_ && recorded > last_->recorded)
+        {
+            const double expected = last_->device + ratio_ * static_cast<double>(recorded - last_->recorded);
+            if (std::abs(device - expected) > gap_frames)
+                links_.push_back({recorded, expected}); // Close the stretch before the gap
+            else
+                ratio_ = (device - last_->device) / static_cast<double>(recorded - last_->recorded);
+        }
+
+        const bool gap = !links_.empty() && links_.back().recorded == recorded;
+        if (links_.empty() || gap ||
+            recorded - links_.back().recorded >= link_seconds * estimator_.nominal_rate())
+            links_.push_back({recorded, device});
+        last_ = Link{recorded, device};
+    }
+
+    double SessionClock::device_at(std::uint64_t recorded) const noexcept
+    {
+        if (links_.empty())
+            return static_cast<double>(recorded);
+
+        // The last link at or before `recorded`: after a step, its far side
+        auto after = std::upper_bound(links_.begin(), links_.end(), recorded,
+                                      [](std::uint64_t r, const Link &l) { return r < l.recorded; });
+        const auto &link = after == links_.begin() ? links_.front() : *std::prev(after);
+        double ratio = ratio_;
+        if (after != links_.end() && after != links_.begin() && after->recorded > link.recorded)
+            ratio = (after->device - link.device) / static_cast<double>(after->recorded - link.recorded);
+        return link.device + ratio * (static_cast<double>(recorded) - static_cast<double>(link.recorded));
+    }
+
+    double SessionClock::seconds_at(std::uint64_t recorded) const noexcept
+    {
+        return estimator_.seconds_at(device_at(recorded));
+    }
+
+    std::string SessionClock::manifest_json(std::uint64_t total_recorded, bool retimed) const
+    {
+        std::string json = std::format(
+            "{{\"nominal_rate\":{},\"measured_rate\":{:.3f},\"drift_ppm\":{:.2f},\"retimed\":{},\"map\":[",
+            estimator_.nominal_rate(), estimator_.rate(), estimator_.drift_ppm(), retimed ? "true" : "false");
+        auto out = std::back_inserter(json);
+        for (const auto &link : links_)
+        {
+            if (link.recorded < total_recorded)
+                std::format_to(out, "[{},{:.6f}],", link.recorded, estimator_.seconds_at(link.device));
+        }
+        std::format_to(out, "[{},{:.6f}]]}}", total_recorded, seconds_at(total_recorded));
+        return json;
+    }
+
+} // namespace harness::clock
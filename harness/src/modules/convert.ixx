@@ -0,0 +1,737 @@
+// ============================================================================
+// TopNotchNotes Harness - Sample Conversion Module
+// f32 <-> s16/s24/s32, (de)interleaving and mixing with SIMD kernels picked at runtime
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <span>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HARNESS_CONVERT_X86 1
+#else
+#define HARNESS_CONVERT_X86 0
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define HARNESS_CONVERT_NEON 1
+#else
+#define HARNESS_CONVERT_NEON 0
+#endif
+
+export module harness:convert;
+
+import :cpu;
+
+export namespace harness::convert
+{
+
+    // ============================================================================
+    // Conventions
+    // ============================================================================
+    //
+    // Float samples are nominally in [-1, 1]. Conversions to integers clamp to
+    // that range first, round to nearest and saturate, so out-of-range input
+    // clips instead of wrapping. Scale factors:
+    //
+    //     f32 -> s16  * 32767         s16 -> f32  / 32768
+    //     f32 -> s24  * 8388607       s24 -> f32  / 8388608   (3 bytes, little-endian)
+    //     f32 -> s32  * 2147483648    s32 -> f32  / 2147483648
+    //
+    // Output spans must hold at least as many samples as the input.
+
+    using cpu::Isa;
+    using cpu::to_string;
+
+    // ============================================================================
+    // Scalar Reference Kernels
+    // ============================================================================
+
+    namespace scalar
+    {
+        inline std::int32_t round_clamped(float sample, float scale, float max) noexcept
+        {
+            // NaN compares false and ends up at -scale, like the SIMD kernels
+            const float clamped = sample > -1.0f ? std::min(sample * scale, max) : -scale;
+            return static_cast<std::int32_t>(std::lrint(clamped));
+        }
+
+        inline void f32_to_s16(const float *in, std::int16_t *out, std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = static_cast<std::int16_t>(round_clamped(in[i], 32767.0f, 32767.0f));
+        }
+
+        inline void s16_to_f32(const std::int16_t *in, float *out, std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = static_cast<float>(in[i]) * (1.0f / 32768.0f);
+        }
+
+        inline void f32_to_s32(const float *in, std::int32_t *out, std::size_t count) noexcept
+        {
+            // 2147483520 is the largest float below 2^31
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = round_clamped(in[i], 2147483648.0f, 2147483520.0f);
+        }
+
+        inline void s32_to_f32(const std::int32_t *in, float *out, std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = static_cast<float>(in[i]) * (1.0f / 2147483648.0f);
+        }
+
+        inline void f32_to_s24(const float *in, std::uint8_t *out, std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto value = static_cast<std::uint32_t>(round_clamped(in[i], 8388607.0f, 8388607.0f));
+                out[3 * i] = static_cast<std::uint8_t>(value);
+                out[3 * i + 1] = static_cast<std::uint8_t>(value >> 8);
+                out[3 * i + 2] = static_cast<std::uint8_t>(value >> 16);
+            }
+        }
+
+        inline void s24_to_f32(const std::uint8_t *in, float *out, std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                // Assemble in the top three bytes, then shift down to sign-extend
+                const std::uint32_t raw = (std::uint32_t{in[3 * i]} << 8) | (std::uint32_t{in[3 * i + 1]} << 16) |
+                                          (std::uint32_t{in[3 * i + 2]} << 24);
+                out[i] = static_cast<float>(static_cast<std::int32_t>(raw) >> 8) * (1.0f / 8388608.0f);
+            }
+        }
+
+        inline void deinterleave_stereo(const float *in, float *left, float *right, std::size_t frames) noexcept
+        {
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                left[i] = in[2 * i];
+                right[i] = in[2 * i + 1];
+            }
+        }
+
+        inline void interleave_stereo(const float *left, const float *right, float *out, std::size_t frames) noexcept
+        {
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                out[2 * i] = left[i];
+                out[2 * i + 1] = right[i];
+            }
+        }
+
+        inline void mix(const float *a, float gain_a, const float *b, float gain_b, float *out,
+                        std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = a[i] * gain_a + b[i] * gain_b;
+        }
+    } // namespace scalar
+
+    // ============================================================================
+    // SIMD Kernels
+    // ============================================================================
+
+    namespace detail
+    {
+        struct Kernels
+        {
+            Isa isa;
+            void (*f32_to_s16)(const float *, std::int16_t *, std::size_t) noexcept;
+            void (*s16_to_f32)(const std::int16_t *, float *, std::size_t) noexcept;
+            void (*f32_to_s32)(const float *, std::int32_t *, std::size_t) noexcept;
+            void (*s32_to_f32)(const std::int32_t *, float *, std::size_t) noexcept;
+            void (*f32_to_s24)(const float *, std::uint8_t *, std::size_t) noexcept;
+            void (*s24_to_f32)(const std::uint8_t *, float *, std::size_t) noexcept;
+            void (*deinterleave_stereo)(const float *, float *, float *, std::size_t) noexcept;
+            void (*interleave_stereo)(const float *, const float *, float *, std::size_t) noexcept;
+            void (*mix)(const float *, float, const float *, float, float *, std::size_t) noexcept;
+        };
+
+        inline constexpr Kernels scalar_kernels{
+            Isa::Scalar, scalar::f32_to_s16, scalar::s16_to_f32, scalar::f32_to_s32, scalar::s32_to_f32,
+            scalar::f32_to_s24, scalar::s24_to_f32, scalar::deinterleave_stereo, scalar::interleave_stereo,
+            scalar::mix};
+
+#if HARNESS_CONVERT_X86
+
+        // Compiled for their ISA regardless of the global flags; only called
+        // after the CPU has been checked
+
+        // ---- SSE4.1 ----------------------------------------------------------
+
+        __attribute__((target("sse4.1"))) inline __m128i sse_scale(__m128 v, __m128 scale, __m128 max) noexcept
+        {
+            // max_ps returns the second operand for NaN, so NaN clamps to -1
+            v = _mm_max_ps(v, _mm_set1_ps(-1.0f));
+            v = _mm_min_ps(_mm_mul_ps(v, scale), max);
+            return _mm_cvtps_epi32(v);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_f32_to_s16(const float *in, std::int16_t *out,
+                                                                        std::size_t count) noexcept
+        {
+            const __m128 scale = _mm_set1_ps(32767.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i lo = sse_scale(_mm_loadu_ps(in + i), scale, scale);
+                const __m128i hi = sse_scale(_mm_loadu_ps(in + i + 4), scale, scale);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(lo, hi));
+            }
+            scalar::f32_to_s16(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_s16_to_f32(const std::int16_t *in, float *out,
+                                                                        std::size_t count) noexcept
+        {
+            const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                const __m128i lo = _mm_cvtepi16_epi32(packed);
+                const __m128i hi = _mm_cvtepi16_epi32(_mm_srli_si128(packed, 8));
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+                _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+            }
+            scalar::s16_to_f32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_f32_to_s32(const float *in, std::int32_t *out,
+                                                                        std::size_t count) noexcept
+        {
+            const __m128 scale = _mm_set1_ps(2147483648.0f);
+            const __m128 max = _mm_set1_ps(2147483520.0f);
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), sse_scale(_mm_loadu_ps(in + i), scale, max));
+            scalar::f32_to_s32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_s32_to_f32(const std::int32_t *in, float *out,
+                                                                        std::size_t count) noexcept
+        {
+            const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+            }
+            scalar::s32_to_f32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_f32_to_s24(const float *in, std::uint8_t *out,
+                                                                        std::size_t count) noexcept
+        {
+            // Keep the low three bytes of each 32-bit lane
+            const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            const __m128 scale = _mm_set1_ps(8388607.0f);
+            // Each store writes 16 bytes for 12; the next store overwrites the
+            // surplus, so stop while 16 bytes still fit
+            std::size_t i = 0;
+            for (; i + 6 <= count; i += 4)
+            {
+                const __m128i packed = _mm_shuffle_epi8(sse_scale(_mm_loadu_ps(in + i), scale, scale), pack);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 3 * i), packed);
+            }
+            scalar::f32_to_s24(in + i, out + 3 * i, count - i);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_s24_to_f32(const std::uint8_t *in, float *out,
+                                                                        std::size_t count) noexcept
+        {
+            // Each sample into the top three bytes of a lane; arithmetic shift sign-extends
+            const __m128i unpack = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            const __m128 scale = _mm_set1_ps(1.0f / 8388608.0f);
+            // Loads read 16 bytes for 12, so stop while 16 bytes remain
+            std::size_t i = 0;
+            for (; i + 6 <= count; i += 4)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 3 * i));
+                const __m128i raw = _mm_shuffle_epi8(bytes, unpack);
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(raw, 8)), scale));
+            }
+            scalar::s24_to_f32(in + 3 * i, out + i, count - i);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_deinterleave_stereo(const float *in, float *left,
+                                                                                 float *right,
+                                                                                 std::size_t frames) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= frames; i += 4)
+            {
+                const __m128 a = _mm_loadu_ps(in + 2 * i);     // L0 R0 L1 R1
+                const __m128 b = _mm_loadu_ps(in + 2 * i + 4); // L2 R2 L3 R3
+                _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+            scalar::deinterleave_stereo(in + 2 * i, left + i, right + i, frames - i);
+        }
+
+        __attribute__((target("sse4.1"))) inline void sse41_interleave_stereo(const float *left, const float *right,
+                                                                               float *out, std::size_t frames) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= frames; i += 4)
+            {
+                const __m128 l = _mm_loadu_ps(left + i);
+                const __m128 r = _mm_loadu_ps(right + i);
+                _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+            }
+            scalar::interleave_stereo(left + i, right + i, out + 2 * i, frames - i);
+        }
+
+        // Multiply and add separately (no FMA) in every variant, so all of
+        // them round exactly like the scalar loop
+        __attribute__((target("sse4.1"))) inline void sse41_mix(const float *a, float gain_a, const float *b,
+                                                                 float gain_b, float *out, std::size_t count) noexcept
+        {
+            const __m128 ga = _mm_set1_ps(gain_a);
+            const __m128 gb = _mm_set1_ps(gain_b);
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + i), ga),
+                                                  _mm_mul_ps(_mm_loadu_ps(b + i), gb)));
+            scalar::mix(a + i, gain_a, b + i, gain_b, out + i, count - i);
+        }
+
+        // ---- AVX2 ------------------------------------------------------------
+
+        __attribute__((target("avx2"))) inline __m256i avx_scale(__m256 v, __m256 scale, __m256 max) noexcept
+        {
+            v = _mm256_max_ps(v, _mm256_set1_ps(-1.0f));
+            v = _mm256_min_ps(_mm256_mul_ps(v, scale), max);
+            return _mm256_cvtps_epi32(v);
+        }
+
+        __attribute__((target("avx2"))) inline void avx2_f32_to_s16(const float *in, std::int16_t *out,
+                                                                     std::size_t count) noexcept
+        {
+            const __m256 scale = _mm256_set1_ps(32767.0f);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m256i lo = avx_scale(_mm256_loadu_ps(in + i), scale, scale);
+                const __m256i hi = avx_scale(_mm256_loadu_ps(in + i + 8), scale, scale);
+                // packs works per 128-bit lane; restore sample order across lanes
+                const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), packed);
+            }
+            sse41_f32_to_s16(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx2"))) inline void avx2_s16_to_f32(const std::int16_t *in, float *out,
+                                                                     std::size_t count) noexcept
+        {
+            const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+                const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(packed));
+                const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(packed, 1));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+                _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+            }
+            sse41_s16_to_f32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx2"))) inline void avx2_f32_to_s32(const float *in, std::int32_t *out,
+                                                                     std::size_t count) noexcept
+        {
+            const __m256 scale = _mm256_set1_ps(2147483648.0f);
+            const __m256 max = _mm256_set1_ps(2147483520.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                    avx_scale(_mm256_loadu_ps(in + i), scale, max));
+            sse41_f32_to_s32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx2"))) inline void avx2_s32_to_f32(const std::int32_t *in, float *out,
+                                                                     std::size_t count) noexcept
+        {
+            const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+            }
+            sse41_s32_to_f32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx2"))) inline void avx2_mix(const float *a, float gain_a, const float *b, float gain_b,
+                                                              float *out, std::size_t count) noexcept
+        {
+            const __m256 ga = _mm256_set1_ps(gain_a);
+            const __m256 gb = _mm256_set1_ps(gain_b);
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(a + i), ga),
+                                                        _mm256_mul_ps(_mm256_loadu_ps(b + i), gb)));
+            sse41_mix(a + i, gain_a, b + i, gain_b, out + i, count - i);
+        }
+
+        // ---- AVX-512 ---------------------------------------------------------
+
+        __attribute__((target("avx512f,avx512bw"))) inline __m512i avx512_scale(__m512 v, __m512 scale,
+                                                                               __m512 max) noexcept
+        {
+            v = _mm512_max_ps(v, _mm512_set1_ps(-1.0f));
+            v = _mm512_min_ps(_mm512_mul_ps(v, scale), max);
+            return _mm512_cvtps_epi32(v);
+        }
+
+        __attribute__((target("avx512f,avx512bw"))) inline void avx512_f32_to_s16(const float *in, std::int16_t *out,
+                                                                                 std::size_t count) noexcept
+        {
+            const __m512 scale = _mm512_set1_ps(32767.0f);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                // Saturating narrow in one instruction, already in order
+                const __m256i packed = _mm512_cvtsepi32_epi16(avx512_scale(_mm512_loadu_ps(in + i), scale, scale));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), packed);
+            }
+            avx2_f32_to_s16(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx512f,avx512bw"))) inline void avx512_s16_to_f32(const std::int16_t *in, float *out,
+                                                                                 std::size_t count) noexcept
+        {
+            const __m512 scale = _mm512_set1_ps(1.0f / 32768.0f);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+                _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(packed)), scale));
+            }
+            avx2_s16_to_f32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx512f,avx512bw"))) inline void avx512_f32_to_s32(const float *in, std::int32_t *out,
+                                                                                 std::size_t count) noexcept
+        {
+            const __m512 scale = _mm512_set1_ps(2147483648.0f);
+            const __m512 max = _mm512_set1_ps(2147483520.0f);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+                _mm512_storeu_si512(out + i, avx512_scale(_mm512_loadu_ps(in + i), scale, max));
+            avx2_f32_to_s32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx512f,avx512bw"))) inline void avx512_s32_to_f32(const std::int32_t *in, float *out,
+                                                                                 std::size_t count) noexcept
+        {
+            const __m512 scale = _mm512_set1_ps(1.0f / 2147483648.0f);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+                _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_loadu_si512(in + i)), scale));
+            avx2_s32_to_f32(in + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx512f,avx512bw"))) inline void avx512_mix(const float *a, float gain_a, const float *b,
+                                                                           float gain_b, float *out,
+                                                                           std::size_t count) noexcept
+        {
+            const __m512 ga = _mm512_set1_ps(gain_a);
+            const __m512 gb = _mm512_set1_ps(gain_b);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+                _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(a + i), ga),
+                                                        _mm512_mul_ps(_mm512_loadu_ps(b + i), gb)));
+            avx2_mix(a + i, gain_a, b + i, gain_b, out + i, count - i);
+        }
+
+        inline constexpr Kernels sse41_kernels{
+            Isa::Sse41, sse41_f32_to_s16, sse41_s16_to_f32, sse41_f32_to_s32, sse41_s32_to_f32,
+            sse41_f32_to_s24, sse41_s24_to_f32, sse41_deinterleave_stereo, sse41_interleave_stereo, sse41_mix};
+
+        // 24-bit packing and stereo shuffles are bound by the byte shuffles,
+        // which AVX2 does not widen usefully; they reuse the SSE4.1 kernels
+        inline constexpr Kernels avx2_kernels{
+            Isa::Avx2, avx2_f32_to_s16, avx2_s16_to_f32, avx2_f32_to_s32, avx2_s32_to_f32,
+            sse41_f32_to_s24, sse41_s24_to_f32, sse41_deinterleave_stereo, sse41_interleave_stereo, avx2_mix};
+
+        inline constexpr Kernels avx512_kernels{
+            Isa::Avx512, avx512_f32_to_s16, avx512_s16_to_f32, avx512_f32_to_s32, avx512_s32_to_f32,
+            sse41_f32_to_s24, sse41_s24_to_f32, sse41_deinterleave_stereo, sse41_interleave_stereo, avx512_mix};
+
+#endif // HARNESS_CONVERT_X86
+
+#if HARNESS_CONVERT_NEON
+
+        inline int32x4_t neon_scale(float32x4_t v, float scale, float32x4_t max) noexcept
+        {
+            // vmaxq propagates NaN, so clear it first (NaN != NaN)
+            v = vbslq_f32(vceqq_f32(v, v), v, vdupq_n_f32(-1.0f));
+            v = vmaxq_f32(v, vdupq_n_f32(-1.0f));
+            v = vminq_f32(vmulq_n_f32(v, scale), max);
+            return vcvtnq_s32_f32(v);
+        }
+
+        inline void neon_f32_to_s16(const float *in, std::int16_t *out, std::size_t count) noexcept
+        {
+            const float32x4_t max = vdupq_n_f32(32767.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const int16x4_t lo = vqmovn_s32(neon_scale(vld1q_f32(in + i), 32767.0f, max));
+                const int16x4_t hi = vqmovn_s32(neon_scale(vld1q_f32(in + i + 4), 32767.0f, max));
+                vst1q_s16(out + i, vcombine_s16(lo, hi));
+            }
+            scalar::f32_to_s16(in + i, out + i, count - i);
+        }
+
+        inline void neon_s16_to_f32(const std::int16_t *in, float *out, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const int16x8_t packed = vld1q_s16(in + i);
+                vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(packed))), 1.0f / 32768.0f));
+                vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(packed))), 1.0f / 32768.0f));
+            }
+            scalar::s16_to_f32(in + i, out + i, count - i);
+        }
+
+        inline void neon_f32_to_s32(const float *in, std::int32_t *out, std::size_t count) noexcept
+        {
+            const float32x4_t max = vdupq_n_f32(2147483520.0f);
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+                vst1q_s32(out + i, neon_scale(vld1q_f32(in + i), 2147483648.0f, max));
+            scalar::f32_to_s32(in + i, out + i, count - i);
+        }
+
+        inline void neon_s32_to_f32(const std::int32_t *in, float *out, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+                vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(in + i)), 1.0f / 2147483648.0f));
+            scalar::s32_to_f32(in + i, out + i, count - i);
+        }
+
+        inline void neon_deinterleave_stereo(const float *in, float *left, float *right, std::size_t frames) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= frames; i += 4)
+            {
+                const float32x4x2_t lr = vld2q_f32(in + 2 * i);
+                vst1q_f32(left + i, lr.val[0]);
+                vst1q_f32(right + i, lr.val[1]);
+            }
+            scalar::deinterleave_stereo(in + 2 * i, left + i, right + i, frames - i);
+        }
+
+        inline void neon_interleave_stereo(const float *left, const float *right, float *out,
+                                           std::size_t frames) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= frames; i += 4)
+                vst2q_f32(out + 2 * i, float32x4x2_t{{vld1q_f32(left + i), vld1q_f32(right + i)}});
+            scalar::interleave_stereo(left + i, right + i, out + 2 * i, frames - i);
+        }
+
+        inline void neon_mix(const float *a, float gain_a, const float *b, float gain_b, float *out,
+                             std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+                vst1q_f32(out + i,
+                          vaddq_f32(vmulq_n_f32(vld1q_f32(a + i), gain_a), vmulq_n_f32(vld1q_f32(b + i), gain_b)));
+            scalar::mix(a + i, gain_a, b + i, gain_b, out + i, count - i);
+        }
+
+        inline constexpr Kernels neon_kernels{
+            Isa::Neon, neon_f32_to_s16, neon_s16_to_f32, neon_f32_to_s32, neon_s32_to_f32,
+            scalar::f32_to_s24, scalar::s24_to_f32, neon_deinterleave_stereo, neon_interleave_stereo, neon_mix};
+
+#endif // HARNESS_CONVERT_NEON
+
+        /// Kernel table for an ISA, or nullptr when this CPU or build cannot run it
+        inline const Kernels *kernels_for(Isa isa) noexcept
+        {
+            if (!cpu::supports(isa))
+                return nullptr;
+            switch (isa)
+            {
+            case Isa::Scalar:
+                return &scalar_kernels;
+#if HARNESS_CONVERT_X86
+            case Isa::Sse41:
+                return &sse41_kernels;
+            case Isa::Avx2:
+                return &avx2_kernels;
+            case Isa::Avx512:
+                return &avx512_kernels;
+#endif
+#if HARNESS_CONVERT_NEON
+            case Isa::Neon:
+                return &neon_kernels;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        inline const Kernels *best_kernels() noexcept
+        {
+            for (auto isa : {Isa::Avx512, Isa::Avx2, Isa::Neon, Isa::Sse41})
+            {
+                if (!cpu::enabled(isa))
+                    continue;
+                if (const auto *table = kernels_for(isa))
+                    return table;
+            }
+            return &scalar_kernels;
+        }
+
+        inline std::atomic<const Kernels *> &active() noexcept
+        {
+            static std::atomic<const Kernels *> table{best_kernels()};
+            return table;
+        }
+
+        inline const Kernels &kernels() noexcept
+        {
+            return *active().load(std::memory_order_relaxed);
+        }
+    } // namespace detail
+
+    // ============================================================================
+    // Dispatch
+    // ============================================================================
+
+    /// Kernels in use: the best the CPU supports unless overridden
+    [[nodiscard]] inline Isa active_isa() noexcept
+    {
+        return detail::kernels().isa;
+    }
+
+    /// Force a kernel set (tests and benchmarks). Returns false, leaving the
+    /// current set, when this CPU or build does not support it.
+    inline bool use_isa(Isa isa) noexcept
+    {
+        const auto *table = detail::kernels_for(isa);
+        if (!table)
+            return false;
+        detail::active().store(table, std::memory_order_relaxed);
+        return true;
+    }
+
+    // ============================================================================
+    // Conversions
+    // ============================================================================
+
+    inline void f32_to_s16(std::span<const float> in, std::span<std::int16_t> out) noexcept
+    {
+        detail::kernels().f32_to_s16(in.data(), out.data(), std::min(in.size(), out.size()));
+    }
+
+    inline void s16_to_f32(std::span<const std::int16_t> in, std::span<float> out) noexcept
+    {
+        detail::kernels().s16_to_f32(in.data(), out.data(), std::min(in.size(), out.size()));
+    }
+
+    inline void f32_to_s32(std::span<const float> in, std::span<std::int32_t> out) noexcept
+    {
+        detail::kernels().f32_to_s32(in.data(), out.data(), std::min(in.size(), out.size()));
+    }
+
+    inline void s32_to_f32(std::span<const std::int32_t> in, std::span<float> out) noexcept
+    {
+        detail::kernels().s32_to_f32(in.data(), out.data(), std::min(in.size(), out.size()));
+    }
+
+    /// `out` holds 3 bytes per sample
+    inline void f32_to_s24(std::span<const float> in, std::span<std::uint8_t> out) noexcept
+    {
+        detail::kernels().f32_to_s24(in.data(), out.data(), std::min(in.size(), out.size() / 3));
+    }
+
+    /// `in` holds 3 bytes per sample
+    inline void s24_to_f32(std::span<const std::uint8_t> in, std::span<float> out) noexcept
+    {
+        detail::kernels().s24_to_f32(in.data(), out.data(), std::min(in.size() / 3, out.size()));
+    }
+
+    // ============================================================================
+    // Interleaving
+    // ============================================================================
+
+    /// Split interleaved frames into planar channels: `planar` holds channel 0's
+    /// frames, then channel 1's, and so on
+    inline void deinterleave(std::span<const float> interleaved, std::size_t channels, std::span<float> planar) noexcept
+    {
+        if (channels == 0)
+            return;
+        const std::size_t frames = std::min(interleaved.size(), planar.size()) / channels;
+        if (channels == 1)
+        {
+            std::copy_n(interleaved.begin(), frames, planar.begin());
+            return;
+        }
+        if (channels == 2)
+        {
+            detail::kernels().deinterleave_stereo(interleaved.data(), planar.data(), planar.data() + frames, frames);
+            return;
+        }
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            for (std::size_t i = 0; i < frames; ++i)
+                planar[c * frames + i] = interleaved[i * channels + c];
+        }
+    }
+
+    /// Inverse of deinterleave()
+    inline void interleave(std::span<const float> planar, std::size_t channels, std::span<float> interleaved) noexcept
+    {
+        if (channels == 0)
+            return;
+        const std::size_t frames = std::min(interleaved.size(), planar.size()) / channels;
+        if (channels == 1)
+        {
+            std::copy_n(planar.begin(), frames, interleaved.begin());
+            return;
+        }
+        if (channels == 2)
+        {
+            detail::kernels().interleave_stereo(planar.data(), planar.data() + frames, interleaved.data(), frames);
+            return;
+        }
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            for (std::size_t i = 0; i < frames; ++i)
+                interleaved[i * channels + c] = planar[c * frames + i];
+        }
+    }
+
+    // ============================================================================
+    // Mixing
+    // ============================================================================
+
+    /// out = a * gain_a + b * gain_b, over the shortest of the three. `out`
+    /// may be `a` or `b`. No clipping; the integer conversions clamp later.
+    inline void mix(std::span<const float> a, float gain_a, std::span<const float> b, float gain_b,
+                    std::span<float> out) noexcept
+    {
+        detail::kernels().mix(a.data(), gain_a, b.data(), gain_b, out.data(),
+                              std::min({a.size(), b.size(), out.size()}));
+    }
+
+} // namespace harness::convert
@@ -0,0 +1,206 @@
+// ============================================================================
+// TopNotchNotes Harness - Course Vocabulary Module
+// Per-course language models and keyword lists with a compiled-LM cache
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+// PocketSphinx headers (ARPA -> binary LM compilation)
+#include <pocketsphinx.h>
+#include <sphinxbase/cmd_ln.h>
+
+export module harness:course;
+
+export namespace harness::course
+{
+
+    // ============================================================================
+    // Type Aliases
+    // ============================================================================
+
+    template <typename T>
+    using CourseResult = std::expected<T, std::string>;
+
+    // ============================================================================
+    // Course Model
+    // ============================================================================
+
+    /// Everything a decoder needs to specialize for one course.
+    /// Paths are empty when the course does not provide that file.
+    struct CourseModel
+    {
+        std::string course_id;
+        std::filesystem::path lm_path;       // Binary LM, ready for a fast load
+        std::filesystem::path dict_path;     // Extra pronunciations ("word PH ON EH S")
+        std::filesystem::path keywords_path; // One keyphrase per line, for spotting
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return lm_path.empty() && dict_path.empty() && keywords_path.empty();
+        }
+    };
+
+    /// Course IDs come from the UI; only allow what is safe as a file name
+    [[nodiscard]] constexpr bool valid_course_id(std::string_view id) noexcept
+    {
+        return !id.empty() && id.size() <= 128 &&
+               std::ranges::all_of(id, [](char c)
+                                   { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                                            (c >= '0' && c <= '9') || c == '-' || c == '_'; });
+    }
+
+    // ============================================================================
+    // Course Library
+    // ============================================================================
+
+    /// Resolves course IDs to models laid out as
+    ///
+    ///     <courses_dir>/<course_id>/course.lm        ARPA or binary LM
+    ///     <courses_dir>/<course_id>/course.dict      optional
+    ///     <courses_dir>/<course_id>/keywords.txt     optional
+    ///
+    /// ARPA models are compiled once to the binary format in `cache_dir`,
+    /// keyed by source size and mtime, so later sessions load in milliseconds.
+    class CourseLibrary
+    {
+    public:
+        CourseLibrary(std::filesystem::path courses_dir, std::filesystem::path cache_dir);
+
+        /// Locate (and if needed compile) the model for a course
+        [[nodiscard]] CourseResult<CourseModel> resolve(std::string_view course_id);
+
+        [[nodiscard]] const std::filesystem::path &courses_dir() const noexcept { return courses_dir_; }
+
+    private:
+        [[nodiscard]] CourseResult<std::filesystem::path> compiled_lm(std::string_view course_id,
+                                                                      const std::filesystem::path &source);
+
+        std::filesystem::path courses_dir_;
+        std::filesystem::path cache_dir_;
+
+        std::mutex mutex_;
+        std::unordered_map<std::string, CourseModel> resolved_; // Per-process memo
+    };
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    CourseLibrary::CourseLibrary(std::filesystem::path courses_dir, std::filesystem::path cache_dir)
+        : courses_dir_(std::move(courses_dir)),
+          cache_dir_(std::move(cache_dir))
+    {
+    }
+
+    CourseResult<CourseModel> CourseLibrary::resolve(std::string_view course_id)
+    {
+        if (!valid_course_id(course_id))
+        {
+            return std::unexpected(std::format("Invalid course id: {}", course_id));
+        }
+
+        std::lock_guard lock(mutex_);
+        if (auto it = resolved_.find(std::string(course_id)); it != resolved_.end())
+        {
+            return it->second;
+        }
+
+        const auto dir = courses_dir_ / course_id;
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec))
+        {
+            return std::unexpected(std::format("No vocabulary for course {}", course_id));
+        }
+
+        CourseModel model{.course_id = std::string(course_id)};
+        if (auto lm = dir / "course.lm"; std::filesystem::exists(lm, ec))
+        {
+            auto compiled = compiled_lm(course_id, lm);
+            if (!compiled)
+                return std::unexpected(compiled.error());
+            model.lm_path = std::move(*compiled);
+        }
+        if (auto dict = dir / "course.dict"; std::filesystem::exists(dict, ec))
+        {
+            model.dict_path = dict;
+        }
+        if (auto keywords = dir / "keywords.txt"; std::filesystem::exists(keywords, ec))
+        {
+            model.keywords_path = keywords;
+        }
+
+        if (model.empty())
+        {
+            return std::unexpected(std::format("Course {} has no course.lm, course.dict or keywords.txt",
+                                               course_id));
+        }
+
+        resolved_.emplace(model.course_id, model);
+        return model;
+    }
+
+    CourseResult<std::filesystem::path> CourseLibrary::compiled_lm(std::string_view course_id,
+                                                                   const std::filesystem::path &source)
+    {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(source, ec);
+        const auto mtime = std::filesystem::last_write_time(source, ec).time_since_epoch().count();
+        if (ec)
+        {
+            return std::unexpected("Cannot stat " + source.string());
+        }
+
+        const auto cached = cache_dir_ / std::format("{}-{:x}-{:x}.lm.bin", course_id, size,
+                                                     static_cast<std::uint64_t>(mtime));
+        if (std::filesystem::exists(cached, ec))
+        {
+            return cached;
+        }
+
+        std::filesystem::create_directories(cache_dir_, ec);
+        if (ec)
+        {
+            return std::unexpected("Cannot create course cache " + cache_dir_.string() + ": " + ec.message());
+        }
+
+        // Compile into a temporary file, then publish atomically
+        logmath_t *lmath = logmath_init(1.0001, 0, 0);
+        ngram_model_t *lm = ngram_model_read(nullptr, source.c_str(), NGRAM_AUTO, lmath);
+        if (!lm)
+        {
+            logmath_free(lmath);
+            return std::unexpected("Failed to read language model " + source.string());
+        }
+
+        auto tmp = cached;
+        tmp += ".tmp";
+        const bool written = ngram_model_write(lm, tmp.c_str(), NGRAM_BIN) == 0;
+        ngram_model_free(lm);
+        logmath_free(lmath);
+
+        if (!written)
+        {
+            std::filesystem::remove(tmp, ec);
+            return std::unexpected("Failed to compile language model " + source.string());
+        }
+        std::filesystem::rename(tmp, cached, ec);
+        if (ec)
+        {
+            return std::unexpected("Failed to store compiled language model: " + ec.message());
+        }
+        return cached;
+    }
+
+} // namespace harness::course
@@ -0,0 +1,214 @@
+// ============================================================================
+// TopNotchNotes Harness - CPU Feature Module
+// One-time cpuid probe that SIMD kernels use to pick their variant at runtime
+// ============================================================================
+
+module;
+
+#include <cstdint>
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define HARNESS_CPU_X86 1
+#else
+#define HARNESS_CPU_X86 0
+#endif
+
+export module harness:cpu;
+
+export namespace harness::cpu
+{
+
+    // ============================================================================
+    // Instruction Sets
+    // ============================================================================
+
+    /// Kernel variants, in increasing order of preference on their architecture
+    enum class Isa : std::uint8_t
+    {
+        Scalar,
+        Sse41,
+        Avx2,
+        Avx512,
+        Neon
+    };
+
+    constexpr std::string_view to_string(Isa isa) noexcept
+    {
+        switch (isa)
+        {
+        case Isa::Scalar:
+            return "scalar";
+        case Isa::Sse41:
+            return "sse4.1";
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Avx512:
+            return "avx512";
+        case Isa::Neon:
+            return "neon";
+        }
+        return "scalar";
+    }
+
+    constexpr std::optional<Isa> parse_isa(std::string_view name) noexcept
+    {
+        for (auto isa : {Isa::Scalar, Isa::Sse41, Isa::Avx2, Isa::Avx512, Isa::Neon})
+        {
+            if (to_string(isa) == name)
+                return isa;
+        }
+        return std::nullopt;
+    }
+
+    // ============================================================================
+    // Feature Detection
+    // ============================================================================
+
+    /// What the CPU and OS support. The AVX flags also require the OS to save
+    /// the wider registers (XGETBV), not just the CPU to have them.
+    struct Features
+    {
+        bool sse41 = false;
+        bool avx2 = false;
+        bool fma = false;
+        bool avx512f = false;
+        bool avx512bw = false;
+        bool neon = false;
+
+        /// Highest variant these features can run, before any cap
+        [[nodiscard]] Isa best() const noexcept
+        {
+            if (neon)
+                return Isa::Neon;
+            if (avx512f && avx512bw)
+                return Isa::Avx512;
+            if (avx2)
+                return Isa::Avx2;
+            if (sse41)
+                return Isa::Sse41;
+            return Isa::Scalar;
+        }
+
+        /// Flag list for logs, e.g. "sse4.1 avx2 fma"
+        [[nodiscard]] std::string describe() const
+        {
+            std::string flags;
+            auto add = [&flags](bool present, std::string_view name)
+            {
+                if (!present)
+                    return;
+                if (!flags.empty())
+                    flags += ' ';
+                flags += name;
+            };
+            add(sse41, "sse4.1");
+            add(avx2, "avx2");
+            add(fma, "fma");
+            add(avx512f, "avx512f");
+            add(avx512bw, "avx512bw");
+            add(neon, "neon");
+            return flags.empty() ? std::string("none") : flags;
+        }
+    };
+
+    /// Query the CPU. Use features() instead; this does the actual cpuid work.
+    [[nodiscard]] inline Features detect() noexcept
+    {
+        Features found;
+#if HARNESS_CPU_X86
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return found;
+        found.sse41 = (ecx & bit_SSE4_1) != 0;
+        const bool fma = (ecx & bit_FMA) != 0;
+
+        // XMM+YMM (bits 1-2) and opmask+ZMM (bits 5-7) enabled by the OS
+        std::uint64_t xcr0 = 0;
+        if ((ecx & bit_OSXSAVE) != 0)
+        {
+            unsigned lo = 0, hi = 0;
+            __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            xcr0 = (std::uint64_t{hi} << 32) | lo;
+        }
+        const bool os_ymm = (xcr0 & 0x6) == 0x6;
+        const bool os_zmm = (xcr0 & 0xe6) == 0xe6;
+
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        {
+            found.avx2 = os_ymm && (ebx & bit_AVX2) != 0;
+            found.fma = os_ymm && fma;
+            found.avx512f = os_zmm && (ebx & bit_AVX512F) != 0;
+            found.avx512bw = os_zmm && (ebx & bit_AVX512BW) != 0;
+        }
+#elif defined(__aarch64__)
+        found.neon = true; // Mandatory on AArch64
+#endif
+        return found;
+    }
+
+    /// This machine's features, probed on first use
+    [[nodiscard]] inline const Features &features() noexcept
+    {
+        static const Features probed = detect();
+        return probed;
+    }
+
+    /// Variant kernels should use: the best the CPU supports, lowered by the
+    /// HARNESS_ISA environment variable (e.g. HARNESS_ISA=sse4.1) to reproduce
+    /// what an older machine would run
+    [[nodiscard]] inline Isa best_isa() noexcept
+    {
+        static const Isa chosen = []
+        {
+            const Isa best = features().best();
+            const char *cap = std::getenv("HARNESS_ISA");
+            const auto limit = cap ? parse_isa(cap) : std::nullopt;
+            if (!limit)
+                return best;
+            if (*limit == Isa::Scalar)
+                return Isa::Scalar;
+            if (best == Isa::Neon || *limit == Isa::Neon)
+                return best; // No lower NEON level to cap at
+            return std::min(best, *limit);
+        }();
+        return chosen;
+    }
+
+    /// Whether this CPU can run kernels built for `isa`
+    [[nodiscard]] inline bool supports(Isa isa) noexcept
+    {
+        const auto &f = features();
+        switch (isa)
+        {
+        case Isa::Scalar:
+            return true;
+        case Isa::Sse41:
+            return f.sse41;
+        case Isa::Avx2:
+            return f.avx2;
+        case Isa::Avx512:
+            return f.avx512f && f.avx512bw;
+        case Isa::Neon:
+            return f.neon;
+        }
+        return false;
+    }
+
+    /// Whether dispatchers should pick `isa`: supported and within the cap
+    [[nodiscard]] inline bool enabled(Isa isa) noexcept
+    {
+        if (!supports(isa))
+            return false;
+        const Isa best = best_isa();
+        if (isa == Isa::Neon || best == Isa::Neon)
+            return isa == best || isa == Isa::Scalar;
+        return isa <= best;
+    }
+
+} // namespace harness::cpu
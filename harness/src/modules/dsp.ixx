@@ -0,0 +1,566 @@
+// ============================================================================
+// TopNotchNotes Harness - DSP Module
+// FFT, windowing, mel filterbank and resampling primitives shared by the
+// analysis and capture stages
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HARNESS_DSP_X86 1
+#else
+#define HARNESS_DSP_X86 0
+#endif
+
+export module harness:dsp;
+
+import :cpu;
+
+export namespace harness::dsp
+{
+
+    // ============================================================================
+    // Kernel Variants
+    // ============================================================================
+
+    namespace detail
+    {
+        /// All radix-2 stages over bit-reversed split re/im data. Written as
+        /// plain loops and compiled once per ISA below; the variants only
+        /// differ in vector width, not in operation order, so results match
+        /// bit for bit.
+        [[gnu::always_inline]] inline void butterfly_stages(float *__restrict r, float *__restrict m,
+                                                            const float *__restrict twiddle_re,
+                                                            const float *__restrict twiddle_im,
+                                                            std::size_t size) noexcept
+        {
+            std::size_t tw_offset = 0;
+            for (std::size_t len = 2; len <= size; len <<= 1)
+            {
+                const std::size_t half = len / 2;
+                const float *__restrict wr = twiddle_re + tw_offset;
+                const float *__restrict wi = twiddle_im + tw_offset;
+
+                for (std::size_t i = 0; i < size; i += len)
+                {
+                    float *__restrict ar = r + i;
+                    float *__restrict ai = m + i;
+                    float *__restrict br = r + i + half;
+                    float *__restrict bi = m + i + half;
+
+                    for (std::size_t k = 0; k < half; ++k)
+                    {
+                        float tr = br[k] * wr[k] - bi[k] * wi[k];
+                        float ti = br[k] * wi[k] + bi[k] * wr[k];
+                        br[k] = ar[k] - tr;
+                        bi[k] = ai[k] - ti;
+                        ar[k] += tr;
+                        ai[k] += ti;
+                    }
+                }
+                tw_offset += half;
+            }
+        }
+
+        using Butterflies = void (*)(float *, float *, const float *, const float *, std::size_t) noexcept;
+
+        inline void butterflies_baseline(float *r, float *m, const float *wr, const float *wi,
+                                         std::size_t size) noexcept
+        {
+            butterfly_stages(r, m, wr, wi, size);
+        }
+
+#if HARNESS_DSP_X86
+        __attribute__((target("avx2"))) inline void butterflies_avx2(float *r, float *m, const float *wr,
+                                                                      const float *wi, std::size_t size) noexcept
+        {
+            butterfly_stages(r, m, wr, wi, size);
+        }
+#endif
+
+        /// Butterfly kernel for this CPU, chosen on first use
+        [[nodiscard]] inline Butterflies butterfly_kernel() noexcept
+        {
+            static const Butterflies chosen = []() -> Butterflies
+            {
+#if HARNESS_DSP_X86
+                if (cpu::enabled(cpu::Isa::Avx2))
+                    return butterflies_avx2;
+#endif
+                return butterflies_baseline;
+            }();
+            return chosen;
+        }
+    } // namespace detail
+
+    /// Name of the FFT kernel in use, for STATUS and logs
+    [[nodiscard]] inline std::string_view fft_variant() noexcept
+    {
+#if HARNESS_DSP_X86
+        if (detail::butterfly_kernel() == detail::butterflies_avx2)
+            return "avx2";
+#endif
+        return "baseline";
+    }
+
+    // ============================================================================
+    // Complex FFT (radix-2, split real/imaginary storage)
+    // ============================================================================
+
+    /// In-place iterative radix-2 FFT over split re/im arrays.
+    /// Twiddles are stored contiguously per stage so the inner butterfly loop
+    /// walks unit-stride arrays and is auto-vectorized by the compiler, once
+    /// per ISA (see detail::butterfly_kernel).
+    class Fft
+    {
+    public:
+        explicit Fft(std::size_t size)
+            : size_(size), bit_reverse_(size)
+        {
+            // Size must be a power of two >= 2
+            if (size_ < 2 || !std::has_single_bit(size_))
+            {
+                size_ = std::bit_ceil(std::max<std::size_t>(size_, 2));
+                bit_reverse_.resize(size_);
+            }
+
+            const auto bits = static_cast<unsigned>(std::countr_zero(size_));
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                std::size_t reversed = 0;
+                for (unsigned b = 0; b < bits; ++b)
+                {
+                    reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+                }
+                bit_reverse_[i] = static_cast<std::uint32_t>(reversed);
+            }
+
+            // Stage with butterfly span `len` uses len/2 twiddles starting at offset len/2 - 1
+            twiddle_re_.reserve(size_);
+            twiddle_im_.reserve(size_);
+            for (std::size_t len = 2; len <= size_; len <<= 1)
+            {
+                for (std::size_t k = 0; k < len / 2; ++k)
+                {
+                    double angle = -2.0 * std::numbers::pi * static_cast<double>(k) /
+                                   static_cast<double>(len);
+                    twiddle_re_.push_back(static_cast<float>(std::cos(angle)));
+                    twiddle_im_.push_back(static_cast<float>(std::sin(angle)));
+                }
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+        /// Forward transform (unnormalized)
+        void forward(std::span<float> re, std::span<float> im) const noexcept
+        {
+            transform(re, im);
+        }
+
+        /// Inverse transform (unnormalized - caller scales by 1/size)
+        void inverse(std::span<float> re, std::span<float> im) const noexcept
+        {
+            // IFFT(x) = conj(FFT(conj(x)))
+            for (auto &v : im)
+                v = -v;
+            transform(re, im);
+            for (auto &v : im)
+                v = -v;
+        }
+
+    private:
+        void transform(std::span<float> re, std::span<float> im) const noexcept
+        {
+            if (re.size() < size_ || im.size() < size_)
+                return;
+
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                std::size_t j = bit_reverse_[i];
+                if (j > i)
+                {
+                    std::swap(re[i], re[j]);
+                    std::swap(im[i], im[j]);
+                }
+            }
+
+            butterflies_(re.data(), im.data(), twiddle_re_.data(), twiddle_im_.data(), size_);
+        }
+
+        std::size_t size_;
+        detail::Butterflies butterflies_ = detail::butterfly_kernel();
+        std::vector<std::uint32_t> bit_reverse_;
+        std::vector<float> twiddle_re_;
+        std::vector<float> twiddle_im_;
+    };
+
+    // ============================================================================
+    // Real FFT (N-point real input via an N/2-point complex transform)
+    // ============================================================================
+
+    /// Real-input FFT producing bins 0..N/2 (inclusive)
+    class RealFft
+    {
+    public:
+        explicit RealFft(std::size_t size)
+            : size_(std::bit_ceil(std::max<std::size_t>(size, 4))),
+              half_(size_ / 2),
+              fft_(half_),
+              work_re_(half_),
+              work_im_(half_)
+        {
+            post_re_.resize(half_);
+            post_im_.resize(half_);
+            for (std::size_t k = 0; k < half_; ++k)
+            {
+                double angle = -2.0 * std::numbers::pi * static_cast<double>(k) /
+                               static_cast<double>(size_);
+                post_re_[k] = static_cast<float>(std::cos(angle));
+                post_im_[k] = static_cast<float>(std::sin(angle));
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+        [[nodiscard]] std::size_t bins() const noexcept { return half_ + 1; }
+
+        /// Transform `input` (size() samples) into bins() complex outputs
+        void forward(std::span<const float> input,
+                     std::span<float> out_re, std::span<float> out_im) noexcept
+        {
+            if (input.size() < size_ || out_re.size() < bins() || out_im.size() < bins())
+                return;
+
+            // Pack even/odd samples as real/imag of a half-size complex sequence
+            for (std::size_t m = 0; m < half_; ++m)
+            {
+                work_re_[m] = input[2 * m];
+                work_im_[m] = input[2 * m + 1];
+            }
+            fft_.forward(work_re_, work_im_);
+
+            // Split the interleaved spectrum back into the real-input spectrum
+            for (std::size_t k = 0; k < half_; ++k)
+            {
+                std::size_t nk = (half_ - k) & (half_ - 1);
+                float zr = work_re_[k], zi = work_im_[k];
+                float cr = work_re_[nk], ci = -work_im_[nk];
+
+                float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+                // (Z - conj(Z[N/2-k])) / 2i
+                float odr = 0.5f * (zi - ci), odi = -0.5f * (zr - cr);
+
+                float tr = odr * post_re_[k] - odi * post_im_[k];
+                float ti = odr * post_im_[k] + odi * post_re_[k];
+                out_re[k] = er + tr;
+                out_im[k] = ei + ti;
+            }
+            out_re[half_] = work_re_[0] - work_im_[0];
+            out_im[half_] = 0.0f;
+        }
+
+        /// Inverse of forward(): bins() complex inputs -> size() real samples (scaled by 1/N)
+        void inverse(std::span<const float> in_re, std::span<const float> in_im,
+                     std::span<float> output) noexcept
+        {
+            if (output.size() < size_ || in_re.size() < bins() || in_im.size() < bins())
+                return;
+
+            for (std::size_t k = 0; k < half_; ++k)
+            {
+                float xr = in_re[k], xi = in_im[k];
+                float cr = in_re[half_ - k], ci = -in_im[half_ - k];
+
+                float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+                float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+                // Xo = (X - conj(X[N/2-k])) / 2 * W^-k
+                float odr = dr * post_re_[k] + di * post_im_[k];
+                float odi = di * post_re_[k] - dr * post_im_[k];
+
+                // Z = Xe + i * Xo
+                work_re_[k] = er - odi;
+                work_im_[k] = ei + odr;
+            }
+            fft_.inverse(work_re_, work_im_);
+
+            const float scale = 1.0f / static_cast<float>(half_);
+            for (std::size_t m = 0; m < half_; ++m)
+            {
+                output[2 * m] = work_re_[m] * scale;
+                output[2 * m + 1] = work_im_[m] * scale;
+            }
+        }
+
+    private:
+        std::size_t size_;
+        std::size_t half_;
+        Fft fft_;
+        std::vector<float> work_re_;
+        std::vector<float> work_im_;
+        std::vector<float> post_re_;
+        std::vector<float> post_im_;
+    };
+
+    // ============================================================================
+    // Windowing
+    // ============================================================================
+
+    /// Periodic Hann window of the given length
+    [[nodiscard]] inline std::vector<float> hann_window(std::size_t length)
+    {
+        std::vector<float> window(length);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            window[i] = static_cast<float>(
+                0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(i) /
+                                     static_cast<double>(length)));
+        }
+        return window;
+    }
+
+    // ============================================================================
+    // Mel Filterbank
+    // ============================================================================
+
+    [[nodiscard]] inline double hz_to_mel(double hz) noexcept
+    {
+        return 2595.0 * std::log10(1.0 + hz / 700.0);
+    }
+
+    [[nodiscard]] inline double mel_to_hz(double mel) noexcept
+    {
+        return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0);
+    }
+
+    /// Triangular HTK-style mel filterbank over a power spectrum
+    class MelFilterbank
+    {
+    public:
+        MelFilterbank(std::size_t fft_size, std::uint32_t sample_rate,
+                      std::size_t bands, float min_hz, float max_hz)
+            : bands_(bands), first_bin_(bands), weights_(bands)
+        {
+            const std::size_t bins = fft_size / 2 + 1;
+            const double nyquist = sample_rate / 2.0;
+            const double lo = hz_to_mel(std::clamp<double>(min_hz, 0.0, nyquist));
+            const double hi = hz_to_mel(std::clamp<double>(max_hz, min_hz, nyquist));
+
+            // bands + 2 edge frequencies expressed in fractional FFT bins
+            std::vector<double> edges(bands + 2);
+            for (std::size_t i = 0; i < edges.size(); ++i)
+            {
+                double mel = lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(bands + 1);
+                edges[i] = mel_to_hz(mel) * static_cast<double>(fft_size) / sample_rate;
+            }
+
+            for (std::size_t b = 0; b < bands; ++b)
+            {
+                double left = edges[b], center = edges[b + 1], right = edges[b + 2];
+                auto start = static_cast<std::size_t>(std::ceil(left));
+                auto stop = std::min(bins - 1, static_cast<std::size_t>(std::floor(right)));
+
+                first_bin_[b] = start;
+                for (std::size_t k = start; k <= stop && k < bins; ++k)
+                {
+                    double x = static_cast<double>(k);
+                    double w = x <= center ? (x - left) / std::max(center - left, 1e-9)
+                                           : (right - x) / std::max(right - center, 1e-9);
+                    weights_[b].push_back(static_cast<float>(std::max(w, 0.0)));
+                }
+            }
+        }
+
+        [[nodiscard]] std::size_t bands() const noexcept { return bands_; }
+
+        /// Apply the filterbank to a power spectrum, writing per-band energy
+        void apply(std::span<const float> power, std::span<float> out) const noexcept
+        {
+            for (std::size_t b = 0; b < bands_ && b < out.size(); ++b)
+            {
+                float energy = 0.0f;
+                const auto &w = weights_[b];
+                const std::size_t first = first_bin_[b];
+                for (std::size_t k = 0; k < w.size() && first + k < power.size(); ++k)
+                {
+                    energy += w[k] * power[first + k];
+                }
+                out[b] = energy;
+            }
+        }
+
+    private:
+        std::size_t bands_;
+        std::vector<std::size_t> first_bin_;
+        std::vector<std::vector<float>> weights_;
+    };
+
+    // ============================================================================
+    // Decimation
+    // ============================================================================
+
+    /// Average groups of `factor` samples (box filter + decimation)
+    [[nodiscard]] inline std::vector<float> decimate(std::span<const float> input, std::size_t factor)
+    {
+        if (factor <= 1)
+            return {input.begin(), input.end()};
+
+        std::vector<float> output(input.size() / factor);
+        const float scale = 1.0f / static_cast<float>(factor);
+        for (std::size_t i = 0; i < output.size(); ++i)
+        {
+            float sum = 0.0f;
+            for (std::size_t k = 0; k < factor; ++k)
+                sum += input[i * factor + k];
+            output[i] = sum * scale;
+        }
+        return output;
+    }
+
+    // ============================================================================
+    // Drift Compensation
+    // ============================================================================
+
+    /// Brings a stream from another device onto the reference clock, so the
+    /// two can be mixed sample for sample. Input is queued with push(); each
+    /// pull() of N samples consumes about N of it, at a rate a PI controller
+    /// adjusts to hold the queue near `target` samples. Sound cards drift
+    /// apart by tens of ppm, so the rate stays within a hair of 1 and cubic
+    /// (Catmull-Rom) interpolation is plenty.
+    ///
+    /// The queue alone is a poor measure: it steps by a whole input block at
+    /// each push, and with two similar periods the pushes drift against the
+    /// pulls over minutes, which the controller would chase. So it counts
+    /// the input due since the last push as already there, from the times
+    /// passed with each call.
+    class DriftResampler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// Corrections are limited to `max_ppm`; faster drift ends in resyncs
+        DriftResampler(std::uint32_t sample_rate, std::size_t target, double max_ppm = 1000.0)
+            : sample_rate_(sample_rate), target_(target), max_offset_(max_ppm * 1e-6)
+        {
+            queue_.reserve(8 * target);
+        }
+
+        /// `at`: when the block was captured (its callback ran)
+        void push(std::span<const float> input, Clock::time_point at)
+        {
+            queue_.insert(queue_.end(), input.begin(), input.end());
+            last_push_ = at;
+        }
+
+        /// Fill `out` from the queue, for the reference block captured `at`.
+        /// Gives silence and returns false until the queue has filled to the
+        /// target, first and after running dry.
+        bool pull(std::span<float> out, Clock::time_point at);
+
+        /// Input samples consumed per output sample
+        [[nodiscard]] double ratio() const noexcept { return ratio_; }
+
+        /// Input clock against the reference, in parts per million
+        [[nodiscard]] double drift_ppm() const noexcept { return (ratio_ - 1.0) * 1e6; }
+
+        [[nodiscard]] std::size_t target() const noexcept { return target_; }
+
+        /// Queued input not consumed yet
+        [[nodiscard]] double backlog() const noexcept { return static_cast<double>(queue_.size()) - position_; }
+
+        /// Times the queue ran dry or overflowed and was rebuilt
+        [[nodiscard]] std::uint64_t resyncs() const noexcept { return resyncs_; }
+
+    private:
+        // Output samples for the controller to work off a backlog error
+        // (~20 s at 48 kHz); critically damped: ki = kp^2 / 4
+        static constexpr double settle_samples = 1 << 20;
+        static constexpr double kp = 1.0 / settle_samples;
+        static constexpr double ki = kp * kp / 4.0;
+        // The backlog jitters by a callback period with the two callbacks'
+        // phase; average that out over ~100 pulls
+        static constexpr double smoothing = 0.01;
+
+        std::uint32_t sample_rate_;
+        Clock::time_point last_push_{};
+        std::vector<float> queue_;
+        double position_ = 1.0; // Read position in queue_; the sample before it is interpolator history
+        double ratio_ = 1.0;
+        double error_ = 0.0; // Smoothed backlog - target
+        double integral_ = 0.0;
+        std::size_t target_;
+        double max_offset_;
+        bool primed_ = false;
+        std::uint64_t resyncs_ = 0;
+    };
+
+    bool DriftResampler::pull(std::span<float> out, Clock::time_point at)
+    {
+        const auto count = out.size();
+        const auto since_push = std::chrono::duration<double>(at - last_push_).count();
+        const double due = std::clamp(since_push, 0.0, 0.5) * sample_rate_;
+        if (!primed_)
+        {
+            if (backlog() < static_cast<double>(target_ + count))
+            {
+                std::fill(out.begin(), out.end(), 0.0f);
+                return false;
+            }
+            // Start on target rather than a block over it, which the
+            // controller would take minutes to settle from
+            primed_ = true;
+            position_ += std::max(0.0, backlog() + due - static_cast<double>(target_));
+            error_ = 0.0;
+        }
+
+        error_ += smoothing * (backlog() + due - static_cast<double>(target_) - error_);
+        integral_ = std::clamp(integral_ + ki * error_ * static_cast<double>(count), -max_offset_, max_offset_);
+        ratio_ = 1.0 + std::clamp(kp * error_ + integral_, -max_offset_, max_offset_);
+
+        const auto last = static_cast<std::size_t>(position_ + static_cast<double>(count) * ratio_);
+        if (last + 2 >= queue_.size())
+        {
+            // Ran dry: the other device stalled or runs slower than the limit
+            std::fill(out.begin(), out.end(), 0.0f);
+            primed_ = false;
+            ++resyncs_;
+            return false;
+        }
+
+        double position = position_;
+        for (auto &sample : out)
+        {
+            const auto k = static_cast<std::size_t>(position);
+            const auto t = static_cast<float>(position - static_cast<double>(k));
+            const float y0 = queue_[k - 1], y1 = queue_[k], y2 = queue_[k + 1], y3 = queue_[k + 2];
+            sample = y1 + 0.5f * t * (y2 - y0 + t * (2.0f * y0 - 5.0f * y1 + 4.0f * y2 - y3 +
+                                                     t * (3.0f * (y1 - y2) + y3 - y0)));
+            position += ratio_;
+        }
+
+        if (static_cast<double>(queue_.size()) - position > static_cast<double>(8 * target_))
+        {
+            // Far more than the controller can work off: the reader stalled
+            position = static_cast<double>(queue_.size() - target_);
+            error_ = 0.0;
+            ++resyncs_;
+        }
+
+        // Keep one sample of history before the read position
+        const auto consumed = static_cast<std::size_t>(position) - 1;
+        queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(consumed));
+        position_ = position - static_cast<double>(consumed);
+        return true;
+    }
+
+} // namespace harness::dsp
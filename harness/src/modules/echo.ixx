@@ -0,0 +1,318 @@
+// ============================================================================
+// TopNotchNotes Harness - Echo Cancellation Module
+// Partitioned-block frequency-domain adaptive filter (PBFDAF) that removes
+// the system audio the microphone picks up from the speakers
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HARNESS_ECHO_X86 1
+#else
+#define HARNESS_ECHO_X86 0
+#endif
+
+export module harness:echo;
+
+import :cpu;
+import :dsp;
+
+export namespace harness::echo
+{
+
+    // ============================================================================
+    // Kernel Variants
+    // ============================================================================
+
+    namespace detail
+    {
+        /// Y += W * X over split re/im bins, for every partition
+        [[gnu::always_inline]] inline void accumulate_partitions(float *__restrict yr, float *__restrict yi,
+                                                                 const float *__restrict wr,
+                                                                 const float *__restrict wi,
+                                                                 const float *__restrict xr,
+                                                                 const float *__restrict xi,
+                                                                 std::size_t bins, std::size_t partitions) noexcept
+        {
+            for (std::size_t p = 0; p < partitions; ++p)
+            {
+                const std::size_t o = p * bins;
+                for (std::size_t k = 0; k < bins; ++k)
+                {
+                    yr[k] += wr[o + k] * xr[o + k] - wi[o + k] * xi[o + k];
+                    yi[k] += wr[o + k] * xi[o + k] + wi[o + k] * xr[o + k];
+                }
+            }
+        }
+
+        /// W += step * conj(X) * E, for every partition
+        [[gnu::always_inline]] inline void adapt_partitions(float *__restrict wr, float *__restrict wi,
+                                                            const float *__restrict xr,
+                                                            const float *__restrict xi,
+                                                            const float *__restrict er,
+                                                            const float *__restrict ei,
+                                                            const float *__restrict step, std::size_t bins,
+                                                            std::size_t partitions) noexcept
+        {
+            for (std::size_t p = 0; p < partitions; ++p)
+            {
+                const std::size_t o = p * bins;
+                for (std::size_t k = 0; k < bins; ++k)
+                {
+                    wr[o + k] += step[k] * (xr[o + k] * er[k] + xi[o + k] * ei[k]);
+                    wi[o + k] += step[k] * (xr[o + k] * ei[k] - xi[o + k] * er[k]);
+                }
+            }
+        }
+
+        struct Kernels
+        {
+            void (*accumulate)(float *, float *, const float *, const float *, const float *, const float *,
+                               std::size_t, std::size_t) noexcept;
+            void (*adapt)(float *, float *, const float *, const float *, const float *, const float *,
+                          const float *, std::size_t, std::size_t) noexcept;
+        };
+
+        inline void accumulate_baseline(float *yr, float *yi, const float *wr, const float *wi, const float *xr,
+                                        const float *xi, std::size_t bins, std::size_t partitions) noexcept
+        {
+            accumulate_partitions(yr, yi, wr, wi, xr, xi, bins, partitions);
+        }
+
+        inline void adapt_baseline(float *wr, float *wi, const float *xr, const float *xi, const float *er,
+                                   const float *ei, const float *step, std::size_t bins,
+                                   std::size_t partitions) noexcept
+        {
+            adapt_partitions(wr, wi, xr, xi, er, ei, step, bins, partitions);
+        }
+
+#if HARNESS_ECHO_X86
+        __attribute__((target("avx2"))) inline void accumulate_avx2(float *yr, float *yi, const float *wr,
+                                                                     const float *wi, const float *xr,
+                                                                     const float *xi, std::size_t bins,
+                                                                     std::size_t partitions) noexcept
+        {
+            accumulate_partitions(yr, yi, wr, wi, xr, xi, bins, partitions);
+        }
+
+        __attribute__((target("avx2"))) inline void adapt_avx2(float *wr, float *wi, const float *xr,
+                                                                const float *xi, const float *er,
+                                                                const float *ei, const float *step,
+                                                                std::size_t bins, std::size_t partitions) noexcept
+        {
+            adapt_partitions(wr, wi, xr, xi, er, ei, step, bins, partitions);
+        }
+#endif
+
+        /// Filter kernels for this CPU, chosen on first use
+        [[nodiscard]] inline const Kernels &kernels() noexcept
+        {
+            static const Kernels chosen = []() -> Kernels
+            {
+#if HARNESS_ECHO_X86
+                if (cpu::enabled(cpu::Isa::Avx2))
+                    return {accumulate_avx2, adapt_avx2};
+#endif
+                return {accumulate_baseline, adapt_baseline};
+            }();
+            return chosen;
+        }
+    } // namespace detail
+
+    // ============================================================================
+    // Echo Canceller
+    // ============================================================================
+
+    struct EchoConfig
+    {
+        std::size_t block = 256;      // Samples per filter block (power of two)
+        std::size_t partitions = 32;  // Echo tail: block * partitions (~170 ms at 48 kHz)
+        std::size_t reference_delay = 0; // How far the reference lags the microphone
+        float step = 0.5f;            // Normalized adaptation step, 0..1
+    };
+
+    /// Subtracts the estimated echo of a reference stream (the system audio)
+    /// from the microphone. The echo path is modelled by `partitions` filter
+    /// blocks in the frequency domain (overlap-save, 2 * block point FFTs),
+    /// adapted by normalized LMS per bin; one partition per block gets the
+    /// gradient constraint, which keeps the cost at three FFTs plus two.
+    ///
+    /// The microphone is delayed by `reference_delay` so the echo never
+    /// arrives before its reference, then by one block to fill the filter:
+    /// output lags input by latency() samples.
+    class EchoCanceller
+    {
+    public:
+        explicit EchoCanceller(EchoConfig config = {});
+
+        /// Remove the echo of `reference` from `mic` into `out`; all three
+        /// the same length, and `reference` sample-aligned with `mic`
+        void process(std::span<const float> mic, std::span<const float> reference, std::span<float> out);
+
+        [[nodiscard]] std::size_t latency() const noexcept { return block_ + config_.reference_delay; }
+
+        /// Echo return loss enhancement while the reference plays, in dB:
+        /// how much quieter the output is than the microphone
+        [[nodiscard]] double erle_db() const noexcept
+        {
+            return 10.0 * std::log10((mic_energy_ + 1e-12) / (out_energy_ + 1e-12));
+        }
+
+    private:
+        void process_block(const float *mic, const float *reference, float *out);
+
+        // Below this mean square the reference is treated as silent and the
+        // filter left alone: there is nothing to learn the echo path from
+        static constexpr float silent_power = 1e-8f;
+        // Per-bin power is smoothed over ~20 blocks
+        static constexpr float power_smoothing = 0.05f;
+
+        EchoConfig config_;
+        std::size_t block_;
+        std::size_t bins_;
+        dsp::RealFft fft_;
+        const detail::Kernels *kernels_ = &detail::kernels();
+
+        std::vector<float> mic_pending_; // Starts with reference_delay samples of silence
+        std::vector<float> reference_pending_;
+        std::vector<float> out_pending_; // Starts with one block of silence
+
+        std::vector<float> reference_window_; // Previous and current reference block
+        std::vector<float> x_re_, x_im_;      // Reference spectra, newest partition first
+        std::vector<float> w_re_, w_im_;      // Filter partitions, youngest age first
+        std::vector<float> y_re_, y_im_;
+        std::vector<float> e_re_, e_im_;
+        std::vector<float> x_power_, e_power_, step_;
+        std::vector<float> time_; // FFT-sized scratch
+        std::size_t newest_ = 0;  // Slot of the newest reference spectrum
+        std::size_t constrain_next_ = 0; // Filter partition due for the gradient constraint
+        double mic_energy_ = 0.0;
+        double out_energy_ = 0.0;
+    };
+
+    EchoCanceller::EchoCanceller(EchoConfig config)
+        : config_(config),
+          block_(std::bit_ceil(std::max<std::size_t>(config.block, 16))),
+          bins_(block_ + 1),
+          fft_(2 * block_),
+          mic_pending_(config.reference_delay, 0.0f),
+          out_pending_(block_, 0.0f),
+          reference_window_(2 * block_, 0.0f),
+          x_re_(std::max<std::size_t>(config.partitions, 1) * bins_, 0.0f),
+          x_im_(x_re_.size(), 0.0f),
+          w_re_(x_re_.size(), 0.0f),
+          w_im_(x_re_.size(), 0.0f),
+          y_re_(bins_), y_im_(bins_), e_re_(bins_), e_im_(bins_),
+          x_power_(bins_, 0.0f), e_power_(bins_, 0.0f), step_(bins_, 0.0f),
+          time_(2 * block_)
+    {
+        config_.partitions = x_re_.size() / bins_;
+    }
+
+    void EchoCanceller::process(std::span<const float> mic, std::span<const float> reference, std::span<float> out)
+    {
+        const auto count = std::min({mic.size(), reference.size(), out.size()});
+        mic_pending_.insert(mic_pending_.end(), mic.begin(), mic.begin() + static_cast<std::ptrdiff_t>(count));
+        reference_pending_.insert(reference_pending_.end(), reference.begin(),
+                                  reference.begin() + static_cast<std::ptrdiff_t>(count));
+
+        // The reference holds the fewest samples, by reference_delay
+        std::size_t done = 0;
+        for (; done + block_ <= reference_pending_.size(); done += block_)
+        {
+            const auto at = out_pending_.size();
+            out_pending_.resize(at + block_);
+            process_block(mic_pending_.data() + done, reference_pending_.data() + done, out_pending_.data() + at);
+        }
+        mic_pending_.erase(mic_pending_.begin(), mic_pending_.begin() + static_cast<std::ptrdiff_t>(done));
+        reference_pending_.erase(reference_pending_.begin(),
+                                 reference_pending_.begin() + static_cast<std::ptrdiff_t>(done));
+
+        std::copy_n(out_pending_.begin(), count, out.begin());
+        out_pending_.erase(out_pending_.begin(), out_pending_.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+
+    void EchoCanceller::process_block(const float *mic, const float *reference, float *out)
+    {
+        const auto partitions = config_.partitions;
+
+        // Newest reference spectrum over the last two blocks
+        std::copy_n(reference_window_.begin() + static_cast<std::ptrdiff_t>(block_), block_,
+                    reference_window_.begin());
+        std::copy_n(reference, block_, reference_window_.begin() + static_cast<std::ptrdiff_t>(block_));
+        newest_ = (newest_ + partitions - 1) % partitions;
+        const auto slot = newest_ * bins_;
+        fft_.forward(reference_window_, std::span(x_re_).subspan(slot, bins_), std::span(x_im_).subspan(slot, bins_));
+
+        // Echo estimate: each filter partition against the reference spectrum
+        // of its age. The spectra rotate through their slots while the filter
+        // stays in age order, so age a pairs with slot (newest_ + a) %
+        // partitions: two contiguous runs for the kernels.
+        const auto head = partitions - newest_;
+        const auto tail = head * bins_;
+        std::fill(y_re_.begin(), y_re_.end(), 0.0f);
+        std::fill(y_im_.begin(), y_im_.end(), 0.0f);
+        kernels_->accumulate(y_re_.data(), y_im_.data(), w_re_.data(), w_im_.data(), x_re_.data() + slot,
+                            x_im_.data() + slot, bins_, head);
+        kernels_->accumulate(y_re_.data(), y_im_.data(), w_re_.data() + tail, w_im_.data() + tail, x_re_.data(),
+                            x_im_.data(), bins_, newest_);
+        fft_.inverse(y_re_, y_im_, time_);
+
+        // Error: what the microphone has beyond the estimate (overlap-save
+        // keeps the second half)
+        double mic_energy = 0.0, out_energy = 0.0, reference_energy = 0.0;
+        for (std::size_t i = 0; i < block_; ++i)
+        {
+            out[i] = mic[i] - time_[block_ + i];
+            mic_energy += static_cast<double>(mic[i]) * mic[i];
+            out_energy += static_cast<double>(out[i]) * out[i];
+            reference_energy += static_cast<double>(reference[i]) * reference[i];
+        }
+        if (reference_energy / static_cast<double>(block_) < silent_power)
+            return;
+        mic_energy_ += power_smoothing * (mic_energy - mic_energy_);
+        out_energy_ += power_smoothing * (out_energy - out_energy_);
+
+        std::fill_n(time_.begin(), block_, 0.0f);
+        std::copy_n(out, block_, time_.begin() + static_cast<std::ptrdiff_t>(block_));
+        fft_.forward(time_, e_re_, e_im_);
+
+        // Normalized step per bin, shared out over the partitions, which all
+        // move the estimate. The error power in the denominator slows
+        // adaptation while someone near the microphone talks over the
+        // reference, which would otherwise pull the filter off the echo path.
+        const float floor = silent_power * static_cast<float>(2 * block_);
+        const float scale = config_.step / static_cast<float>(partitions);
+        for (std::size_t k = 0; k < bins_; ++k)
+        {
+            const float x2 = x_re_[slot + k] * x_re_[slot + k] + x_im_[slot + k] * x_im_[slot + k];
+            const float e2 = e_re_[k] * e_re_[k] + e_im_[k] * e_im_[k];
+            x_power_[k] += power_smoothing * (x2 - x_power_[k]);
+            e_power_[k] += power_smoothing * (e2 - e_power_[k]);
+            step_[k] = scale / (x_power_[k] + e_power_[k] + floor);
+        }
+        kernels_->adapt(w_re_.data(), w_im_.data(), x_re_.data() + slot, x_im_.data() + slot, e_re_.data(),
+                       e_im_.data(), step_.data(), bins_, head);
+        kernels_->adapt(w_re_.data() + tail, w_im_.data() + tail, x_re_.data(), x_im_.data(), e_re_.data(),
+                       e_im_.data(), step_.data(), bins_, newest_);
+
+        // Gradient constraint for one partition: its impulse response must
+        // fit in one block, or the circular convolution wraps around
+        const auto constrained = constrain_next_ * bins_;
+        constrain_next_ = (constrain_next_ + 1) % partitions;
+        auto wr = std::span(w_re_).subspan(constrained, bins_);
+        auto wi = std::span(w_im_).subspan(constrained, bins_);
+        fft_.inverse(wr, wi, time_);
+        std::fill(time_.begin() + static_cast<std::ptrdiff_t>(block_), time_.end(), 0.0f);
+        fft_.forward(time_, wr, wi);
+    }
+
+} // namespace harness::echo
@@ -0,0 +1,144 @@
+// ============================================================================
+// TopNotchNotes Harness - Transcription Engine Registry
+// Named factories for the available ITranscribeEngine backends
+// ============================================================================
+
+module;
+
+#include <algorithm>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Same probe as the whisper partition; macros do not cross module boundaries
+#if __has_include(<whisper.h>)
+#define HARNESS_HAS_WHISPER 1
+#else
+#define HARNESS_HAS_WHISPER 0
+#endif
+
+export module harness:engines;
+
+import :transcribe;
+import :whisper;
+
+export namespace harness::transcribe
+{
+
+    // ============================================================================
+    // Engine Registry
+    // ============================================================================
+
+    using EngineResult = std::expected<std::unique_ptr<ITranscribeEngine>, std::string>;
+
+    /// Backends selectable by name. The built-in ones are registered on first
+    /// use; others can be added at startup.
+    class EngineRegistry
+    {
+    public:
+        using Factory = std::function<EngineResult(const TranscribeConfig &)>;
+
+        /// Register (or replace) a backend
+        void add(std::string name, Factory factory)
+        {
+            std::lock_guard lock(mutex_);
+            auto it = std::ranges::find(factories_, name, &Entry::name);
+            if (it != factories_.end())
+                it->factory = std::move(factory);
+            else
+                factories_.push_back({std::move(name), std::move(factory)});
+        }
+
+        [[nodiscard]] EngineResult create(std::string_view name, const TranscribeConfig &config) const
+        {
+            Factory factory;
+            {
+                std::lock_guard lock(mutex_);
+                auto it = std::ranges::find(factories_, name, &Entry::name);
+                if (it == factories_.end())
+                    return std::unexpected("Unknown transcription engine: " + std::string(name));
+                factory = it->factory;
+            }
+            return factory(config); // Model loading runs unlocked
+        }
+
+        [[nodiscard]] bool contains(std::string_view name) const
+        {
+            std::lock_guard lock(mutex_);
+            return std::ranges::find(factories_, name, &Entry::name) != factories_.end();
+        }
+
+        /// Registered names, in registration order
+        [[nodiscard]] std::vector<std::string> names() const
+        {
+            std::lock_guard lock(mutex_);
+            std::vector<std::string> result;
+            for (const auto &entry : factories_)
+                result.push_back(entry.name);
+            return result;
+        }
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            Factory factory;
+        };
+
+        mutable std::mutex mutex_;
+        std::vector<Entry> factories_;
+    };
+
+    /// Process-wide registry with the built-in backends
+    [[nodiscard]] inline EngineRegistry &engines()
+    {
+        static EngineRegistry registry;
+        static const bool registered = []
+        {
+            registry.add("pocketsphinx", [](const TranscribeConfig &config) -> EngineResult
+                         {
+                auto engine = PocketSphinxEngine::create(config);
+                if (!engine)
+                    return std::unexpected(engine.error());
+                return std::move(*engine); });
+#if HARNESS_HAS_WHISPER
+            registry.add("whisper", [](const TranscribeConfig &config) -> EngineResult
+                         {
+                auto engine = WhisperEngine::create(config);
+                if (!engine)
+                    return std::unexpected(engine.error());
+                return std::move(*engine); });
+#endif
+            registry.add("stub", [](const TranscribeConfig &) -> EngineResult
+                         { return std::make_unique<StubTranscribeEngine>(); });
+            return true;
+        }();
+        (void)registered;
+        return registry;
+    }
+
+    // ============================================================================
+    // Factory Function
+    // ============================================================================
+
+    /// Create the configured transcription engine, falling back to the stub
+    /// so a session always has something to drive
+    [[nodiscard]] inline std::unique_ptr<ITranscribeEngine>
+    create_engine(const TranscribeConfig &config)
+    {
+        auto result = engines().create(config.engine, config);
+        if (result)
+        {
+            return std::move(*result);
+        }
+        std::print(stderr, "{} failed: {} - falling back to stub\n", config.engine, result.error());
+        return std::make_unique<StubTranscribeEngine>();
+    }
+
+} // namespace harness::transcribe
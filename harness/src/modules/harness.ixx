@@ -25,6 +25,25 @@ export import :transcribe;
 export import :io;
 export import :ringbuffer;
 export import :telemetry;
+export import :dsp;
+export import :preview;
+export import :shm;
+export import :server;
+export import :postprocess;
+export import :course;
+export import :rescore;
+export import :whisper;
+export import :engines;
+export import :asr;
+export import :convert;
+export import :cpu;
+export import :journal;
+export import :trace;
+export import :metrics;
+export import :memory;
+export import :checksum;
+export import :echo;
+export import :clock;
 
 export namespace harness
 {
@@ -87,6 +106,13 @@ export namespace harness
         Resume,
         Kill,
         Status,
+        Subscribe,
+        Course,
+        Engine,
+        Trace,
+        Metrics,
+        Verify,
+        Aec,
         Unknown
     };
 
@@ -105,6 +131,20 @@ export namespace harness
             return Kill;
         if (cmd == "STATUS")
             return Status;
+        if (cmd == "SUBSCRIBE")
+            return Subscribe;
+        if (cmd == "COURSE")
+            return Course;
+        if (cmd == "ENGINE")
+            return Engine;
+        if (cmd == "TRACE")
+            return Trace;
+        if (cmd == "METRICS")
+            return Metrics;
+        if (cmd == "VERIFY")
+            return Verify;
+        if (cmd == "AEC")
+            return Aec;
         return Unknown;
     }
 
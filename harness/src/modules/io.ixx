@@ -20,9 +20,29 @@ module;
 #include <atomic>
 #include <stdexcept>
 #include <cstring>
+#include <string_view>
+#include <memory>
+#include <algorithm>
+#include <system_error>
+#include <optional>
+#include <utility>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 export module harness:io;
 
+import :convert;
+import :trace;
+import :metrics;
+import :memory;
+import :checksum;
+
 export namespace harness::io
 {
 
@@ -198,6 +218,28 @@ export namespace harness::io
     // WAV File Writer
     // ============================================================================
 
+    /// Sample encoding of a WAV file's data chunk
+    enum class WavFormat : std::uint8_t
+    {
+        Float32, // IEEE float, lossless for the capture path
+        Pcm16,
+        Pcm24
+    };
+
+    [[nodiscard]] constexpr std::size_t bytes_per_sample(WavFormat format) noexcept
+    {
+        switch (format)
+        {
+        case WavFormat::Pcm16:
+            return 2;
+        case WavFormat::Pcm24:
+            return 3;
+        case WavFormat::Float32:
+            break;
+        }
+        return 4;
+    }
+
     /// WAV file header structure
     struct WavHeader
     {
@@ -220,15 +262,29 @@ export namespace harness::io
         char data[4] = {'d', 'a', 't', 'a'};
         std::uint32_t data_size = 0;
 
-        void configure(std::uint32_t rate, std::uint16_t channels)
+        void configure(std::uint32_t rate, std::uint16_t channels, WavFormat format = WavFormat::Float32)
         {
             sample_rate = rate;
             num_channels = channels;
+            audio_format = format == WavFormat::Float32 ? 3 : 1; // IEEE float or integer PCM
+            bits_per_sample = static_cast<std::uint16_t>(io::bytes_per_sample(format) * 8);
             std::uint16_t bytes_per_sample = bits_per_sample / 8;
             block_align = static_cast<std::uint16_t>(num_channels * bytes_per_sample);
             byte_rate = sample_rate * block_align;
         }
 
+        /// Encoding described by the header, if WavWriter could have written it
+        [[nodiscard]] std::optional<WavFormat> format() const noexcept
+        {
+            if (audio_format == 3 && bits_per_sample == 32)
+                return WavFormat::Float32;
+            if (audio_format == 1 && bits_per_sample == 16)
+                return WavFormat::Pcm16;
+            if (audio_format == 1 && bits_per_sample == 24)
+                return WavFormat::Pcm24;
+            return std::nullopt;
+        }
+
         void finalize(std::size_t data_bytes)
         {
             data_size = static_cast<std::uint32_t>(data_bytes);
@@ -238,13 +294,323 @@ export namespace harness::io
 
     static_assert(sizeof(WavHeader) == 44, "WavHeader must be 44 bytes");
 
-    /// WAV file writer with proper header management
+    // ============================================================================
+    // Sequential File - Long recordings outside the page cache
+    // ============================================================================
+
+    /// How a recording reaches the disk
+    enum class WriteMode : std::uint8_t
+    {
+        Buffered,  // std::ofstream through the page cache
+        Streaming, // Through the page cache, written back and dropped block by block
+        Direct     // O_DIRECT aligned blocks; Streaming where the filesystem refuses them
+    };
+
+    [[nodiscard]] constexpr std::string_view to_string(WriteMode mode) noexcept
+    {
+        switch (mode)
+        {
+        case WriteMode::Buffered:
+            return "buffered";
+        case WriteMode::Streaming:
+            return "streaming";
+        case WriteMode::Direct:
+            return "direct";
+        }
+        return "buffered";
+    }
+
+    struct WriteOptions
+    {
+        WriteMode mode = WriteMode::Buffered;
+        std::uint64_t expected_bytes = 0; // Reserved up front; past it the file reserves as it grows
+    };
+
+    /// Append-only file written from a staging buffer in large blocks, with
+    /// disk space reserved ahead of the data (fallocate) and the unused
+    /// reservation released on close. Written blocks never linger in the page
+    /// cache: Direct bypasses it, Streaming starts writeback as each block is
+    /// written and drops the block before it. Bytes already written can be
+    /// patched, which WavWriter needs for the header.
+    class SequentialFile
+    {
+    public:
+        static constexpr std::size_t block_bytes = 512 * 1024;
+        static constexpr std::uint64_t reserve_step = std::uint64_t{64} << 20;
+
+        /// `options.mode` must be Streaming or Direct
+        static IOResult<SequentialFile> open(const std::filesystem::path &path, WriteOptions options);
+
+        ~SequentialFile();
+
+        SequentialFile(SequentialFile &&other) noexcept;
+        SequentialFile &operator=(SequentialFile &&other) noexcept;
+        SequentialFile(const SequentialFile &) = delete;
+        SequentialFile &operator=(const SequentialFile &) = delete;
+
+        bool write(std::span<const std::byte> data);
+
+        /// Put the partial block on disk too. In Direct mode it is padded to
+        /// the alignment, so the file reads as zeros past size() until the
+        /// next block or close() replaces the padding.
+        bool flush();
+
+        /// Overwrite bytes that were already written
+        bool patch(std::uint64_t offset, std::span<const std::byte> data);
+
+        /// Flush, cut the file to size() (dropping padding and reservation)
+        bool close();
+
+        [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+        [[nodiscard]] bool direct() const noexcept { return direct_; }
+        [[nodiscard]] std::uint64_t size() const noexcept { return block_offset_ + fill_; }
+
+        /// The block not yet handed to the kernel, starting at staged_offset()
+        [[nodiscard]] std::span<const std::byte> staged() const noexcept { return {buffer_.get(), fill_}; }
+        [[nodiscard]] std::uint64_t staged_offset() const noexcept { return block_offset_; }
+
+    private:
+        struct FreeAligned
+        {
+            void operator()(std::byte *p) const noexcept { std::free(p); }
+        };
+        using AlignedBuffer = std::unique_ptr<std::byte, FreeAligned>;
+
+        SequentialFile(int fd, bool direct, std::size_t alignment);
+
+        bool put(const std::byte *data, std::size_t length, std::uint64_t offset);
+        bool write_block(std::size_t length);
+        void reserve(std::uint64_t end, std::uint64_t step);
+        void release_behind();
+
+        int fd_ = -1;
+        bool direct_ = false;
+        std::size_t alignment_ = 4096;
+        AlignedBuffer buffer_;           // block_bytes of the file from block_offset_
+        std::size_t fill_ = 0;           // Bytes of buffer_ in use
+        std::uint64_t block_offset_ = 0; // Always a multiple of block_bytes
+        std::uint64_t reserved_ = 0;     // fallocate'd up to here
+    };
+
+    IOResult<SequentialFile> SequentialFile::open(const std::filesystem::path &path, WriteOptions options)
+    {
+        constexpr int flags = O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC; // Read for patch()
+        bool direct = options.mode == WriteMode::Direct;
+        int fd = direct ? ::open(path.c_str(), flags | O_DIRECT, 0644) : -1;
+        if (fd < 0)
+        {
+            direct = false; // EINVAL: no O_DIRECT on this filesystem
+            fd = ::open(path.c_str(), flags, 0644);
+        }
+        if (fd < 0)
+            return std::unexpected("Failed to open file: " + path.string() + ": " + std::strerror(errno));
+
+        // Devices need at most their logical block size; the filesystem
+        // block is a multiple of it
+        struct stat st{};
+        const auto blksize = ::fstat(fd, &st) == 0 ? static_cast<std::size_t>(st.st_blksize) : 0;
+        const auto alignment = std::clamp(std::bit_ceil(blksize), std::size_t{4096}, block_bytes);
+
+        SequentialFile file(fd, direct, alignment);
+        if (!file.buffer_)
+            return std::unexpected("Out of memory for the write buffer of " + path.string());
+        file.reserve(options.expected_bytes, 0);
+        return file;
+    }
+
+    SequentialFile::SequentialFile(int fd, bool direct, std::size_t alignment)
+        : fd_(fd), direct_(direct), alignment_(alignment),
+          buffer_(static_cast<std::byte *>(std::aligned_alloc(alignment, block_bytes)))
+    {
+    }
+
+    SequentialFile::~SequentialFile()
+    {
+        close();
+    }
+
+    SequentialFile::SequentialFile(SequentialFile &&other) noexcept
+        : fd_(std::exchange(other.fd_, -1)), direct_(other.direct_), alignment_(other.alignment_),
+          buffer_(std::move(other.buffer_)), fill_(other.fill_), block_offset_(other.block_offset_),
+          reserved_(other.reserved_)
+    {
+    }
+
+    SequentialFile &SequentialFile::operator=(SequentialFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            fd_ = std::exchange(other.fd_, -1);
+            direct_ = other.direct_;
+            alignment_ = other.alignment_;
+            buffer_ = std::move(other.buffer_);
+            fill_ = other.fill_;
+            block_offset_ = other.block_offset_;
+            reserved_ = other.reserved_;
+        }
+        return *this;
+    }
+
+    bool SequentialFile::write(std::span<const std::byte> data)
+    {
+        if (fd_ < 0)
+            return false;
+        while (!data.empty())
+        {
+            const auto n = std::min(data.size(), block_bytes - fill_);
+            std::memcpy(buffer_.get() + fill_, data.data(), n);
+            fill_ += n;
+            data = data.subspan(n);
+            if (fill_ == block_bytes)
+            {
+                if (!write_block(block_bytes))
+                    return false;
+                block_offset_ += block_bytes;
+                fill_ = 0;
+                if (!direct_)
+                    release_behind();
+            }
+        }
+        return true;
+    }
+
+    bool SequentialFile::flush()
+    {
+        if (fd_ < 0 || fill_ == 0)
+            return fd_ >= 0;
+        // The block stays staged; the next full write covers it again
+        const auto length = direct_ ? (fill_ + alignment_ - 1) / alignment_ * alignment_ : fill_;
+        std::memset(buffer_.get() + fill_, 0, length - fill_);
+        return write_block(length);
+    }
+
+    bool SequentialFile::patch(std::uint64_t offset, std::span<const std::byte> data)
+    {
+        if (fd_ < 0)
+            return false;
+        const auto end = offset + data.size();
+        if (offset >= block_offset_ && end <= size())
+        {
+            std::memcpy(buffer_.get() + (offset - block_offset_), data.data(), data.size());
+            return true;
+        }
+        if (end > block_offset_)
+            return false; // Straddles the staged block
+        if (!direct_)
+            return put(data.data(), data.size(), offset);
+
+        // Read-modify-write the aligned span around it
+        const auto first = offset / alignment_ * alignment_;
+        const auto length = static_cast<std::size_t>((end - first + alignment_ - 1) / alignment_ * alignment_);
+        AlignedBuffer scratch(static_cast<std::byte *>(std::aligned_alloc(alignment_, length)));
+        if (!scratch ||
+            ::pread(fd_, scratch.get(), length, static_cast<off_t>(first)) != static_cast<ssize_t>(length))
+            return false;
+        std::memcpy(scratch.get() + (offset - first), data.data(), data.size());
+        return put(scratch.get(), length, first);
+    }
+
+    bool SequentialFile::close()
+    {
+        if (fd_ < 0)
+            return true;
+        bool ok = flush();
+        ok = ::ftruncate(fd_, static_cast<off_t>(size())) == 0 && ok;
+        if (!direct_)
+        {
+            ::sync_file_range(fd_, 0, 0,
+                              SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+            ::posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+        }
+        ok = ::close(fd_) == 0 && ok;
+        fd_ = -1;
+        return ok;
+    }
+
+    bool SequentialFile::put(const std::byte *data, std::size_t length, std::uint64_t offset)
+    {
+        std::size_t done = 0;
+        while (done < length)
+        {
+            const auto n = ::pwrite(fd_, data + done, length - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && errno == EINVAL && direct_)
+            {
+                // Opened with O_DIRECT, but the filesystem refuses the writes
+                direct_ = false;
+                ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT);
+                continue;
+            }
+            if (n <= 0)
+                return false;
+            done += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool SequentialFile::write_block(std::size_t length)
+    {
+        static auto &latency = metrics::global().histogram("harness_wav_block_write_seconds",
+                                                           "Time to hand one block of a recording to the kernel");
+        reserve(block_offset_ + length, reserve_step);
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = put(buffer_.get(), length, block_offset_);
+        latency.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        return ok;
+    }
+
+    void SequentialFile::reserve(std::uint64_t end, std::uint64_t step)
+    {
+        if (end <= reserved_)
+            return;
+        // KEEP_SIZE: readers still see the file end where the data does
+        const auto target = std::max(end, reserved_ + step);
+        if (::fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(reserved_),
+                        static_cast<off_t>(target - reserved_)) == 0)
+            reserved_ = target;
+        else
+            reserved_ = UINT64_MAX; // Not supported here; stop asking
+    }
+
+    void SequentialFile::release_behind()
+    {
+        // Start writeback of the block just written. The block before it was
+        // started a block ago, so waiting for it rarely blocks.
+        const auto just_written = block_offset_ - block_bytes;
+        ::sync_file_range(fd_, static_cast<off_t>(just_written), block_bytes, SYNC_FILE_RANGE_WRITE);
+        if (just_written == 0)
+            return;
+        const auto previous = static_cast<off_t>(just_written - block_bytes);
+        ::sync_file_range(fd_, previous, block_bytes,
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        ::posix_fadvise(fd_, previous, block_bytes, POSIX_FADV_DONTNEED);
+    }
+
+    /// What another thread needs to read a WavWriter's file while it is still
+    /// being written: the header and the tail of the staged block, which only
+    /// reaches the file once the block is full. Copied on the writer's thread.
+    struct WavSnapshot
+    {
+        WavHeader header;
+        std::uint64_t staged_offset = 0; // File offset of `staged`
+        std::vector<std::byte> staged;
+    };
+
+    /// WAV file writer with proper header management. Samples are always
+    /// passed as float; integer formats are converted on write.
+    /// Each file gets a `<file>.xxh3` manifest, hashed as the data is written.
+    /// Long recordings can bypass the page cache (WriteOptions).
     class WavWriter
     {
     public:
         static IOResult<WavWriter> create(const std::filesystem::path &path,
                                           std::uint32_t sample_rate,
-                                          std::uint16_t channels = 1);
+                                          std::uint16_t channels = 1,
+                                          WavFormat format = WavFormat::Float32,
+                                          WriteOptions options = {});
 
         ~WavWriter();
 
@@ -253,31 +619,62 @@ export namespace harness::io
         WavWriter(const WavWriter &) = delete;
         WavWriter &operator=(const WavWriter &) = delete;
 
-        /// Write audio samples
+        /// Write audio samples; false when they could not be written, in
+        /// which case they are not counted either
         bool write(std::span<const float> samples);
 
+        /// Push buffered samples to the file so other readers can see them
+        void flush();
+
+        /// Copy of what is not in the file yet, from `first_sample` on. Only
+        /// Buffered mode writes anything, its few KiB of stream buffer.
+        [[nodiscard]] WavSnapshot snapshot(std::uint64_t first_sample);
+
         /// Finalize the file (updates header)
         void close();
 
-        [[nodiscard]] bool is_open() const noexcept { return file_.is_open(); }
+        [[nodiscard]] bool is_open() const noexcept
+        {
+            return file_.is_open() || (sequential_ && sequential_->is_open());
+        }
+        [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
         [[nodiscard]] std::size_t samples_written() const noexcept { return samples_written_; }
+        [[nodiscard]] std::uint32_t sample_rate() const noexcept { return header_.sample_rate; }
+        [[nodiscard]] WavFormat format() const noexcept { return format_; }
+
+        /// The path actually in use; Direct falls back to Streaming
+        [[nodiscard]] WriteMode write_mode() const noexcept
+        {
+            if (!sequential_)
+                return WriteMode::Buffered;
+            return sequential_->direct() ? WriteMode::Direct : WriteMode::Streaming;
+        }
 
     private:
-        WavWriter(const std::filesystem::path &path, std::uint32_t sample_rate, std::uint16_t channels);
+        WavWriter(const std::filesystem::path &path, std::uint32_t sample_rate, std::uint16_t channels,
+                  WavFormat format, WriteOptions options);
+
+        bool put(std::span<const std::byte> bytes);
 
         std::filesystem::path path_;
-        std::ofstream file_;
+        std::ofstream file_;                       // WriteMode::Buffered
+        std::optional<SequentialFile> sequential_; // Streaming and Direct
         WavHeader header_;
+        WavFormat format_ = WavFormat::Float32;
+        std::vector<std::uint8_t> encoded_; // Conversion scratch for integer formats
         std::size_t samples_written_ = 0;
+        std::optional<checksum::ManifestWriter> manifest_; // <file>.xxh3, hashed as written
     };
 
     IOResult<WavWriter> WavWriter::create(const std::filesystem::path &path,
                                           std::uint32_t sample_rate,
-                                          std::uint16_t channels)
+                                          std::uint16_t channels,
+                                          WavFormat format,
+                                          WriteOptions options)
     {
         try
         {
-            return WavWriter(path, sample_rate, channels);
+            return WavWriter(path, sample_rate, channels, format, options);
         }
         catch (const std::exception &e)
         {
@@ -285,36 +682,59 @@ export namespace harness::io
         }
     }
 
-    WavWriter::WavWriter(const std::filesystem::path &path, std::uint32_t sample_rate, std::uint16_t channels)
-        : path_(path)
+    WavWriter::WavWriter(const std::filesystem::path &path, std::uint32_t sample_rate, std::uint16_t channels,
+                         WavFormat format, WriteOptions options)
+        : path_(path), format_(format)
     {
         if (auto parent = path_.parent_path(); !parent.empty())
         {
             std::filesystem::create_directories(parent);
         }
 
-        file_.open(path_, std::ios::binary | std::ios::trunc);
-        if (!file_.is_open())
+        if (options.mode == WriteMode::Buffered)
         {
-            throw std::runtime_error("Failed to open file: " + path_.string());
+            file_.open(path_, std::ios::binary | std::ios::trunc);
+            if (!file_.is_open())
+            {
+                throw std::runtime_error("Failed to open file: " + path_.string());
+            }
+        }
+        else
+        {
+            auto file = SequentialFile::open(path_, options);
+            if (!file)
+            {
+                throw std::runtime_error(file.error());
+            }
+            sequential_ = std::move(*file);
         }
 
-        header_.configure(sample_rate, channels);
+        header_.configure(sample_rate, channels, format);
 
         // Write placeholder header
-        file_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+        put(std::as_bytes(std::span(&header_, 1)));
+
+        auto manifest = checksum::ManifestWriter::create(path_, sizeof(header_));
+        if (!manifest)
+        {
+            throw std::runtime_error(manifest.error());
+        }
+        manifest_ = std::move(*manifest);
     }
 
     WavWriter::~WavWriter()
     {
-        if (file_.is_open())
+        if (is_open())
         {
             close();
         }
     }
 
     WavWriter::WavWriter(WavWriter &&other) noexcept
-        : path_(std::move(other.path_)), file_(std::move(other.file_)), header_(other.header_), samples_written_(other.samples_written_)
+        : path_(std::move(other.path_)), file_(std::move(other.file_)), sequential_(std::move(other.sequential_)),
+          header_(other.header_), format_(other.format_),
+          encoded_(std::move(other.encoded_)), samples_written_(other.samples_written_),
+          manifest_(std::move(other.manifest_))
     {
     }
 
@@ -322,39 +742,307 @@ export namespace harness::io
     {
         if (this != &other)
         {
-            if (file_.is_open())
+            if (is_open())
                 close();
             path_ = std::move(other.path_);
             file_ = std::move(other.file_);
+            sequential_ = std::move(other.sequential_);
             header_ = other.header_;
+            format_ = other.format_;
+            encoded_ = std::move(other.encoded_);
             samples_written_ = other.samples_written_;
+            manifest_ = std::move(other.manifest_);
         }
         return *this;
     }
 
     bool WavWriter::write(std::span<const float> samples)
     {
-        if (!file_.is_open())
+        trace::Scope scope("WavWriter::write");
+        if (!is_open())
             return false;
 
-        file_.write(reinterpret_cast<const char *>(samples.data()),
-                    static_cast<std::streamsize>(samples.size_bytes()));
+        std::span<const std::byte> bytes;
+        switch (format_)
+        {
+        case WavFormat::Float32:
+            bytes = std::as_bytes(samples);
+            break;
+        case WavFormat::Pcm16:
+            encoded_.resize(samples.size() * 2);
+            convert::f32_to_s16(samples, {reinterpret_cast<std::int16_t *>(encoded_.data()), samples.size()});
+            bytes = std::as_bytes(std::span(encoded_));
+            break;
+        case WavFormat::Pcm24:
+            encoded_.resize(samples.size() * 3);
+            convert::f32_to_s24(samples, encoded_);
+            bytes = std::as_bytes(std::span(encoded_));
+            break;
+        }
+        if (!put(bytes))
+            return false;
+        if (manifest_)
+            manifest_->update(bytes);
         samples_written_ += samples.size();
+
+        static auto &written = metrics::global().counter("harness_wav_bytes_written_total",
+                                                         "Sample data written to session WAV files");
+        written.add(bytes.size());
         return true;
     }
 
+    bool WavWriter::put(std::span<const std::byte> bytes)
+    {
+        if (sequential_)
+            return sequential_->write(bytes);
+        file_.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return file_.good();
+    }
+
+    void WavWriter::flush()
+    {
+        if (sequential_)
+            sequential_->flush();
+        else if (file_.is_open())
+            file_.flush();
+    }
+
+    WavSnapshot WavWriter::snapshot(std::uint64_t first_sample)
+    {
+        WavSnapshot snapshot{.header = header_};
+        if (!sequential_)
+        {
+            if (file_.is_open())
+                file_.flush();
+            return snapshot;
+        }
+
+        const auto staged = sequential_->staged();
+        const auto from = std::max(sequential_->staged_offset(),
+                                   sizeof(WavHeader) + first_sample * bytes_per_sample(format_));
+        if (from < sequential_->size())
+        {
+            snapshot.staged_offset = from;
+            snapshot.staged.assign(staged.begin() + static_cast<std::ptrdiff_t>(from - sequential_->staged_offset()),
+                                   staged.end());
+        }
+        return snapshot;
+    }
+
     void WavWriter::close()
     {
-        if (!file_.is_open())
+        if (!is_open())
             return;
 
         // Update header with final sizes
-        header_.finalize(samples_written_ * sizeof(float));
+        header_.finalize(samples_written_ * bytes_per_sample(format_));
 
         // Seek back and write final header
-        file_.seekp(0);
-        file_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
-        file_.close();
+        if (sequential_)
+        {
+            sequential_->patch(0, std::as_bytes(std::span(&header_, 1)));
+            sequential_->close();
+        }
+        else
+        {
+            file_.seekp(0);
+            file_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+            file_.close();
+        }
+
+        if (manifest_)
+        {
+            manifest_->add_range(0, std::as_bytes(std::span(&header_, 1)));
+            manifest_->close();
+        }
+    }
+
+    /// Read a range of mono samples back from a file written by WavWriter.
+    /// Samples past the end of the data are not returned. With a snapshot of
+    /// a file still being written, the staged bytes it holds are read too.
+    [[nodiscard]] IOResult<std::vector<float>> read_wav_samples(const std::filesystem::path &path,
+                                                                std::uint64_t first_sample,
+                                                                std::uint64_t count,
+                                                                const WavSnapshot *snapshot = nullptr)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return std::unexpected("Failed to open " + path.string());
+
+        WavHeader header;
+        if (snapshot)
+            header = snapshot->header;
+        else if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            return std::unexpected("Truncated WAV header in " + path.string());
+        const auto format = header.format();
+        if (!format)
+            return std::unexpected("Unsupported WAV encoding in " + path.string());
+
+        const auto width = bytes_per_sample(*format);
+        std::vector<float> samples(count);
+        std::vector<std::uint8_t> raw(*format == WavFormat::Float32 ? 0 : count * width);
+        char *target = raw.empty() ? reinterpret_cast<char *>(samples.data()) : reinterpret_cast<char *>(raw.data());
+
+        const auto begin = sizeof(WavHeader) + first_sample * width;
+        const auto length = count * width;
+        file.seekg(static_cast<std::streamoff>(begin));
+        file.read(target, static_cast<std::streamsize>(length));
+        auto available = static_cast<std::size_t>(file.gcount());
+
+        // Staged bytes supersede whatever the file holds at their offsets
+        if (snapshot && !snapshot->staged.empty())
+        {
+            const auto staged_end = snapshot->staged_offset + snapshot->staged.size();
+            const auto from = std::max<std::uint64_t>(begin, snapshot->staged_offset);
+            const auto to = std::min<std::uint64_t>(begin + length, staged_end);
+            if (from < to)
+            {
+                std::memcpy(target + (from - begin), snapshot->staged.data() + (from - snapshot->staged_offset),
+                            static_cast<std::size_t>(to - from));
+                available = std::max(available, static_cast<std::size_t>(to - begin));
+            }
+        }
+        const auto read = available / width;
+
+        if (*format == WavFormat::Pcm16)
+            convert::s16_to_f32({reinterpret_cast<const std::int16_t *>(raw.data()), read}, samples);
+        else if (*format == WavFormat::Pcm24)
+            convert::s24_to_f32(std::span(raw).first(read * width), samples);
+        samples.resize(read);
+        return samples;
+    }
+
+    // ============================================================================
+    // Transcript Writer
+    // ============================================================================
+
+    /// Markdown transcript for one session. Committed segments may arrive from
+    /// the post-processing thread, so appends are serialized internally.
+    /// Segments stay in memory so a later pass can revise them.
+    class TranscriptWriter
+    {
+    public:
+        static IOResult<std::unique_ptr<TranscriptWriter>> create(const std::filesystem::path &path,
+                                                                  std::string_view session_id);
+
+        /// Append one committed segment
+        void append(std::uint64_t segment_id, std::string_view text);
+
+        /// Replace a segment's text. The file is rewritten to a temporary and
+        /// renamed over the original, so readers never see a partial update.
+        /// Works after close(); a segment not yet appended takes the revision
+        /// when it arrives.
+        IOResult<void> revise(std::uint64_t segment_id, std::string_view text);
+
+        /// Flush and close; later appends are ignored
+        void close();
+
+        [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+    private:
+        explicit TranscriptWriter(std::filesystem::path path) : path_(std::move(path)) {}
+
+        using Text = memory::String<memory::Tag::Transcript>;
+
+        struct Segment
+        {
+            std::uint64_t id;
+            Text text;
+        };
+
+        std::filesystem::path path_;
+        std::mutex mutex_;
+        std::ofstream file_;
+        std::string header_;
+        memory::Vector<memory::Tag::Transcript, Segment> segments_;
+        memory::Vector<memory::Tag::Transcript, Segment> early_revisions_; // Revised before their live text was committed
+        bool closed_ = false;
+    };
+
+    IOResult<std::unique_ptr<TranscriptWriter>>
+    TranscriptWriter::create(const std::filesystem::path &path, std::string_view session_id)
+    {
+        auto writer = std::unique_ptr<TranscriptWriter>(new TranscriptWriter(path));
+        writer->file_.open(path, std::ios::trunc);
+        if (!writer->file_.is_open())
+        {
+            return std::unexpected("Failed to open transcript: " + path.string());
+        }
+
+        writer->header_ = "# Recording Session: " + std::string(session_id) + "\n\n---\n\n";
+        writer->file_ << writer->header_;
+        return writer;
+    }
+
+    void TranscriptWriter::append(std::uint64_t segment_id, std::string_view text)
+    {
+        std::lock_guard lock(mutex_);
+        if (!file_.is_open())
+            return;
+
+        Segment segment{segment_id, Text(text)};
+        auto early = std::ranges::find(early_revisions_, segment_id, &Segment::id);
+        if (early != early_revisions_.end())
+        {
+            segment.text = std::move(early->text);
+            early_revisions_.erase(early);
+        }
+
+        file_ << segment.text << " ";
+        file_.flush();
+        segments_.push_back(std::move(segment));
+    }
+
+    IOResult<void> TranscriptWriter::revise(std::uint64_t segment_id, std::string_view text)
+    {
+        std::lock_guard lock(mutex_);
+
+        auto segment = std::ranges::find(segments_, segment_id, &Segment::id);
+        if (segment == segments_.end())
+        {
+            if (!closed_)
+                early_revisions_.push_back({segment_id, Text(text)});
+            return {};
+        }
+        segment->text = text;
+
+        auto tmp = path_;
+        tmp += ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            out << header_;
+            for (const auto &s : segments_)
+                out << s.text << " ";
+            if (closed_)
+                out << "\n";
+            if (!out.flush())
+                return std::unexpected("Failed to write " + tmp.string());
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, path_, ec);
+        if (ec)
+            return std::unexpected("Failed to replace transcript: " + ec.message());
+
+        // Keep appending to the new file, not the unlinked one
+        if (file_.is_open())
+        {
+            file_.close();
+            file_.open(path_, std::ios::app);
+        }
+        return {};
+    }
+
+    void TranscriptWriter::close()
+    {
+        std::lock_guard lock(mutex_);
+        if (file_.is_open())
+        {
+            file_ << "\n";
+            file_.close();
+        }
+        closed_ = true;
+        early_revisions_.clear();
     }
 
 } // namespace harness::io
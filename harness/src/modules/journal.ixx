@@ -0,0 +1,595 @@
+// ============================================================================
+// TopNotchNotes Harness - Capture Journal Module
+// Records raw capture callbacks and commands with their timing, and replays
+// them through the live pipeline to reproduce stalls offline
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+export module harness:journal;
+
+import :audio;
+import :ringbuffer;
+
+export namespace harness::journal
+{
+
+    // ============================================================================
+    // Type Aliases
+    // ============================================================================
+
+    template <typename T>
+    using JournalResult = std::expected<T, std::string>;
+
+    // ============================================================================
+    // File Format
+    // ============================================================================
+    //
+    // FileHeader, then records back to back: RecordHeader + payload. Times are
+    // steady-clock nanoseconds since the journal was opened. A record cut off
+    // by a crash ends the journal; everything before it still replays.
+
+    enum class RecordKind : std::uint8_t
+    {
+        Audio = 1,   // One capture callback; count = samples, payload = encoded
+        Command = 2, // One command line as received; payload = the text
+        Gap = 3      // Samples the journal could not keep up with; no payload
+    };
+
+    struct FileHeader
+    {
+        char magic[8] = {'T', 'N', 'N', 'J', 'R', 'N', 'L', '\0'};
+        std::uint32_t version = 1;
+        std::uint32_t sample_rate = 48000;
+        std::uint32_t channels = 1;
+        std::uint32_t reserved = 0;
+        std::int64_t started_unix_ns = 0; // Wall clock when recording began
+    };
+
+    static_assert(sizeof(FileHeader) == 32, "FileHeader must be 32 bytes");
+
+    struct RecordHeader
+    {
+        RecordKind kind = RecordKind::Audio;
+        std::uint8_t reserved[3] = {};
+        std::uint32_t count = 0;
+        std::int64_t at_ns = 0;
+        std::uint32_t payload_bytes = 0;
+        std::uint32_t reserved2 = 0;
+    };
+
+    static_assert(sizeof(RecordHeader) == 24, "RecordHeader must be 24 bytes");
+
+    /// Largest records a writer produces: one callback that fit in its sample
+    /// ring, and a payload well above its encoding or any command line. A
+    /// reader takes anything bigger for corruption rather than allocate it.
+    inline constexpr std::uint32_t max_record_samples = 131072;
+    inline constexpr std::uint32_t max_record_bytes = 1u << 20;
+
+    /// One decoded record
+    struct Record
+    {
+        RecordKind kind = RecordKind::Audio;
+        std::chrono::nanoseconds at{0};
+        std::vector<float> samples;  // Audio
+        std::string command;         // Command
+        std::uint64_t gap_samples = 0; // Gap
+    };
+
+    // ============================================================================
+    // Sample Codec
+    // ============================================================================
+
+    /// Lossless and cheap: each sample's bit pattern is XORed with the previous
+    /// one and only the non-zero low bytes are kept. Neighbouring samples share
+    /// the sign, exponent and top mantissa bits, so most need two or three
+    /// bytes and digital silence needs none. A nibble per sample holds the
+    /// length, two samples to a control byte. Each block starts from zero.
+    void encode_samples(std::span<const float> samples, std::vector<std::uint8_t> &out)
+    {
+        std::uint32_t previous = 0;
+        for (std::size_t i = 0; i < samples.size(); i += 2)
+        {
+            const auto control = out.size();
+            out.push_back(0);
+            std::uint8_t lengths = 0;
+            for (std::size_t j = 0; j < 2 && i + j < samples.size(); ++j)
+            {
+                const auto bits = std::bit_cast<std::uint32_t>(samples[i + j]);
+                const auto delta = bits ^ previous;
+                previous = bits;
+
+                const auto length = static_cast<unsigned>(std::bit_width(delta) + 7) / 8;
+                lengths = static_cast<std::uint8_t>(lengths | (length << (4 * j)));
+                for (unsigned k = 0; k < length; ++k)
+                    out.push_back(static_cast<std::uint8_t>(delta >> (8 * k)));
+            }
+            out[control] = lengths;
+        }
+    }
+
+    /// Inverse of encode_samples; false if `bytes` does not hold exactly
+    /// out.size() samples
+    [[nodiscard]] bool decode_samples(std::span<const std::uint8_t> bytes, std::span<float> out) noexcept
+    {
+        std::uint32_t previous = 0;
+        std::size_t at = 0;
+        for (std::size_t i = 0; i < out.size(); i += 2)
+        {
+            if (at >= bytes.size())
+                return false;
+            const auto lengths = bytes[at++];
+            for (std::size_t j = 0; j < 2 && i + j < out.size(); ++j)
+            {
+                const unsigned length = (lengths >> (4 * j)) & 0xF;
+                if (length > 4 || bytes.size() - at < length)
+                    return false;
+                std::uint32_t delta = 0;
+                for (unsigned k = 0; k < length; ++k)
+                    delta |= std::uint32_t{bytes[at++]} << (8 * k);
+                previous ^= delta;
+                out[i + j] = std::bit_cast<float>(previous);
+            }
+        }
+        return at == bytes.size();
+    }
+
+    // ============================================================================
+    // Journal Writer
+    // ============================================================================
+
+    /// Records what the capture callback delivered and when, plus every
+    /// command line. The callback side only copies into lock-free rings; a
+    /// writer thread encodes and writes, so a slow disk shows up as Gap
+    /// records rather than as a stalled audio thread.
+    class JournalWriter final : public audio::CaptureTap
+    {
+    public:
+        static JournalResult<std::unique_ptr<JournalWriter>> create(const std::filesystem::path &path,
+                                                                    std::uint32_t sample_rate,
+                                                                    std::uint32_t channels);
+
+        /// Writes whatever is still queued
+        ~JournalWriter() override;
+
+        JournalWriter(const JournalWriter &) = delete;
+        JournalWriter &operator=(const JournalWriter &) = delete;
+
+        void on_capture(std::span<const float> samples,
+                        std::chrono::steady_clock::time_point at) noexcept override;
+
+        /// Any thread; ignored once closed
+        void record_command(std::string_view line,
+                            std::chrono::steady_clock::time_point at = std::chrono::steady_clock::now());
+
+        /// Stop the writer thread and flush. Idempotent.
+        void close();
+
+        [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+        [[nodiscard]] std::uint64_t bytes_written() const noexcept { return bytes_written_.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t samples_recorded() const noexcept { return samples_recorded_.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t samples_dropped() const noexcept { return samples_dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        /// One callback's worth of samples waiting in samples_
+        struct Block
+        {
+            std::int64_t at_ns = 0;
+            std::uint32_t samples = 0;
+            bool dropped = false; // Did not fit; only the count is kept
+        };
+
+        struct PendingCommand
+        {
+            std::int64_t at_ns = 0;
+            std::string line;
+        };
+
+        JournalWriter(const std::filesystem::path &path, std::chrono::steady_clock::time_point origin);
+
+        void run(std::stop_token stop);
+        void drain();
+        void write_record(RecordKind kind, std::int64_t at_ns, std::uint32_t count,
+                          std::span<const std::uint8_t> payload);
+
+        [[nodiscard]] std::int64_t since_origin(std::chrono::steady_clock::time_point at) const noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(at - origin_).count();
+        }
+
+        std::filesystem::path path_;
+        std::chrono::steady_clock::time_point origin_;
+        std::ofstream file_;
+
+        // Audio thread -> writer thread (~2.7 s of 48 kHz mono)
+        RingBuffer<float, max_record_samples> samples_;
+        RingBuffer<Block, 1024> blocks_;
+        std::atomic<std::uint64_t> overflowed_{0}; // Dropped when even blocks_ was full
+
+        std::mutex mutex_; // Guards commands_, closed_ and the file
+        std::deque<PendingCommand> commands_;
+        bool closed_ = false;
+
+        std::vector<float> scratch_;
+        std::vector<std::uint8_t> encoded_;
+
+        std::atomic<std::uint64_t> bytes_written_{0};
+        std::atomic<std::uint64_t> samples_recorded_{0};
+        std::atomic<std::uint64_t> samples_dropped_{0};
+
+        std::jthread writer_; // Last: started after everything above exists
+    };
+
+    // ============================================================================
+    // Journal Reader
+    // ============================================================================
+
+    class JournalReader
+    {
+    public:
+        static JournalResult<JournalReader> open(const std::filesystem::path &path);
+
+        [[nodiscard]] const FileHeader &header() const noexcept { return header_; }
+
+        /// Next record in file order, or nullopt at the end (including a
+        /// trailing record cut short)
+        [[nodiscard]] JournalResult<std::optional<Record>> next();
+
+    private:
+        std::filesystem::path path_;
+        std::ifstream file_;
+        FileHeader header_;
+        std::uint64_t file_bytes_ = 0;
+        std::vector<std::uint8_t> payload_;
+    };
+
+    // ============================================================================
+    // Replay
+    // ============================================================================
+
+    /// Where replayed records go. `audio` gets each callback's samples as they
+    /// were delivered. When replaying as fast as possible, `room` reports
+    /// whether that many samples would fit downstream and `drained` whether
+    /// all audio delivered so far was consumed, so a command lands after the
+    /// audio that preceded it (to within the frame being processed).
+    struct ReplaySink
+    {
+        std::function<void(std::span<const float>)> audio;
+        std::function<void(std::string_view)> command;
+        std::function<bool(std::size_t)> room;
+        std::function<bool()> drained;
+    };
+
+    struct ReplayStats
+    {
+        std::uint64_t audio_blocks = 0;
+        std::uint64_t samples = 0;
+        std::uint64_t commands = 0;
+        std::uint64_t gap_samples = 0;                 // Replayed as silence
+        std::chrono::nanoseconds max_lateness{0};      // Behind schedule, worst case
+        std::chrono::nanoseconds journal_duration{0};  // Time of the last record
+    };
+
+    /// Feed every record to `sink` in order. speed 1 keeps the recorded timing
+    /// (an overloaded pipeline drops samples just like it did live), 4 plays
+    /// four times faster, and 0 ignores timing and waits for `room` instead,
+    /// so nothing is dropped. Gaps become silence to keep sample positions.
+    JournalResult<ReplayStats> replay(JournalReader &reader, double speed, const ReplaySink &sink,
+                                      std::stop_token stop = {});
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    JournalWriter::JournalWriter(const std::filesystem::path &path, std::chrono::steady_clock::time_point origin)
+        : path_(path), origin_(origin)
+    {
+    }
+
+    JournalResult<std::unique_ptr<JournalWriter>> JournalWriter::create(const std::filesystem::path &path,
+                                                                        std::uint32_t sample_rate,
+                                                                        std::uint32_t channels)
+    {
+        if (auto parent = path.parent_path(); !parent.empty())
+        {
+            std::error_code error;
+            std::filesystem::create_directories(parent, error);
+        }
+
+        std::unique_ptr<JournalWriter> writer(new JournalWriter(path, std::chrono::steady_clock::now()));
+        writer->file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!writer->file_.is_open())
+            return std::unexpected("Failed to open capture journal: " + path.string());
+
+        FileHeader header;
+        header.sample_rate = sample_rate;
+        header.channels = channels;
+        header.started_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count();
+        writer->file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        writer->bytes_written_ = sizeof(header);
+
+        writer->writer_ = std::jthread([raw = writer.get()](std::stop_token stop)
+                                       { raw->run(stop); });
+        return writer;
+    }
+
+    JournalWriter::~JournalWriter()
+    {
+        close();
+    }
+
+    void JournalWriter::on_capture(std::span<const float> samples,
+                                   std::chrono::steady_clock::time_point at) noexcept
+    {
+        Block block{.at_ns = since_origin(at), .samples = static_cast<std::uint32_t>(samples.size())};
+        if (blocks_.full())
+        {
+            overflowed_.fetch_add(samples.size(), std::memory_order_relaxed);
+            return;
+        }
+        if (samples_.available() >= samples.size())
+            (void)samples_.push(samples);
+        else
+            block.dropped = true;
+        (void)blocks_.push(block);
+    }
+
+    void JournalWriter::record_command(std::string_view line, std::chrono::steady_clock::time_point at)
+    {
+        std::lock_guard lock(mutex_);
+        if (!closed_)
+            commands_.push_back({since_origin(at), std::string(line)});
+    }
+
+    void JournalWriter::close()
+    {
+        if (writer_.joinable())
+        {
+            writer_.request_stop();
+            writer_.join();
+        }
+        std::lock_guard lock(mutex_);
+        if (std::exchange(closed_, true))
+            return;
+        file_.flush();
+        file_.close();
+    }
+
+    void JournalWriter::run(std::stop_token stop)
+    {
+        // Polled rather than signalled: the audio thread must not touch a
+        // mutex or condition variable
+        while (!stop.stop_requested())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            drain();
+        }
+        drain();
+    }
+
+    void JournalWriter::drain()
+    {
+        std::lock_guard lock(mutex_);
+        if (closed_)
+            return;
+
+        // Commands are written in time order between the callbacks around them
+        auto write_commands_until = [this](std::int64_t at_ns)
+        {
+            while (!commands_.empty() && commands_.front().at_ns <= at_ns)
+            {
+                const auto &line = commands_.front().line;
+                write_record(RecordKind::Command, commands_.front().at_ns, static_cast<std::uint32_t>(line.size()),
+                             {reinterpret_cast<const std::uint8_t *>(line.data()), line.size()});
+                commands_.pop_front();
+            }
+        };
+
+        while (auto block = blocks_.pop())
+        {
+            write_commands_until(block->at_ns);
+            if (block->dropped)
+            {
+                write_record(RecordKind::Gap, block->at_ns, block->samples, {});
+                samples_dropped_.fetch_add(block->samples, std::memory_order_relaxed);
+                continue;
+            }
+
+            scratch_.resize(block->samples);
+            (void)samples_.pop(std::span<float>(scratch_));
+            encoded_.clear();
+            encode_samples(scratch_, encoded_);
+            write_record(RecordKind::Audio, block->at_ns, block->samples, encoded_);
+            samples_recorded_.fetch_add(block->samples, std::memory_order_relaxed);
+        }
+
+        if (const auto overflowed = overflowed_.exchange(0, std::memory_order_relaxed))
+        {
+            write_record(RecordKind::Gap, since_origin(std::chrono::steady_clock::now()),
+                         static_cast<std::uint32_t>(overflowed), {});
+            samples_dropped_.fetch_add(overflowed, std::memory_order_relaxed);
+        }
+        write_commands_until(std::numeric_limits<std::int64_t>::max());
+        file_.flush(); // A crash loses at most one poll interval
+    }
+
+    void JournalWriter::write_record(RecordKind kind, std::int64_t at_ns, std::uint32_t count,
+                                     std::span<const std::uint8_t> payload)
+    {
+        RecordHeader header{.kind = kind,
+                            .count = count,
+                            .at_ns = at_ns,
+                            .payload_bytes = static_cast<std::uint32_t>(payload.size())};
+        file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file_.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        bytes_written_.fetch_add(sizeof(header) + payload.size(), std::memory_order_relaxed);
+    }
+
+    JournalResult<JournalReader> JournalReader::open(const std::filesystem::path &path)
+    {
+        JournalReader reader;
+        reader.path_ = path;
+        reader.file_.open(path, std::ios::binary);
+        if (!reader.file_.is_open())
+            return std::unexpected("Failed to open capture journal: " + path.string());
+
+        if (!reader.file_.read(reinterpret_cast<char *>(&reader.header_), sizeof(FileHeader)) ||
+            std::string_view(reader.header_.magic, 7) != "TNNJRNL")
+            return std::unexpected("Not a capture journal: " + path.string());
+        if (reader.header_.version != 1)
+            return std::unexpected("Unsupported capture journal version " +
+                                   std::to_string(reader.header_.version) + " in " + path.string());
+        if (reader.header_.channels == 0)
+            return std::unexpected("Capture journal has no channels: " + path.string());
+
+        std::error_code ec;
+        reader.file_bytes_ = std::filesystem::file_size(path, ec);
+        if (ec)
+            return std::unexpected("Cannot size capture journal " + path.string() + ": " + ec.message());
+        return reader;
+    }
+
+    JournalResult<std::optional<Record>> JournalReader::next()
+    {
+        RecordHeader header;
+        if (!file_.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            return std::nullopt;
+
+        // Sizes are checked before anything is allocated from them. Audio
+        // takes at least one control byte per two samples.
+        const auto position = static_cast<std::uint64_t>(file_.tellg());
+        if (header.payload_bytes > max_record_bytes ||
+            (header.kind == RecordKind::Audio &&
+             (header.count > max_record_samples || header.count > 2ull * header.payload_bytes)))
+            return std::unexpected("Corrupt record header at byte " + std::to_string(position - sizeof(header)) +
+                                   " of " + path_.string());
+        if (header.payload_bytes > file_bytes_ - std::min(position, file_bytes_))
+            return std::nullopt; // Cut off by a crash
+
+        payload_.resize(header.payload_bytes);
+        if (!file_.read(reinterpret_cast<char *>(payload_.data()), static_cast<std::streamsize>(payload_.size())))
+            return std::nullopt;
+
+        Record record{.kind = header.kind, .at = std::chrono::nanoseconds(header.at_ns)};
+        switch (header.kind)
+        {
+        case RecordKind::Audio:
+            record.samples.resize(header.count);
+            if (!decode_samples(payload_, record.samples))
+                return std::unexpected("Corrupt audio record in " + path_.string());
+            break;
+        case RecordKind::Command:
+            record.command.assign(payload_.begin(), payload_.end());
+            break;
+        case RecordKind::Gap:
+            record.gap_samples = header.count;
+            break;
+        default:
+            return std::unexpected("Unknown record kind " + std::to_string(std::to_underlying(header.kind)) +
+                                   " in " + path_.string());
+        }
+        return record;
+    }
+
+    JournalResult<ReplayStats> replay(JournalReader &reader, double speed, const ReplaySink &sink,
+                                      std::stop_token stop)
+    {
+        using clock = std::chrono::steady_clock;
+        const auto started = clock::now();
+        const bool timed = speed > 0.0;
+        const auto frame_samples = std::size_t{1024} * reader.header().channels;
+
+        // Sleep until `due` in short steps so a stop request is noticed
+        auto wait_until = [&stop](clock::time_point due)
+        {
+            while (!stop.stop_requested())
+            {
+                const auto now = clock::now();
+                if (now >= due)
+                    return;
+                std::this_thread::sleep_for(std::min<clock::duration>(due - now, std::chrono::milliseconds(50)));
+            }
+        };
+        auto deliver = [&](std::span<const float> samples)
+        {
+            while (!timed && sink.room && !sink.room(samples.size()) && !stop.stop_requested())
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            sink.audio(samples);
+        };
+
+        ReplayStats stats;
+        std::vector<float> silence;
+        while (!stop.stop_requested())
+        {
+            auto record = reader.next();
+            if (!record)
+                return std::unexpected(record.error());
+            if (!*record)
+                break;
+
+            stats.journal_duration = std::max(stats.journal_duration, (*record)->at);
+            if (timed)
+            {
+                const auto due = started + std::chrono::duration_cast<clock::duration>(
+                                               std::chrono::duration<double, std::nano>(
+                                                   static_cast<double>((*record)->at.count()) / speed));
+                wait_until(due);
+                stats.max_lateness = std::max(stats.max_lateness,
+                                              std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - due));
+            }
+
+            switch ((*record)->kind)
+            {
+            case RecordKind::Audio:
+                deliver((*record)->samples);
+                ++stats.audio_blocks;
+                stats.samples += (*record)->samples.size();
+                break;
+            case RecordKind::Command:
+                while (!timed && sink.drained && !sink.drained() && !stop.stop_requested())
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                sink.command((*record)->command);
+                ++stats.commands;
+                break;
+            case RecordKind::Gap:
+                // In callback-sized pieces so the downstream ring can take them
+                for (auto left = (*record)->gap_samples; left > 0;)
+                {
+                    const auto piece = std::min<std::uint64_t>(left, frame_samples);
+                    silence.assign(piece, 0.0f);
+                    deliver(silence);
+                    left -= piece;
+                }
+                stats.gap_samples += (*record)->gap_samples;
+                break;
+            }
+        }
+        return stats;
+    }
+
+} // namespace harness::journal
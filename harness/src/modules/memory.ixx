@@ -0,0 +1,312 @@
+// ============================================================================
+// TopNotchNotes Harness - Memory Module
+// Tagged allocators for accounting, and the budget that decides when a
+// session has to degrade
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+export module harness:memory;
+
+import :metrics;
+
+export namespace harness::memory
+{
+
+    // ============================================================================
+    // Accounts
+    // ============================================================================
+
+    /// What an allocation is for. Decoder internals (PocketSphinx lattices)
+    /// allocate with malloc and only show up in the resident size.
+    enum class Tag : std::uint8_t
+    {
+        AsrQueue,   // Audio waiting for a decoder worker
+        Transcript, // Committed segments kept for revision
+        Count
+    };
+
+    [[nodiscard]] constexpr std::string_view to_string(Tag tag) noexcept
+    {
+        switch (tag)
+        {
+        case Tag::AsrQueue:
+            return "asr_queue";
+        case Tag::Transcript:
+            return "transcript";
+        case Tag::Count:
+            break;
+        }
+        return "unknown";
+    }
+
+    /// Live bytes under one tag and the most seen since reset_peak()
+    class Account
+    {
+    public:
+        void charge(std::size_t bytes) noexcept
+        {
+            const auto now = bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            auto peak = peak_.load(std::memory_order_relaxed);
+            while (now > peak && !peak_.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void release(std::size_t bytes) noexcept { bytes_.fetch_sub(bytes, std::memory_order_relaxed); }
+
+        [[nodiscard]] std::size_t bytes() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::size_t peak() const noexcept { return peak_.load(std::memory_order_relaxed); }
+
+        void reset_peak() noexcept { peak_.store(bytes(), std::memory_order_relaxed); }
+
+    private:
+        std::atomic<std::size_t> bytes_{0};
+        std::atomic<std::size_t> peak_{0};
+    };
+
+    inline Account &account(Tag tag) noexcept
+    {
+        static std::array<Account, static_cast<std::size_t>(Tag::Count)> accounts;
+        return accounts[static_cast<std::size_t>(tag)];
+    }
+
+    /// Bytes under every tag
+    [[nodiscard]] inline std::size_t tracked_bytes() noexcept
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(Tag::Count); ++i)
+            total += account(static_cast<Tag>(i)).bytes();
+        return total;
+    }
+
+    // ============================================================================
+    // Tagged Allocator
+    // ============================================================================
+
+    /// std::allocator that charges its tag's account. Stateless, so tagged
+    /// containers move and swap like standard ones.
+    template <typename T, Tag tag>
+    class Allocator
+    {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = Allocator<U, tag>;
+        };
+
+        Allocator() noexcept = default;
+
+        template <typename U>
+        Allocator(const Allocator<U, tag> &) noexcept
+        {
+        }
+
+        [[nodiscard]] T *allocate(std::size_t n)
+        {
+            T *p = std::allocator<T>{}.allocate(n);
+            account(tag).charge(n * sizeof(T));
+            return p;
+        }
+
+        void deallocate(T *p, std::size_t n) noexcept
+        {
+            account(tag).release(n * sizeof(T));
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U, tag> &) const noexcept
+        {
+            return true;
+        }
+    };
+
+    template <Tag tag>
+    using String = std::basic_string<char, std::char_traits<char>, Allocator<char, tag>>;
+
+    template <Tag tag, typename T>
+    using Vector = std::vector<T, Allocator<T, tag>>;
+
+    // ============================================================================
+    // Process
+    // ============================================================================
+
+    /// Resident set size, what the OOM killer looks at; 0 if unavailable
+    [[nodiscard]] inline std::size_t resident_bytes() noexcept
+    {
+        std::FILE *statm = std::fopen("/proc/self/statm", "r");
+        if (!statm)
+            return 0;
+        unsigned long size = 0, resident = 0;
+        const bool ok = std::fscanf(statm, "%lu %lu", &size, &resident) == 2;
+        std::fclose(statm);
+        return ok ? resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)) : 0;
+    }
+
+    /// Hand freed heap pages back to the system where the allocator allows it
+    inline void trim() noexcept
+    {
+#if defined(__GLIBC__)
+        ::malloc_trim(0);
+#endif
+    }
+
+    /// Copy the current figures into the metrics registry
+    inline void publish(std::size_t budget_bytes)
+    {
+        auto &registry = metrics::global();
+        static auto &asr_queue = registry.gauge("harness_memory_asr_queue_bytes", "Audio queued for decoding");
+        static auto &transcript =
+            registry.gauge("harness_memory_transcript_bytes", "Transcript segments held for revision");
+        static auto &resident = registry.gauge("harness_memory_resident_bytes", "Resident set size");
+        static auto &budget = registry.gauge("harness_memory_budget_bytes", "Configured budget, 0 if unlimited");
+        asr_queue.set(static_cast<double>(account(Tag::AsrQueue).bytes()));
+        transcript.set(static_cast<double>(account(Tag::Transcript).bytes()));
+        resident.set(static_cast<double>(resident_bytes()));
+        budget.set(static_cast<double>(budget_bytes));
+    }
+
+    // ============================================================================
+    // Budget
+    // ============================================================================
+
+    enum class Pressure : std::uint8_t
+    {
+        Normal,
+        Elevated, // Shed what can be rebuilt: buffers, partial hypotheses
+        Critical  // Also cut utterances short so decoders release their lattices
+    };
+
+    [[nodiscard]] constexpr std::string_view to_string(Pressure pressure) noexcept
+    {
+        switch (pressure)
+        {
+        case Pressure::Normal:
+            return "normal";
+        case Pressure::Elevated:
+            return "elevated";
+        case Pressure::Critical:
+            return "critical";
+        }
+        return "unknown";
+    }
+
+    /// Maps usage to a pressure level. Elevated from 85% of the limit and
+    /// critical at the limit; back to normal only below 75%, so a session
+    /// hovering at the threshold does not flap.
+    class Budget
+    {
+    public:
+        static constexpr double elevated_at = 0.85;
+        static constexpr double relaxed_below = 0.75;
+
+        /// `limit == 0` means unlimited: always Normal
+        explicit Budget(std::size_t limit = 0) noexcept : limit_(limit) {}
+
+        [[nodiscard]] std::size_t limit() const noexcept { return limit_; }
+        [[nodiscard]] Pressure level() const noexcept { return level_; }
+
+        Pressure evaluate(std::size_t used) noexcept
+        {
+            if (limit_ == 0)
+                return level_ = Pressure::Normal;
+
+            const double ratio = static_cast<double>(used) / static_cast<double>(limit_);
+            if (ratio >= 1.0)
+                level_ = Pressure::Critical;
+            else if (ratio >= elevated_at)
+                level_ = Pressure::Elevated;
+            else if (ratio < relaxed_below)
+                level_ = Pressure::Normal;
+            else if (level_ == Pressure::Critical)
+                level_ = Pressure::Elevated;
+            return level_;
+        }
+
+    private:
+        std::size_t limit_;
+        Pressure level_ = Pressure::Normal;
+    };
+
+    // ============================================================================
+    // Watcher
+    // ============================================================================
+
+    /// Samples the resident size against a budget twice a second on its own
+    /// low-priority thread, and trims the heap there when pressure rises, so
+    /// neither the /proc read nor malloc_trim stalls the audio path. The
+    /// session only reads level().
+    class Watcher
+    {
+    public:
+        explicit Watcher(std::size_t limit, std::chrono::milliseconds period = std::chrono::milliseconds(500))
+            : budget_(limit),
+              period_(period)
+        {
+            thread_ = std::jthread([this](std::stop_token stop)
+                                   { run(stop); });
+        }
+
+        Watcher(const Watcher &) = delete;
+        Watcher &operator=(const Watcher &) = delete;
+
+        [[nodiscard]] Pressure level() const noexcept { return level_.load(std::memory_order_acquire); }
+        [[nodiscard]] std::size_t resident() const noexcept { return resident_.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::size_t peak() const noexcept { return peak_.load(std::memory_order_relaxed); }
+
+    private:
+        void run(std::stop_token stop)
+        {
+            // Linux applies a nice value to the calling thread alone
+            (void)::setpriority(PRIO_PROCESS, static_cast<id_t>(::gettid()), 10);
+
+            std::mutex mutex;
+            std::condition_variable_any wake;
+            std::unique_lock lock(mutex);
+            do
+            {
+                const auto used = resident_bytes();
+                resident_.store(used, std::memory_order_relaxed);
+                peak_.store(std::max(peak_.load(std::memory_order_relaxed), used), std::memory_order_relaxed);
+                const auto level = budget_.evaluate(used);
+                if (level > level_.exchange(level, std::memory_order_acq_rel))
+                    trim();
+            } while (!wake.wait_for(lock, stop, period_, [] { return false; }) && !stop.stop_requested());
+        }
+
+        Budget budget_; // Watcher thread only
+        std::chrono::milliseconds period_;
+        std::atomic<Pressure> level_{Pressure::Normal};
+        std::atomic<std::size_t> resident_{0};
+        std::atomic<std::size_t> peak_{0};
+
+        std::jthread thread_; // Last: started after everything above exists
+    };
+
+} // namespace harness::memory
@@ -0,0 +1,330 @@
+// ============================================================================
+// TopNotchNotes Harness - Metrics Module
+// Lock-free counters, gauges and histograms with Prometheus text exposition
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module harness:metrics;
+
+export namespace harness::metrics
+{
+
+    namespace detail
+    {
+        /// Updates go to one of these per metric, picked per thread, so
+        /// threads updating the same metric rarely share a cache line
+        inline constexpr std::size_t shards = 8;
+
+        [[nodiscard]] inline std::size_t shard_index() noexcept
+        {
+            static std::atomic<std::size_t> next{0};
+            thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % shards;
+            return index;
+        }
+
+        struct alignas(64) PaddedCount
+        {
+            std::atomic<std::uint64_t> value{0};
+        };
+    } // namespace detail
+
+    // ============================================================================
+    // Counter
+    // ============================================================================
+
+    /// Monotonic count, sharded per thread and summed on read
+    class Counter
+    {
+    public:
+        void add(std::uint64_t amount = 1) noexcept
+        {
+            shards_[detail::shard_index()].value.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t value() const noexcept
+        {
+            std::uint64_t total = 0;
+            for (const auto &shard : shards_)
+                total += shard.value.load(std::memory_order_relaxed);
+            return total;
+        }
+
+    private:
+        std::array<detail::PaddedCount, detail::shards> shards_;
+    };
+
+    // ============================================================================
+    // Gauge
+    // ============================================================================
+
+    /// Current value of something that goes up and down (queue depth, RTF)
+    class Gauge
+    {
+    public:
+        void set(double value) noexcept { value_.store(value, std::memory_order_relaxed); }
+        void add(double delta) noexcept { value_.fetch_add(delta, std::memory_order_relaxed); }
+
+        [[nodiscard]] double value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> value_{0.0};
+    };
+
+    // ============================================================================
+    // Histogram
+    // ============================================================================
+
+    /// Merged view of a histogram at one point in time
+    struct HistogramSnapshot
+    {
+        std::vector<std::uint64_t> buckets;
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+
+        /// Upper bound of the bucket holding quantile `q` (0..1)
+        [[nodiscard]] std::uint64_t quantile(double q) const noexcept;
+    };
+
+    /// HDR-style histogram of non-negative integers (typically nanoseconds).
+    /// Values below 32 get exact buckets; above that each power of two is
+    /// split into 16 linear buckets, so a bucket is at most ~6% wide. Values
+    /// past 2^40 (~18 minutes in ns) land in the last bucket.
+    class Histogram
+    {
+    public:
+        static constexpr unsigned sub_bits = 4;
+        static constexpr std::uint64_t sub_count = std::uint64_t{1} << sub_bits;
+        static constexpr unsigned max_bits = 40;
+        static constexpr std::size_t bucket_count = (max_bits - sub_bits) * sub_count + sub_count;
+
+        [[nodiscard]] static constexpr std::size_t bucket_of(std::uint64_t value) noexcept
+        {
+            value = std::min(value, (std::uint64_t{1} << max_bits) - 1);
+            if (value < 2 * sub_count)
+                return static_cast<std::size_t>(value);
+            const auto shift = static_cast<unsigned>(std::bit_width(value)) - (sub_bits + 1);
+            return static_cast<std::size_t>(sub_count * shift + (value >> shift));
+        }
+
+        /// Largest value that lands in `bucket`
+        [[nodiscard]] static constexpr std::uint64_t upper_bound(std::size_t bucket) noexcept
+        {
+            if (bucket < 2 * sub_count)
+                return bucket;
+            const auto shift = static_cast<unsigned>(bucket / sub_count) - 1;
+            const auto top = bucket % sub_count + sub_count;
+            return ((top + 1) << shift) - 1;
+        }
+
+        void record(std::uint64_t value) noexcept
+        {
+            auto &shard = *shards_[detail::shard_index()];
+            shard.buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+            shard.count.fetch_add(1, std::memory_order_relaxed);
+            shard.sum.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        /// Merge the shards. Updates racing with the read may be half counted
+        /// (bucket seen, count not yet), which a scrape tolerates.
+        [[nodiscard]] HistogramSnapshot snapshot() const
+        {
+            HistogramSnapshot merged;
+            merged.buckets.assign(bucket_count, 0);
+            for (const auto &shard : shards_)
+            {
+                for (std::size_t i = 0; i < bucket_count; ++i)
+                    merged.buckets[i] += shard->buckets[i].load(std::memory_order_relaxed);
+                merged.count += shard->count.load(std::memory_order_relaxed);
+                merged.sum += shard->sum.load(std::memory_order_relaxed);
+            }
+            return merged;
+        }
+
+    private:
+        struct alignas(64) Shard
+        {
+            std::array<std::atomic<std::uint64_t>, bucket_count> buckets{};
+            std::atomic<std::uint64_t> count{0};
+            std::atomic<std::uint64_t> sum{0};
+        };
+
+        // Allocated up front: ~5 KiB per shard
+        std::array<std::unique_ptr<Shard>, detail::shards> shards_ = []
+        {
+            std::array<std::unique_ptr<Shard>, detail::shards> shards;
+            for (auto &shard : shards)
+                shard = std::make_unique<Shard>();
+            return shards;
+        }();
+    };
+
+    std::uint64_t HistogramSnapshot::quantile(double q) const noexcept
+    {
+        if (count == 0)
+            return 0;
+        const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return Histogram::upper_bound(i);
+        }
+        return Histogram::upper_bound(buckets.size() - 1);
+    }
+
+    // ============================================================================
+    // Registry
+    // ============================================================================
+
+    /// Named metrics. Registration takes a lock and is meant for setup; the
+    /// returned references stay valid for the registry's lifetime, and
+    /// updating through them never locks. Registering a name again returns
+    /// the existing metric.
+    class Registry
+    {
+    public:
+        /// `scale` converts the recorded integers to the exposed unit, e.g.
+        /// 1e-9 for nanoseconds recorded into a *_seconds_total counter
+        Counter &counter(std::string_view name, std::string_view help, double scale = 1.0);
+        Gauge &gauge(std::string_view name, std::string_view help);
+        Histogram &histogram(std::string_view name, std::string_view help, double scale = 1e-9);
+
+        /// Prometheus text exposition format 0.0.4
+        [[nodiscard]] std::string render() const;
+
+    private:
+        enum class Kind : std::uint8_t
+        {
+            Counter,
+            Gauge,
+            Histogram
+        };
+
+        struct Entry
+        {
+            std::string name;
+            std::string help;
+            Kind kind;
+            double scale = 1.0;
+            std::unique_ptr<Counter> counter;
+            std::unique_ptr<Gauge> gauge;
+            std::unique_ptr<Histogram> histogram;
+        };
+
+        Entry &find_or_add(std::string_view name, std::string_view help, Kind kind, double scale);
+
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<Entry>> entries_;
+    };
+
+    Registry::Entry &Registry::find_or_add(std::string_view name, std::string_view help, Kind kind, double scale)
+    {
+        std::lock_guard lock(mutex_);
+        for (auto &entry : entries_)
+        {
+            if (entry->name == name && entry->kind == kind)
+                return *entry;
+        }
+        auto &entry = *entries_.emplace_back(std::make_unique<Entry>(
+            Entry{.name = std::string(name), .help = std::string(help), .kind = kind, .scale = scale}));
+        switch (kind)
+        {
+        case Kind::Counter:
+            entry.counter = std::make_unique<Counter>();
+            break;
+        case Kind::Gauge:
+            entry.gauge = std::make_unique<Gauge>();
+            break;
+        case Kind::Histogram:
+            entry.histogram = std::make_unique<Histogram>();
+            break;
+        }
+        return entry;
+    }
+
+    Counter &Registry::counter(std::string_view name, std::string_view help, double scale)
+    {
+        return *find_or_add(name, help, Kind::Counter, scale).counter;
+    }
+
+    Gauge &Registry::gauge(std::string_view name, std::string_view help)
+    {
+        return *find_or_add(name, help, Kind::Gauge, 1.0).gauge;
+    }
+
+    Histogram &Registry::histogram(std::string_view name, std::string_view help, double scale)
+    {
+        return *find_or_add(name, help, Kind::Histogram, scale).histogram;
+    }
+
+    std::string Registry::render() const
+    {
+        std::lock_guard lock(mutex_);
+        std::string text;
+        auto out = std::back_inserter(text);
+        for (const auto &entry : entries_)
+        {
+            constexpr std::string_view kinds[] = {"counter", "gauge", "histogram"};
+            std::format_to(out, "# HELP {} {}\n# TYPE {} {}\n", entry->name, entry->help, entry->name,
+                           kinds[static_cast<std::size_t>(entry->kind)]);
+            switch (entry->kind)
+            {
+            case Kind::Counter:
+                if (entry->scale == 1.0)
+                    std::format_to(out, "{} {}\n", entry->name, entry->counter->value());
+                else
+                    std::format_to(out, "{} {}\n", entry->name,
+                                   static_cast<double>(entry->counter->value()) * entry->scale);
+                break;
+            case Kind::Gauge:
+                std::format_to(out, "{} {}\n", entry->name, entry->gauge->value());
+                break;
+            case Kind::Histogram:
+            {
+                // Cumulative buckets at every second power of two from 2^10
+                // (~1 us in ns); each is an exact bucket boundary
+                const auto snapshot = entry->histogram->snapshot();
+                std::uint64_t cumulative = 0;
+                std::size_t next = 0;
+                for (unsigned bits = 10; bits <= Histogram::max_bits; bits += 2)
+                {
+                    const auto bound = std::uint64_t{1} << bits;
+                    for (; next < Histogram::bucket_of(bound); ++next)
+                        cumulative += snapshot.buckets[next];
+                    std::format_to(out, "{}_bucket{{le=\"{}\"}} {}\n", entry->name,
+                                   static_cast<double>(bound) * entry->scale, cumulative);
+                }
+                std::format_to(out, "{}_bucket{{le=\"+Inf\"}} {}\n{}_sum {}\n{}_count {}\n", entry->name,
+                               snapshot.count, entry->name, static_cast<double>(snapshot.sum) * entry->scale,
+                               entry->name, snapshot.count);
+                break;
+            }
+            }
+        }
+        return text;
+    }
+
+    /// Registry shared by the whole harness
+    inline Registry &global()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+} // namespace harness::metrics
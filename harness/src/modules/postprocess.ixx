@@ -0,0 +1,438 @@
+// ============================================================================
+// TopNotchNotes Harness - Transcript Post-Processing Module
+// Streaming punctuation and truecasing for committed transcript segments
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module harness:postprocess;
+
+export namespace harness::postprocess
+{
+
+    // ============================================================================
+    // Type Aliases
+    // ============================================================================
+
+    template <typename T>
+    using PostResult = std::expected<T, std::string>;
+
+    // ============================================================================
+    // Model File Layout (written by scripts/build_punct_model.py)
+    // ============================================================================
+
+    inline constexpr std::uint32_t model_magic = 0x4D504E54; // "TNPM"
+    inline constexpr std::uint32_t model_version = 1;
+
+    struct ModelHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t entry_count;
+        std::uint32_t strings_size;
+    };
+
+    /// Per-word statistics. Probabilities are fixed point, 65535 == 1.0.
+    /// Entries are sorted by hash; the string blob follows the entry table.
+    struct ModelEntry
+    {
+        std::uint64_t hash;            // FNV-1a of the lowercase word
+        std::uint16_t comma_after;     // P(word is followed by a comma)
+        std::uint16_t period_after;    // P(word ends a sentence)
+        std::uint16_t sentence_start;  // P(word starts a sentence)
+        std::uint16_t question_start;  // P(a sentence starting with word is a question)
+        std::uint32_t case_offset;     // Truecased form in the string blob
+        std::uint16_t case_length;     // 0 if the lowercase form is canonical
+        std::uint16_t reserved;
+    };
+
+    static_assert(sizeof(ModelHeader) == 16, "ModelHeader layout is part of the file format");
+    static_assert(sizeof(ModelEntry) == 24, "ModelEntry layout is part of the file format");
+
+    /// 64-bit FNV-1a, shared with the model builder
+    [[nodiscard]] constexpr std::uint64_t word_hash(std::string_view word) noexcept
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : word)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // ============================================================================
+    // Punctuation Model
+    // ============================================================================
+
+    /// Read-only, memory-mapped word table. Loading is O(1); pages are
+    /// faulted in on first lookup and shared between processes.
+    class PunctuationModel
+    {
+    public:
+        static PostResult<std::shared_ptr<const PunctuationModel>> load(const std::filesystem::path &path);
+
+        ~PunctuationModel();
+
+        PunctuationModel(const PunctuationModel &) = delete;
+        PunctuationModel &operator=(const PunctuationModel &) = delete;
+
+        /// Look up a lowercase word, nullptr if unknown
+        [[nodiscard]] const ModelEntry *find(std::string_view word) const noexcept;
+
+        /// Truecased spelling of an entry (empty if lowercase is canonical)
+        [[nodiscard]] std::string_view cased(const ModelEntry &entry) const noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+    private:
+        PunctuationModel(void *base, std::size_t map_size, std::span<const ModelEntry> entries,
+                         std::string_view strings);
+
+        void *base_ = nullptr;
+        std::size_t map_size_ = 0;
+        std::span<const ModelEntry> entries_;
+        std::string_view strings_;
+    };
+
+    PunctuationModel::PunctuationModel(void *base, std::size_t map_size,
+                                       std::span<const ModelEntry> entries, std::string_view strings)
+        : base_(base),
+          map_size_(map_size),
+          entries_(entries),
+          strings_(strings)
+    {
+    }
+
+    PunctuationModel::~PunctuationModel()
+    {
+        if (base_)
+        {
+            munmap(base_, map_size_);
+        }
+    }
+
+    PostResult<std::shared_ptr<const PunctuationModel>>
+    PunctuationModel::load(const std::filesystem::path &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return std::unexpected("Punctuation model not found: " + path.string());
+        }
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(ModelHeader))
+        {
+            ::close(fd);
+            return std::unexpected("Punctuation model is truncated: " + path.string());
+        }
+
+        const auto map_size = static_cast<std::size_t>(st.st_size);
+        void *base = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file alive
+        if (base == MAP_FAILED)
+        {
+            return std::unexpected("Failed to map punctuation model");
+        }
+
+        ModelHeader header;
+        std::memcpy(&header, base, sizeof(header));
+        const std::size_t table_bytes = std::size_t{header.entry_count} * sizeof(ModelEntry);
+        if (header.magic != model_magic || header.version != model_version ||
+            sizeof(ModelHeader) + table_bytes + header.strings_size > map_size)
+        {
+            munmap(base, map_size);
+            return std::unexpected("Punctuation model header mismatch: " + path.string());
+        }
+
+        const auto *bytes = static_cast<const char *>(base);
+        std::span entries(reinterpret_cast<const ModelEntry *>(bytes + sizeof(ModelHeader)),
+                          header.entry_count);
+        std::string_view strings(bytes + sizeof(ModelHeader) + table_bytes, header.strings_size);
+
+        return std::shared_ptr<const PunctuationModel>(
+            new PunctuationModel(base, map_size, entries, strings));
+    }
+
+    const ModelEntry *PunctuationModel::find(std::string_view word) const noexcept
+    {
+        const auto hash = word_hash(word);
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), hash,
+                                   [](const ModelEntry &entry, std::uint64_t h)
+                                   { return entry.hash < h; });
+        return (it != entries_.end() && it->hash == hash) ? &*it : nullptr;
+    }
+
+    std::string_view PunctuationModel::cased(const ModelEntry &entry) const noexcept
+    {
+        if (entry.case_length == 0 ||
+            std::size_t{entry.case_offset} + entry.case_length > strings_.size())
+        {
+            return {};
+        }
+        return strings_.substr(entry.case_offset, entry.case_length);
+    }
+
+    // ============================================================================
+    // Punctuator
+    // ============================================================================
+
+    /// Decision thresholds for the table model
+    struct PunctuatorConfig
+    {
+        float sentence_threshold = 0.5f;
+        float comma_threshold = 0.5f;
+        std::size_t min_sentence_words = 3; // No breaks inside very short runs
+    };
+
+    namespace detail
+    {
+        [[nodiscard]] constexpr float probability(std::uint16_t fixed) noexcept
+        {
+            return static_cast<float>(fixed) / 65535.0f;
+        }
+
+        [[nodiscard]] constexpr bool is_pronoun_i(std::string_view word) noexcept
+        {
+            return word == "i" || word.starts_with("i'");
+        }
+
+        inline void capitalize_first(std::string &out, std::size_t from)
+        {
+            if (from < out.size() && out[from] >= 'a' && out[from] <= 'z')
+                out[from] = static_cast<char>(out[from] - 'a' + 'A');
+        }
+    } // namespace detail
+
+    /// Punctuate and truecase one committed segment of lowercase ASR output.
+    /// With no model only the rules apply: capitalized sentence start,
+    /// "I" and a final period.
+    [[nodiscard]] inline std::string punctuate(const PunctuationModel *model, std::string_view raw,
+                                               const PunctuatorConfig &config = {})
+    {
+        struct Word
+        {
+            std::string_view text;
+            const ModelEntry *entry;
+        };
+
+        // Tokenize once, resolving every word against the table
+        std::vector<Word> words;
+        for (std::size_t pos = 0; pos < raw.size();)
+        {
+            auto start = raw.find_first_not_of(' ', pos);
+            if (start == std::string_view::npos)
+                break;
+            auto end = std::min(raw.find(' ', start), raw.size());
+            auto text = raw.substr(start, end - start);
+            words.push_back({text, model ? model->find(text) : nullptr});
+            pos = end;
+        }
+
+        std::string out;
+        out.reserve(raw.size() + raw.size() / 8 + 2);
+
+        std::size_t sentence_words = 0;
+        bool question = false;
+        for (std::size_t i = 0; i < words.size(); ++i)
+        {
+            const auto &word = words[i];
+            const std::size_t word_start = out.size() + (out.empty() ? 0 : 1);
+            if (!out.empty())
+                out += ' ';
+
+            if (sentence_words == 0)
+                question = word.entry &&
+                           detail::probability(word.entry->question_start) >= config.sentence_threshold;
+
+            auto cased = word.entry ? model->cased(*word.entry) : std::string_view{};
+            if (!cased.empty())
+                out += cased;
+            else if (detail::is_pronoun_i(word.text))
+                (out += 'I') += word.text.substr(1);
+            else
+                out += word.text;
+
+            if (sentence_words == 0)
+                detail::capitalize_first(out, word_start);
+            ++sentence_words;
+
+            if (i + 1 == words.size())
+                break;
+
+            // Noisy-or of "this word ends a sentence" and "next word starts one"
+            const auto &next = words[i + 1];
+            const float p_end = word.entry ? detail::probability(word.entry->period_after) : 0.0f;
+            const float p_start = next.entry ? detail::probability(next.entry->sentence_start) : 0.0f;
+            const float p_break = 1.0f - (1.0f - p_end) * (1.0f - p_start);
+
+            if (sentence_words >= config.min_sentence_words && p_break >= config.sentence_threshold)
+            {
+                out += question ? '?' : '.';
+                sentence_words = 0;
+            }
+            else if (word.entry && detail::probability(word.entry->comma_after) >= config.comma_threshold)
+            {
+                out += ',';
+            }
+        }
+
+        if (!words.empty())
+            out += question ? '?' : '.';
+        return out;
+    }
+
+    // ============================================================================
+    // Post-Processor Worker
+    // ============================================================================
+
+    /// Runs the punctuator on committed segments off the audio thread.
+    /// Segments are delivered in submission order. A segment that waited
+    /// longer than `max_latency` skips the table model and gets the rules
+    /// only, so a backlog drains quickly instead of growing.
+    class PostProcessor
+    {
+    public:
+        /// Receives (segment id, finished text) on the worker thread
+        using Callback = std::function<void(std::uint64_t, std::string)>;
+
+        PostProcessor(std::shared_ptr<const PunctuationModel> model, Callback callback,
+                      std::chrono::milliseconds max_latency = std::chrono::milliseconds(250));
+        ~PostProcessor();
+
+        PostProcessor(const PostProcessor &) = delete;
+        PostProcessor &operator=(const PostProcessor &) = delete;
+        PostProcessor(PostProcessor &&) = delete;
+        PostProcessor &operator=(PostProcessor &&) = delete;
+
+        /// Queue a segment (never blocks on processing)
+        void submit(std::uint64_t segment_id, std::string text);
+
+        /// Block until every submitted segment has been delivered
+        void flush();
+
+        [[nodiscard]] std::size_t processed() const noexcept { return processed_.load(); }
+        [[nodiscard]] std::size_t late() const noexcept { return late_.load(); }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Job
+        {
+            std::uint64_t id;
+            std::string text;
+            Clock::time_point submitted;
+        };
+
+        void run(std::stop_token stop);
+
+        std::shared_ptr<const PunctuationModel> model_;
+        Callback callback_;
+        std::chrono::milliseconds max_latency_;
+
+        std::mutex mutex_;
+        std::condition_variable_any cv_;
+        std::condition_variable_any idle_cv_;
+        std::deque<Job> queue_;
+        bool busy_ = false;
+
+        std::atomic<std::size_t> processed_{0};
+        std::atomic<std::size_t> late_{0};
+
+        std::jthread worker_;
+    };
+
+    PostProcessor::PostProcessor(std::shared_ptr<const PunctuationModel> model, Callback callback,
+                                 std::chrono::milliseconds max_latency)
+        : model_(std::move(model)),
+          callback_(std::move(callback)),
+          max_latency_(max_latency)
+    {
+        worker_ = std::jthread([this](std::stop_token stop)
+                               { run(stop); });
+    }
+
+    PostProcessor::~PostProcessor()
+    {
+        flush();
+        worker_.request_stop();
+        cv_.notify_all();
+    }
+
+    void PostProcessor::submit(std::uint64_t segment_id, std::string text)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back({segment_id, std::move(text), Clock::now()});
+        }
+        cv_.notify_one();
+    }
+
+    void PostProcessor::flush()
+    {
+        std::unique_lock lock(mutex_);
+        idle_cv_.wait(lock, [this]
+                      { return queue_.empty() && !busy_; });
+    }
+
+    void PostProcessor::run(std::stop_token stop)
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(mutex_);
+                if (!cv_.wait(lock, stop, [this]
+                              { return !queue_.empty(); }))
+                {
+                    return; // Stop requested with nothing queued
+                }
+                job = std::move(queue_.front());
+                queue_.pop_front();
+                busy_ = true;
+            }
+
+            const bool is_late = Clock::now() - job.submitted > max_latency_;
+            if (is_late)
+                ++late_;
+
+            auto text = punctuate(is_late ? nullptr : model_.get(), job.text);
+            if (callback_)
+                callback_(job.id, std::move(text));
+            ++processed_;
+
+            {
+                std::lock_guard lock(mutex_);
+                busy_ = false;
+            }
+            idle_cv_.notify_all();
+        }
+    }
+
+} // namespace harness::postprocess
@@ -0,0 +1,299 @@
+// ============================================================================
+// TopNotchNotes Harness - Preview Module
+// Min/max/RMS waveform decimation and log-mel spectrogram slices for the UI
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+export module harness:preview;
+
+import :dsp;
+
+export namespace harness::preview
+{
+
+    // ============================================================================
+    // Type Aliases
+    // ============================================================================
+
+    using AudioFrame = std::span<const float>;
+
+    // ============================================================================
+    // Preview Configuration
+    // ============================================================================
+
+    struct PreviewConfig
+    {
+        std::uint32_t sample_rate = 48000;
+        std::uint32_t columns_per_second = 100; // Waveform pixel columns per second
+        std::uint32_t columns_per_packet = 10;  // Columns batched per emitted packet (~100ms)
+        bool enable_spectrum = true;
+        std::uint32_t spectrum_hz = 25; // Spectrogram slices per second
+        std::uint32_t fft_size = 1024;
+        std::uint32_t mel_bands = 40;
+        float min_hz = 60.0f;
+        float max_hz = 8000.0f;
+        float floor_db = -100.0f; // Maps to byte 0 in spectrum slices
+    };
+
+    // ============================================================================
+    // Waveform Decimator
+    // ============================================================================
+
+    /// Bytes per packed waveform column: int8 min, int8 max, uint8 rms
+    inline constexpr std::size_t bytes_per_column = 3;
+
+    /// Reduces audio to one min/max/RMS triple per pixel column.
+    /// Columns are packed as 3 bytes each so 100 columns/s costs 300 B/s.
+    class WaveformDecimator
+    {
+    public:
+        explicit WaveformDecimator(std::size_t samples_per_column)
+            : samples_per_column_(std::max<std::size_t>(samples_per_column, 1))
+        {
+            reset_bucket();
+        }
+
+        /// Accumulate a frame, appending every completed column to `out`
+        /// Returns the number of columns appended
+        std::size_t push(AudioFrame frame, std::vector<std::uint8_t> &out)
+        {
+            std::size_t produced = 0;
+            std::size_t offset = 0;
+
+            while (offset < frame.size())
+            {
+                std::size_t take = std::min(samples_per_column_ - count_, frame.size() - offset);
+                auto chunk = frame.subspan(offset, take);
+
+                // Branch-free reductions over the chunk vectorize cleanly
+                float lo = min_, hi = max_, sum = sum_squares_;
+                for (float s : chunk)
+                {
+                    lo = std::min(lo, s);
+                    hi = std::max(hi, s);
+                    sum += s * s;
+                }
+                min_ = lo;
+                max_ = hi;
+                sum_squares_ = sum;
+                count_ += take;
+                offset += take;
+
+                if (count_ == samples_per_column_)
+                {
+                    emit_column(out);
+                    ++produced;
+                }
+            }
+
+            return produced;
+        }
+
+        void reset() noexcept { reset_bucket(); }
+
+    private:
+        static std::uint8_t quantize_signed(float v) noexcept
+        {
+            auto q = static_cast<std::int8_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 127.0f));
+            return static_cast<std::uint8_t>(q);
+        }
+
+        void emit_column(std::vector<std::uint8_t> &out)
+        {
+            float rms = std::sqrt(sum_squares_ / static_cast<float>(count_));
+            out.push_back(quantize_signed(min_));
+            out.push_back(quantize_signed(max_));
+            out.push_back(static_cast<std::uint8_t>(std::lround(std::clamp(rms, 0.0f, 1.0f) * 255.0f)));
+            reset_bucket();
+        }
+
+        void reset_bucket() noexcept
+        {
+            min_ = std::numeric_limits<float>::max();
+            max_ = std::numeric_limits<float>::lowest();
+            sum_squares_ = 0.0f;
+            count_ = 0;
+        }
+
+        std::size_t samples_per_column_;
+        std::size_t count_ = 0;
+        float min_ = 0.0f;
+        float max_ = 0.0f;
+        float sum_squares_ = 0.0f;
+    };
+
+    // ============================================================================
+    // Spectrogram Slicer
+    // ============================================================================
+
+    /// Produces a log-mel slice (one byte per band) at a fixed rate from the
+    /// most recent fft_size samples. One 1024-point real FFT per slice at 25 Hz
+    /// is well under 1% of a core.
+    class SpectrogramSlicer
+    {
+    public:
+        explicit SpectrogramSlicer(const PreviewConfig &config)
+            : fft_(config.fft_size),
+              filterbank_(fft_.size(), config.sample_rate, config.mel_bands,
+                          config.min_hz, config.max_hz),
+              window_(dsp::hann_window(fft_.size())),
+              history_(fft_.size(), 0.0f),
+              windowed_(fft_.size()),
+              spec_re_(fft_.bins()),
+              spec_im_(fft_.bins()),
+              power_(fft_.bins()),
+              mel_(config.mel_bands),
+              hop_(std::max<std::size_t>(config.sample_rate / std::max<std::uint32_t>(config.spectrum_hz, 1), 1)),
+              floor_db_(config.floor_db)
+        {
+            // Normalize so a full-scale sine reads ~0 dB
+            float window_sum = 0.0f;
+            for (float w : window_)
+                window_sum += w;
+            float amplitude_scale = 2.0f / window_sum;
+            power_scale_ = amplitude_scale * amplitude_scale;
+        }
+
+        [[nodiscard]] std::size_t bands() const noexcept { return filterbank_.bands(); }
+
+        /// Feed a frame, appending bands() bytes to `out` for each completed slice
+        /// Returns the number of slices appended
+        std::size_t push(AudioFrame frame, std::vector<std::uint8_t> &out)
+        {
+            std::size_t produced = 0;
+            for (float s : frame)
+            {
+                history_[write_pos_] = s;
+                write_pos_ = (write_pos_ + 1) % history_.size();
+                if (++since_slice_ >= hop_)
+                {
+                    since_slice_ = 0;
+                    compute_slice(out);
+                    ++produced;
+                }
+            }
+            return produced;
+        }
+
+    private:
+        void compute_slice(std::vector<std::uint8_t> &out)
+        {
+            // Unroll the circular history (oldest first) while applying the window
+            const std::size_t n = history_.size();
+            const std::size_t tail = n - write_pos_;
+            for (std::size_t i = 0; i < tail; ++i)
+                windowed_[i] = history_[write_pos_ + i] * window_[i];
+            for (std::size_t i = 0; i < write_pos_; ++i)
+                windowed_[tail + i] = history_[i] * window_[tail + i];
+
+            fft_.forward(windowed_, spec_re_, spec_im_);
+            for (std::size_t k = 0; k < power_.size(); ++k)
+            {
+                power_[k] = (spec_re_[k] * spec_re_[k] + spec_im_[k] * spec_im_[k]) * power_scale_;
+            }
+
+            filterbank_.apply(power_, mel_);
+            for (float energy : mel_)
+            {
+                float db = 10.0f * std::log10(energy + 1e-12f);
+                float norm = (db - floor_db_) / -floor_db_;
+                out.push_back(static_cast<std::uint8_t>(std::lround(std::clamp(norm, 0.0f, 1.0f) * 255.0f)));
+            }
+        }
+
+        dsp::RealFft fft_;
+        dsp::MelFilterbank filterbank_;
+        std::vector<float> window_;
+        std::vector<float> history_;
+        std::vector<float> windowed_;
+        std::vector<float> spec_re_;
+        std::vector<float> spec_im_;
+        std::vector<float> power_;
+        std::vector<float> mel_;
+        std::size_t hop_;
+        std::size_t write_pos_ = 0;
+        std::size_t since_slice_ = 0;
+        float floor_db_;
+        float power_scale_ = 1.0f;
+    };
+
+    // ============================================================================
+    // Preview Stage
+    // ============================================================================
+
+    /// Combined waveform + spectrogram stage run on the consumer thread.
+    /// Output is buffered until the caller drains it with take_*().
+    class PreviewStage
+    {
+    public:
+        explicit PreviewStage(const PreviewConfig &config = {})
+            : config_(config),
+              decimator_(config.sample_rate / std::max<std::uint32_t>(config.columns_per_second, 1))
+        {
+            if (config_.enable_spectrum)
+            {
+                slicer_.emplace(config_);
+            }
+        }
+
+        void process(AudioFrame frame)
+        {
+            pending_columns_ += decimator_.push(frame, waveform_);
+            if (slicer_)
+            {
+                pending_slices_ += slicer_->push(frame, spectrum_);
+            }
+        }
+
+        /// Returns true once enough columns are buffered for a packet
+        [[nodiscard]] bool waveform_ready() const noexcept
+        {
+            return pending_columns_ >= config_.columns_per_packet;
+        }
+
+        [[nodiscard]] bool spectrum_ready() const noexcept { return pending_slices_ > 0; }
+
+        [[nodiscard]] std::size_t spectrum_bands() const noexcept
+        {
+            return slicer_ ? slicer_->bands() : 0;
+        }
+
+        /// Hand the buffered waveform columns to `fn(bytes, columns)` and clear
+        template <typename Fn>
+        void take_waveform(Fn &&fn)
+        {
+            fn(std::span<const std::uint8_t>(waveform_), pending_columns_);
+            waveform_.clear();
+            pending_columns_ = 0;
+        }
+
+        /// Hand the buffered spectrum slices to `fn(bytes, bands)` and clear
+        template <typename Fn>
+        void take_spectrum(Fn &&fn)
+        {
+            fn(std::span<const std::uint8_t>(spectrum_), spectrum_bands());
+            spectrum_.clear();
+            pending_slices_ = 0;
+        }
+
+    private:
+        PreviewConfig config_;
+        WaveformDecimator decimator_;
+        std::optional<SpectrogramSlicer> slicer_; // Disengaged when spectrum is disabled
+        std::vector<std::uint8_t> waveform_;
+        std::vector<std::uint8_t> spectrum_;
+        std::size_t pending_columns_ = 0;
+        std::size_t pending_slices_ = 0;
+    };
+
+} // namespace harness::preview
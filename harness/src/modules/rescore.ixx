@@ -0,0 +1,217 @@
+// ============================================================================
+// TopNotchNotes Harness - Rescoring Module
+// Background second pass over finished segments with a slower, better decoder
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+export module harness:rescore;
+
+import :transcribe;
+import :io;
+import :dsp;
+
+export namespace harness::rescore
+{
+
+    // ============================================================================
+    // Jobs
+    // ============================================================================
+
+    /// One finished VAD segment, re-read from the session WAV
+    struct RescoreJob
+    {
+        std::filesystem::path wav_path;
+        std::uint32_t wav_rate = 48000;
+        std::uint64_t first_sample = 0;
+        std::uint64_t sample_count = 0;
+        io::WavSnapshot snapshot; // What the writer had not put in the file yet
+        std::string live_text; // Raw live-pass text; equal results are not reported
+
+        /// Called on the rescoring thread with the new raw text
+        std::function<void(std::string)> on_revised;
+    };
+
+    // ============================================================================
+    // Rescorer
+    // ============================================================================
+
+    /// Single low-priority worker that re-decodes segments after the live pass.
+    /// The worker runs under SCHED_IDLE (or the lowest nice level) so it only
+    /// gets cores the live path leaves idle. The engine is built lazily on the
+    /// worker, so loading the larger models never blocks a command.
+    class Rescorer
+    {
+    public:
+        using EngineFactory = std::function<std::unique_ptr<transcribe::ITranscribeEngine>()>;
+
+        Rescorer(EngineFactory factory, std::uint32_t engine_rate);
+
+        /// Queued jobs are dropped; the live text stays in place
+        ~Rescorer();
+
+        Rescorer(const Rescorer &) = delete;
+        Rescorer &operator=(const Rescorer &) = delete;
+
+        void submit(RescoreJob job);
+
+        /// Block until every submitted job has been processed (tests, shutdown)
+        void wait_idle();
+
+        [[nodiscard]] std::uint64_t completed() const noexcept { return completed_.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t revised() const noexcept { return revised_.load(std::memory_order_relaxed); }
+
+    private:
+        void run(std::stop_token stop);
+        void process(const RescoreJob &job);
+
+        EngineFactory factory_;
+        std::uint32_t engine_rate_;
+        std::unique_ptr<transcribe::ITranscribeEngine> engine_;
+        bool engine_failed_ = false;
+
+        std::mutex mutex_;
+        std::condition_variable_any wake_;
+        std::condition_variable idle_;
+        std::deque<RescoreJob> queue_;
+        bool busy_ = false;
+
+        std::atomic<std::uint64_t> completed_{0};
+        std::atomic<std::uint64_t> revised_{0};
+
+        std::jthread worker_; // Last: started after everything above exists
+    };
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    /// Put the calling thread behind everything else on the machine
+    inline void lower_thread_priority()
+    {
+        sched_param param{};
+        if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0)
+        {
+            // Per-thread nice value on Linux
+            (void)setpriority(PRIO_PROCESS, static_cast<id_t>(::gettid()), 19);
+        }
+    }
+
+    Rescorer::Rescorer(EngineFactory factory, std::uint32_t engine_rate)
+        : factory_(std::move(factory)),
+          engine_rate_(engine_rate),
+          worker_([this](std::stop_token stop)
+                  { run(stop); })
+    {
+    }
+
+    Rescorer::~Rescorer()
+    {
+        worker_.request_stop();
+        wake_.notify_all();
+    }
+
+    void Rescorer::submit(RescoreJob job)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back(std::move(job));
+        }
+        wake_.notify_one();
+    }
+
+    void Rescorer::wait_idle()
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this]
+                   { return queue_.empty() && !busy_; });
+    }
+
+    void Rescorer::run(std::stop_token stop)
+    {
+        lower_thread_priority();
+
+        while (true)
+        {
+            RescoreJob job;
+            {
+                std::unique_lock lock(mutex_);
+                busy_ = false;
+                idle_.notify_all();
+                if (!wake_.wait(lock, stop, [this]
+                                { return !queue_.empty(); }) ||
+                    stop.stop_requested())
+                    return;
+                job = std::move(queue_.front());
+                queue_.pop_front();
+                busy_ = true;
+            }
+
+            process(job);
+            completed_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Rescorer::process(const RescoreJob &job)
+    {
+        if (!engine_ && !engine_failed_)
+        {
+            engine_ = factory_();
+            engine_failed_ = !engine_;
+            if (engine_failed_)
+                std::print(stderr, "Rescoring engine unavailable - keeping live text\n");
+        }
+        if (!engine_)
+            return;
+
+        auto samples = io::read_wav_samples(job.wav_path, job.first_sample, job.sample_count, &job.snapshot);
+        if (!samples || samples->empty())
+            return;
+
+        const std::size_t factor = job.wav_rate % engine_rate_ == 0 ? job.wav_rate / engine_rate_ : 1;
+        const auto audio = dsp::decimate(*samples, factor);
+
+        // Same 20 ms framing as the live path
+        engine_->reset();
+        const std::size_t chunk = engine_rate_ / 50;
+        for (std::size_t offset = 0; offset < audio.size(); offset += chunk)
+        {
+            auto frame = std::span(audio).subspan(offset, std::min(chunk, audio.size() - offset));
+            (void)engine_->process(frame);
+        }
+
+        auto segment = engine_->finalize();
+        if (!segment)
+            return;
+        auto text = segment->full_text();
+        if (text.empty() || text == job.live_text)
+            return;
+
+        revised_.fetch_add(1, std::memory_order_relaxed);
+        job.on_revised(std::move(text));
+    }
+
+} // namespace harness::rescore
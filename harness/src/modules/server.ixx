@@ -0,0 +1,667 @@
+// ============================================================================
+// TopNotchNotes Harness - Control Server Module
+// Non-blocking AF_UNIX command/telemetry server for additional observers, and
+// a plain HTTP endpoint for metrics scrapers
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+export module harness:server;
+
+import :telemetry;
+
+export namespace harness::server
+{
+
+    // ============================================================================
+    // Type Aliases
+    // ============================================================================
+
+    template <typename T>
+    using ServerResult = std::expected<T, std::string>;
+
+    /// Receives one trimmed command line from a client (e.g. "START /path")
+    using CommandHandler = std::function<void(std::string_view)>;
+
+    /// Produces the body of a metrics scrape
+    using ScrapeHandler = std::function<std::string()>;
+
+    // ============================================================================
+    // Control Server
+    // ============================================================================
+
+    /// Local control socket speaking the same line protocol as stdin/stdout.
+    /// Telemetry is formatted once by the Emitter and handed over as a shared
+    /// line; queuing and writes to each client happen on the server thread,
+    /// so the capture path pays the same cost for one observer or ten.
+    ///
+    /// Clients may send `SUBSCRIBE ...` (see telemetry::parse_subscription)
+    /// to choose event types and rates for their own connection. Other lines
+    /// are commands.
+    class ControlServer : public telemetry::ITelemetrySink
+    {
+    public:
+        static ServerResult<std::shared_ptr<ControlServer>> create(const std::filesystem::path &path,
+                                                                   CommandHandler handler);
+
+        ~ControlServer() override;
+
+        ControlServer(const ControlServer &) = delete;
+        ControlServer &operator=(const ControlServer &) = delete;
+        ControlServer(ControlServer &&) = delete;
+        ControlServer &operator=(ControlServer &&) = delete;
+
+        // ITelemetrySink
+        [[nodiscard]] telemetry::Subscription demand() const noexcept override;
+        void publish(telemetry::EventType type, std::string_view line) override;
+
+        [[nodiscard]] std::size_t client_count() const noexcept
+        {
+            return client_count_.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+    private:
+        struct Client
+        {
+            int fd = -1;
+            telemetry::Subscription subscription;
+            telemetry::RateGate gate;
+            std::deque<std::shared_ptr<const std::string>> queue;
+            std::size_t offset = 0; // Bytes of queue.front() already sent
+            std::string inbuf;
+            bool want_write = false;
+        };
+
+        ControlServer(std::filesystem::path path, CommandHandler handler,
+                      int listen_fd, int epoll_fd, int wake_fd);
+
+        void run(std::stop_token stop);
+        void accept_clients();
+        void fan_out();
+        bool read_client(Client &client);
+        bool flush_client(Client &client);
+        bool handle_line(Client &client, std::string_view line);
+        void close_client(int fd);
+        void update_demand();
+
+        static constexpr std::size_t max_queued_lines = 1024;
+        static constexpr std::size_t max_line_length = 4096;
+
+        std::filesystem::path path_;
+        CommandHandler handler_;
+        int listen_fd_ = -1;
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+
+        std::unordered_map<int, Client> clients_; // Server thread only
+        std::atomic<std::size_t> client_count_{0};
+
+        // Union of all client subscriptions, read by the emitting thread
+        std::atomic<std::uint32_t> demand_mask_{0};
+        std::atomic<std::uint32_t> demand_level_hz_{0};
+        std::atomic<std::int64_t> demand_metrics_ms_{0};
+
+        std::mutex pending_mutex_;
+        std::vector<std::pair<telemetry::EventType, std::shared_ptr<const std::string>>> pending_;
+
+        std::jthread thread_;
+    };
+
+    // ============================================================================
+    // Metrics Endpoint
+    // ============================================================================
+
+    /// Answers `GET /metrics` over HTTP/1.0 on a Unix socket, for scrapers
+    /// that speak HTTP but not the line protocol:
+    ///     curl --unix-socket /run/user/1000/tnn-metrics.sock http://localhost/metrics
+    /// One request per connection, served in turn on the endpoint's thread.
+    class MetricsEndpoint
+    {
+    public:
+        static ServerResult<std::unique_ptr<MetricsEndpoint>> create(const std::filesystem::path &path,
+                                                                     ScrapeHandler handler);
+
+        ~MetricsEndpoint();
+
+        MetricsEndpoint(const MetricsEndpoint &) = delete;
+        MetricsEndpoint &operator=(const MetricsEndpoint &) = delete;
+
+        [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+    private:
+        MetricsEndpoint(std::filesystem::path path, ScrapeHandler handler, int listen_fd, int wake_fd);
+
+        void run(std::stop_token stop);
+        void serve(int fd);
+
+        static constexpr std::size_t max_request_length = 8192;
+
+        std::filesystem::path path_;
+        ScrapeHandler handler_;
+        int listen_fd_ = -1;
+        int wake_fd_ = -1;
+        std::jthread thread_;
+    };
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    namespace detail
+    {
+        /// Listening, non-blocking, owner-only socket at `path`, replacing a
+        /// stale one left by a previous run
+        inline ServerResult<int> listen_unix(const std::filesystem::path &path, std::string_view what)
+        {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            const auto native = path.string();
+            if (native.empty() || native.size() >= sizeof(addr.sun_path))
+            {
+                return std::unexpected("Path for the " + std::string(what) + " is empty or too long");
+            }
+            std::memcpy(addr.sun_path, native.c_str(), native.size() + 1);
+
+            if (auto parent = path.parent_path(); !parent.empty())
+            {
+                std::error_code ec;
+                std::filesystem::create_directories(parent, ec);
+            }
+            ::unlink(native.c_str());
+
+            int listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listen_fd < 0)
+            {
+                return std::unexpected("Failed to create " + std::string(what));
+            }
+
+            if (::bind(listen_fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+                ::listen(listen_fd, 16) != 0)
+            {
+                ::close(listen_fd);
+                return std::unexpected("Failed to bind " + std::string(what) + ": " + native);
+            }
+            ::chmod(native.c_str(), S_IRUSR | S_IWUSR); // Same-user access only
+            return listen_fd;
+        }
+    } // namespace detail
+
+    ServerResult<std::shared_ptr<ControlServer>>
+    ControlServer::create(const std::filesystem::path &path, CommandHandler handler)
+    {
+        auto listening = detail::listen_unix(path, "control socket");
+        if (!listening)
+        {
+            return std::unexpected(listening.error());
+        }
+        const int listen_fd = *listening;
+
+        int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        int wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd < 0 || wake_fd < 0)
+        {
+            if (epoll_fd >= 0)
+                ::close(epoll_fd);
+            if (wake_fd >= 0)
+                ::close(wake_fd);
+            ::close(listen_fd);
+            ::unlink(path.c_str());
+            return std::unexpected("Failed to create control server event loop");
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listen_fd;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+        ev.data.fd = wake_fd;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+
+        return std::shared_ptr<ControlServer>(
+            new ControlServer(path, std::move(handler), listen_fd, epoll_fd, wake_fd));
+    }
+
+    ControlServer::ControlServer(std::filesystem::path path, CommandHandler handler,
+                                 int listen_fd, int epoll_fd, int wake_fd)
+        : path_(std::move(path)),
+          handler_(std::move(handler)),
+          listen_fd_(listen_fd),
+          epoll_fd_(epoll_fd),
+          wake_fd_(wake_fd)
+    {
+        thread_ = std::jthread([this](std::stop_token stop)
+                               { run(stop); });
+    }
+
+    ControlServer::~ControlServer()
+    {
+        thread_.request_stop();
+        std::uint64_t one = 1;
+        (void)::write(wake_fd_, &one, sizeof(one));
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        for (auto &[fd, client] : clients_)
+        {
+            ::close(fd);
+        }
+        ::close(wake_fd_);
+        ::close(epoll_fd_);
+        ::close(listen_fd_);
+        ::unlink(path_.c_str());
+    }
+
+    telemetry::Subscription ControlServer::demand() const noexcept
+    {
+        return {
+            .mask = demand_mask_.load(std::memory_order_relaxed),
+            .level_hz = demand_level_hz_.load(std::memory_order_relaxed),
+            .metrics_interval = std::chrono::milliseconds(demand_metrics_ms_.load(std::memory_order_relaxed))};
+    }
+
+    void ControlServer::publish(telemetry::EventType type, std::string_view line)
+    {
+        auto shared = std::make_shared<const std::string>(line);
+        bool was_empty;
+        {
+            std::lock_guard lock(pending_mutex_);
+            was_empty = pending_.empty();
+            pending_.emplace_back(type, std::move(shared));
+        }
+
+        // One wakeup per batch; the server thread drains everything queued
+        if (was_empty)
+        {
+            std::uint64_t one = 1;
+            (void)::write(wake_fd_, &one, sizeof(one));
+        }
+    }
+
+    void ControlServer::run(std::stop_token stop)
+    {
+        std::array<epoll_event, 32> events{};
+
+        while (!stop.stop_requested())
+        {
+            int n = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                const int fd = events[static_cast<std::size_t>(i)].data.fd;
+                const auto flags = events[static_cast<std::size_t>(i)].events;
+
+                if (fd == listen_fd_)
+                {
+                    accept_clients();
+                }
+                else if (fd == wake_fd_)
+                {
+                    std::uint64_t count;
+                    (void)::read(wake_fd_, &count, sizeof(count));
+                    fan_out();
+                }
+                else if (auto it = clients_.find(fd); it != clients_.end())
+                {
+                    bool alive = true;
+                    if (flags & (EPOLLERR | EPOLLHUP))
+                        alive = false;
+                    if (alive && (flags & EPOLLIN))
+                        alive = read_client(it->second);
+                    if (alive && (flags & EPOLLOUT))
+                        alive = flush_client(it->second);
+                    if (!alive)
+                        close_client(fd);
+                }
+            }
+        }
+    }
+
+    void ControlServer::accept_clients()
+    {
+        while (true)
+        {
+            int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return; // EAGAIN or transient error
+
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = fd;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0)
+            {
+                ::close(fd);
+                continue;
+            }
+
+            clients_[fd].fd = fd;
+            client_count_.store(clients_.size(), std::memory_order_relaxed);
+            update_demand();
+        }
+    }
+
+    void ControlServer::fan_out()
+    {
+        decltype(pending_) batch;
+        {
+            std::lock_guard lock(pending_mutex_);
+            batch.swap(pending_);
+        }
+
+        const auto now = telemetry::RateGate::Clock::now();
+        std::vector<int> overflowed;
+        for (auto &[fd, client] : clients_)
+        {
+            for (const auto &[type, line] : batch)
+            {
+                // The emitter already limits to the fastest client; slower
+                // clients are thinned out here
+                if (client.gate.admit(client.subscription, type, now))
+                {
+                    client.queue.push_back(line);
+                }
+            }
+
+            // A client that stops reading is dropped instead of growing unbounded
+            if (client.queue.size() > max_queued_lines || !flush_client(client))
+            {
+                overflowed.push_back(fd);
+            }
+        }
+
+        for (int fd : overflowed)
+        {
+            close_client(fd);
+        }
+    }
+
+    bool ControlServer::read_client(Client &client)
+    {
+        char buf[1024];
+        while (true)
+        {
+            ssize_t got = ::recv(client.fd, buf, sizeof(buf), 0);
+            if (got == 0)
+                return false; // Peer closed
+            if (got < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+
+            client.inbuf.append(buf, static_cast<std::size_t>(got));
+
+            std::size_t newline;
+            while ((newline = client.inbuf.find('\n')) != std::string::npos)
+            {
+                std::string line = client.inbuf.substr(0, newline);
+                client.inbuf.erase(0, newline + 1);
+                if (!handle_line(client, line))
+                    return false;
+            }
+
+            if (client.inbuf.size() > max_line_length)
+                return false;
+        }
+    }
+
+    bool ControlServer::flush_client(Client &client)
+    {
+        while (!client.queue.empty())
+        {
+            const auto &line = *client.queue.front();
+            ssize_t sent = ::send(client.fd, line.data() + client.offset,
+                                  line.size() - client.offset, MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    return false;
+
+                if (!client.want_write)
+                {
+                    epoll_event ev{};
+                    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT;
+                    ev.data.fd = client.fd;
+                    ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client.fd, &ev);
+                    client.want_write = true;
+                }
+                return true;
+            }
+
+            client.offset += static_cast<std::size_t>(sent);
+            if (client.offset == line.size())
+            {
+                client.queue.pop_front();
+                client.offset = 0;
+            }
+        }
+
+        if (client.want_write)
+        {
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = client.fd;
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client.fd, &ev);
+            client.want_write = false;
+        }
+        return true;
+    }
+
+    bool ControlServer::handle_line(Client &client, std::string_view line)
+    {
+        auto start = line.find_first_not_of(" \t\r\n");
+        auto end = line.find_last_not_of(" \t\r\n");
+        if (start == std::string_view::npos)
+            return true;
+        line = line.substr(start, end - start + 1);
+
+        constexpr std::string_view subscribe = "SUBSCRIBE";
+        if (line.starts_with(subscribe) &&
+            (line.size() == subscribe.size() || line[subscribe.size()] == ' '))
+        {
+            // Per-client subscription; errors only go back to this client
+            if (auto sub = telemetry::parse_subscription(line.substr(subscribe.size())))
+            {
+                client.subscription = *sub;
+                client.gate = {};
+                update_demand();
+            }
+            else
+            {
+                std::string buffer;
+                auto reply = telemetry::JsonLine(buffer, telemetry::EventType::Error)
+                                 .string("body", sub.error())
+                                 .finish();
+                client.queue.push_back(std::make_shared<const std::string>(reply));
+                return flush_client(client);
+            }
+            return true;
+        }
+
+        if (handler_)
+        {
+            handler_(line);
+        }
+        return true;
+    }
+
+    void ControlServer::close_client(int fd)
+    {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        clients_.erase(fd);
+        client_count_.store(clients_.size(), std::memory_order_relaxed);
+        update_demand();
+    }
+
+    void ControlServer::update_demand()
+    {
+        auto combined = telemetry::Subscription{.mask = 0};
+        for (const auto &[fd, client] : clients_)
+        {
+            combined.merge(client.subscription);
+        }
+        demand_level_hz_.store(combined.level_hz, std::memory_order_relaxed);
+        demand_metrics_ms_.store(combined.metrics_interval.count(), std::memory_order_relaxed);
+        demand_mask_.store(combined.mask, std::memory_order_relaxed);
+    }
+
+    // ============================================================================
+    // Metrics Endpoint Implementation
+    // ============================================================================
+
+    ServerResult<std::unique_ptr<MetricsEndpoint>>
+    MetricsEndpoint::create(const std::filesystem::path &path, ScrapeHandler handler)
+    {
+        auto listening = detail::listen_unix(path, "metrics socket");
+        if (!listening)
+        {
+            return std::unexpected(listening.error());
+        }
+
+        int wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd < 0)
+        {
+            ::close(*listening);
+            ::unlink(path.c_str());
+            return std::unexpected("Failed to create metrics endpoint event loop");
+        }
+        return std::unique_ptr<MetricsEndpoint>(new MetricsEndpoint(path, std::move(handler), *listening, wake_fd));
+    }
+
+    MetricsEndpoint::MetricsEndpoint(std::filesystem::path path, ScrapeHandler handler, int listen_fd, int wake_fd)
+        : path_(std::move(path)),
+          handler_(std::move(handler)),
+          listen_fd_(listen_fd),
+          wake_fd_(wake_fd)
+    {
+        thread_ = std::jthread([this](std::stop_token stop)
+                               { run(stop); });
+    }
+
+    MetricsEndpoint::~MetricsEndpoint()
+    {
+        thread_.request_stop();
+        std::uint64_t one = 1;
+        (void)::write(wake_fd_, &one, sizeof(one));
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+        ::close(wake_fd_);
+        ::close(listen_fd_);
+        ::unlink(path_.c_str());
+    }
+
+    void MetricsEndpoint::run(std::stop_token stop)
+    {
+        std::array<pollfd, 2> fds{{{.fd = listen_fd_, .events = POLLIN, .revents = 0},
+                                   {.fd = wake_fd_, .events = POLLIN, .revents = 0}}};
+
+        while (!stop.stop_requested())
+        {
+            if (::poll(fds.data(), fds.size(), -1) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            if (fds[1].revents & POLLIN)
+                break; // Only ever signalled by the destructor
+
+            while (true)
+            {
+                // Blocking, with timeouts, so a stalled scraper cannot wedge the loop
+                int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+                if (fd < 0)
+                    break;
+                const timeval timeout{.tv_sec = 2, .tv_usec = 0};
+                ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                serve(fd);
+                ::close(fd);
+            }
+        }
+    }
+
+    void MetricsEndpoint::serve(int fd)
+    {
+        std::string request;
+        char buf[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos)
+        {
+            ssize_t got = ::recv(fd, buf, sizeof(buf), 0);
+            if (got <= 0 || request.size() > max_request_length)
+                return;
+            request.append(buf, static_cast<std::size_t>(got));
+        }
+
+        // "GET /metrics HTTP/1.1"; query strings and headers are ignored
+        std::string_view line(request);
+        line = line.substr(0, line.find_first_of("\r\n"));
+        const auto method_end = line.find(' ');
+        std::string_view target = method_end == std::string_view::npos ? "" : line.substr(method_end + 1);
+        target = target.substr(0, target.find_first_of(" ?"));
+
+        std::string status = "200 OK";
+        std::string body;
+        if (line.substr(0, method_end) != "GET")
+        {
+            status = "405 Method Not Allowed";
+        }
+        else if (target != "/metrics" && target != "/")
+        {
+            status = "404 Not Found";
+        }
+        else
+        {
+            body = handler_();
+        }
+
+        std::string response = "HTTP/1.0 " + status +
+                                "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+                                std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        std::size_t offset = 0;
+        while (offset < response.size())
+        {
+            ssize_t sent = ::send(fd, response.data() + offset, response.size() - offset, MSG_NOSIGNAL);
+            if (sent <= 0)
+                return;
+            offset += static_cast<std::size_t>(sent);
+        }
+    }
+
+} // namespace harness::server
@@ -0,0 +1,329 @@
+// ============================================================================
+// TopNotchNotes Harness - Shared Memory Module
+// Memfd-backed SPSC record ring for high-rate telemetry to the pilot
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <atomic>
+#include <bit>
+#include <expected>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module harness:shm;
+
+export namespace harness::shm
+{
+
+    // ============================================================================
+    // Type Aliases
+    // ============================================================================
+
+    template <typename T>
+    using ShmResult = std::expected<T, std::string>;
+
+    // ============================================================================
+    // Wire Layout (shared with pilot/internal/ipc/shm.go)
+    // ============================================================================
+
+    inline constexpr std::uint32_t ring_magic = 0x48534E54; // "TNSH"
+    inline constexpr std::uint32_t ring_version = 1;
+    inline constexpr std::size_t header_size = 256;
+    inline constexpr std::size_t record_header_size = 8;
+
+    /// Record types carried by the ring
+    enum class RecordType : std::uint16_t
+    {
+        Padding = 0,  // Fills the tail before a wrap
+        Level = 1,    // float32 dB
+        Waveform = 2, // uint32 column count + packed columns
+        Spectrum = 3  // uint32 band count + concatenated slices
+    };
+
+    /// Region header. Indices are free-running byte counters; each side owns
+    /// one index on its own cache line.
+    struct RingHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t capacity; // Data bytes, power of two
+        alignas(64) std::atomic<std::uint64_t> write_pos;
+        alignas(64) std::atomic<std::uint64_t> read_pos;
+        alignas(64) std::atomic<std::uint64_t> dropped;
+    };
+
+    static_assert(sizeof(RingHeader) <= header_size, "RingHeader must fit the reserved header");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "Shared indices must be lock-free to be valid across processes");
+
+    /// Each record: uint32 payload size, uint16 type, uint16 reserved, payload,
+    /// padded to 8 bytes. Records never straddle the end of the data area.
+    [[nodiscard]] constexpr std::size_t record_span(std::size_t payload) noexcept
+    {
+        return (record_header_size + payload + 7) & ~std::size_t{7};
+    }
+
+    // ============================================================================
+    // Shared Ring
+    // ============================================================================
+
+    /// Single-producer single-consumer record ring in a shared mapping.
+    /// The harness is the producer; the pilot maps the same memfd and consumes.
+    /// A full ring drops the record and bumps `dropped` - the producer never blocks.
+    class SharedRing
+    {
+    public:
+        /// Create and initialize a new memfd-backed ring (consumer side / tests)
+        static ShmResult<SharedRing> create(std::size_t capacity);
+
+        /// Attach to a ring initialized by the parent process
+        static ShmResult<SharedRing> attach(int fd);
+
+        ~SharedRing();
+
+        SharedRing(SharedRing &&other) noexcept;
+        SharedRing &operator=(SharedRing &&other) noexcept;
+        SharedRing(const SharedRing &) = delete;
+        SharedRing &operator=(const SharedRing &) = delete;
+
+        /// Append a record built from a fixed prefix and a body (producer thread)
+        /// Returns false if the ring is full or the record is oversized
+        bool write(RecordType type, std::span<const std::byte> prefix,
+                   std::span<const std::byte> body = {}) noexcept;
+
+        /// Visit all pending records, then release them (consumer thread)
+        /// The payload span is only valid during the callback
+        template <typename Fn>
+        std::size_t read(Fn &&fn)
+        {
+            auto r = header_->read_pos.load(std::memory_order_relaxed);
+            const auto w = header_->write_pos.load(std::memory_order_acquire);
+            std::size_t count = 0;
+
+            while (r < w)
+            {
+                const auto offset = static_cast<std::size_t>(r & (capacity_ - 1));
+                std::uint32_t size = 0;
+                std::uint16_t type = 0;
+                std::memcpy(&size, data_ + offset, sizeof(size));
+                std::memcpy(&type, data_ + offset + 4, sizeof(type));
+
+                if (type != std::to_underlying(RecordType::Padding))
+                {
+                    fn(static_cast<RecordType>(type),
+                       std::span<const std::byte>(data_ + offset + record_header_size, size));
+                    ++count;
+                }
+                r += record_span(size);
+            }
+
+            header_->read_pos.store(r, std::memory_order_release);
+            return count;
+        }
+
+        [[nodiscard]] int fd() const noexcept { return fd_; }
+        [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+        [[nodiscard]] std::uint64_t dropped() const noexcept
+        {
+            return header_->dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        SharedRing(int fd, void *base, std::size_t map_size, bool owns_fd);
+        void release() noexcept;
+
+        int fd_ = -1;
+        bool owns_fd_ = false;
+        void *base_ = nullptr;
+        std::size_t map_size_ = 0;
+        RingHeader *header_ = nullptr;
+        std::byte *data_ = nullptr;
+        std::size_t capacity_ = 0;
+    };
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    SharedRing::SharedRing(int fd, void *base, std::size_t map_size, bool owns_fd)
+        : fd_(fd),
+          owns_fd_(owns_fd),
+          base_(base),
+          map_size_(map_size),
+          header_(static_cast<RingHeader *>(base)),
+          data_(static_cast<std::byte *>(base) + header_size),
+          capacity_(static_cast<std::size_t>(header_->capacity))
+    {
+    }
+
+    SharedRing::~SharedRing()
+    {
+        release();
+    }
+
+    SharedRing::SharedRing(SharedRing &&other) noexcept
+        : fd_(std::exchange(other.fd_, -1)),
+          owns_fd_(std::exchange(other.owns_fd_, false)),
+          base_(std::exchange(other.base_, nullptr)),
+          map_size_(std::exchange(other.map_size_, 0)),
+          header_(std::exchange(other.header_, nullptr)),
+          data_(std::exchange(other.data_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0))
+    {
+    }
+
+    SharedRing &SharedRing::operator=(SharedRing &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            fd_ = std::exchange(other.fd_, -1);
+            owns_fd_ = std::exchange(other.owns_fd_, false);
+            base_ = std::exchange(other.base_, nullptr);
+            map_size_ = std::exchange(other.map_size_, 0);
+            header_ = std::exchange(other.header_, nullptr);
+            data_ = std::exchange(other.data_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    void SharedRing::release() noexcept
+    {
+        if (base_)
+        {
+            munmap(base_, map_size_);
+            base_ = nullptr;
+        }
+        if (owns_fd_ && fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+        fd_ = -1;
+    }
+
+    ShmResult<SharedRing> SharedRing::create(std::size_t capacity)
+    {
+        if (capacity < 4096 || !std::has_single_bit(capacity))
+        {
+            return std::unexpected("Ring capacity must be a power of two >= 4096");
+        }
+
+        int fd = memfd_create("topnotch-telemetry", MFD_CLOEXEC);
+        if (fd < 0)
+        {
+            return std::unexpected("memfd_create failed");
+        }
+
+        const std::size_t map_size = header_size + capacity;
+        if (ftruncate(fd, static_cast<off_t>(map_size)) != 0)
+        {
+            ::close(fd);
+            return std::unexpected("Failed to size shared ring");
+        }
+
+        void *base = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED)
+        {
+            ::close(fd);
+            return std::unexpected("Failed to map shared ring");
+        }
+
+        auto *header = new (base) RingHeader{};
+        header->magic = ring_magic;
+        header->version = ring_version;
+        header->capacity = capacity;
+
+        return SharedRing(fd, base, map_size, true);
+    }
+
+    ShmResult<SharedRing> SharedRing::attach(int fd)
+    {
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) <= header_size)
+        {
+            return std::unexpected("Shared ring fd is invalid or too small");
+        }
+
+        const auto map_size = static_cast<std::size_t>(st.st_size);
+        void *base = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED)
+        {
+            return std::unexpected("Failed to map shared ring");
+        }
+
+        const auto *header = static_cast<const RingHeader *>(base);
+        if (header->magic != ring_magic || header->version != ring_version ||
+            !std::has_single_bit(header->capacity) ||
+            header_size + header->capacity > map_size)
+        {
+            munmap(base, map_size);
+            return std::unexpected("Shared ring header mismatch");
+        }
+
+        return SharedRing(fd, base, map_size, false);
+    }
+
+    bool SharedRing::write(RecordType type, std::span<const std::byte> prefix,
+                           std::span<const std::byte> body) noexcept
+    {
+        const std::size_t payload = prefix.size() + body.size();
+        const std::size_t span = record_span(payload);
+        if (span > capacity_ / 2)
+        {
+            header_->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto w = header_->write_pos.load(std::memory_order_relaxed);
+        const auto r = header_->read_pos.load(std::memory_order_acquire);
+
+        auto offset = static_cast<std::size_t>(w & (capacity_ - 1));
+        const std::size_t contiguous = capacity_ - offset;
+        const std::size_t needed = span + (contiguous < span ? contiguous : 0);
+
+        if (capacity_ - static_cast<std::size_t>(w - r) < needed)
+        {
+            header_->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto put_header = [this](std::size_t at, std::uint32_t size, RecordType t)
+        {
+            const auto raw = std::to_underlying(t);
+            const std::uint16_t reserved = 0;
+            std::memcpy(data_ + at, &size, sizeof(size));
+            std::memcpy(data_ + at + 4, &raw, sizeof(raw));
+            std::memcpy(data_ + at + 6, &reserved, sizeof(reserved));
+        };
+
+        if (contiguous < span)
+        {
+            put_header(offset, static_cast<std::uint32_t>(contiguous - record_header_size),
+                       RecordType::Padding);
+            w += contiguous;
+            offset = 0;
+        }
+
+        put_header(offset, static_cast<std::uint32_t>(payload), type);
+        std::memcpy(data_ + offset + record_header_size, prefix.data(), prefix.size());
+        if (!body.empty())
+        {
+            std::memcpy(data_ + offset + record_header_size + prefix.size(), body.data(), body.size());
+        }
+
+        header_->write_pos.store(w + span, std::memory_order_release);
+        return true;
+    }
+
+} // namespace harness::shm
@@ -13,9 +13,38 @@ module;
 #include <format>
 #include <print>
 #include <utility>
+#include <span>
+#include <optional>
+#include <memory>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <expected>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HARNESS_TELEMETRY_X86 1
+#else
+#define HARNESS_TELEMETRY_X86 0
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 export module harness:telemetry;
 
+import :shm;
+import :cpu;
+import :trace;
+import :metrics;
+
 export namespace harness::telemetry
 {
 
@@ -29,10 +58,19 @@ export namespace harness::telemetry
         Text,     // Transcribed text
         Level,    // Audio level meter
         Error,    // Error notification
-        Info,     // Informational message
-        Heartbeat // Keep-alive
+        Info,      // Informational message
+        Heartbeat, // Keep-alive
+        Waveform,  // Decimated min/max/RMS preview columns
+        Spectrum,  // Log-mel spectrogram slices
+        Session,   // Session start/end
+        Partial,   // Provisional hypothesis, superseded by the next txt
+        Metrics,   // Periodic runtime counters
+        Keyword,   // Spotted keyphrase with its session time
+        Revision   // Second-pass text replacing a committed segment
     };
 
+    inline constexpr std::size_t event_type_count = 13;
+
     constexpr std::string_view to_string(EventType type) noexcept
     {
         using enum EventType;
@@ -50,71 +88,575 @@ export namespace harness::telemetry
             return "info";
         case Heartbeat:
             return "heartbeat";
+        case Waveform:
+            return "wave";
+        case Spectrum:
+            return "spec";
+        case Session:
+            return "session";
+        case Partial:
+            return "partial";
+        case Metrics:
+            return "metrics";
+        case Keyword:
+            return "kw";
+        case Revision:
+            return "rev";
         }
         std::unreachable();
     }
 
+    /// Parse a wire event name back to its type
+    constexpr std::optional<EventType> parse_event_type(std::string_view name) noexcept
+    {
+        for (std::size_t i = 0; i < event_type_count; ++i)
+        {
+            auto type = static_cast<EventType>(i);
+            if (to_string(type) == name)
+                return type;
+        }
+        return std::nullopt;
+    }
+
+    /// Bit for an event type in a subscription mask
+    constexpr std::uint32_t event_bit(EventType type) noexcept
+    {
+        return std::uint32_t{1} << std::to_underlying(type);
+    }
+
+    inline constexpr std::uint32_t all_events = (std::uint32_t{1} << event_type_count) - 1;
+
+    // ============================================================================
+    // Subscriptions
+    // ============================================================================
+
+    /// What one consumer wants to receive and how often.
+    /// Level and metrics are rate limited; other events pass through as-is.
+    struct Subscription
+    {
+        static constexpr std::uint32_t min_level_hz = 1;
+        static constexpr std::uint32_t max_level_hz = 60;
+
+        std::uint32_t mask = all_events;
+        std::uint32_t level_hz = 10;
+        std::chrono::milliseconds metrics_interval{0}; // 0 disables metrics
+
+        [[nodiscard]] bool wants(EventType type) const noexcept
+        {
+            if (type == EventType::Metrics && metrics_interval.count() == 0)
+                return false;
+            return (mask & event_bit(type)) != 0;
+        }
+
+        /// Minimum spacing between two events of this type
+        [[nodiscard]] std::chrono::nanoseconds interval(EventType type) const noexcept
+        {
+            switch (type)
+            {
+            case EventType::Level:
+                return std::chrono::nanoseconds(std::chrono::seconds(1)) / level_hz;
+            case EventType::Metrics:
+                return metrics_interval;
+            default:
+                return std::chrono::nanoseconds::zero();
+            }
+        }
+
+        /// Combine with another consumer: union of events at the faster rate
+        void merge(const Subscription &other) noexcept
+        {
+            if (other.wants(EventType::Level))
+                level_hz = wants(EventType::Level) ? std::max(level_hz, other.level_hz)
+                                                   : other.level_hz;
+            if (other.wants(EventType::Metrics))
+                metrics_interval = wants(EventType::Metrics)
+                                       ? std::min(metrics_interval, other.metrics_interval)
+                                       : other.metrics_interval;
+            mask |= other.mask;
+        }
+    };
+
+    /// Parse SUBSCRIBE arguments, e.g. "txt status level=30 partial=off metrics=1000".
+    /// Bare event names (or `*`) select the event set; without any, all events
+    /// stay selected. `level=<hz>` and `metrics=<ms>` set rates and `<evt>=on|off`
+    /// toggles one type. No arguments restores the defaults.
+    [[nodiscard]] inline std::expected<Subscription, std::string>
+    parse_subscription(std::string_view args)
+    {
+        Subscription sub;
+        bool explicit_set = false;
+
+        while (!args.empty())
+        {
+            auto word_start = args.find_first_not_of(" \t");
+            if (word_start == std::string_view::npos)
+                break;
+            args.remove_prefix(word_start);
+            auto word = args.substr(0, args.find_first_of(" \t"));
+            args.remove_prefix(word.size());
+
+            auto eq = word.find('=');
+            if (eq == std::string_view::npos)
+            {
+                if (!explicit_set)
+                {
+                    sub.mask = 0;
+                    explicit_set = true;
+                }
+                if (word == "*")
+                    sub.mask = all_events;
+                else if (auto type = parse_event_type(word))
+                    sub.mask |= event_bit(*type);
+                else
+                    return std::unexpected(std::format("Unknown event type: {}", word));
+                continue;
+            }
+
+            auto name = word.substr(0, eq);
+            auto value = word.substr(eq + 1);
+            auto type = parse_event_type(name);
+            if (!type)
+                return std::unexpected(std::format("Unknown event type: {}", name));
+
+            if (value == "on")
+            {
+                sub.mask |= event_bit(*type);
+                continue;
+            }
+            if (value == "off")
+            {
+                sub.mask &= ~event_bit(*type);
+                continue;
+            }
+
+            std::uint32_t number = 0;
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+            if (ec != std::errc{} || ptr != value.data() + value.size())
+                return std::unexpected(std::format("Invalid value for {}: {}", name, value));
+
+            if (*type == EventType::Level)
+            {
+                if (number < Subscription::min_level_hz || number > Subscription::max_level_hz)
+                    return std::unexpected(std::format("Level rate must be {}-{} Hz",
+                                                       Subscription::min_level_hz,
+                                                       Subscription::max_level_hz));
+                sub.level_hz = number;
+            }
+            else if (*type == EventType::Metrics)
+            {
+                sub.metrics_interval = std::chrono::milliseconds(number);
+            }
+            else
+            {
+                return std::unexpected(std::format("{} only takes on/off", name));
+            }
+            sub.mask |= event_bit(*type);
+        }
+
+        return sub;
+    }
+
+    /// Per-consumer rate limiter for level and metrics events.
+    /// Deadlines advance by the interval, so the average rate stays exact even
+    /// when events are offered at a coarser cadence (one per audio callback).
+    class RateGate
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// True if `sub` wants `type` and it is due; consumes the slot
+        [[nodiscard]] bool admit(const Subscription &sub, EventType type, Clock::time_point now) noexcept
+        {
+            if (!sub.wants(type))
+                return false;
+
+            const auto interval = sub.interval(type);
+            if (interval == Clock::duration::zero())
+                return true;
+
+            auto &next = next_[std::to_underlying(type)];
+            if (now < next)
+                return false;
+            next = (now - next > interval) ? now + interval : next + interval;
+            return true;
+        }
+
+    private:
+        std::array<Clock::time_point, event_type_count> next_{};
+    };
+
     // ============================================================================
     // JSON Escape Utility
     // ============================================================================
 
-    /// Escape a string for JSON output
-    [[nodiscard]] inline std::string json_escape(std::string_view input)
+    namespace detail
     {
-        std::string result;
-        result.reserve(input.size() + 8);
+        inline constexpr char hex_digits[] = "0123456789abcdef";
+
+        [[nodiscard]] constexpr bool needs_escape(unsigned char c) noexcept
+        {
+            return c < 0x20 || c == '"' || c == '\\';
+        }
+
+        [[nodiscard]] inline std::size_t find_escape_from(const char *data, std::size_t size, std::size_t i) noexcept
+        {
+            for (; i < size; ++i)
+            {
+                if (needs_escape(static_cast<unsigned char>(data[i])))
+                    return i;
+            }
+            return size;
+        }
+
+        /// Offset of the first byte that needs escaping, or `size` if none.
+        /// Clean runs are skipped 16 bytes at a time where SIMD is available.
+        [[nodiscard]] inline std::size_t find_escape_baseline(const char *data, std::size_t size) noexcept
+        {
+            std::size_t i = 0;
+
+#if defined(__SSE2__)
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i control = _mm_set1_epi8(0x1f);
+            for (; i + 16 <= size; i += 16)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                const __m128i hit = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                    _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+                if (auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(hit)))
+                    return i + static_cast<std::size_t>(std::countr_zero(bits));
+            }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+            const uint8x16_t quote = vdupq_n_u8('"');
+            const uint8x16_t backslash = vdupq_n_u8('\\');
+            const uint8x16_t control = vdupq_n_u8(0x1f);
+            for (; i + 16 <= size; i += 16)
+            {
+                const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(data + i));
+                const uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)),
+                                                vcleq_u8(v, control));
+                if (vmaxvq_u8(hit) != 0)
+                    break; // Pinpoint within this block below
+            }
+#endif
+
+            return find_escape_from(data, size, i);
+        }
+
+#if HARNESS_TELEMETRY_X86
+        /// 32 bytes at a time; only called once the CPU is known to have AVX2
+        __attribute__((target("avx2"))) inline std::size_t find_escape_avx2(const char *data,
+                                                                             std::size_t size) noexcept
+        {
+            const __m256i quote = _mm256_set1_epi8('"');
+            const __m256i backslash = _mm256_set1_epi8('\\');
+            const __m256i control = _mm256_set1_epi8(0x1f);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                const __m256i hit = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                    _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v)); // v <= 0x1f unsigned
+                if (auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit)))
+                    return i + static_cast<std::size_t>(std::countr_zero(bits));
+            }
+            return i + find_escape_baseline(data + i, size - i);
+        }
+#endif
 
-        for (char c : input)
+        using FindEscape = std::size_t (*)(const char *, std::size_t) noexcept;
+
+        /// Escape scanner for this CPU, chosen on first use
+        [[nodiscard]] inline FindEscape escape_kernel() noexcept
+        {
+            static const FindEscape chosen = []() -> FindEscape
+            {
+#if HARNESS_TELEMETRY_X86
+                if (cpu::enabled(cpu::Isa::Avx2))
+                    return find_escape_avx2;
+#endif
+                return find_escape_baseline;
+            }();
+            return chosen;
+        }
+
+        [[nodiscard]] inline std::size_t find_escape(const char *data, std::size_t size) noexcept
+        {
+            return escape_kernel()(data, size);
+        }
+
+        inline void append_escaped(std::string &out, unsigned char c)
         {
             switch (c)
             {
             case '"':
-                result += "\\\"";
+                out += "\\\"";
                 break;
             case '\\':
-                result += "\\\\";
+                out += "\\\\";
                 break;
             case '\b':
-                result += "\\b";
+                out += "\\b";
                 break;
             case '\f':
-                result += "\\f";
+                out += "\\f";
                 break;
             case '\n':
-                result += "\\n";
+                out += "\\n";
                 break;
             case '\r':
-                result += "\\r";
+                out += "\\r";
                 break;
             case '\t':
-                result += "\\t";
+                out += "\\t";
                 break;
             default:
-                if (static_cast<unsigned char>(c) < 0x20)
-                {
-                    std::format_to(std::back_inserter(result), "\\u{:04x}",
-                                   static_cast<unsigned>(c));
-                }
-                else
-                {
-                    result += c;
-                }
+            {
+                const char seq[] = {'\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 0xf]};
+                out.append(seq, sizeof(seq));
+            }
+            }
+        }
+    } // namespace detail
+
+    /// Append `input` escaped for a JSON string to `out` (no allocation beyond
+    /// growing `out`). Runs without special characters are copied in bulk.
+    inline void json_escape_to(std::string &out, std::string_view input)
+    {
+        out.reserve(out.size() + input.size());
+
+        std::size_t pos = 0;
+        while (pos < input.size())
+        {
+            const auto clean = detail::find_escape(input.data() + pos, input.size() - pos);
+            out.append(input.data() + pos, clean);
+            pos += clean;
+            if (pos < input.size())
+            {
+                detail::append_escaped(out, static_cast<unsigned char>(input[pos]));
+                ++pos;
             }
         }
+    }
 
+    /// Escape a string for JSON output
+    [[nodiscard]] inline std::string json_escape(std::string_view input)
+    {
+        std::string result;
+        json_escape_to(result, input);
         return result;
     }
 
+    /// Name of the escape scanner in use, for STATUS and logs
+    [[nodiscard]] inline std::string_view escape_variant() noexcept
+    {
+#if HARNESS_TELEMETRY_X86
+        if (detail::escape_kernel() == detail::find_escape_avx2)
+            return "avx2";
+#endif
+#if defined(__SSE2__)
+        return "sse2";
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        return "neon";
+#else
+        return "scalar";
+#endif
+    }
+
+    // ============================================================================
+    // Number Formatting
+    // ============================================================================
+
+    /// Append an integer using std::to_chars
+    template <std::integral T>
+    inline void append_number(std::string &out, T value)
+    {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, result.ptr);
+    }
+
+    /// Append a float with fixed precision; non-finite values become null
+    inline void append_fixed(std::string &out, float value, int precision)
+    {
+        if (!std::isfinite(value))
+        {
+            out += "null";
+            return;
+        }
+        char buf[64];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+        out.append(buf, result.ptr);
+    }
+
+    // ============================================================================
+    // Base64 Utility
+    // ============================================================================
+
+    /// Append binary payloads (preview data) base64-encoded to `out`
+    inline void base64_encode_to(std::string &out, std::span<const std::uint8_t> input)
+    {
+        static constexpr char alphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        out.reserve(out.size() + (input.size() + 2) / 3 * 4);
+
+        std::size_t i = 0;
+        for (; i + 3 <= input.size(); i += 3)
+        {
+            std::uint32_t v = (std::uint32_t{input[i]} << 16) |
+                              (std::uint32_t{input[i + 1]} << 8) |
+                              std::uint32_t{input[i + 2]};
+            const char quad[] = {alphabet[(v >> 18) & 0x3f], alphabet[(v >> 12) & 0x3f],
+                                 alphabet[(v >> 6) & 0x3f], alphabet[v & 0x3f]};
+            out.append(quad, sizeof(quad));
+        }
+
+        if (std::size_t rest = input.size() - i; rest > 0)
+        {
+            std::uint32_t v = std::uint32_t{input[i]} << 16;
+            if (rest == 2)
+                v |= std::uint32_t{input[i + 1]} << 8;
+            out += alphabet[(v >> 18) & 0x3f];
+            out += alphabet[(v >> 12) & 0x3f];
+            out += rest == 2 ? alphabet[(v >> 6) & 0x3f] : '=';
+            out += '=';
+        }
+    }
+
+    /// Encode binary payloads for embedding in JSON lines
+    [[nodiscard]] inline std::string base64_encode(std::span<const std::uint8_t> input)
+    {
+        std::string result;
+        base64_encode_to(result, input);
+        return result;
+    }
+
+    // ============================================================================
+    // Line Builder
+    // ============================================================================
+
+    /// Builds one telemetry line `{"evt":"<type>",...}\n` into a reused buffer
+    class JsonLine
+    {
+    public:
+        JsonLine(std::string &buffer, EventType type) : buffer_(buffer)
+        {
+            buffer_.clear();
+            buffer_ += "{\"evt\":\"";
+            buffer_ += to_string(type);
+            buffer_ += '"';
+        }
+
+        /// Escaped string field
+        JsonLine &string(std::string_view key, std::string_view value)
+        {
+            begin_field(key);
+            buffer_ += '"';
+            json_escape_to(buffer_, value);
+            buffer_ += '"';
+            return *this;
+        }
+
+        /// Integer field
+        template <std::integral T>
+        JsonLine &number(std::string_view key, T value)
+        {
+            begin_field(key);
+            append_number(buffer_, value);
+            return *this;
+        }
+
+        /// Fixed-precision float field
+        JsonLine &number(std::string_view key, float value, int precision)
+        {
+            begin_field(key);
+            append_fixed(buffer_, value, precision);
+            return *this;
+        }
+
+        /// Base64 string field
+        JsonLine &base64(std::string_view key, std::span<const std::uint8_t> data)
+        {
+            begin_field(key);
+            buffer_ += '"';
+            base64_encode_to(buffer_, data);
+            buffer_ += '"';
+            return *this;
+        }
+
+        /// Close the object; the view is valid until the buffer is reused
+        [[nodiscard]] std::string_view finish()
+        {
+            buffer_ += "}\n";
+            return buffer_;
+        }
+
+    private:
+        // Keys are protocol constants and never need escaping
+        void begin_field(std::string_view key)
+        {
+            buffer_ += ",\"";
+            buffer_ += key;
+            buffer_ += "\":";
+        }
+
+        std::string &buffer_;
+    };
+
     // ============================================================================
     // Telemetry Emitter
     // ============================================================================
 
-    /// Thread-safe telemetry emitter using std::print
+    /// Additional consumer of formatted telemetry lines (e.g. the control socket).
+    /// Called with the emitter lock held, so publish() must not block.
+    class ITelemetrySink
+    {
+    public:
+        virtual ~ITelemetrySink() = default;
+
+        /// Combined subscription of all downstream consumers
+        [[nodiscard]] virtual Subscription demand() const noexcept = 0;
+
+        /// Hand over a fully formatted line (including trailing newline)
+        virtual void publish(EventType type, std::string_view line) = 0;
+    };
+
+    /// One key/value pair of a metrics event
+    struct Metric
+    {
+        std::string_view name;
+        std::int64_t value;
+    };
+
+    /// Thread-safe telemetry emitter. Each event is formatted once and written
+    /// to stdout and to the optional sink. Events no consumer subscribed to
+    /// (or that are not yet due) are dropped before formatting.
     class Emitter
     {
     public:
+        using Clock = RateGate::Clock;
+
         Emitter() = default;
 
+        /// Replace the subscription of the stdout/shared-ring consumer
+        void subscribe(const Subscription &sub)
+        {
+            std::lock_guard lock(mutex_);
+            stdout_sub_ = sub;
+        }
+
+        /// Whether any consumer currently wants this event type. Lets callers
+        /// skip producing expensive events (e.g. previews) altogether.
+        [[nodiscard]] bool wants(EventType type)
+        {
+            trace::Scope scope("Emitter::wants");
+            std::lock_guard lock(mutex_);
+            return stdout_sub_.wants(type) || (sink_ && sink_->demand().wants(type));
+        }
+
         /// Emit a status event
         void status(std::string_view state)
         {
@@ -127,24 +669,103 @@ export namespace harness::telemetry
             emit(EventType::Text, "body", content);
         }
 
+        /// Emit the final text of a committed transcript segment
+        void segment(std::uint64_t segment_id, std::string_view content)
+        {
+            std::lock_guard lock(mutex_);
+            publish(EventType::Text, true, Clock::now(), [&](JsonLine &line)
+                    { line.number("seg", segment_id).string("body", content); });
+        }
+
+        /// Emit improved text for an already committed segment
+        void revision(std::uint64_t segment_id, std::string_view content)
+        {
+            std::lock_guard lock(mutex_);
+            publish(EventType::Revision, true, Clock::now(), [&](JsonLine &line)
+                    { line.number("seg", segment_id).string("body", content); });
+        }
+
+        /// Emit a provisional hypothesis for the utterance in progress
+        void partial(std::string_view content)
+        {
+            emit(EventType::Partial, "body", content);
+        }
+
         /// Emit a transcribed text with timestamp
         void text(std::string_view content, std::chrono::milliseconds timestamp)
         {
             std::lock_guard lock(mutex_);
-            std::print(stdout, "{{\"evt\":\"{}\",\"body\":\"{}\",\"time\":{}}}\n",
-                       to_string(EventType::Text),
-                       json_escape(content),
-                       timestamp.count());
-            std::fflush(stdout);
+            publish(EventType::Text, true, Clock::now(), [&](JsonLine &line)
+                    { line.string("body", content).number("time", timestamp.count()); });
+        }
+
+        /// Emit a spotted keyphrase; `timestamp` is relative to session start
+        void keyword(std::string_view phrase, std::chrono::milliseconds timestamp, float confidence)
+        {
+            std::lock_guard lock(mutex_);
+            publish(EventType::Keyword, true, Clock::now(), [&](JsonLine &line)
+                    { line.string("body", phrase).number("time", timestamp.count()).number("conf", confidence, 2); });
+        }
+
+        /// Route level and preview events into a shared-memory ring instead of
+        /// stdout. Control and text events keep using the pipe.
+        void attach_shared_ring(shm::SharedRing ring)
+        {
+            std::lock_guard lock(mutex_);
+            ring_.emplace(std::move(ring));
         }
 
-        /// Emit an audio level event
+        [[nodiscard]] bool has_shared_ring()
+        {
+            std::lock_guard lock(mutex_);
+            return ring_.has_value();
+        }
+
+        /// Attach an additional line consumer (nullptr detaches)
+        void set_sink(std::shared_ptr<ITelemetrySink> sink)
+        {
+            std::lock_guard lock(mutex_);
+            sink_ = std::move(sink);
+        }
+
+        /// Offer an audio level reading. It is only sent when a consumer's
+        /// level rate says it is due, so callers may offer every frame.
         void level(float db)
         {
+            trace::Scope scope("Emitter::level");
+            std::lock_guard lock(mutex_);
+            const auto now = Clock::now();
+            const bool local = stdout_gate_.admit(stdout_sub_, EventType::Level, now);
+            if (local && ring_)
+            {
+                (void)ring_->write(shm::RecordType::Level, std::as_bytes(std::span(&db, 1)));
+            }
+            publish(EventType::Level, local && !ring_, now, [&](JsonLine &line)
+                    { line.number("db", db, 1); });
+        }
+
+        /// Emit packed waveform preview columns (3 bytes each: min, max, rms)
+        void waveform(std::span<const std::uint8_t> columns, std::size_t count)
+        {
+            trace::Scope scope("Emitter::waveform");
+            std::lock_guard lock(mutex_);
+            const bool local = stdout_sub_.wants(EventType::Waveform);
+            if (local)
+                write_binary(shm::RecordType::Waveform, columns, count);
+            publish(EventType::Waveform, local && !ring_, Clock::now(), [&](JsonLine &line)
+                    { line.number("cols", count).base64("data", columns); });
+        }
+
+        /// Emit log-mel spectrum slices (one byte per band, slices concatenated)
+        void spectrum(std::span<const std::uint8_t> slices, std::size_t bands)
+        {
+            trace::Scope scope("Emitter::spectrum");
             std::lock_guard lock(mutex_);
-            std::print(stdout, "{{\"evt\":\"{}\",\"db\":{:.1f}}}\n",
-                       to_string(EventType::Level), db);
-            std::fflush(stdout);
+            const bool local = stdout_sub_.wants(EventType::Spectrum);
+            if (local)
+                write_binary(shm::RecordType::Spectrum, slices, bands);
+            publish(EventType::Spectrum, local && !ring_, Clock::now(), [&](JsonLine &line)
+                    { line.number("bins", bands).base64("data", slices); });
         }
 
         /// Emit an error event
@@ -167,9 +788,23 @@ export namespace harness::telemetry
             auto epoch = std::chrono::duration_cast<std::chrono::milliseconds>(
                              now.time_since_epoch())
                              .count();
-            std::print(stdout, "{{\"evt\":\"{}\",\"ts\":{}}}\n",
-                       to_string(EventType::Heartbeat), epoch);
-            std::fflush(stdout);
+            publish(EventType::Heartbeat, true, Clock::now(), [&](JsonLine &line)
+                    { line.number("ts", epoch); });
+        }
+
+        /// Offer a metrics snapshot; sent at the subscribed metrics interval
+        void metrics(std::initializer_list<Metric> values)
+        {
+            trace::Scope scope("Emitter::metrics");
+            std::lock_guard lock(mutex_);
+            const auto now = Clock::now();
+            const bool local = stdout_gate_.admit(stdout_sub_, EventType::Metrics, now);
+            publish(EventType::Metrics, local, now, [&](JsonLine &line)
+                    {
+                        for (const auto &metric : values)
+                        {
+                            line.number(metric.name, metric.value);
+                        } });
         }
 
         /// Emit session start info
@@ -177,10 +812,8 @@ export namespace harness::telemetry
                            std::string_view output_path)
         {
             std::lock_guard lock(mutex_);
-            std::print(stdout,
-                       "{{\"evt\":\"session\",\"action\":\"start\",\"id\":\"{}\",\"path\":\"{}\"}}\n",
-                       json_escape(session_id), json_escape(output_path));
-            std::fflush(stdout);
+            publish(EventType::Session, true, Clock::now(), [&](JsonLine &line)
+                    { line.string("action", "start").string("id", session_id).string("path", output_path); });
         }
 
         /// Emit session end info
@@ -189,22 +822,71 @@ export namespace harness::telemetry
                          std::chrono::seconds duration)
         {
             std::lock_guard lock(mutex_);
-            std::print(stdout,
-                       "{{\"evt\":\"session\",\"action\":\"end\",\"id\":\"{}\",\"bytes\":{},\"duration\":{}}}\n",
-                       json_escape(session_id), bytes_written, duration.count());
-            std::fflush(stdout);
+            publish(EventType::Session, true, Clock::now(), [&](JsonLine &line)
+                    {
+                        line.string("action", "end")
+                            .string("id", session_id)
+                            .number("bytes", bytes_written)
+                            .number("duration", duration.count()); });
         }
 
     private:
+        /// Format (only if someone wants it) and deliver a line.
+        /// `to_stdout` is false when the event already went through the shared
+        /// ring or the local consumer's rate limit rejected it.
+        template <typename Build>
+        void publish(EventType type, bool to_stdout, Clock::time_point now, Build &&build)
+        {
+            trace::Scope scope("Emitter::publish");
+            to_stdout = to_stdout && stdout_sub_.wants(type);
+            const bool to_sink = sink_ && sink_gate_.admit(sink_->demand(), type, now);
+            if (!to_stdout && !to_sink)
+                return;
+
+            const auto started = Clock::now();
+            JsonLine builder(line_, type);
+            build(builder);
+            const auto line = builder.finish();
+            if (to_stdout)
+            {
+                std::fwrite(line.data(), 1, line.size(), stdout);
+                std::fflush(stdout);
+            }
+            if (to_sink)
+            {
+                sink_->publish(type, line);
+            }
+            emit_time_.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count()));
+        }
+
+        /// Write a count-prefixed binary record if a shared ring is attached
+        void write_binary(shm::RecordType type, std::span<const std::uint8_t> body,
+                          std::size_t count)
+        {
+            if (!ring_)
+                return;
+
+            auto prefix = static_cast<std::uint32_t>(count);
+            (void)ring_->write(type, std::as_bytes(std::span(&prefix, 1)), std::as_bytes(body));
+        }
+
         void emit(EventType type, std::string_view key, std::string_view value)
         {
             std::lock_guard lock(mutex_);
-            std::print(stdout, "{{\"evt\":\"{}\",\"{}\":\"{}\"}}\n",
-                       to_string(type), key, json_escape(value));
-            std::fflush(stdout);
+            publish(type, true, Clock::now(), [&](JsonLine &line)
+                    { line.string(key, value); });
         }
 
         std::mutex mutex_;
+        std::optional<shm::SharedRing> ring_;
+        std::string line_; // Reused formatting buffer
+        std::shared_ptr<ITelemetrySink> sink_;
+        Subscription stdout_sub_;
+        RateGate stdout_gate_;
+        RateGate sink_gate_;
+        metrics::Histogram &emit_time_ = metrics::global().histogram(
+            "harness_emit_seconds", "Time to format and deliver one telemetry line");
     };
 
     // ============================================================================
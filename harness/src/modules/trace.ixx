@@ -0,0 +1,311 @@
+// ============================================================================
+// TopNotchNotes Harness - Trace Module
+// Scoped markers around hot sections, recorded per thread and exported as a
+// Chrome trace (chrome://tracing, ui.perfetto.dev)
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HARNESS_TRACE_TSC 1
+#else
+#define HARNESS_TRACE_TSC 0
+#endif
+
+// Set by CMake from HARNESS_TRACING; markers compile to nothing when 0
+#ifndef HARNESS_TRACE_ENABLED
+#define HARNESS_TRACE_ENABLED 1
+#endif
+
+export module harness:trace;
+
+export namespace harness::trace
+{
+
+    /// Whether markers were compiled in. When false a Scope is empty and the
+    /// optimizer removes it entirely.
+    inline constexpr bool compiled_in = HARNESS_TRACE_ENABLED != 0;
+
+    /// Raw timestamp: the TSC on x86, the virtual counter on AArch64.
+    /// Converted to time once, when the trace is written.
+    [[nodiscard]] inline std::uint64_t ticks() noexcept
+    {
+#if HARNESS_TRACE_TSC
+        return __rdtsc();
+#elif defined(__aarch64__)
+        std::uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /// One completed marker. `name` must be a string literal.
+    struct Event
+    {
+        const char *name = nullptr;
+        std::uint64_t begin = 0;
+        std::uint64_t end = 0;
+    };
+
+    namespace detail
+    {
+        /// ~90 s of the busiest thread at typical marker rates; later events
+        /// in a window are counted as dropped
+        inline constexpr std::size_t events_per_thread = std::size_t{1} << 16;
+
+        /// Threads that can record at once; markers on any further thread
+        /// are dropped
+        inline constexpr std::size_t max_threads = 32;
+
+        /// Written only by the thread that claimed it. The exporter reads
+        /// `count` events once `epoch` shows they belong to the window being
+        /// exported. Event storage is not touched until it is written.
+        struct ThreadBuffer
+        {
+            std::atomic<bool> claimed{false};
+            int tid = 0;
+            char name[16] = {};
+            std::unique_ptr<Event[]> events = std::make_unique_for_overwrite<Event[]>(events_per_thread);
+            std::atomic<std::size_t> count{0};
+            std::atomic<std::uint64_t> epoch{0};
+            std::atomic<std::uint64_t> dropped{0};
+        };
+
+        struct State
+        {
+            std::atomic<bool> enabled{false};
+            std::atomic<std::uint64_t> epoch{0}; // One per START
+
+            std::mutex mutex; // Start/stop
+            std::unique_ptr<ThreadBuffer[]> buffers; // Allocated by the first START, never shrunk
+            std::atomic<ThreadBuffer *> pool{nullptr};
+            std::uint64_t start_ticks = 0;
+            std::chrono::steady_clock::time_point start_time;
+        };
+
+        inline State &state() noexcept
+        {
+            static State instance;
+            return instance;
+        }
+
+        /// A thread's claim on a pool buffer, given back when the thread exits
+        struct ThreadSlot
+        {
+            ThreadBuffer *buffer = nullptr;
+
+            ~ThreadSlot()
+            {
+                if (buffer)
+                    buffer->claimed.store(false, std::memory_order_release);
+            }
+        };
+
+        /// The calling thread's buffer. The first marker claims one from the
+        /// pool without locking or allocating, as it may run in the capture
+        /// callback. A buffer holding events of the current window is not
+        /// handed on. nullptr when every buffer is taken.
+        inline ThreadBuffer *thread_buffer() noexcept
+        {
+            thread_local ThreadSlot slot;
+            if (slot.buffer)
+                return slot.buffer;
+
+            auto *pool = state().pool.load(std::memory_order_acquire);
+            if (!pool)
+                return nullptr;
+            const auto epoch = state().epoch.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < max_threads; ++i)
+            {
+                auto &candidate = pool[i];
+                bool expected = false;
+                if (candidate.epoch.load(std::memory_order_acquire) == epoch ||
+                    !candidate.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                    continue;
+                candidate.tid = static_cast<int>(::gettid());
+                if (pthread_getname_np(pthread_self(), candidate.name, sizeof(candidate.name)) != 0)
+                    candidate.name[0] = '\0';
+                slot.buffer = &candidate;
+                return slot.buffer;
+            }
+            return nullptr;
+        }
+
+        inline void record(const char *name, std::uint64_t begin, std::uint64_t end) noexcept
+        {
+            auto *claimed = thread_buffer();
+            if (!claimed)
+                return;
+            auto &buffer = *claimed;
+            const auto epoch = state().epoch.load(std::memory_order_relaxed);
+            if (buffer.epoch.load(std::memory_order_relaxed) != epoch)
+            {
+                // First event of a new window on this thread
+                buffer.count.store(0, std::memory_order_relaxed);
+                buffer.dropped.store(0, std::memory_order_relaxed);
+                buffer.epoch.store(epoch, std::memory_order_release);
+            }
+
+            const auto index = buffer.count.load(std::memory_order_relaxed);
+            if (index >= events_per_thread)
+            {
+                buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            buffer.events[index] = {name, begin, end};
+            buffer.count.store(index + 1, std::memory_order_release);
+        }
+    } // namespace detail
+
+    // ============================================================================
+    // Markers
+    // ============================================================================
+
+    /// Times the enclosing block while a trace is running:
+    ///     trace::Scope scope("WavWriter::write");
+    /// Costs one relaxed load when no trace is running.
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name) noexcept
+        {
+            if constexpr (compiled_in)
+            {
+                if (detail::state().enabled.load(std::memory_order_relaxed))
+                {
+                    name_ = name;
+                    begin_ = ticks();
+                }
+            }
+        }
+
+        ~Scope()
+        {
+            if constexpr (compiled_in)
+            {
+                if (name_)
+                    detail::record(name_, begin_, ticks());
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *name_ = nullptr;
+        std::uint64_t begin_ = 0;
+    };
+
+    // ============================================================================
+    // Control
+    // ============================================================================
+
+    struct Summary
+    {
+        std::size_t events = 0;
+        std::uint64_t dropped = 0;
+        std::size_t threads = 0;
+    };
+
+    [[nodiscard]] inline bool active() noexcept
+    {
+        return detail::state().enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Open a recording window. Events of an earlier window are discarded.
+    inline void start()
+    {
+        auto &shared = detail::state();
+        std::lock_guard lock(shared.mutex);
+        if (!shared.buffers)
+        {
+            shared.buffers = std::make_unique<detail::ThreadBuffer[]>(detail::max_threads);
+            shared.pool.store(shared.buffers.get(), std::memory_order_release);
+        }
+        shared.epoch.fetch_add(1, std::memory_order_relaxed);
+        shared.start_time = std::chrono::steady_clock::now();
+        shared.start_ticks = ticks();
+        shared.enabled.store(true, std::memory_order_release);
+    }
+
+    /// Close the window and write it to `path` as Chrome trace JSON. The tick
+    /// rate is calibrated against the steady clock over the window itself.
+    inline std::expected<Summary, std::string> stop(const std::filesystem::path &path)
+    {
+        auto &shared = detail::state();
+        std::lock_guard lock(shared.mutex);
+        if (!shared.enabled.exchange(false, std::memory_order_acq_rel))
+            return std::unexpected("No trace running (TRACE START)");
+
+        const auto end_ticks = ticks();
+        const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                                      shared.start_time)
+                                 .count();
+        const double ticks_per_us =
+            elapsed > 0.0 ? static_cast<double>(end_ticks - shared.start_ticks) / elapsed : 1.0;
+
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open())
+            return std::unexpected("Failed to write trace: " + path.string());
+
+        const auto pid = ::getpid();
+        const auto epoch = shared.epoch.load(std::memory_order_relaxed);
+        Summary summary;
+        std::string text = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (std::size_t b = 0; b < detail::max_threads; ++b)
+        {
+            const auto *buffer = &shared.buffers[b];
+            if (buffer->epoch.load(std::memory_order_acquire) != epoch)
+                continue; // Recorded nothing in this window
+            const auto count = buffer->count.load(std::memory_order_acquire);
+
+            std::format_to(std::back_inserter(text),
+                           "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                           first ? "" : ",", pid, buffer->tid,
+                           buffer->name[0] != '\0' ? std::string_view(buffer->name) : "thread");
+            first = false;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto &event = buffer->events[i];
+                if (event.begin < shared.start_ticks)
+                    continue; // Opened before this window
+                std::format_to(std::back_inserter(text),
+                               ",\n{{\"name\":\"{}\",\"cat\":\"harness\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{}}}",
+                               event.name, static_cast<double>(event.begin - shared.start_ticks) / ticks_per_us,
+                               static_cast<double>(event.end - event.begin) / ticks_per_us, pid, buffer->tid);
+                ++summary.events;
+            }
+            summary.dropped += buffer->dropped.load(std::memory_order_relaxed);
+            ++summary.threads;
+        }
+        text += "]}\n";
+
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!out)
+            return std::unexpected("Failed to write trace: " + path.string());
+        return summary;
+    }
+
+} // namespace harness::trace
@@ -16,8 +16,20 @@ module;
 #include <chrono>
 #include <filesystem>
 #include <cmath>
+#include <format>
 #include <print>
 #include <algorithm>
+#include <utility>
+#include <fstream>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <unordered_set>
+#include <deque>
+
+#include <unistd.h>
 
 // PocketSphinx headers
 #include <pocketsphinx.h>
@@ -25,6 +37,11 @@ module;
 
 export module harness:transcribe;
 
+import :course;
+import :convert;
+import :trace;
+import :telemetry;
+
 export namespace harness::transcribe
 {
 
@@ -63,6 +80,20 @@ export namespace harness::transcribe
         }
     };
 
+    /// `segment` with its times moved by `offset`, e.g. from the start of
+    /// its utterance onto the session clock
+    [[nodiscard]] inline TranscriptSegment shifted(TranscriptSegment segment, std::chrono::milliseconds offset)
+    {
+        for (auto &word : segment.words)
+        {
+            word.start_time += offset;
+            word.end_time += offset;
+        }
+        segment.start_time += offset;
+        segment.end_time += offset;
+        return segment;
+    }
+
     // ============================================================================
     // Transcription Configuration
     // ============================================================================
@@ -71,17 +102,62 @@ export namespace harness::transcribe
     {
         std::filesystem::path model_path = "";
         std::filesystem::path dictionary_path = "";
+        std::filesystem::path lm_path = "";
+        double beam = 1e-48;      // Decoder beams: wider is slower but more accurate
+        double word_beam = 7e-29;
         std::uint32_t sample_rate = 16000; // Most ASR models use 16kHz
-        bool enable_punctuation = true;
+        std::uint32_t input_rate = 16000;  // Rate of the frames given to process(); a multiple of sample_rate
+        bool enable_punctuation = true; // Punctuate/truecase committed segments
+        std::filesystem::path punctuation_model_path = "/usr/share/topnotchnotes/punctuation.tnpm";
+        std::chrono::milliseconds punctuation_max_latency{250};
         bool enable_diarization = false;
         float silence_threshold_db = -40.0f;
         std::chrono::milliseconds min_silence_duration{300};
+        std::vector<std::string> keywords = {"exam", "homework", "important"};
+        double keyword_threshold = 1e-20; // Lower catches more phrases, with more false alarms
+
+        // Second pass over finished segments, on otherwise idle cores
+        bool enable_rescoring = true;
+        std::filesystem::path rescore_model_path = ""; // Larger acoustic model; empty keeps model_path
+        std::filesystem::path rescore_lm_path = "";    // Larger language model; empty keeps lm_path
+
+        // Backend, by registry name ("pocketsphinx", "whisper", "stub")
+        std::string engine = "pocketsphinx";
+
+        // Whisper backend: quantized ggml model, decoded in sliding windows
+        std::filesystem::path whisper_model_path = "/usr/share/topnotchnotes/ggml-base.en-q8_0.bin";
+        int whisper_threads = 2;
+        std::chrono::milliseconds whisper_window{10000}; // Audio per decode (whisper maximum is 30 s)
+        std::chrono::milliseconds whisper_step{2000};    // New speech between partial decodes
     };
 
+    /// Configuration for the background second pass: the larger models when
+    /// installed, and much wider beams since it does not run in real time
+    [[nodiscard]] inline TranscribeConfig rescoring_config(const TranscribeConfig &live)
+    {
+        auto config = live;
+        if (!live.rescore_model_path.empty())
+            config.model_path = live.rescore_model_path;
+        if (!live.rescore_lm_path.empty())
+            config.lm_path = live.rescore_lm_path;
+        config.beam = 1e-80;
+        config.word_beam = 1e-60;
+        config.input_rate = config.sample_rate; // The rescorer decimates the WAV itself
+        return config;
+    }
+
     // ============================================================================
     // Transcription Engine Interface
     // ============================================================================
 
+    /// Output of the asynchronous interface. Exactly one final event is
+    /// produced per submit_end(), with an empty segment when nothing was heard.
+    struct EngineEvent
+    {
+        TranscriptSegment segment;
+        bool final = false;
+    };
+
     /// Abstract interface for transcription backends
     class ITranscribeEngine
     {
@@ -99,6 +175,51 @@ export namespace harness::transcribe
 
         /// Check if engine is ready
         [[nodiscard]] virtual bool is_ready() const noexcept = 0;
+
+        /// Specialize for a course vocabulary; an empty model restores the
+        /// generic one. Takes effect at the next utterance boundary.
+        [[nodiscard]] virtual std::expected<void, std::string> use_course(const course::CourseModel &model)
+        {
+            (void)model;
+            return std::unexpected("Transcription engine does not support course vocabularies");
+        }
+
+        // ---- Asynchronous interface ------------------------------------------
+        // Chunked engines decode on their own worker and override these so the
+        // per-frame call never waits for a decode. The defaults run the
+        // synchronous calls inline.
+
+        /// Queue one frame of speech
+        virtual void submit(AudioFrame frame)
+        {
+            if (auto segment = process(frame))
+                ready_.push_back({std::move(*segment), false});
+        }
+
+        /// Mark the end of the current utterance
+        virtual void submit_end()
+        {
+            ready_.push_back({finalize().value_or(TranscriptSegment{}), true});
+        }
+
+        /// Next partial or final result, if one is ready; never blocks
+        [[nodiscard]] virtual std::optional<EngineEvent> poll()
+        {
+            if (ready_.empty())
+                return std::nullopt;
+            auto event = std::move(ready_.front());
+            ready_.pop_front();
+            return event;
+        }
+
+        /// Block until everything submitted has been decoded
+        virtual void flush() {}
+
+        /// True when submit() returns before decoding
+        [[nodiscard]] virtual bool is_async() const noexcept { return false; }
+
+    private:
+        std::deque<EngineEvent> ready_;
     };
 
     // ============================================================================
@@ -118,6 +239,7 @@ export namespace harness::transcribe
         /// Returns true if voice activity is detected
         [[nodiscard]] bool process(AudioFrame frame)
         {
+            trace::Scope scope("VAD");
             float db = calculate_db(frame);
 
             if (db > threshold_db_)
@@ -182,18 +304,12 @@ export namespace harness::transcribe
         [[nodiscard]] std::optional<TranscriptSegment> process(AudioFrame frame) override
         {
             ++frame_count_;
+            ++utterance_frames_;
 
             // Simulate periodic output
             if (frame_count_ % 50 == 0)
             {
-                auto now = std::chrono::milliseconds(frame_count_ * 20); // ~20ms per frame
-                return TranscriptSegment{
-                    .words = {{.text = "[audio detected]",
-                               .start_time = now - std::chrono::milliseconds(500),
-                               .end_time = now,
-                               .confidence = 0.9f}},
-                    .start_time = now - std::chrono::milliseconds(500),
-                    .end_time = now};
+                return make_segment();
             }
 
             return std::nullopt;
@@ -201,12 +317,18 @@ export namespace harness::transcribe
 
         [[nodiscard]] std::optional<TranscriptSegment> finalize() override
         {
-            return std::nullopt;
+            // Simulate a final result for every utterance that saw audio
+            if (std::exchange(utterance_frames_, 0) == 0)
+            {
+                return std::nullopt;
+            }
+            return make_segment();
         }
 
         void reset() override
         {
             frame_count_ = 0;
+            utterance_frames_ = 0;
         }
 
         [[nodiscard]] bool is_ready() const noexcept override
@@ -215,13 +337,88 @@ export namespace harness::transcribe
         }
 
     private:
+        [[nodiscard]] TranscriptSegment make_segment() const
+        {
+            auto now = std::chrono::milliseconds(frame_count_ * 20); // ~20ms per frame
+            return TranscriptSegment{
+                .words = {{.text = "[audio detected]",
+                           .start_time = now - std::chrono::milliseconds(500),
+                           .end_time = now,
+                           .confidence = 0.9f}},
+                .start_time = now - std::chrono::milliseconds(500),
+                .end_time = now};
+        }
+
         std::size_t frame_count_ = 0;
+        std::size_t utterance_frames_ = 0;
+    };
+
+    // ============================================================================
+    // Decoder Input
+    // ============================================================================
+
+    /// Brings live frames down to the decoder rate. Capture runs at a multiple
+    /// of it (48 kHz against 16 kHz); each output sample is the mean of
+    /// factor() inputs, and a partial group carries into the next frame so
+    /// frame edges lose nothing. Rates that do not divide are passed through.
+    class DecoderFeed
+    {
+    public:
+        DecoderFeed(std::uint32_t input_rate, std::uint32_t decoder_rate) noexcept
+            : factor_(decoder_rate > 0 && input_rate % decoder_rate == 0 ? input_rate / decoder_rate : 1)
+        {
+        }
+
+        /// Decimated samples for `frame`, valid until the next push()
+        [[nodiscard]] std::span<const float> push(AudioFrame frame) {
+            if (factor_ == 1) {
+                return frame;
+            }
+            output_.clear();
+            const float scale = 1.0f / static_cast<float>(factor_);
+            for (const float sample : frame) {
+                sum_ += sample;
+                if (++count_ == factor_) {
+                    output_.push_back(sum_ * scale);
+                    sum_ = 0.0f;
+                    count_ = 0;
+                }
+            }
+            return output_;
+        }
+
+        /// Drops a partial group, at an utterance boundary
+        void reset() noexcept {
+            sum_ = 0.0f;
+            count_ = 0;
+        }
+
+        [[nodiscard]] std::size_t factor() const noexcept { return factor_; }
+
+    private:
+        std::size_t factor_;
+        float sum_ = 0.0f;
+        std::size_t count_ = 0;
+        std::vector<float> output_;
     };
 
     // ============================================================================
     // PocketSphinx Transcription Engine
     // ============================================================================
 
+    /// PocketSphinx consumes 16-bit PCM. Runs on every frame, so it goes
+    /// through the SIMD converter; `out` only reallocates when it grows.
+    inline void to_pcm16(AudioFrame frame, std::vector<std::int16_t>& out) {
+        out.resize(frame.size());
+        convert::f32_to_s16(frame, out);
+    }
+
+    /// ps_process_raw under a trace marker; the decoder's share of each frame
+    inline int process_raw(ps_decoder_t* decoder, const std::vector<std::int16_t>& samples) {
+        trace::Scope scope("ps_process_raw");
+        return ps_process_raw(decoder, samples.data(), samples.size(), FALSE, FALSE);
+    }
+
     class PocketSphinxEngine : public ITranscribeEngine
     {
     public:
@@ -234,21 +431,34 @@ export namespace harness::transcribe
         [[nodiscard]] std::optional<TranscriptSegment> finalize() override;
         void reset() override;
         [[nodiscard]] bool is_ready() const noexcept override;
+        [[nodiscard]] std::expected<void, std::string> use_course(const course::CourseModel &model) override;
 
     private:
-        explicit PocketSphinxEngine(ps_decoder_t* decoder, std::uint32_t sample_rate);
+        PocketSphinxEngine(ps_decoder_t* decoder, std::uint32_t sample_rate, std::uint32_t input_rate);
+
+        std::expected<void, std::string> apply_pending_course();
+        void add_dictionary_words(const std::filesystem::path &dict_path);
         
         ps_decoder_t* decoder_ = nullptr;
+        std::string default_search_;                   // Generic LM search, restored on demand
+        std::optional<course::CourseModel> pending_course_;
+        std::unordered_set<std::string> dict_courses_; // Courses whose words were added
         std::uint32_t sample_rate_ = 16000;
+        DecoderFeed feed_;
         std::vector<std::int16_t> resample_buffer_;
         std::size_t frame_count_ = 0;
         bool utterance_started_ = false;
     };
 
-    PocketSphinxEngine::PocketSphinxEngine(ps_decoder_t* decoder, std::uint32_t sample_rate)
+    PocketSphinxEngine::PocketSphinxEngine(ps_decoder_t* decoder, std::uint32_t sample_rate,
+                                           std::uint32_t input_rate)
         : decoder_(decoder)
         , sample_rate_(sample_rate)
+        , feed_(input_rate, sample_rate)
     {
+        if (const char* search = ps_get_search(decoder_)) {
+            default_search_ = search;
+        }
     }
 
     PocketSphinxEngine::~PocketSphinxEngine() {
@@ -265,7 +475,7 @@ export namespace harness::transcribe
         const char* dict_path = "/usr/share/pocketsphinx/model/en-us/cmudict-en-us.dict";
         
         // Override with custom paths if provided
-        std::string custom_hmm, custom_dict;
+        std::string custom_hmm, custom_dict, custom_lm;
         if (!config.model_path.empty()) {
             custom_hmm = config.model_path.string();
             hmm_path = custom_hmm.c_str();
@@ -274,12 +484,20 @@ export namespace harness::transcribe
             custom_dict = config.dictionary_path.string();
             dict_path = custom_dict.c_str();
         }
+        if (!config.lm_path.empty()) {
+            custom_lm = config.lm_path.string();
+            lm_path = custom_lm.c_str();
+        }
+        const auto beam = std::format("{}", config.beam);
+        const auto word_beam = std::format("{}", config.word_beam);
 
         // Create command-line configuration using SphinxBase
         cmd_ln_t* ps_cfg = cmd_ln_init(nullptr, ps_args(), TRUE,
             "-hmm", hmm_path,
             "-lm", lm_path,
             "-dict", dict_path,
+            "-beam", beam.c_str(),
+            "-wbeam", word_beam.c_str(),
             "-logfn", "/dev/null",  // Suppress verbose logging
             nullptr);
         
@@ -296,10 +514,10 @@ export namespace harness::transcribe
         }
 
         auto engine = std::unique_ptr<PocketSphinxEngine>(
-            new PocketSphinxEngine(decoder, config.sample_rate)
+            new PocketSphinxEngine(decoder, config.sample_rate, config.input_rate)
         );
         
-        std::print("PocketSphinx engine initialized (sample_rate={})\n", config.sample_rate);
+        telemetry::emit_info(std::format("PocketSphinx engine initialized (sample_rate={})", config.sample_rate));
         return engine;
     }
 
@@ -310,24 +528,24 @@ export namespace harness::transcribe
 
         // Start utterance if not already started
         if (!utterance_started_) {
+            if (pending_course_) {
+                if (auto applied = apply_pending_course(); !applied) {
+                    telemetry::emit_error(applied.error());
+                }
+            }
             if (ps_start_utt(decoder_) < 0) {
-                std::print(stderr, "Failed to start utterance\n");
+                telemetry::emit_error("Failed to start utterance");
                 return std::nullopt;
             }
             utterance_started_ = true;
         }
 
-        // Convert float [-1,1] to int16
-        resample_buffer_.resize(frame.size());
-        std::transform(frame.begin(), frame.end(), resample_buffer_.begin(),
-            [](float s) -> std::int16_t {
-                return static_cast<std::int16_t>(std::clamp(s, -1.0f, 1.0f) * 32767.0f);
-            });
+        // Down to the decoder rate, then float [-1,1] to int16
+        to_pcm16(feed_.push(frame), resample_buffer_);
 
         // Process audio
-        if (ps_process_raw(decoder_, resample_buffer_.data(), 
-                           resample_buffer_.size(), FALSE, FALSE) < 0) {
-            std::print(stderr, "Failed to process audio\n");
+        if (process_raw(decoder_, resample_buffer_) < 0) {
+            telemetry::emit_error("Failed to process audio");
             return std::nullopt;
         }
 
@@ -386,29 +604,375 @@ export namespace harness::transcribe
             utterance_started_ = false;
         }
         frame_count_ = 0;
+        feed_.reset();
     }
 
     bool PocketSphinxEngine::is_ready() const noexcept {
         return decoder_ != nullptr;
     }
 
+    std::expected<void, std::string> PocketSphinxEngine::use_course(const course::CourseModel &model) {
+        if (!decoder_) {
+            return std::unexpected("Decoder not initialized");
+        }
+
+        // Searches can only be switched between utterances
+        pending_course_ = model;
+        if (utterance_started_) {
+            return {};
+        }
+        return apply_pending_course();
+    }
+
+    std::expected<void, std::string> PocketSphinxEngine::apply_pending_course() {
+        auto model = std::move(*pending_course_);
+        pending_course_.reset();
+
+        if (model.lm_path.empty()) {
+            if (ps_set_search(decoder_, default_search_.c_str()) < 0) {
+                return std::unexpected("Failed to restore the generic language model");
+            }
+            return {};
+        }
+
+        // Course words must be in the dictionary before the LM references them
+        if (!model.dict_path.empty() && dict_courses_.insert(model.course_id).second) {
+            add_dictionary_words(model.dict_path);
+        }
+
+        // Each course LM is loaded into the warm decoder once and kept as a
+        // named search, so switching back and forth is just ps_set_search
+        const auto search = "course:" + model.course_id;
+        if (!ps_get_lm(decoder_, search.c_str()) &&
+            ps_set_lm_file(decoder_, search.c_str(), model.lm_path.c_str()) < 0) {
+            return std::unexpected("Failed to load language model " + model.lm_path.string());
+        }
+        if (ps_set_search(decoder_, search.c_str()) < 0) {
+            return std::unexpected("Failed to activate language model for course " + model.course_id);
+        }
+        return {};
+    }
+
+    void PocketSphinxEngine::add_dictionary_words(const std::filesystem::path &dict_path) {
+        std::ifstream dict(dict_path);
+        std::vector<std::pair<std::string, std::string>> words;
+        std::string line;
+        while (std::getline(dict, line)) {
+            auto split = line.find_first_of(" \t");
+            if (line.empty() || line[0] == '#' || split == std::string::npos) {
+                continue;
+            }
+            auto phones = line.find_first_not_of(" \t", split);
+            if (phones != std::string::npos) {
+                words.emplace_back(line.substr(0, split), line.substr(phones));
+            }
+        }
+
+        // Rebuild the search structures once, after the last word
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            const bool last = i + 1 == words.size();
+            ps_add_word(decoder_, words[i].first.c_str(), words[i].second.c_str(), last ? TRUE : FALSE);
+        }
+    }
+
     // ============================================================================
-    // Factory Function
+    // PocketSphinx Keyword Spotter
     // ============================================================================
 
-    /// Create a transcription engine based on configuration
-    [[nodiscard]] inline std::unique_ptr<ITranscribeEngine>
-    create_engine(const TranscribeConfig &config)
+    /// PocketSphinx keyphrase list for `keywords`, one phrase per line. Each
+    /// phrase is trimmed, lower-cased to match the dictionary and spaced
+    /// singly; blank and repeated phrases are dropped. A phrase may carry its
+    /// own "/threshold/", otherwise `threshold` is appended.
+    [[nodiscard]] inline std::string keyphrase_list(std::span<const std::string> keywords, double threshold)
     {
-        // Try PocketSphinx first
-        auto result = PocketSphinxEngine::create(config);
-        if (result) {
-            return std::move(*result);
+        std::string list;
+        std::unordered_set<std::string> seen;
+        for (const auto &keyword : keywords)
+        {
+            std::string_view text = keyword;
+            std::string_view own_threshold;
+            if (const auto slash = text.find('/'); slash != std::string_view::npos)
+            {
+                own_threshold = text.substr(slash);
+                text = text.substr(0, slash);
+                while (!own_threshold.empty() && std::isspace(static_cast<unsigned char>(own_threshold.back())))
+                    own_threshold.remove_suffix(1);
+                if (own_threshold.size() < 3 || own_threshold.back() != '/')
+                    own_threshold = {};
+            }
+
+            std::string phrase;
+            bool gap = false;
+            for (const char c : text)
+            {
+                if (std::isspace(static_cast<unsigned char>(c)))
+                {
+                    gap = !phrase.empty();
+                    continue;
+                }
+                if (gap)
+                    phrase += ' ';
+                gap = false;
+                phrase += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            if (phrase.empty() || !seen.insert(phrase).second)
+                continue;
+
+            list += own_threshold.empty() ? std::format("{} /{}/\n", phrase, threshold)
+                                          : std::format("{} {}\n", phrase, own_threshold);
         }
-        std::print(stderr, "PocketSphinx failed: {} - falling back to stub\n", result.error());
+        return list;
+    }
 
-        // Fallback to stub engine
-        return std::make_unique<StubTranscribeEngine>();
+    /// Keyphrase search without a language model. Only the keyphrase HMMs and
+    /// a phone loop are scored, a small fraction of the cost of full decoding.
+    /// Each hit comes back as a segment with one word per detected phrase,
+    /// timed from the start of the current utterance.
+    class KeywordSpotterEngine : public ITranscribeEngine
+    {
+    public:
+        static std::expected<std::unique_ptr<KeywordSpotterEngine>, std::string>
+        create(const TranscribeConfig &config);
+
+        ~KeywordSpotterEngine() override;
+
+        [[nodiscard]] std::optional<TranscriptSegment> process(AudioFrame frame) override;
+        [[nodiscard]] std::optional<TranscriptSegment> finalize() override;
+        void reset() override;
+        [[nodiscard]] bool is_ready() const noexcept override;
+        [[nodiscard]] std::expected<void, std::string> use_course(const course::CourseModel &model) override;
+
+        static constexpr std::uint32_t frames_per_second = 100; // PocketSphinx default -frate
+
+        /// Time of decoder frame `frame` in a search that began `search_start`
+        /// samples into the utterance, from the start of the utterance
+        [[nodiscard]] static std::chrono::milliseconds hit_time(std::uint64_t search_start, std::uint32_t sample_rate,
+                                                                int frame) noexcept
+        {
+            return std::chrono::milliseconds(search_start * 1000 / sample_rate +
+                                             static_cast<std::uint64_t>(std::max(frame, 0)) * 1000 / frames_per_second);
+        }
+
+    private:
+
+        KeywordSpotterEngine(ps_decoder_t* decoder, std::uint32_t sample_rate, std::uint32_t input_rate);
+
+        std::expected<void, std::string> apply_pending_course();
+        std::optional<TranscriptSegment> collect_hits();
+
+        ps_decoder_t* decoder_ = nullptr;
+        std::string default_search_;
+        std::optional<course::CourseModel> pending_course_;
+        std::uint32_t sample_rate_ = 16000;
+        DecoderFeed feed_;
+        std::vector<std::int16_t> sample_buffer_;
+        std::uint64_t utterance_samples_ = 0; // Fed to the decoder since the utterance began
+        std::uint64_t search_start_ = 0;      // utterance_samples_ when the search restarted
+        bool search_started_ = false;
+    };
+
+    KeywordSpotterEngine::KeywordSpotterEngine(ps_decoder_t* decoder, std::uint32_t sample_rate,
+                                               std::uint32_t input_rate)
+        : decoder_(decoder)
+        , sample_rate_(sample_rate)
+        , feed_(input_rate, sample_rate)
+    {
+        if (const char* search = ps_get_search(decoder_)) {
+            default_search_ = search;
+        }
+    }
+
+    KeywordSpotterEngine::~KeywordSpotterEngine() {
+        if (decoder_) {
+            ps_free(decoder_);
+        }
+    }
+
+    std::expected<std::unique_ptr<KeywordSpotterEngine>, std::string>
+    KeywordSpotterEngine::create(const TranscribeConfig &config) {
+        if (config.keywords.empty()) {
+            return std::unexpected("No keywords configured");
+        }
+
+        const char* hmm_path = "/usr/share/pocketsphinx/model/en-us/en-us";
+        const char* dict_path = "/usr/share/pocketsphinx/model/en-us/cmudict-en-us.dict";
+        std::string custom_hmm, custom_dict;
+        if (!config.model_path.empty()) {
+            custom_hmm = config.model_path.string();
+            hmm_path = custom_hmm.c_str();
+        }
+        if (!config.dictionary_path.empty()) {
+            custom_dict = config.dictionary_path.string();
+            dict_path = custom_dict.c_str();
+        }
+
+        const auto list = keyphrase_list(config.keywords, config.keyword_threshold);
+        if (list.empty()) {
+            return std::unexpected("No keywords configured");
+        }
+
+        // The keyphrase list is only read while the decoder is set up. mkstemp
+        // creates a new 0600 file, so nothing else can plant or read it, and it
+        // is unlinked as soon as the decoder has loaded it.
+        auto kws_name = (std::filesystem::temp_directory_path() / "tnn-keywords-XXXXXX").string();
+        const int kws_fd = ::mkstemp(kws_name.data());
+        if (kws_fd < 0) {
+            return std::unexpected(std::format("Failed to create keyword list: {}", std::strerror(errno)));
+        }
+        const std::filesystem::path kws_path = kws_name;
+        bool written = true;
+        for (std::size_t done = 0; done < list.size();) {
+            const auto n = ::write(kws_fd, list.data() + done, list.size() - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                written = false;
+                break;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        if (::close(kws_fd) != 0 || !written) {
+            std::filesystem::remove(kws_path);
+            return std::unexpected("Failed to write keyword list " + kws_path.string());
+        }
+
+        cmd_ln_t* ps_cfg = cmd_ln_init(nullptr, ps_args(), TRUE,
+            "-hmm", hmm_path,
+            "-dict", dict_path,
+            "-kws", kws_path.c_str(),
+            "-logfn", "/dev/null",
+            nullptr);
+        if (!ps_cfg) {
+            std::filesystem::remove(kws_path);
+            return std::unexpected("Failed to create PocketSphinx keyword config");
+        }
+
+        ps_decoder_t* decoder = ps_init(ps_cfg);
+        std::filesystem::remove(kws_path);
+        if (!decoder) {
+            cmd_ln_free_r(ps_cfg);
+            return std::unexpected("Failed to initialize PocketSphinx keyword spotter - check model paths");
+        }
+
+        return std::unique_ptr<KeywordSpotterEngine>(
+            new KeywordSpotterEngine(decoder, config.sample_rate, config.input_rate));
+    }
+
+    std::optional<TranscriptSegment> KeywordSpotterEngine::process(AudioFrame frame) {
+        if (!decoder_ || frame.empty()) {
+            return std::nullopt;
+        }
+
+        if (!search_started_) {
+            if (pending_course_) {
+                if (auto applied = apply_pending_course(); !applied) {
+                    telemetry::emit_error(applied.error());
+                }
+            }
+            if (ps_start_utt(decoder_) < 0) {
+                return std::nullopt;
+            }
+            search_start_ = utterance_samples_;
+            search_started_ = true;
+        }
+
+        // Hit frames are counted at the decoder rate, so the samples are too
+        to_pcm16(feed_.push(frame), sample_buffer_);
+        if (process_raw(decoder_, sample_buffer_) < 0) {
+            return std::nullopt;
+        }
+        utterance_samples_ += sample_buffer_.size();
+
+        // A keyphrase search has a hypothesis only once something matched;
+        // restart it so the same phrase is not reported twice
+        const char* hyp = ps_get_hyp(decoder_, nullptr);
+        if (!hyp || hyp[0] == '\0') {
+            return std::nullopt;
+        }
+        return collect_hits();
+    }
+
+    std::optional<TranscriptSegment> KeywordSpotterEngine::finalize() {
+        std::optional<TranscriptSegment> hits;
+        if (decoder_ && search_started_) {
+            hits = collect_hits();
+        }
+        utterance_samples_ = 0;
+        feed_.reset();
+        return hits;
+    }
+
+    void KeywordSpotterEngine::reset() {
+        if (decoder_ && search_started_) {
+            ps_end_utt(decoder_);
+            search_started_ = false;
+        }
+        utterance_samples_ = 0;
+        feed_.reset();
+    }
+
+    bool KeywordSpotterEngine::is_ready() const noexcept {
+        return decoder_ != nullptr;
+    }
+
+    std::optional<TranscriptSegment> KeywordSpotterEngine::collect_hits() {
+        ps_end_utt(decoder_);
+        search_started_ = false;
+
+        auto to_ms = [&](int frame) { return hit_time(search_start_, sample_rate_, frame); };
+
+        TranscriptSegment segment{};
+        for (ps_seg_t* seg = ps_seg_iter(decoder_); seg; seg = ps_seg_next(seg)) {
+            int start_frame = 0, end_frame = 0;
+            ps_seg_frames(seg, &start_frame, &end_frame);
+            int32 ascr = 0, lscr = 0, lback = 0;
+            const auto prob = ps_seg_prob(seg, &ascr, &lscr, &lback);
+            segment.words.push_back({
+                .text = ps_seg_word(seg),
+                .start_time = to_ms(start_frame),
+                .end_time = to_ms(end_frame),
+                .confidence = static_cast<float>(logmath_exp(ps_get_logmath(decoder_), prob))
+            });
+        }
+
+        if (segment.words.empty()) {
+            return std::nullopt;
+        }
+        segment.start_time = segment.words.front().start_time;
+        segment.end_time = segment.words.back().end_time;
+        return segment;
+    }
+
+    std::expected<void, std::string> KeywordSpotterEngine::use_course(const course::CourseModel &model) {
+        if (!decoder_) {
+            return std::unexpected("Keyword spotter not initialized");
+        }
+        pending_course_ = model;
+        if (search_started_) {
+            return {};
+        }
+        return apply_pending_course();
+    }
+
+    std::expected<void, std::string> KeywordSpotterEngine::apply_pending_course() {
+        auto model = std::move(*pending_course_);
+        pending_course_.reset();
+
+        // Courses without their own keyword list use the default one
+        if (model.keywords_path.empty()) {
+            if (ps_set_search(decoder_, default_search_.c_str()) < 0) {
+                return std::unexpected("Failed to restore the default keywords");
+            }
+            return {};
+        }
+
+        const auto search = "kws:" + model.course_id;
+        if (ps_set_kws(decoder_, search.c_str(), model.keywords_path.c_str()) < 0 ||
+            ps_set_search(decoder_, search.c_str()) < 0) {
+            return std::unexpected("Failed to load keywords for course " + model.course_id);
+        }
+        return {};
     }
 
     // ============================================================================
@@ -0,0 +1,398 @@
+// ============================================================================
+// TopNotchNotes Harness - Whisper Transcription Module
+// CPU transformer backend (whisper.cpp / ggml) decoding sliding windows
+// ============================================================================
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if __has_include(<whisper.h>)
+#include <whisper.h>
+#define HARNESS_HAS_WHISPER 1
+#else
+#define HARNESS_HAS_WHISPER 0
+#endif
+
+export module harness:whisper;
+
+import :transcribe;
+import :telemetry;
+
+export namespace harness::transcribe
+{
+
+    /// Whether the harness was built against whisper.cpp
+    inline constexpr bool whisper_available = HARNESS_HAS_WHISPER != 0;
+
+    /// Rate whisper decodes at (whisper.cpp's WHISPER_SAMPLE_RATE)
+    inline constexpr std::uint32_t whisper_rate = 16000;
+
+    /// One decode of a final: `length` samples from `offset`, whose words are
+    /// moved by `shift` onto the utterance's timeline
+    struct WhisperWindow
+    {
+        std::size_t offset;
+        std::size_t length;
+        std::chrono::milliseconds shift;
+    };
+
+    /// Splits `samples` of whisper-rate audio into windows of `window`. A
+    /// tail under a second joins the window before it rather than being
+    /// decoded from mostly padding.
+    [[nodiscard]] inline std::vector<WhisperWindow> whisper_windows(std::size_t samples, std::size_t window)
+    {
+        std::vector<WhisperWindow> windows;
+        for (std::size_t offset = 0, length = 0; offset < samples && window > 0; offset += length)
+        {
+            length = std::min(window, samples - offset);
+            if (samples - offset - length < whisper_rate)
+                length = samples - offset;
+            windows.push_back({offset, length, std::chrono::milliseconds(offset * 1000 / whisper_rate)});
+        }
+        return windows;
+    }
+
+#if HARNESS_HAS_WHISPER
+
+    static_assert(whisper_rate == WHISPER_SAMPLE_RATE);
+
+    // ============================================================================
+    // Whisper Engine
+    // ============================================================================
+
+    /// whisper.cpp on the CPU. Quantized ggml models (q8_0, q5_1) load as-is
+    /// and roughly halve memory traffic, which is what bounds CPU decoding.
+    ///
+    /// Whisper decodes whole windows, not frames, so all decoding happens on
+    /// one worker thread:
+    ///  - while speech continues, every `whisper_step` of new audio queues a
+    ///    partial decode of the trailing `whisper_window`;
+    ///  - submit_end() queues the whole utterance, decoded window by window.
+    /// Queued partials are coalesced: only the newest one is decoded, since
+    /// older ones would be superseded before anyone saw them.
+    class WhisperEngine : public ITranscribeEngine
+    {
+    public:
+        static std::expected<std::unique_ptr<WhisperEngine>, std::string>
+        create(const TranscribeConfig &config);
+
+        ~WhisperEngine() override;
+
+        // Synchronous interface, built on the asynchronous one
+        [[nodiscard]] std::optional<TranscriptSegment> process(AudioFrame frame) override;
+        [[nodiscard]] std::optional<TranscriptSegment> finalize() override;
+        void reset() override;
+        [[nodiscard]] bool is_ready() const noexcept override;
+
+        void submit(AudioFrame frame) override;
+        void submit_end() override;
+        [[nodiscard]] std::optional<EngineEvent> poll() override;
+        void flush() override;
+        [[nodiscard]] bool is_async() const noexcept override { return true; }
+
+    private:
+        struct Job
+        {
+            std::vector<float> audio; // 16 kHz mono
+            bool final = false;
+            std::uint64_t generation = 0;
+        };
+
+        WhisperEngine(whisper_context *context, const TranscribeConfig &config);
+
+        void run(std::stop_token stop);
+        [[nodiscard]] TranscriptSegment decode(std::span<const float> audio, bool partial);
+
+        whisper_context *context_ = nullptr;
+        DecoderFeed feed_; // Capture frames down to whisper_rate
+        std::size_t window_samples_;
+        std::size_t step_samples_;
+        int threads_;
+        std::vector<float> padded_; // Worker only: short input padded to a second
+
+        // Producer side (caller's thread)
+        std::vector<float> utterance_;
+        std::size_t since_partial_ = 0;
+
+        std::mutex mutex_;
+        std::condition_variable_any wake_;
+        std::condition_variable idle_;
+        std::deque<Job> jobs_;
+        std::deque<EngineEvent> results_;
+        std::uint64_t generation_ = 0; // Bumped by reset() to discard in-flight work
+        bool busy_ = false;
+
+        std::jthread worker_; // Last: started after everything above exists
+    };
+
+    WhisperEngine::WhisperEngine(whisper_context *context, const TranscribeConfig &config)
+        : context_(context),
+          feed_(config.input_rate, whisper_rate),
+          window_samples_(static_cast<std::size_t>(config.whisper_window.count()) * WHISPER_SAMPLE_RATE / 1000),
+          step_samples_(static_cast<std::size_t>(config.whisper_step.count()) * WHISPER_SAMPLE_RATE / 1000),
+          threads_(config.whisper_threads),
+          worker_([this](std::stop_token stop)
+                  { run(stop); })
+    {
+    }
+
+    std::expected<std::unique_ptr<WhisperEngine>, std::string>
+    WhisperEngine::create(const TranscribeConfig &config)
+    {
+        if (!std::filesystem::exists(config.whisper_model_path))
+        {
+            return std::unexpected("Whisper model not found: " + config.whisper_model_path.string());
+        }
+
+        auto params = whisper_context_default_params();
+        params.use_gpu = false;
+        whisper_context *context = whisper_init_from_file_with_params(config.whisper_model_path.c_str(), params);
+        if (!context)
+        {
+            return std::unexpected("Failed to load whisper model " + config.whisper_model_path.string());
+        }
+
+        telemetry::emit_info(std::format("Whisper engine initialized ({} threads)", config.whisper_threads));
+        return std::unique_ptr<WhisperEngine>(new WhisperEngine(context, config));
+    }
+
+    WhisperEngine::~WhisperEngine()
+    {
+        worker_.request_stop();
+        wake_.notify_all();
+        if (worker_.joinable())
+            worker_.join();
+        whisper_free(context_);
+    }
+
+    void WhisperEngine::submit(AudioFrame frame)
+    {
+        const auto samples = feed_.push(frame);
+        utterance_.insert(utterance_.end(), samples.begin(), samples.end());
+        since_partial_ += samples.size();
+        if (since_partial_ < step_samples_)
+            return;
+        since_partial_ = 0;
+
+        const auto tail = std::min(utterance_.size(), window_samples_);
+        Job job{{utterance_.end() - static_cast<std::ptrdiff_t>(tail), utterance_.end()}, false, 0};
+        {
+            std::lock_guard lock(mutex_);
+            job.generation = generation_;
+            std::erase_if(jobs_, [](const Job &queued)
+                          { return !queued.final; });
+            jobs_.push_back(std::move(job));
+        }
+        wake_.notify_one();
+    }
+
+    void WhisperEngine::submit_end()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            std::erase_if(jobs_, [](const Job &queued)
+                          { return !queued.final; });
+            jobs_.push_back({std::move(utterance_), true, generation_});
+        }
+        utterance_.clear();
+        since_partial_ = 0;
+        feed_.reset();
+        wake_.notify_one();
+    }
+
+    std::optional<EngineEvent> WhisperEngine::poll()
+    {
+        std::lock_guard lock(mutex_);
+        if (results_.empty())
+            return std::nullopt;
+        auto event = std::move(results_.front());
+        results_.pop_front();
+        return event;
+    }
+
+    void WhisperEngine::flush()
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this]
+                   { return jobs_.empty() && !busy_; });
+    }
+
+    std::optional<TranscriptSegment> WhisperEngine::process(AudioFrame frame)
+    {
+        submit(frame);
+
+        // Latest partial, if the worker produced one since the last call
+        std::optional<TranscriptSegment> latest;
+        std::lock_guard lock(mutex_);
+        while (!results_.empty() && !results_.front().final)
+        {
+            latest = std::move(results_.front().segment);
+            results_.pop_front();
+        }
+        return latest;
+    }
+
+    std::optional<TranscriptSegment> WhisperEngine::finalize()
+    {
+        submit_end();
+        flush();
+        while (auto event = poll())
+        {
+            if (event->final)
+            {
+                if (event->segment.words.empty())
+                    return std::nullopt;
+                return std::move(event->segment);
+            }
+        }
+        return std::nullopt;
+    }
+
+    void WhisperEngine::reset()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            ++generation_;
+            jobs_.clear();
+            results_.clear();
+        }
+        utterance_.clear();
+        since_partial_ = 0;
+        feed_.reset();
+    }
+
+    bool WhisperEngine::is_ready() const noexcept
+    {
+        return context_ != nullptr;
+    }
+
+    void WhisperEngine::run(std::stop_token stop)
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(mutex_);
+                busy_ = false;
+                idle_.notify_all();
+                if (!wake_.wait(lock, stop, [this]
+                                { return !jobs_.empty(); }) ||
+                    stop.stop_requested())
+                    return;
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+                busy_ = true;
+            }
+
+            // Finals cover the whole utterance, one window at a time
+            TranscriptSegment result{};
+            const std::span<const float> audio(job.audio);
+            const auto chunk = job.final ? window_samples_ : audio.size();
+            for (const auto &window : whisper_windows(audio.size(), chunk))
+            {
+                auto piece = decode(audio.subspan(window.offset, window.length), !job.final);
+                for (auto &word : piece.words)
+                {
+                    word.start_time += window.shift;
+                    word.end_time += window.shift;
+                    result.words.push_back(std::move(word));
+                }
+            }
+            if (!result.words.empty())
+            {
+                result.start_time = result.words.front().start_time;
+                result.end_time = result.words.back().end_time;
+            }
+
+            std::lock_guard lock(mutex_);
+            if (job.generation == generation_ && (job.final || !result.words.empty()))
+                results_.push_back({std::move(result), job.final});
+        }
+    }
+
+    TranscriptSegment WhisperEngine::decode(std::span<const float> audio, bool partial)
+    {
+        TranscriptSegment segment{};
+
+        if (audio.empty())
+            return segment;
+
+        // Whisper needs at least one second of input; shorter utterances are
+        // padded with silence (and a little more, as whisper rounds down)
+        const auto duration = std::chrono::milliseconds(audio.size() * 1000 / WHISPER_SAMPLE_RATE);
+        if (audio.size() < WHISPER_SAMPLE_RATE)
+        {
+            padded_.assign(WHISPER_SAMPLE_RATE + WHISPER_SAMPLE_RATE / 100, 0.0f);
+            std::ranges::copy(audio, padded_.begin());
+            audio = padded_;
+        }
+
+        auto params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+        params.n_threads = threads_;
+        params.language = "en";
+        params.no_context = true;
+        params.single_segment = partial; // Partials are replaced wholesale anyway
+        params.print_progress = false;
+        params.print_realtime = false;
+        params.print_special = false;
+        params.print_timestamps = false;
+
+        if (whisper_full(context_, params, audio.data(), static_cast<int>(audio.size())) != 0)
+            return segment;
+
+        // Whisper timestamps are in 10 ms units
+        const int count = whisper_full_n_segments(context_);
+        for (int i = 0; i < count; ++i)
+        {
+            std::string_view text = whisper_full_get_segment_text(context_, i);
+            while (!text.empty() && text.front() == ' ')
+                text.remove_prefix(1);
+            if (text.empty())
+                continue;
+
+            // Confidence is the mean probability of the segment's text tokens;
+            // timestamps and other special tokens sort after end-of-text
+            float probability = 0.0f;
+            int tokens = 0;
+            for (int t = 0, n = whisper_full_n_tokens(context_, i); t < n; ++t)
+            {
+                if (whisper_full_get_token_id(context_, i, t) >= whisper_token_eot(context_))
+                    continue;
+                probability += whisper_full_get_token_p(context_, i, t);
+                ++tokens;
+            }
+
+            const auto t0 = std::chrono::milliseconds(whisper_full_get_segment_t0(context_, i) * 10);
+            const auto t1 = std::chrono::milliseconds(whisper_full_get_segment_t1(context_, i) * 10);
+            segment.words.push_back({
+                .text = std::string(text),
+                .start_time = std::min(duration, t0),
+                .end_time = std::min(duration, t1),
+                .confidence = tokens > 0 ? probability / static_cast<float>(tokens) : 0.0f,
+            });
+        }
+        return segment;
+    }
+
+#endif // HARNESS_HAS_WHISPER
+
+} // namespace harness::transcribe
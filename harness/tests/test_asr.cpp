@@ -0,0 +1,140 @@
+// ============================================================================
+// TopNotchNotes Harness - ASR Scheduler Tests
+// ============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    /// Records which stream it belongs to whenever it decodes a frame;
+    /// can be held until released to keep the single worker busy
+    class RecordingEngine : public harness::transcribe::ITranscribeEngine
+    {
+    public:
+        RecordingEngine(char name, std::vector<char> &log, std::mutex &log_mutex,
+                        std::atomic<bool> *hold = nullptr)
+            : name_(name), log_(log), log_mutex_(log_mutex), hold_(hold)
+        {
+        }
+
+        std::optional<harness::transcribe::TranscriptSegment> process(harness::transcribe::AudioFrame) override
+        {
+            while (hold_ && hold_->load())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard lock(log_mutex_);
+            log_.push_back(name_);
+            return std::nullopt;
+        }
+
+        std::optional<harness::transcribe::TranscriptSegment> finalize() override
+        {
+            harness::transcribe::TranscriptSegment segment{};
+            segment.words.push_back({.text = std::string(1, name_)});
+            return segment;
+        }
+
+        void reset() override {}
+        bool is_ready() const noexcept override { return true; }
+
+    private:
+        char name_;
+        std::vector<char> &log_;
+        std::mutex &log_mutex_;
+        std::atomic<bool> *hold_;
+    };
+
+    bool test_scheduled_roundtrip()
+    {
+        using namespace harness;
+
+        asr::Scheduler scheduler(2, 16000);
+        auto engine = scheduler.attach(std::make_unique<transcribe::StubTranscribeEngine>());
+        if (!engine || !engine->is_async())
+            return false;
+
+        std::vector<float> frame(320);
+        for (int i = 0; i < 100; ++i)
+            engine->submit(frame);
+        engine->submit_end();
+        engine->flush();
+
+        int partials = 0;
+        int finals = 0;
+        while (auto event = engine->poll())
+            (event->final ? finals : partials) += 1;
+
+        auto *scheduled = dynamic_cast<asr::ScheduledEngine *>(engine.get());
+        if (!scheduled)
+            return false;
+        auto stats = scheduled->stats();
+        return partials == 2 && finals == 1 && stats.samples_decoded == 32000 &&
+               stats.samples_queued == 0 && stats.rtf() >= 0.0;
+    }
+
+    bool test_most_backlog_first()
+    {
+        using namespace harness;
+
+        std::vector<char> log;
+        std::mutex log_mutex;
+        std::atomic<bool> hold{true};
+
+        asr::Scheduler scheduler(1, 16000);
+        auto blocker = scheduler.attach(std::make_unique<RecordingEngine>('x', log, log_mutex, &hold));
+        auto light = scheduler.attach(std::make_unique<RecordingEngine>('a', log, log_mutex));
+        auto heavy = scheduler.attach(std::make_unique<RecordingEngine>('b', log, log_mutex));
+
+        // Occupy the only worker, then queue 1 frame for `a` and 5 for `b`
+        std::vector<float> frame(160);
+        blocker->submit(frame);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        light->submit(frame);
+        for (int i = 0; i < 5; ++i)
+            heavy->submit(frame);
+        hold = false;
+
+        light->flush();
+        heavy->flush();
+
+        std::lock_guard lock(log_mutex);
+        return log == std::vector<char>{'x', 'b', 'b', 'b', 'b', 'b', 'a'};
+    }
+
+} // anonymous namespace
+
+int run_asr_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("scheduled_roundtrip", test_scheduled_roundtrip);
+    run("most_backlog_first", test_most_backlog_first);
+
+    std::print("\nASR Scheduler Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
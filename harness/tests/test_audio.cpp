@@ -0,0 +1,153 @@
+// ============================================================================
+// TopNotchNotes Harness - Audio Device Tests
+// Runs on miniaudio's null backend, which paces silence like a real device
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <print>
+#include <thread>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    using IdleClock = std::chrono::steady_clock;
+
+    bool test_park_and_resume()
+    {
+        using namespace harness;
+
+        auto device = audio::AudioDevice::create({.backends = {"null"}});
+        if (!device || !device->start() || !device->wait_for_data())
+            return false;
+
+        // Parked: no callbacks, nothing buffered, still active
+        if (!device->park() || !device->is_parked() || !device->is_active())
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (device->buffered_samples() != 0)
+            return false;
+
+        // Audio again within a few periods (one is ~21 ms)
+        const auto resumed_at = IdleClock::now();
+        if (!device->resume() || device->is_parked())
+            return false;
+        auto frame = device->wait_for_data();
+        const auto latency = IdleClock::now() - resumed_at;
+        (void)device->stop();
+        return frame && !frame->empty() && latency < std::chrono::milliseconds(100);
+    }
+
+    bool test_wake_threshold_batches()
+    {
+        using namespace harness;
+
+        auto device = audio::AudioDevice::create({.backends = {"null"}});
+        if (!device || !device->start())
+            return false;
+
+        // The consumer is only woken once 6000 samples are waiting
+        constexpr std::size_t wake = 6000;
+        device->set_wake_samples(wake);
+        while (device->try_get_data())
+        {
+        }
+        auto frame = device->wait_for_data();
+        const bool batched = frame && frame->size() + device->buffered_samples() >= wake;
+        (void)device->stop();
+        return batched;
+    }
+
+    bool test_drift_resampler_tracks_clock()
+    {
+        using namespace harness;
+        using Clock = dsp::DriftResampler::Clock;
+
+        // Five simulated minutes of a 441-sample device running 200 ppm fast
+        // against a 1024-sample reference
+        constexpr double rate = 48000.0, ppm = 200.0;
+        constexpr std::size_t period = 1024, other_period = 441;
+        dsp::DriftResampler resampler(48000, 2 * period + period);
+        const auto at = [](double seconds)
+        { return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds))); };
+
+        std::vector<float> block(other_period), out(period);
+        double pushed_until = 0.0, previous = 0.0, max_step = 0.0;
+        std::uint64_t generated = 0;
+        bool primed = false;
+        for (std::size_t pull = 1; pull <= 300 * 48000 / period; ++pull)
+        {
+            const double now = static_cast<double>(pull * period) / rate;
+            while (pushed_until + other_period / (rate * (1.0 + ppm * 1e-6)) <= now)
+            {
+                pushed_until += other_period / (rate * (1.0 + ppm * 1e-6));
+                for (auto &sample : block)
+                    sample = static_cast<float>(std::sin(0.01 * static_cast<double>(generated++)));
+                resampler.push(block, at(pushed_until));
+            }
+            if (!resampler.pull(out, at(now)))
+                continue;
+            // A slow sine stays smooth across pulls: nothing dropped or repeated
+            for (float sample : out)
+            {
+                if (primed)
+                    max_step = std::max(max_step, std::abs(static_cast<double>(sample) - previous));
+                previous = sample;
+                primed = true;
+            }
+        }
+        return std::abs(resampler.drift_ppm() - ppm) < 5.0 && resampler.resyncs() == 0 && max_step < 0.0105;
+    }
+
+    bool test_loopback_frames_align()
+    {
+        using namespace harness;
+
+        auto device = audio::AudioDevice::create({.enable_loopback = true, .backends = {"null"}});
+        if (!device || !device->has_loopback() || !device->start())
+            return false;
+
+        // Every frame comes with system audio of the same length
+        bool aligned = true;
+        for (int i = 0; i < 20 && aligned; ++i)
+        {
+            auto frame = device->wait_for_data();
+            aligned = frame && device->loopback_frame().size() == frame->size();
+        }
+        (void)device->stop();
+        return aligned;
+    }
+
+} // anonymous namespace
+
+int run_audio_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("park_and_resume", test_park_and_resume);
+    run("wake_threshold_batches", test_wake_threshold_batches);
+    run("drift_resampler_tracks_clock", test_drift_resampler_tracks_clock);
+    run("loopback_frames_align", test_loopback_frames_align);
+
+    std::print("\nAudio Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
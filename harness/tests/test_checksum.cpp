@@ -0,0 +1,146 @@
+// ============================================================================
+// TopNotchNotes Harness - Checksum Tests
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <print>
+#include <span>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    std::filesystem::path checksum_temp_path(const char *name)
+    {
+        return std::filesystem::temp_directory_path() /
+               ("tnn-checksum-" + std::to_string(::getpid()) + "-" + name);
+    }
+
+    bool test_xxh3_reference_vectors()
+    {
+        using namespace harness;
+
+        // From the reference implementation (xxhsum -H3) over bytes 31 * i + 7
+        std::vector<std::byte> data(5000);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<std::byte>(i * 31 + 7);
+        const std::pair<std::size_t, std::uint64_t> expected[] = {
+            {0, 0x2d06800538d394c2}, {3, 0x15f7093b173d005c},   {8, 0xdec6a9a43575982e},
+            {16, 0x7e484c18d74895d0}, {100, 0x8c97158042fbf926}, {200, 0x12fdb864685f344d},
+            {240, 0xccc7375172c41f03}, {241, 0x0b3b630948ce4a00}, {1024, 0x23bc880ebf0d29c6},
+            {5000, 0x559fff92c2b7f8ee}};
+
+        const auto original = checksum::active_isa();
+        bool ok = true;
+        for (auto isa : {cpu::Isa::Scalar, cpu::Isa::Avx2})
+        {
+            if (!checksum::use_isa(isa))
+                continue;
+            for (auto [length, hash] : expected)
+            {
+                const auto input = std::span<const std::byte>(data).first(length);
+
+                // Streamed in uneven pieces that straddle the internal buffer
+                checksum::Xxh3 streamed;
+                for (std::size_t offset = 0, step = 1; offset < length; offset += step, step = step * 3 + 1)
+                    streamed.update(input.subspan(offset, std::min(step, length - offset)));
+                ok = ok && checksum::xxh3_64(input) == hash && streamed.digest() == hash;
+            }
+        }
+        checksum::use_isa(original);
+        return ok;
+    }
+
+    bool test_manifest_detects_corruption()
+    {
+        using namespace harness;
+
+        const auto path = checksum_temp_path("data.bin");
+        std::vector<std::byte> data(10000);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<std::byte>(i * 7);
+        {
+            std::ofstream(path, std::ios::binary)
+                .write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+            auto manifest = checksum::ManifestWriter::create(path, 16, 1024);
+            if (!manifest)
+                return false;
+            manifest->update(std::span(data).subspan(16, 5000));
+            manifest->update(std::span(data).subspan(5016));
+            manifest->add_range(0, std::span(data).first(16));
+            manifest->close();
+        }
+
+        auto clean = checksum::verify(checksum::manifest_path(path), 3);
+
+        // Flip one byte in the fourth data range
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(16 + 3 * 1024 + 100);
+            file.put('\x55');
+        }
+        auto corrupt = checksum::verify(checksum::manifest_path(path), 3);
+        std::filesystem::remove(path);
+        std::filesystem::remove(checksum::manifest_path(path));
+
+        return clean && clean->ok() && clean->ranges == 11 && clean->covered_bytes == data.size() && corrupt &&
+               corrupt->bad_offsets == std::vector<std::uint64_t>{16 + 3 * 1024};
+    }
+
+    bool test_wav_writer_manifest()
+    {
+        using namespace harness;
+
+        const auto path = checksum_temp_path("session.wav");
+        {
+            auto writer = io::WavWriter::create(path, 48000, 1, io::WavFormat::Pcm16);
+            if (!writer)
+                return false;
+            std::vector<float> frame(1024, 0.25f);
+            for (int i = 0; i < 10; ++i)
+                writer->write(frame);
+        }
+
+        // The header is rewritten at close and covered as its own range
+        auto report = checksum::verify(checksum::manifest_path(path));
+        std::filesystem::remove(path);
+        std::filesystem::remove(checksum::manifest_path(path));
+        return report && report->ok() && report->ranges == 2 && report->covered_bytes == 44 + 10 * 1024 * 2;
+    }
+
+} // anonymous namespace
+
+int run_checksum_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("xxh3_reference_vectors", test_xxh3_reference_vectors);
+    run("manifest_detects_corruption", test_manifest_detects_corruption);
+    run("wav_writer_manifest", test_wav_writer_manifest);
+
+    std::print("\nChecksum Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
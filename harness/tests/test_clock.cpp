@@ -0,0 +1,118 @@
+// ============================================================================
+// TopNotchNotes Harness - Sample Clock Tests
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <string>
+
+import harness;
+
+namespace
+{
+
+    using harness::clock::Clock;
+
+    Clock::time_point clock_at(double seconds)
+    {
+        return Clock::time_point{} +
+               std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    /// A card running 100 ppm fast for an hour, its callbacks scheduled up
+    /// to a few ms late and now and then 30 ms late
+    bool test_estimates_drift_from_late_callbacks()
+    {
+        constexpr double true_rate = 48000.0 * (1.0 + 100e-6);
+        constexpr std::uint64_t period = 1024;
+        harness::clock::DriftEstimator estimator(48000, Clock::time_point{});
+
+        std::mt19937 rng(11);
+        std::exponential_distribution<double> late(1000.0); // Mean 1 ms
+        std::uniform_int_distribution<int> spike(0, 99);
+        double worst = 0.0;
+        for (std::uint64_t frame = period; frame < 3600 * 48000; frame += period)
+        {
+            const double delay = late(rng) + (spike(rng) == 0 ? 0.030 : 0.0);
+            estimator.add({frame, clock_at(static_cast<double>(frame) / true_rate + delay)});
+            // Times already handed out must stay right, not just the newest
+            if (frame % (600 * period) == 0 && frame > 60 * 48000)
+            {
+                const auto earlier = static_cast<double>(frame - 30 * 48000);
+                worst = std::max({worst, std::abs(estimator.seconds_at(static_cast<double>(frame)) -
+                                                  static_cast<double>(frame) / true_rate),
+                                  std::abs(estimator.seconds_at(earlier) - earlier / true_rate)});
+            }
+        }
+
+        const bool drift_ok = std::abs(estimator.drift_ppm() - 100.0) < 1.0;
+        const bool time_ok = worst < 0.002;
+        if (!drift_ok || !time_ok)
+            std::print("  drift {:.2f} ppm, worst time error {:.2f} ms\n", estimator.drift_ppm(), worst * 1e3);
+        return drift_ok && time_ok;
+    }
+
+    /// Twenty seconds, a five second pause, twenty more: the second stretch
+    /// keeps the time that passed during the pause
+    bool test_maps_pauses_and_retiming()
+    {
+        constexpr std::uint64_t block = 960;
+        harness::clock::SessionClock paused(48000, Clock::time_point{});
+        harness::clock::SessionClock retimed(48000, Clock::time_point{});
+        std::uint64_t recorded = 0;
+        for (std::uint64_t device = 0; device < 45 * 48000; device += block)
+        {
+            paused.observe({device + block, clock_at(static_cast<double>(device + block) / 48000.0)});
+            retimed.observe({device + block, clock_at(static_cast<double>(device + block) / 48000.0)});
+            // Retimed from a card 200 ppm fast: fewer samples recorded
+            retimed.recorded(device - device / 5000, static_cast<double>(device));
+            if (device >= 20 * 48000 && device < 25 * 48000)
+                continue;
+            paused.recorded(recorded, static_cast<double>(device));
+            recorded += block;
+        }
+
+        const auto expect = [](double got, double want) { return std::abs(got - want) < 1e-3; };
+        const std::uint64_t before = 10 * 48000, after = 30 * 48000;
+        const std::string manifest = paused.manifest_json(recorded, false);
+        const bool pause_ok = expect(paused.seconds_at(before), 10.0) && expect(paused.seconds_at(after), 35.0);
+        const bool retime_ok = expect(retimed.seconds_at(after - after / 5000), 30.0);
+        const bool manifest_ok = manifest.starts_with("{\"nominal_rate\":48000,") &&
+                                 manifest.find("[960000,20.000000],[960000,25.000000]") != std::string::npos;
+        if (!pause_ok || !retime_ok || !manifest_ok)
+            std::print("  {:.4f} s / {:.4f} s / {:.4f} s\n  {}\n", paused.seconds_at(before),
+                       paused.seconds_at(after), retimed.seconds_at(after - after / 5000), manifest);
+        return pause_ok && retime_ok && manifest_ok;
+    }
+
+} // anonymous namespace
+
+int run_clock_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("estimates_drift_from_late_callbacks", test_estimates_drift_from_late_callbacks);
+    run("maps_pauses_and_retiming", test_maps_pauses_and_retiming);
+
+    std::print("\nSample Clock Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,299 @@
+// ============================================================================
+// TopNotchNotes Harness - Sample Conversion Tests
+// ============================================================================
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <unistd.h>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    using harness::convert::Isa;
+
+    constexpr Isa all_isas[] = {Isa::Scalar, Isa::Sse41, Isa::Avx2, Isa::Avx512, Isa::Neon};
+
+    /// Odd length so every kernel also runs its scalar tail
+    std::vector<float> conversion_input()
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+        std::vector<float> samples(1027);
+        for (auto &sample : samples)
+            sample = dist(rng);
+        const float edges[] = {1.0f, -1.0f, 2.0f, -2.0f, 0.0f, 0.5f, -0.5f, 1e-9f,
+                               std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                               std::numeric_limits<float>::quiet_NaN()};
+        std::copy(std::begin(edges), std::end(edges), samples.begin());
+        return samples;
+    }
+
+    bool test_s16_saturates()
+    {
+        using namespace harness;
+
+        const auto previous = convert::active_isa();
+        bool ok = true;
+        for (auto isa : all_isas)
+        {
+            if (!convert::use_isa(isa))
+                continue;
+            const std::vector<float> in{1.0f, -1.0f, 2.0f, -2.0f, 0.5f, 1e30f, -1e30f, 0.0f, 3.0f};
+            std::vector<std::int16_t> out(in.size());
+            convert::f32_to_s16(in, out);
+            ok = ok && out == std::vector<std::int16_t>{32767, -32767, 32767, -32767, 16384, 32767, -32767, 0, 32767};
+
+            std::vector<std::int32_t> wide(3);
+            convert::f32_to_s32(std::vector<float>{2.0f, 1.0f, -2.0f}, wide);
+            ok = ok && wide[0] == 2147483520 && wide[1] == 2147483520 && wide[2] == -2147483647 - 1;
+        }
+        convert::use_isa(previous);
+        return ok;
+    }
+
+    bool test_kernels_match_scalar()
+    {
+        using namespace harness;
+
+        const auto in = conversion_input();
+        auto run_all = [&in]
+        {
+            std::vector<std::int16_t> s16(in.size());
+            std::vector<std::int32_t> s32(in.size());
+            std::vector<std::uint8_t> s24(in.size() * 3);
+            std::vector<float> back16(in.size()), back32(in.size()), back24(in.size()), planar(in.size() - 1);
+            std::vector<float> restored(in.size() - 1), mixed(in.size());
+            convert::f32_to_s16(in, s16);
+            convert::f32_to_s32(in, s32);
+            convert::f32_to_s24(in, s24);
+            convert::s16_to_f32(s16, back16);
+            convert::s32_to_f32(s32, back32);
+            convert::s24_to_f32(s24, back24);
+            convert::deinterleave(back16, 2, planar);
+            convert::interleave(planar, 2, restored);
+            convert::mix(back16, 0.7f, back24, -0.45f, mixed);
+            return std::tuple(s16, s32, s24, back16, back32, back24, planar, restored, mixed);
+        };
+
+        const auto previous = convert::active_isa();
+        convert::use_isa(Isa::Scalar);
+        const auto reference = run_all();
+
+        bool ok = true;
+        for (auto isa : all_isas)
+        {
+            if (!convert::use_isa(isa))
+                continue;
+            if (run_all() != reference)
+            {
+                std::print("  {} differs from scalar\n", convert::to_string(isa));
+                ok = false;
+            }
+        }
+        convert::use_isa(previous);
+        return ok;
+    }
+
+    bool test_wav_integer_roundtrip()
+    {
+        using namespace harness;
+
+        std::vector<float> samples(1001);
+        for (std::size_t i = 0; i < samples.size(); ++i)
+            samples[i] = std::sin(static_cast<float>(i) * 0.01f) * 0.9f;
+
+        // Within two steps: one for rounding, one for the asymmetric scale
+        bool ok = true;
+        for (auto [format, tolerance] : {std::pair{io::WavFormat::Pcm16, 2.0f / 32768.0f},
+                                         std::pair{io::WavFormat::Pcm24, 2.0f / 8388608.0f}})
+        {
+            auto path = std::filesystem::temp_directory_path() /
+                        ("tnn-convert-" + std::to_string(::getpid()) + "-" +
+                         std::to_string(io::bytes_per_sample(format)) + ".wav");
+            {
+                auto writer = io::WavWriter::create(path, 48000, 1, format);
+                if (!writer)
+                    return false;
+                writer->write(samples);
+            }
+            if (std::filesystem::file_size(path) != 44 + samples.size() * io::bytes_per_sample(format))
+                ok = false;
+
+            auto read = io::read_wav_samples(path, 100, 2000);
+            std::filesystem::remove(path);
+            std::filesystem::remove(checksum::manifest_path(path));
+            if (!read || read->size() != samples.size() - 100)
+                return false;
+            for (std::size_t i = 0; i < read->size(); ++i)
+                ok = ok && std::abs((*read)[i] - samples[100 + i]) <= tolerance;
+        }
+        return ok;
+    }
+
+    bool test_wav_write_modes()
+    {
+        using namespace harness;
+
+        // Several staging blocks plus a partial one, read back mid-recording
+        // the way the rescorer does: from a snapshot, then after a flush
+        std::vector<float> samples(300001);
+        for (std::size_t i = 0; i < samples.size(); ++i)
+            samples[i] = static_cast<float>(i % 1000) / 1000.0f;
+        const auto half = std::span(samples).first(100000);
+
+        for (auto mode : {io::WriteMode::Streaming, io::WriteMode::Direct})
+        {
+            auto path = std::filesystem::temp_directory_path() /
+                        ("tnn-write-" + std::to_string(::getpid()) + "-" + std::string(io::to_string(mode)) + ".wav");
+            {
+                auto writer = io::WavWriter::create(path, 48000, 1, io::WavFormat::Float32, {.mode = mode});
+                if (!writer || writer->write_mode() == io::WriteMode::Buffered)
+                    return false;
+                if (!writer->write(half))
+                    return false;
+                const auto snapshot = writer->snapshot(99990);
+                auto staged = io::read_wav_samples(path, 99990, 10, &snapshot);
+                writer->flush();
+                auto early = io::read_wav_samples(path, 99990, 10);
+                const std::vector<float> tail(half.end() - 10, half.end());
+                if (!staged || *staged != tail || !early || *early != tail)
+                    return false;
+                writer->write(std::span(samples).subspan(half.size()));
+            }
+
+            const auto report = checksum::verify(checksum::manifest_path(path));
+            auto read = io::read_wav_samples(path, 0, samples.size() + 10);
+            const bool ok = std::filesystem::file_size(path) == 44 + samples.size() * sizeof(float) && report &&
+                            report->ok() && read && *read == samples;
+            std::filesystem::remove(path);
+            std::filesystem::remove(checksum::manifest_path(path));
+            if (!ok)
+                return false;
+        }
+        return true;
+    }
+
+    /// A segment across the staging block edge, read while the file is still
+    /// open: the snapshot covers the part that is not in the file yet
+    bool test_wav_snapshot_spans_block_edge()
+    {
+        using namespace harness;
+
+        std::vector<float> samples(200000);
+        for (std::size_t i = 0; i < samples.size(); ++i)
+            samples[i] = std::sin(static_cast<float>(i) * 0.003f) * 0.5f;
+
+        auto path = std::filesystem::temp_directory_path() / ("tnn-snapshot-" + std::to_string(::getpid()) + ".wav");
+        bool ok = false;
+        {
+            auto writer = io::WavWriter::create(path, 48000, 1, io::WavFormat::Pcm24, {.mode = io::WriteMode::Streaming});
+            if (!writer || !writer->write(samples))
+                return false;
+
+            // 174000 * 3 + 44 bytes in: the block edge is 748 samples later
+            const auto snapshot = writer->snapshot(174000);
+            const auto before = std::filesystem::file_size(path);
+            auto read = io::read_wav_samples(path, 174000, 2000, &snapshot);
+            ok = before == io::SequentialFile::block_bytes && !snapshot.staged.empty() && read && read->size() == 2000;
+            for (std::size_t i = 0; ok && i < read->size(); ++i)
+                ok = std::abs((*read)[i] - samples[174000 + i]) <= 2.0f / 8388608.0f;
+        }
+        std::filesystem::remove(path);
+        std::filesystem::remove(checksum::manifest_path(path));
+        return ok;
+    }
+
+    bool test_interleave_channels()
+    {
+        using namespace harness;
+
+        // Three channels of 5 frames: sample = 10 * channel + frame
+        std::vector<float> planar(15);
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+            for (std::size_t i = 0; i < 5; ++i)
+                planar[c * 5 + i] = static_cast<float>(10 * c + i);
+        }
+        std::vector<float> interleaved(15);
+        convert::interleave(planar, 3, interleaved);
+        std::vector<float> restored(15);
+        convert::deinterleave(interleaved, 3, restored);
+        return interleaved[0] == 0.0f && interleaved[1] == 10.0f && interleaved[2] == 20.0f &&
+               interleaved[3] == 1.0f && restored == planar;
+    }
+
+    bool test_dispatch_matches_baseline()
+    {
+        using namespace harness;
+
+        // Whatever was picked must run here, and never above the cap
+        const auto best = cpu::best_isa();
+        if (!cpu::supports(best) || !cpu::enabled(convert::active_isa()))
+            return false;
+
+        // The butterfly variant in use must agree bit for bit with the baseline;
+        // any data and twiddles will do for that (size - 1 twiddles in total)
+        constexpr std::size_t size = 256;
+        std::vector<float> re(size), im(size), wr(size - 1), wi(size - 1);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            re[i] = std::sin(static_cast<float>(i) * 0.37f);
+            im[i] = std::cos(static_cast<float>(i) * 1.9f);
+        }
+        for (std::size_t i = 0; i < wr.size(); ++i)
+        {
+            wr[i] = std::cos(static_cast<float>(i) * 0.11f);
+            wi[i] = -std::sin(static_cast<float>(i) * 0.11f);
+        }
+        auto base_re = re, base_im = im;
+        dsp::detail::butterfly_kernel()(re.data(), im.data(), wr.data(), wi.data(), size);
+        dsp::detail::butterflies_baseline(base_re.data(), base_im.data(), wr.data(), wi.data(), size);
+
+        return re == base_re && im == base_im && !telemetry::escape_variant().empty();
+    }
+
+} // anonymous namespace
+
+int run_convert_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    std::print("Best conversion kernels: {}\n", harness::convert::to_string(harness::convert::active_isa()));
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("s16_saturates", test_s16_saturates);
+    run("kernels_match_scalar", test_kernels_match_scalar);
+    run("wav_integer_roundtrip", test_wav_integer_roundtrip);
+    run("wav_write_modes", test_wav_write_modes);
+    run("wav_snapshot_spans_block_edge", test_wav_snapshot_spans_block_edge);
+    run("interleave_channels", test_interleave_channels);
+    run("dispatch_matches_baseline", test_dispatch_matches_baseline);
+
+    std::print("\nConversion Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
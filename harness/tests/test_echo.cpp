@@ -0,0 +1,164 @@
+// ============================================================================
+// TopNotchNotes Harness - Echo Cancellation Tests
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <print>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    /// A room in miniature: the reference reaches the microphone 30 ms after
+    /// the sink took it, through a few reflections and a short decay, and
+    /// the reference stream itself lags the microphone by `lag`
+    struct EchoRoom
+    {
+        static constexpr std::size_t lag = 2048;
+        static constexpr std::size_t output_delay = 1440;
+
+        static constexpr std::size_t tail = 4096;
+
+        std::vector<float> source;
+        std::vector<std::pair<std::size_t, float>> taps; // Impulse response, sparse
+
+        explicit EchoRoom(std::size_t samples)
+        {
+            std::mt19937 rng(7);
+            std::normal_distribution<float> noise(0.0f, 1.0f);
+            // Speech-like: coloured noise with a syllable-rate envelope
+            float state = 0.0f;
+            source.resize(samples + lag + output_delay + tail);
+            for (std::size_t i = 0; i < source.size(); ++i)
+            {
+                state = 0.9f * state + 0.05f * noise(rng);
+                source[i] = state * (0.6f + 0.4f * std::sin(static_cast<float>(i) * 2e-4f));
+            }
+            for (std::size_t i = 0; i < 64; ++i)
+                taps.emplace_back(i, 0.3f * noise(rng) * std::exp(-static_cast<float>(i) / 16.0f));
+            for (std::size_t i : {700u, 1900u, 3500u})
+                taps.emplace_back(i, 0.1f * noise(rng));
+        }
+
+        /// Microphone (echo only) and reference at stream position `n`
+        [[nodiscard]] float echo(std::size_t n) const
+        {
+            const std::size_t t = n + lag + tail;
+            float sum = 0.0f;
+            for (const auto &[delay, gain] : taps)
+                sum += gain * source[t - delay];
+            return sum;
+        }
+        [[nodiscard]] float reference(std::size_t n) const
+        {
+            return source[n + output_delay + tail];
+        }
+    };
+
+    bool test_cancels_echo_keeps_speech()
+    {
+        using namespace harness;
+
+        // Eight seconds of echo alone to converge, then someone talks over it
+        constexpr std::size_t frame = 1024, talk_from = 8 * 48000, total = 12 * 48000;
+        const EchoRoom room(total);
+        echo::EchoCanceller canceller({.reference_delay = EchoRoom::lag});
+        const auto latency = canceller.latency();
+        const auto speech = [](std::size_t n)
+        { return n < talk_from ? 0.0f : 0.05f * std::sin(0.03f * static_cast<float>(n)); };
+
+        std::vector<float> mic(frame), reference(frame), out(frame);
+        double echo_energy = 0.0, residual_energy = 0.0, speech_energy = 0.0, distortion = 0.0;
+        for (std::size_t at = 0; at + frame <= total; at += frame)
+        {
+            for (std::size_t i = 0; i < frame; ++i)
+            {
+                mic[i] = room.echo(at + i) + speech(at + i);
+                reference[i] = room.reference(at + i);
+            }
+            canceller.process(mic, reference, out);
+            for (std::size_t i = 0; i < frame; ++i)
+            {
+                const auto n = at + i;
+                if (n < latency)
+                    continue;
+                const double echo = room.echo(n - latency), near = speech(n - latency);
+                const double error = out[i] - near;
+                if (n >= 6 * 48000 && n < talk_from)
+                {
+                    echo_energy += echo * echo;
+                    residual_energy += error * error;
+                }
+                else if (n >= talk_from + 48000)
+                {
+                    speech_energy += near * near;
+                    distortion += error * error;
+                }
+            }
+        }
+
+        // At least 25 dB of echo gone; over it, the talker stays 8 dB above
+        // residual echo and distortion
+        const double erle = 10.0 * std::log10(echo_energy / residual_energy);
+        const double clarity = 10.0 * std::log10(speech_energy / distortion);
+        return erle > 25.0 && clarity > 8.0 && canceller.erle_db() > 0.0;
+    }
+
+    bool test_silent_reference_passes_through()
+    {
+        using namespace harness;
+
+        // Nothing to cancel: the microphone comes out exactly, latency() late
+        echo::EchoCanceller canceller({.block = 128, .reference_delay = 300});
+        const auto latency = canceller.latency();
+        std::vector<float> input(48000), output;
+        for (std::size_t i = 0; i < input.size(); ++i)
+            input[i] = std::sin(0.01f * static_cast<float>(i));
+        const std::vector<float> silence(700, 0.0f);
+        std::vector<float> out(700);
+        for (std::size_t at = 0; at + 700 <= input.size(); at += 700)
+        {
+            canceller.process(std::span(input).subspan(at, 700), silence, out);
+            output.insert(output.end(), out.begin(), out.end());
+        }
+        for (std::size_t i = 0; i < output.size(); ++i)
+        {
+            if (output[i] != (i < latency ? 0.0f : input[i - latency]))
+                return false;
+        }
+        return latency == 428;
+    }
+
+} // anonymous namespace
+
+int run_echo_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("cancels_echo_keeps_speech", test_cancels_echo_keeps_speech);
+    run("silent_reference_passes_through", test_silent_reference_passes_through);
+
+    std::print("\nEcho Cancellation Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+// ============================================================================
+// TopNotchNotes Harness - Capture Journal Tests
+// ============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <print>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    std::filesystem::path journal_path(const char *name)
+    {
+        return std::filesystem::temp_directory_path() /
+               ("tnn-journal-" + std::to_string(::getpid()) + "-" + name + ".tnnj");
+    }
+
+    bool test_codec_roundtrip()
+    {
+        using namespace harness;
+
+        // Edge values, then a tone and digital silence
+        std::vector<float> samples{0.0f, -0.0f, 1.0f, -1.0f, 1e-42f,
+                                   std::numeric_limits<float>::infinity(),
+                                   std::numeric_limits<float>::quiet_NaN()};
+        for (int i = 0; i < 1000; ++i)
+            samples.push_back(0.3f * std::sin(static_cast<float>(i) * 0.05f));
+        samples.resize(samples.size() + 1001, 0.0f);
+
+        std::vector<std::uint8_t> encoded;
+        journal::encode_samples(samples, encoded);
+        std::vector<float> decoded(samples.size());
+        if (!journal::decode_samples(encoded, decoded))
+            return false;
+
+        // Bit for bit, NaN payload and negative zero included
+        const bool exact = std::memcmp(samples.data(), decoded.data(), samples.size() * sizeof(float)) == 0;
+        const bool smaller = encoded.size() < samples.size() * sizeof(float) * 3 / 4;
+        encoded.pop_back(); // A truncated payload must be rejected
+        return exact && smaller && !journal::decode_samples(encoded, decoded);
+    }
+
+    bool test_record_and_replay()
+    {
+        using namespace harness;
+
+        const auto path = journal_path("replay");
+        const auto origin = std::chrono::steady_clock::now();
+        std::vector<float> first(1024, 0.25f), second(1024, -0.5f);
+        {
+            auto writer = journal::JournalWriter::create(path, 48000, 1);
+            if (!writer)
+                return false;
+            (*writer)->record_command("START", origin);
+            (*writer)->on_capture(first, origin + std::chrono::milliseconds(21));
+            (*writer)->on_capture(second, origin + std::chrono::milliseconds(42));
+            (*writer)->record_command("STOP", origin + std::chrono::milliseconds(50));
+            (*writer)->close();
+            if ((*writer)->samples_recorded() != 2048 || (*writer)->samples_dropped() != 0)
+                return false;
+        }
+
+        auto reader = journal::JournalReader::open(path);
+        if (!reader || reader->header().sample_rate != 48000)
+            return false;
+
+        std::vector<std::string> events;
+        std::vector<float> audio;
+        auto stats = journal::replay(*reader, 0.0,
+                                     {.audio = [&](std::span<const float> samples)
+                                      {
+                                          events.push_back("audio");
+                                          audio.insert(audio.end(), samples.begin(), samples.end());
+                                      },
+                                      .command = [&](std::string_view line)
+                                      { events.emplace_back(line); }});
+        std::filesystem::remove(path);
+
+        std::vector<float> expected = first;
+        expected.insert(expected.end(), second.begin(), second.end());
+        return stats && stats->audio_blocks == 2 && stats->commands == 2 &&
+               events == std::vector<std::string>{"START", "audio", "audio", "STOP"} && audio == expected &&
+               stats->journal_duration >= std::chrono::milliseconds(49);
+    }
+
+    bool test_truncated_journal_replays()
+    {
+        using namespace harness;
+
+        const auto path = journal_path("truncated");
+        {
+            auto writer = journal::JournalWriter::create(path, 48000, 1);
+            if (!writer)
+                return false;
+            std::vector<float> block(512, 0.1f);
+            const auto now = std::chrono::steady_clock::now();
+            (*writer)->on_capture(block, now);
+            (*writer)->on_capture(block, now);
+        }
+
+        // As if the harness died mid-write
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+        auto reader = journal::JournalReader::open(path);
+        if (!reader)
+            return false;
+        auto stats = journal::replay(*reader, 0.0, {.audio = [](auto) {}, .command = [](auto) {}});
+        std::filesystem::remove(path);
+        return stats && stats->audio_blocks == 1;
+    }
+
+    /// Header fields claiming gigabytes are corruption, not a reason to allocate
+    bool test_corrupt_header_rejected()
+    {
+        using namespace harness;
+
+        const auto path = journal_path("corrupt");
+        {
+            auto writer = journal::JournalWriter::create(path, 48000, 1);
+            if (!writer)
+                return false;
+            std::vector<float> block(512, 0.1f);
+            (*writer)->on_capture(block, std::chrono::steady_clock::now());
+        }
+        {
+            const journal::RecordHeader bogus{.count = 0xFFFFFFFF, .payload_bytes = 0xFFFFFFF0};
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            file.write(reinterpret_cast<const char *>(&bogus), sizeof(bogus));
+            file.write("trailing bytes", 14);
+        }
+
+        auto reader = journal::JournalReader::open(path);
+        if (!reader)
+            return false;
+        const auto first = reader->next();
+        const auto second = reader->next();
+        std::filesystem::remove(path);
+        return first && *first && (*first)->samples.size() == 512 && !second;
+    }
+
+} // anonymous namespace
+
+int run_journal_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("codec_roundtrip", test_codec_roundtrip);
+    run("record_and_replay", test_record_and_replay);
+    run("truncated_journal_replays", test_truncated_journal_replays);
+    run("corrupt_header_rejected", test_corrupt_header_rejected);
+
+    std::print("\nJournal Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+// ============================================================================
+// TopNotchNotes Harness - Keyword Spotter Tests
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <print>
+#include <span>
+#include <string>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    using namespace std::chrono_literals;
+    using harness::transcribe::KeywordSpotterEngine;
+
+    /// Phrases are normalized for the dictionary; blanks and repeats go, and
+    /// a phrase's own threshold wins over the default
+    bool test_keyphrase_list_normalizes_phrases()
+    {
+        const std::vector<std::string> keywords = {
+            "  Fourier   Transform ", "", "   ", "fourier transform", "EIGENVALUE /1e-30/ ", "basis /oops",
+        };
+        const auto list = harness::transcribe::keyphrase_list(keywords, 1e-20);
+        const std::string expected = "fourier transform /1e-20/\neigenvalue /1e-30/\nbasis /1e-20/\n";
+        if (list != expected)
+            std::print("  got:\n{}", list);
+        return list == expected;
+    }
+
+    /// A hit 120 frames into a search restarted 1.5 s into an utterance that
+    /// began 62 s into the session is at 64.7 s of session time
+    bool test_hits_map_to_session_time()
+    {
+        const auto start = KeywordSpotterEngine::hit_time(24000, 16000, 120);
+        const auto end = KeywordSpotterEngine::hit_time(24000, 16000, 175);
+        const harness::transcribe::TranscriptSegment hits{
+            .words = {{.text = "eigenvalue", .start_time = start, .end_time = end, .confidence = 0.8f}},
+            .start_time = start,
+            .end_time = end,
+        };
+
+        const auto session = harness::transcribe::shifted(hits, 62s);
+        const bool utterance_ok = start == 2700ms && end == 3250ms;
+        const bool session_ok = session.words.front().start_time == 64700ms &&
+                                session.words.front().end_time == 65250ms && session.start_time == 64700ms &&
+                                session.end_time == 65250ms;
+        const bool clamped = KeywordSpotterEngine::hit_time(0, 16000, -3) == 0ms;
+        if (!utterance_ok || !session_ok || !clamped)
+            std::print("  utterance {}-{} ms, session {}-{} ms\n", start.count(), end.count(),
+                       session.words.front().start_time.count(), session.words.front().end_time.count());
+        return utterance_ok && session_ok && clamped;
+    }
+
+    /// The spotter is handed 48 kHz capture frames. A decoder needs a model,
+    /// so this drives the input stage process() runs them through: 1.5 s of
+    /// 1024-sample frames is 24000 decoder samples, and a hit 120 frames into
+    /// a search restarted there is at 2.7 s, not three times that
+    bool test_capture_frames_decimate_to_decoder_rate()
+    {
+        harness::transcribe::TranscribeConfig config;
+        config.input_rate = 48000;
+        harness::transcribe::DecoderFeed feed(config.input_rate, config.sample_rate);
+
+        // A ramp, so averaging across frame edges shows up
+        std::vector<float> frame(1024);
+        std::uint64_t fed = 0;
+        std::uint64_t decoded = 0;
+        bool means_ok = true;
+        while (fed < 72000)
+        {
+            for (std::size_t i = 0; i < frame.size(); ++i)
+                frame[i] = static_cast<float>(fed + i) / 72000.0f;
+            const auto count = std::min<std::uint64_t>(frame.size(), 72000 - fed);
+            const auto out = feed.push(std::span<const float>(frame).first(count));
+            for (std::size_t i = 0; i < out.size(); ++i)
+            {
+                const float expected = static_cast<float>(3 * (decoded + i) + 1) / 72000.0f;
+                means_ok = means_ok && std::abs(out[i] - expected) < 1e-5f;
+            }
+            fed += count;
+            decoded += out.size();
+        }
+
+        const auto hit = KeywordSpotterEngine::hit_time(decoded, config.sample_rate, 120);
+        const bool passthrough = harness::transcribe::DecoderFeed(16000, 16000).factor() == 1 &&
+                                 harness::transcribe::DecoderFeed(44100, 16000).factor() == 1;
+        const bool rescoring =
+            harness::transcribe::rescoring_config(config).input_rate == config.sample_rate;
+        if (decoded != 24000 || hit != 2700ms || !means_ok)
+            std::print("  {} decoder samples, hit at {} ms, means {}\n", decoded, hit.count(), means_ok);
+        return feed.factor() == 3 && decoded == 24000 && hit == 2700ms && means_ok && passthrough && rescoring;
+    }
+
+} // anonymous namespace
+
+int run_keywords_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("keyphrase_list_normalizes_phrases", test_keyphrase_list_normalizes_phrases);
+    run("hits_map_to_session_time", test_hits_map_to_session_time);
+    run("capture_frames_decimate_to_decoder_rate", test_capture_frames_decimate_to_decoder_rate);
+
+    std::print("\nKeyword Spotter Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+// ============================================================================
+// TopNotchNotes Harness - Memory Accounting Tests
+// ============================================================================
+
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+import harness;
+
+namespace
+{
+
+    bool test_tagged_containers_account()
+    {
+        using namespace harness;
+
+        auto &account = memory::account(memory::Tag::Transcript);
+        const auto before = account.bytes();
+        account.reset_peak();
+        std::size_t grown = 0;
+        {
+            memory::Vector<memory::Tag::Transcript, float> samples(1000);
+            memory::String<memory::Tag::Transcript> text(200, 'x');
+            grown = account.bytes() - before;
+
+            // Moving keeps the allocation, and its charge, in place
+            auto moved = std::move(samples);
+            if (account.bytes() - before != grown)
+                return false;
+        }
+        return grown >= 1000 * sizeof(float) + 200 && account.bytes() == before &&
+               account.peak() >= before + grown;
+    }
+
+    bool test_budget_hysteresis()
+    {
+        using namespace harness;
+        using enum memory::Pressure;
+
+        memory::Budget budget(1000);
+        const bool rising = budget.evaluate(500) == Normal && budget.evaluate(800) == Normal &&
+                            budget.evaluate(850) == Elevated && budget.evaluate(1000) == Critical;
+        // Eases off in steps, and only returns to normal well below the threshold
+        const bool falling = budget.evaluate(900) == Elevated && budget.evaluate(800) == Elevated &&
+                             budget.evaluate(700) == Normal;
+        return rising && falling && memory::Budget(0).evaluate(1u << 30) == Normal;
+    }
+
+    /// The watcher publishes what it samples on its own thread
+    bool test_watcher_publishes_level()
+    {
+        using namespace harness;
+        using namespace std::chrono_literals;
+
+        memory::Watcher tight(1, 5ms); // Any process is over a one-byte budget
+        memory::Watcher unlimited(0, 5ms);
+        for (int i = 0; i < 200 && tight.level() != memory::Pressure::Critical; ++i)
+            std::this_thread::sleep_for(5ms);
+        return tight.level() == memory::Pressure::Critical && tight.peak() >= tight.resident() &&
+               unlimited.level() == memory::Pressure::Normal;
+    }
+
+} // anonymous namespace
+
+int run_memory_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("tagged_containers_account", test_tagged_containers_account);
+    run("budget_hysteresis", test_budget_hysteresis);
+    run("watcher_publishes_level", test_watcher_publishes_level);
+
+    std::print("\nMemory Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
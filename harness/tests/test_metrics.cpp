@@ -0,0 +1,140 @@
+// ============================================================================
+// TopNotchNotes Harness - Metrics Tests
+// ============================================================================
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    bool test_counter_shards_sum()
+    {
+        using namespace harness;
+
+        metrics::Registry registry;
+        auto &counter = registry.counter("test_events_total", "Events");
+        {
+            std::vector<std::jthread> threads;
+            for (int t = 0; t < 12; ++t)
+                threads.emplace_back([&counter]
+                                     {
+                                         for (int i = 0; i < 10000; ++i)
+                                             counter.add();
+                                     });
+        }
+        // Registering the same name again hands back the same counter
+        return counter.value() == 120000 && &registry.counter("test_events_total", "Events") == &counter;
+    }
+
+    bool test_histogram_quantiles_and_render()
+    {
+        using namespace harness;
+
+        // Every bucket edge maps back to itself
+        for (std::size_t bucket = 0; bucket + 1 < metrics::Histogram::bucket_count; ++bucket)
+        {
+            if (metrics::Histogram::bucket_of(metrics::Histogram::upper_bound(bucket)) != bucket ||
+                metrics::Histogram::bucket_of(metrics::Histogram::upper_bound(bucket) + 1) != bucket + 1)
+                return false;
+        }
+
+        metrics::Registry registry;
+        auto &histogram = registry.histogram("test_latency_seconds", "Latency");
+        for (std::uint64_t us = 1; us <= 1000; ++us)
+            histogram.record(us * 1000);
+
+        // Within one bucket width (~6%)
+        const auto snapshot = histogram.snapshot();
+        const auto p50 = static_cast<double>(snapshot.quantile(0.5));
+        const auto p99 = static_cast<double>(snapshot.quantile(0.99));
+        if (snapshot.count != 1000 || p50 < 500e3 || p50 > 500e3 * 1.07 || p99 < 990e3 || p99 > 990e3 * 1.07)
+            return false;
+
+        registry.gauge("test_depth", "Depth").set(3.5);
+        const auto text = registry.render();
+        return text.contains("# TYPE test_latency_seconds histogram\n") &&
+               text.contains("test_latency_seconds_bucket{le=\"+Inf\"} 1000\n") &&
+               text.contains("test_latency_seconds_count 1000\n") &&
+               text.contains("test_latency_seconds_sum 0.5005\n") &&
+               text.contains("# TYPE test_depth gauge\ntest_depth 3.5\n");
+    }
+
+    std::string scrape(const std::filesystem::path &path, std::string_view request)
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        std::string response;
+        if (::connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) == 0 &&
+            ::send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size()))
+        {
+            char buf[4096];
+            ssize_t got;
+            while ((got = ::recv(fd, buf, sizeof(buf), 0)) > 0)
+                response.append(buf, static_cast<std::size_t>(got));
+        }
+        ::close(fd);
+        return response;
+    }
+
+    bool test_endpoint_scrape()
+    {
+        using namespace harness;
+
+        const auto path = std::filesystem::temp_directory_path() /
+                          ("tnn-metrics-" + std::to_string(::getpid()) + ".sock");
+        metrics::Registry registry;
+        registry.counter("test_scrapes_total", "Scrapes").add(7);
+        auto endpoint = server::MetricsEndpoint::create(path, [&registry]
+                                                        { return registry.render(); });
+        if (!endpoint)
+            return false;
+
+        const auto ok = scrape(path, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        const auto missing = scrape(path, "GET /nope HTTP/1.1\r\n\r\n");
+        return ok.starts_with("HTTP/1.0 200 OK\r\n") && ok.contains("text/plain; version=0.0.4") &&
+               ok.ends_with("\r\n\r\n# HELP test_scrapes_total Scrapes\n# TYPE test_scrapes_total counter\n"
+                            "test_scrapes_total 7\n") &&
+               missing.starts_with("HTTP/1.0 404");
+    }
+
+} // anonymous namespace
+
+int run_metrics_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("counter_shards_sum", test_counter_shards_sum);
+    run("histogram_quantiles_and_render", test_histogram_quantiles_and_render);
+    run("endpoint_scrape", test_endpoint_scrape);
+
+    std::print("\nMetrics Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
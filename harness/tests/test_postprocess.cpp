@@ -0,0 +1,159 @@
+// ============================================================================
+// TopNotchNotes Harness - Transcript Post-Processing Tests
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <print>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    using namespace harness::postprocess;
+
+    constexpr std::uint16_t likely = 60000;
+
+    struct TestWord
+    {
+        std::string_view word;
+        std::uint16_t comma_after = 0;
+        std::uint16_t period_after = 0;
+        std::uint16_t sentence_start = 0;
+        std::uint16_t question_start = 0;
+        std::string_view cased = {};
+    };
+
+    /// Write a model file in the same layout scripts/build_punct_model.py produces
+    std::filesystem::path write_model(const std::vector<TestWord> &words)
+    {
+        std::vector<ModelEntry> entries;
+        std::string strings;
+        for (const auto &w : words)
+        {
+            ModelEntry entry{};
+            entry.hash = word_hash(w.word);
+            entry.comma_after = w.comma_after;
+            entry.period_after = w.period_after;
+            entry.sentence_start = w.sentence_start;
+            entry.question_start = w.question_start;
+            entry.case_offset = static_cast<std::uint32_t>(strings.size());
+            entry.case_length = static_cast<std::uint16_t>(w.cased.size());
+            strings += w.cased;
+            entries.push_back(entry);
+        }
+        std::ranges::sort(entries, {}, &ModelEntry::hash);
+
+        ModelHeader header{model_magic, model_version, static_cast<std::uint32_t>(entries.size()),
+                           static_cast<std::uint32_t>(strings.size())};
+
+        auto path = std::filesystem::temp_directory_path() /
+                    ("tnn-punct-" + std::to_string(::getpid()) + ".tnpm");
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(ModelEntry)));
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        return path;
+    }
+
+    bool test_rules_without_model()
+    {
+        return punctuate(nullptr, "i think this is right") == "I think this is right." &&
+               punctuate(nullptr, "") == "";
+    }
+
+    bool test_table_model()
+    {
+        auto path = write_model({
+            {.word = "fourier", .cased = "Fourier"},
+            {.word = "transform", .period_after = likely},
+            {.word = "so", .sentence_start = likely},
+            {.word = "what", .sentence_start = likely, .question_start = likely},
+            {.word = "well", .comma_after = likely},
+        });
+        auto model = PunctuationModel::load(path);
+        std::filesystem::remove(path);
+        if (!model || (*model)->size() != 5)
+            return false;
+
+        auto text = punctuate(model->get(),
+                              "we take the fourier transform so the peaks move what does that mean");
+        return text == "We take the Fourier transform. So the peaks move. What does that mean?" &&
+               punctuate(model->get(), "well i agree") == "Well, I agree.";
+    }
+
+    bool test_rejects_bad_model()
+    {
+        auto path = std::filesystem::temp_directory_path() /
+                    ("tnn-bad-" + std::to_string(::getpid()) + ".tnpm");
+        std::ofstream(path) << "definitely not a model file";
+        auto model = PunctuationModel::load(path);
+        std::filesystem::remove(path);
+        return !model && !PunctuationModel::load("/nonexistent/model.tnpm");
+    }
+
+    bool test_worker_preserves_order()
+    {
+        std::mutex mutex;
+        std::vector<std::pair<std::uint64_t, std::string>> delivered;
+        {
+            PostProcessor worker(nullptr, [&](std::uint64_t id, std::string text)
+                                 {
+                                     std::lock_guard lock(mutex);
+                                     delivered.emplace_back(id, std::move(text)); });
+            for (std::uint64_t id = 1; id <= 20; ++id)
+                worker.submit(id, "segment number " + std::to_string(id));
+            worker.flush();
+            if (worker.processed() != 20)
+                return false;
+        }
+
+        for (std::uint64_t id = 1; id <= 20; ++id)
+        {
+            if (delivered[id - 1].first != id ||
+                delivered[id - 1].second != "Segment number " + std::to_string(id) + ".")
+                return false;
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+int run_postprocess_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("rules_without_model", test_rules_without_model);
+    run("table_model", test_table_model);
+    run("rejects_bad_model", test_rejects_bad_model);
+    run("worker_preserves_order", test_worker_preserves_order);
+
+    std::print("\nPost-processing Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
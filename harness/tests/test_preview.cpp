@@ -0,0 +1,171 @@
+// ============================================================================
+// TopNotchNotes Harness - DSP / Preview Tests
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <print>
+#include <span>
+#include <string>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    bool test_real_fft_matches_dft()
+    {
+        constexpr std::size_t n = 64;
+        std::vector<float> input(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            input[i] = std::sin(0.3f * static_cast<float>(i)) + 0.25f * std::cos(1.7f * static_cast<float>(i));
+        }
+
+        harness::dsp::RealFft fft(n);
+        std::vector<float> re(fft.bins()), im(fft.bins());
+        fft.forward(input, re, im);
+
+        for (std::size_t k = 0; k < fft.bins(); ++k)
+        {
+            double ref_re = 0.0, ref_im = 0.0;
+            for (std::size_t t = 0; t < n; ++t)
+            {
+                double angle = -2.0 * std::numbers::pi * static_cast<double>(k * t) / n;
+                ref_re += input[t] * std::cos(angle);
+                ref_im += input[t] * std::sin(angle);
+            }
+            if (std::abs(ref_re - re[k]) > 1e-3 || std::abs(ref_im - im[k]) > 1e-3)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool test_real_fft_roundtrip()
+    {
+        constexpr std::size_t n = 256;
+        std::vector<float> input(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            input[i] = static_cast<float>((i * 37) % 101) / 101.0f - 0.5f;
+        }
+
+        harness::dsp::RealFft fft(n);
+        std::vector<float> re(fft.bins()), im(fft.bins()), output(n);
+        fft.forward(input, re, im);
+        fft.inverse(re, im, output);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (std::abs(input[i] - output[i]) > 1e-4f)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool test_waveform_decimator()
+    {
+        harness::preview::WaveformDecimator decimator(4);
+        std::vector<std::uint8_t> out;
+
+        // Two full columns plus a partial one across uneven frames
+        std::vector<float> a = {0.0f, 1.0f, -1.0f};
+        std::vector<float> b = {0.0f, 0.5f, 0.5f, 0.5f, 0.5f, 0.25f};
+        auto columns = decimator.push(a, out);
+        columns += decimator.push(b, out);
+
+        if (columns != 2 || out.size() != 2 * harness::preview::bytes_per_column)
+            return false;
+
+        // Column 0: min -1, max 1
+        if (static_cast<std::int8_t>(out[0]) != -127 || static_cast<std::int8_t>(out[1]) != 127)
+            return false;
+
+        // Column 1: all 0.5 -> rms 0.5
+        if (static_cast<std::int8_t>(out[3]) != 64 || static_cast<std::int8_t>(out[4]) != 64)
+            return false;
+        if (out[5] < 127 || out[5] > 128)
+            return false;
+
+        return true;
+    }
+
+    bool test_spectrogram_peak()
+    {
+        harness::preview::PreviewConfig config;
+        config.sample_rate = 16000;
+        config.fft_size = 512;
+        config.mel_bands = 20;
+        config.spectrum_hz = 25;
+        config.max_hz = 8000.0f;
+
+        harness::preview::SpectrogramSlicer slicer(config);
+        std::vector<float> tone(16000 / 25);
+        for (std::size_t i = 0; i < tone.size(); ++i)
+        {
+            tone[i] = 0.5f * std::sin(2.0f * std::numbers::pi_v<float> * 1000.0f *
+                                      static_cast<float>(i) / 16000.0f);
+        }
+
+        std::vector<std::uint8_t> out;
+        if (slicer.push(tone, out) != 1 || out.size() != slicer.bands())
+            return false;
+
+        // The loudest band should sit near 1 kHz on the mel scale
+        auto peak = static_cast<std::size_t>(std::distance(out.begin(), std::ranges::max_element(out)));
+        double mel_lo = harness::dsp::hz_to_mel(config.min_hz);
+        double mel_hi = harness::dsp::hz_to_mel(config.max_hz);
+        double expected = (harness::dsp::hz_to_mel(1000.0) - mel_lo) / (mel_hi - mel_lo) *
+                              static_cast<double>(config.mel_bands + 1) -
+                          1.0;
+        return std::abs(static_cast<double>(peak) - expected) <= 1.0;
+    }
+
+    bool test_base64()
+    {
+        using harness::telemetry::base64_encode;
+        auto enc = [](std::string_view s)
+        {
+            return base64_encode(std::span(reinterpret_cast<const std::uint8_t *>(s.data()), s.size()));
+        };
+
+        return enc("") == "" && enc("f") == "Zg==" && enc("fo") == "Zm8=" &&
+               enc("foo") == "Zm9v" && enc("foobar") == "Zm9vYmFy";
+    }
+
+} // anonymous namespace
+
+int run_preview_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("real_fft_matches_dft", test_real_fft_matches_dft);
+    run("real_fft_roundtrip", test_real_fft_roundtrip);
+    run("waveform_decimator", test_waveform_decimator);
+    run("spectrogram_peak", test_spectrogram_peak);
+    run("base64", test_base64);
+
+    std::print("\nPreview Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
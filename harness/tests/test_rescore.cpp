@@ -0,0 +1,174 @@
+// ============================================================================
+// TopNotchNotes Harness - Two-Pass Rescoring Tests
+// ============================================================================
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    std::filesystem::path rescore_temp_path(std::string_view name)
+    {
+        return std::filesystem::temp_directory_path() /
+               ("tnn-rescore-" + std::to_string(::getpid()) + "-" + std::string(name));
+    }
+
+    std::string read_file(const std::filesystem::path &path)
+    {
+        std::ifstream file(path);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    /// Reports how many samples it was fed, and the value of the first one
+    class CountingEngine : public harness::transcribe::ITranscribeEngine
+    {
+    public:
+        std::optional<harness::transcribe::TranscriptSegment> process(harness::transcribe::AudioFrame frame) override
+        {
+            if (samples_ == 0 && !frame.empty())
+                first_ = frame[0];
+            samples_ += frame.size();
+            return std::nullopt;
+        }
+
+        std::optional<harness::transcribe::TranscriptSegment> finalize() override
+        {
+            harness::transcribe::TranscriptSegment segment{};
+            segment.words.push_back({.text = std::to_string(samples_) + " from " +
+                                             std::to_string(static_cast<int>(first_))});
+            return segment;
+        }
+
+        void reset() override
+        {
+            samples_ = 0;
+        }
+
+        bool is_ready() const noexcept override { return true; }
+
+    private:
+        std::size_t samples_ = 0;
+        float first_ = 0.0f;
+    };
+
+    bool test_transcript_revision()
+    {
+        using harness::io::TranscriptWriter;
+
+        auto path = rescore_temp_path("transcript.md");
+        auto writer = TranscriptWriter::create(path, "20260101_120000");
+        if (!writer)
+            return false;
+        auto &transcript = **writer;
+
+        transcript.append(1, "first");
+        transcript.append(2, "second");
+        if (!transcript.revise(2, "Second") || !transcript.revise(3, "Third"))
+            return false;
+        transcript.append(3, "third"); // Revised before it was committed
+        transcript.append(4, "fourth");
+
+        const std::string header = "# Recording Session: 20260101_120000\n\n---\n\n";
+        bool ok = read_file(path) == header + "first Second Third fourth ";
+
+        // Revisions still land once the live session has closed the file
+        transcript.close();
+        ok = ok && transcript.revise(1, "First") &&
+             read_file(path) == header + "First Second Third fourth \n" &&
+             !std::filesystem::exists(path.string() + ".tmp");
+
+        std::filesystem::remove(path);
+        return ok;
+    }
+
+    bool test_rescorer_rereads_wav()
+    {
+        using namespace harness;
+
+        // One second at 48 kHz where sample i holds the value i / 3
+        auto path = rescore_temp_path("session.wav");
+        auto writer = io::WavWriter::create(path, 48000, 1);
+        if (!writer)
+            return false;
+        std::vector<float> samples(48000);
+        for (std::size_t i = 0; i < samples.size(); ++i)
+            samples[i] = static_cast<float>(i / 3);
+        writer->write(samples);
+        writer->flush();
+
+        std::mutex mutex;
+        std::vector<std::string> revisions;
+        rescore::Rescorer rescorer([]
+                                   { return std::make_unique<CountingEngine>(); },
+                                   16000);
+
+        auto job = [&](std::uint64_t first, std::uint64_t count, std::string live)
+        {
+            return rescore::RescoreJob{
+                .wav_path = path,
+                .wav_rate = 48000,
+                .first_sample = first,
+                .sample_count = count,
+                .live_text = std::move(live),
+                .on_revised = [&](std::string text)
+                {
+                    std::lock_guard lock(mutex);
+                    revisions.push_back(std::move(text));
+                },
+            };
+        };
+
+        // 0.5 s from 0.25 s in: 8000 samples at 16 kHz, first one averages 4000
+        rescorer.submit(job(12000, 24000, "live text"));
+        // Agreeing with the live pass is not a revision
+        rescorer.submit(job(0, 300, "100 from 0"));
+        rescorer.wait_idle();
+
+        writer->close();
+        std::filesystem::remove(path);
+        std::filesystem::remove(checksum::manifest_path(path));
+
+        return rescorer.completed() == 2 && revisions.size() == 1 && revisions[0] == "8000 from 4000";
+    }
+
+} // anonymous namespace
+
+int run_rescore_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("transcript_revision", test_transcript_revision);
+    run("rescorer_rereads_wav", test_rescorer_rereads_wav);
+
+    std::print("\nRescoring Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
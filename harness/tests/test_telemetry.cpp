@@ -2,9 +2,25 @@
 // TopNotchNotes Harness - Telemetry Tests
 // ============================================================================
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
 #include <print>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 import harness;
 
@@ -35,7 +51,36 @@ namespace
         if (json_escape(ctrl) != "\\u0001")
             return false;
 
-        return true;
+        // Long input: specials on both sides of 16/32-byte block boundaries,
+        // UTF-8 bytes (>= 0x80) pass through untouched
+        std::string text;
+        std::string expected;
+        for (int i = 0; i < 200; ++i)
+        {
+            char c = (i % 37 == 15) ? '"' : (i % 41 == 31) ? '\x1f' : (i % 29 == 16) ? '\xc3' : 'a';
+            text += c;
+            expected += c == '"' ? "\\\"" : c == '\x1f' ? "\\u001f" : std::string(1, c);
+        }
+        return json_escape(text) == expected;
+    }
+
+    bool test_json_line()
+    {
+        using namespace harness::telemetry;
+
+        std::string buffer;
+        auto line = JsonLine(buffer, EventType::Level)
+                        .number("db", -3.04f, 1)
+                        .number("frames", std::int64_t{-42})
+                        .string("body", "a\"b")
+                        .finish();
+        if (line != "{\"evt\":\"level\",\"db\":-3.0,\"frames\":-42,\"body\":\"a\\\"b\"}\n")
+            return false;
+
+        // Non-finite values must not break the JSON
+        std::string out;
+        append_fixed(out, -std::numeric_limits<float>::infinity(), 1);
+        return out == "null";
     }
 
     bool test_command_parsing()
@@ -55,6 +100,16 @@ namespace
             return false;
         if (parse_command("STATUS") != Command::Status)
             return false;
+        if (parse_command("SUBSCRIBE") != Command::Subscribe)
+            return false;
+        if (parse_command("COURSE") != Command::Course)
+            return false;
+        if (parse_command("ENGINE") != Command::Engine)
+            return false;
+        if (parse_command("TRACE") != Command::Trace)
+            return false;
+        if (parse_command("AEC") != Command::Aec)
+            return false;
         if (parse_command("INVALID") != Command::Unknown)
             return false;
         if (parse_command("start") != Command::Unknown)
@@ -120,6 +175,256 @@ namespace
         return true;
     }
 
+    bool test_shared_ring_records()
+    {
+        using namespace harness::shm;
+
+        auto ring = SharedRing::create(4096);
+        if (!ring)
+            return false;
+
+        // Push enough 1000-byte records to force wraparound with padding
+        std::vector<std::uint8_t> body(1000);
+        std::uint32_t next_expected = 0;
+        for (std::uint32_t i = 0; i < 20; ++i)
+        {
+            std::memset(body.data(), static_cast<int>(i), body.size());
+            if (!ring->write(RecordType::Waveform, std::as_bytes(std::span(&i, 1)),
+                             std::as_bytes(std::span(body))))
+                return false;
+
+            bool ok = true;
+            ring->read([&](RecordType type, std::span<const std::byte> payload)
+                       {
+                std::uint32_t id = 0;
+                std::memcpy(&id, payload.data(), sizeof(id));
+                ok = ok && type == RecordType::Waveform && payload.size() == 1004 &&
+                     id == next_expected++ && payload[4] == static_cast<std::byte>(id); });
+            if (!ok)
+                return false;
+        }
+
+        // Without a reader the ring fills up and drops instead of blocking
+        for (int i = 0; i < 8; ++i)
+            (void)ring->write(RecordType::Waveform, std::as_bytes(std::span(body)));
+
+        return next_expected == 20 && ring->dropped() > 0;
+    }
+
+    bool test_subscription_parsing()
+    {
+        using namespace harness::telemetry;
+        using namespace std::chrono_literals;
+
+        // Defaults: everything but metrics, level at 10 Hz
+        auto defaults = parse_subscription("");
+        if (!defaults || !defaults->wants(EventType::Level) || defaults->wants(EventType::Metrics))
+            return false;
+
+        auto sub = parse_subscription("txt status level=30 metrics=500");
+        if (!sub || sub->level_hz != 30 || sub->metrics_interval != 500ms)
+            return false;
+        if (!sub->wants(EventType::Text) || !sub->wants(EventType::Level) ||
+            !sub->wants(EventType::Metrics) || sub->wants(EventType::Waveform))
+            return false;
+
+        auto keywords = parse_subscription("kw");
+        if (!keywords || !keywords->wants(EventType::Keyword) || keywords->wants(EventType::Text))
+            return false;
+
+        auto no_partials = parse_subscription("partial=off");
+        if (!no_partials || no_partials->wants(EventType::Partial) || !no_partials->wants(EventType::Text))
+            return false;
+
+        return !parse_subscription("level=120") && !parse_subscription("bogus") &&
+               !parse_subscription("txt=5");
+    }
+
+    bool test_rate_gate()
+    {
+        using namespace harness::telemetry;
+        using namespace std::chrono_literals;
+
+        auto sub = parse_subscription("level=20");
+        if (!sub)
+            return false;
+
+        // Offer a level every 10 ms for one second: expect 20 admitted
+        RateGate gate;
+        RateGate::Clock::time_point now{};
+        int admitted = 0;
+        for (int i = 0; i < 100; ++i, now += 10ms)
+        {
+            if (gate.admit(*sub, EventType::Level, now))
+                ++admitted;
+        }
+
+        // Unlimited types always pass, unsubscribed ones never do
+        return admitted == 20 && gate.admit(*sub, EventType::Text, now) &&
+               !gate.admit(*sub, EventType::Metrics, now);
+    }
+
+    int connect_unix(const std::filesystem::path &path)
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool test_control_server_fanout()
+    {
+        using namespace harness;
+        using namespace std::chrono_literals;
+
+        auto path = std::filesystem::temp_directory_path() /
+                    ("tnn-test-" + std::to_string(::getpid()) + ".sock");
+        std::atomic<int> commands{0};
+        auto created = server::ControlServer::create(path, [&](std::string_view line)
+                                                     { if (line == "STATUS") ++commands; });
+        if (!created)
+            return false;
+        auto &srv = *created;
+
+        int all = connect_unix(path);
+        int text_only = connect_unix(path);
+        if (all < 0 || text_only < 0)
+            return false;
+
+        std::string_view sub = "SUBSCRIBE txt\nSTATUS\n";
+        (void)::send(text_only, sub.data(), sub.size(), 0);
+
+        // Wait for both clients and the filter to be registered
+        for (int i = 0; i < 200 && (srv->client_count() < 2 || commands == 0); ++i)
+            std::this_thread::sleep_for(5ms);
+
+        srv->publish(telemetry::EventType::Level, "{\"evt\":\"level\",\"db\":-3.0}\n");
+        srv->publish(telemetry::EventType::Text, "{\"evt\":\"txt\",\"body\":\"hi\"}\n");
+
+        auto read_until = [](int fd, std::size_t lines)
+        {
+            std::string got;
+            char buf[256];
+            for (int i = 0; i < 200 && static_cast<std::size_t>(std::count(got.begin(), got.end(), '\n')) < lines; ++i)
+            {
+                ssize_t n = ::recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+                if (n > 0)
+                    got.append(buf, static_cast<std::size_t>(n));
+                else
+                    std::this_thread::sleep_for(5ms);
+            }
+            return got;
+        };
+
+        auto all_got = read_until(all, 2);
+        auto text_got = read_until(text_only, 1);
+        ::close(all);
+        ::close(text_only);
+
+        return commands == 1 &&
+               all_got.find("level") != std::string::npos && all_got.find("txt") != std::string::npos &&
+               text_got.find("level") == std::string::npos && text_got.find("txt") != std::string::npos;
+    }
+
+    bool test_course_library()
+    {
+        using namespace harness::course;
+        namespace fs = std::filesystem;
+
+        if (valid_course_id("../etc") || valid_course_id("") || !valid_course_id("cs-101_a"))
+            return false;
+
+        auto root = fs::temp_directory_path() / ("tnn-courses-" + std::to_string(::getpid()));
+        fs::create_directories(root / "bio-201");
+        std::FILE *dict = std::fopen((root / "bio-201" / "course.dict").c_str(), "w");
+        if (!dict)
+            return false;
+        std::fputs("mitochondria M AY T AH K AA N D R IY AH\n", dict);
+        std::fclose(dict);
+
+        CourseLibrary library(root, root / ".cache");
+        auto model = library.resolve("bio-201");
+        bool ok = model && model->lm_path.empty() && !model->dict_path.empty() &&
+                  !library.resolve("chem-101") && !library.resolve("bio/201");
+
+        std::error_code ec;
+        fs::remove_all(root, ec);
+        return ok;
+    }
+
+    bool test_engine_registry()
+    {
+        using namespace harness::transcribe;
+
+        auto &registry = engines();
+        if (!registry.contains("pocketsphinx") || !registry.contains("stub") || registry.contains("nope"))
+            return false;
+        if (registry.create("nope", {}))
+            return false;
+
+        auto engine = registry.create("stub", {});
+        if (!engine || (*engine)->is_async())
+            return false;
+
+        // The default asynchronous interface: partials while speech continues,
+        // then exactly one final per submit_end()
+        std::vector<float> frame(320);
+        int partials = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            (*engine)->submit(frame);
+            while (auto event = (*engine)->poll())
+                partials += event->final ? 100 : 1;
+        }
+        (*engine)->submit_end();
+        auto final = (*engine)->poll();
+        return partials == 2 && final && final->final && !final->segment.words.empty() &&
+               !(*engine)->poll();
+    }
+
+    bool test_trace_export()
+    {
+        namespace trace = harness::trace;
+
+        const auto path = std::filesystem::temp_directory_path() /
+                          ("tnn-trace-" + std::to_string(::getpid()) + ".json");
+        {
+            trace::Scope before("before_window"); // Never recorded
+        }
+        if (!trace::compiled_in)
+            return !trace::stop(path);
+
+        trace::start();
+        {
+            trace::Scope outer("outer");
+            trace::Scope inner("inner");
+        }
+        std::thread([]
+                    { trace::Scope scope("worker"); })
+            .join();
+        auto summary = trace::stop(path);
+        if (!summary || summary->events != 3 || summary->threads != 2 || summary->dropped != 0 || trace::active())
+            return false;
+
+        std::FILE *file = std::fopen(path.c_str(), "r");
+        if (!file)
+            return false;
+        std::string json(static_cast<std::size_t>(std::filesystem::file_size(path)), '\0');
+        const bool read = std::fread(json.data(), 1, json.size(), file) == json.size();
+        std::fclose(file);
+        std::filesystem::remove(path);
+
+        // Nothing to stop twice, and markers outside the window stay out
+        return read && json.starts_with("{\"displayTimeUnit\"") && json.contains("\"name\":\"inner\"") &&
+               json.contains("\"name\":\"worker\"") && !json.contains("before_window") && !trace::stop(path);
+    }
+
 } // anonymous namespace
 
 int run_telemetry_tests()
@@ -146,6 +451,14 @@ int run_telemetry_tests()
     run("state_to_string", test_state_to_string);
     run("session_id_generation", test_session_id_generation);
     run("audio_config", test_audio_config);
+    run("shared_ring_records", test_shared_ring_records);
+    run("json_line", test_json_line);
+    run("subscription_parsing", test_subscription_parsing);
+    run("rate_gate", test_rate_gate);
+    run("control_server_fanout", test_control_server_fanout);
+    run("course_library", test_course_library);
+    run("engine_registry", test_engine_registry);
+    run("trace_export", test_trace_export);
 
     std::print("\nTelemetry Tests: {} passed, {} failed\n", passed, failed);
     return failed > 0 ? 1 : 0;
@@ -153,43 +466,75 @@ int run_telemetry_tests()
 
 // Declare external test functions
 extern int run_ringbuffer_tests();
+extern int run_preview_tests();
+extern int run_postprocess_tests();
+extern int run_rescore_tests();
+extern int run_asr_tests();
+extern int run_convert_tests();
+extern int run_journal_tests();
+extern int run_metrics_tests();
+extern int run_memory_tests();
+extern int run_checksum_tests();
+extern int run_audio_tests();
+extern int run_echo_tests();
+extern int run_clock_tests();
+extern int run_keywords_tests();
+extern int run_whisper_tests();
+
+namespace
+{
+    struct Suite
+    {
+        std::string_view flag;
+        int (*run)();
+    };
+
+    constexpr Suite suites[] = {
+        {"--ringbuffer", run_ringbuffer_tests},
+        {"--telemetry", run_telemetry_tests},
+        {"--preview", run_preview_tests},
+        {"--postprocess", run_postprocess_tests},
+        {"--rescore", run_rescore_tests},
+        {"--asr", run_asr_tests},
+        {"--convert", run_convert_tests},
+        {"--journal", run_journal_tests},
+        {"--metrics", run_metrics_tests},
+        {"--memory", run_memory_tests},
+        {"--checksum", run_checksum_tests},
+        {"--audio", run_audio_tests},
+        {"--echo", run_echo_tests},
+        {"--clock", run_clock_tests},
+        {"--keywords", run_keywords_tests},
+        {"--whisper", run_whisper_tests},
+    };
+} // anonymous namespace
 
 int main(int argc, char *argv[])
 {
-    bool run_ringbuffer = false;
-    bool run_telemetry = false;
+    bool selected[std::size(suites)] = {};
+    bool any = false;
 
     for (int i = 1; i < argc; ++i)
     {
         std::string_view arg(argv[i]);
-        if (arg == "--ringbuffer")
-            run_ringbuffer = true;
-        if (arg == "--telemetry")
-            run_telemetry = true;
-        if (arg == "--all")
+        for (std::size_t s = 0; s < std::size(suites); ++s)
         {
-            run_ringbuffer = true;
-            run_telemetry = true;
+            if (arg == suites[s].flag || arg == "--all")
+            {
+                selected[s] = true;
+                any = true;
+            }
         }
     }
 
     // If no specific tests requested, run all
-    if (!run_ringbuffer && !run_telemetry)
-    {
-        run_ringbuffer = true;
-        run_telemetry = true;
-    }
-
     int result = 0;
-
-    if (run_ringbuffer)
+    for (std::size_t s = 0; s < std::size(suites); ++s)
     {
-        result |= run_ringbuffer_tests();
-    }
-
-    if (run_telemetry)
-    {
-        result |= run_telemetry_tests();
+        if (!any || selected[s])
+        {
+            result |= suites[s].run();
+        }
     }
 
     return result;
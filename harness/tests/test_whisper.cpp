@@ -0,0 +1,100 @@
+// ============================================================================
+// TopNotchNotes Harness - Whisper Windowing Tests
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <span>
+#include <vector>
+
+import harness;
+
+namespace
+{
+
+    using namespace std::chrono_literals;
+
+    /// Samples whisper receives for `capture_samples` at 48 kHz, fed the way
+    /// submit() is fed live: 1024-sample frames through a DecoderFeed
+    std::size_t whisper_samples_from_capture(std::size_t capture_samples)
+    {
+        harness::transcribe::TranscribeConfig config;
+        config.input_rate = 48000;
+        harness::transcribe::DecoderFeed feed(config.input_rate, harness::transcribe::whisper_rate);
+
+        const std::vector<float> frame(1024, 0.25f);
+        std::size_t decoded = 0;
+        for (std::size_t fed = 0; fed < capture_samples; fed += frame.size())
+        {
+            const auto count = std::min(frame.size(), capture_samples - fed);
+            decoded += feed.push(std::span<const float>(frame).first(count)).size();
+        }
+        return decoded;
+    }
+
+    /// 20.5 s of capture is 20.5 s of whisper audio: two 10 s windows, the
+    /// half-second tail joining the second, which starts at 10 s
+    bool test_capture_frames_window_at_whisper_rate()
+    {
+        const auto samples = whisper_samples_from_capture(48000 * 41 / 2);
+        const harness::transcribe::TranscribeConfig config;
+        const auto window = static_cast<std::size_t>(config.whisper_window.count()) *
+                            harness::transcribe::whisper_rate / 1000;
+        const auto windows = harness::transcribe::whisper_windows(samples, window);
+
+        const bool ok = samples == 328000 && windows.size() == 2 && windows[0].offset == 0 &&
+                        windows[0].length == 160000 && windows[0].shift == 0ms && windows[1].offset == 160000 &&
+                        windows[1].length == 168000 && windows[1].shift == 10000ms;
+        if (!ok)
+        {
+            std::print("  {} samples:", samples);
+            for (const auto &w : windows)
+                std::print(" [{}+{} @{} ms]", w.offset, w.length, w.shift.count());
+            std::print("\n");
+        }
+        return ok;
+    }
+
+    /// A tail of a second or more is decoded on its own, shifted to its
+    /// offset; an empty utterance has no windows
+    bool test_long_tail_gets_own_window()
+    {
+        const auto samples = whisper_samples_from_capture(48000 * 23 + 24000);
+        const auto windows = harness::transcribe::whisper_windows(samples, 160000);
+        const bool ok = samples == 376000 && windows.size() == 3 && windows[2].offset == 320000 &&
+                        windows[2].length == 56000 && windows[2].shift == 20000ms &&
+                        harness::transcribe::whisper_windows(0, 160000).empty();
+        if (!ok)
+            std::print("  {} samples, {} windows\n", samples, windows.size());
+        return ok;
+    }
+
+} // anonymous namespace
+
+int run_whisper_tests()
+{
+    int passed = 0;
+    int failed = 0;
+
+    auto run = [&](const char *name, bool (*test)())
+    {
+        if (test())
+        {
+            std::print("[PASS] {}\n", name);
+            ++passed;
+        }
+        else
+        {
+            std::print("[FAIL] {}\n", name);
+            ++failed;
+        }
+    };
+
+    run("capture_frames_window_at_whisper_rate", test_capture_frames_window_at_whisper_rate);
+    run("long_tail_gets_own_window", test_long_tail_gets_own_window);
+
+    std::print("\nWhisper Tests: {} passed, {} failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
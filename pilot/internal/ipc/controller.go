@@ -8,6 +8,7 @@ import (
 	"fmt"
 	"io"
 	"log"
+	"os"
 	"os/exec"
 	"sync"
 	"time"
@@ -17,12 +18,22 @@ import (
 type Command string
 
 const (
-	CmdStart  Command = "START"
-	CmdStop   Command = "STOP"
-	CmdPause  Command = "PAUSE"
-	CmdResume Command = "RESUME"
-	CmdStatus Command = "STATUS"
-	CmdKill   Command = "KILL"
+	CmdStart     Command = "START"
+	CmdStop      Command = "STOP"
+	CmdPause     Command = "PAUSE"
+	CmdResume    Command = "RESUME"
+	CmdStatus    Command = "STATUS"
+	CmdKill      Command = "KILL"
+	CmdSubscribe Command = "SUBSCRIBE"
+	CmdCourse    Command = "COURSE"
+	CmdEngine    Command = "ENGINE"
+)
+
+// Subscriptions requested from the harness depending on UI visibility.
+// A hidden window only needs what changes persistent state.
+var (
+	ForegroundSubscription = []string{"*", "level=30"}
+	BackgroundSubscription = []string{"status", "txt", "rev", "kw", "err", "info", "session", "heartbeat"}
 )
 
 // EventType represents the type of telemetry event from the harness
@@ -36,6 +47,12 @@ const (
 	EventInfo      EventType = "info"
 	EventSession   EventType = "session"
 	EventHeartbeat EventType = "heartbeat"
+	EventWaveform  EventType = "wave"
+	EventSpectrum  EventType = "spec"
+	EventPartial   EventType = "partial"
+	EventMetrics   EventType = "metrics"
+	EventKeyword   EventType = "kw"
+	EventRevision  EventType = "rev"
 )
 
 // TelemetryEvent represents a JSON message from the harness
@@ -43,8 +60,10 @@ type TelemetryEvent struct {
 	Event     EventType `json:"evt"`
 	State     string    `json:"state,omitempty"`
 	Body      string    `json:"body,omitempty"`
+	Seg       uint64    `json:"seg,omitempty"` // Transcript segment, for txt and rev
 	DB        float64   `json:"db,omitempty"`
 	Time      int64     `json:"time,omitempty"`
+	Conf      float64   `json:"conf,omitempty"`
 	Timestamp int64     `json:"ts,omitempty"`
 	
 	// Session events
@@ -53,6 +72,11 @@ type TelemetryEvent struct {
 	Path     string `json:"path,omitempty"`
 	Bytes    int64  `json:"bytes,omitempty"`
 	Duration int64  `json:"duration,omitempty"`
+
+	// Preview events (base64 payload decoded by encoding/json)
+	Cols int    `json:"cols,omitempty"`
+	Bins int    `json:"bins,omitempty"`
+	Data []byte `json:"data,omitempty"`
 }
 
 // EventHandler is a callback for telemetry events
@@ -62,6 +86,8 @@ type EventHandler func(event TelemetryEvent)
 type Controller struct {
 	binaryPath string
 	outputDir  string
+	courseDir  string // Per-course vocabularies, passed as --courses
+	kwsMode    string // Keyword spotting: "", "alongside" or "only"
 	
 	cmd    *exec.Cmd
 	stdin  io.WriteCloser
@@ -77,9 +103,17 @@ type Controller struct {
 	handlers   []EventHandler
 	handlersMu sync.RWMutex
 	
+	// Optional shared-memory ring for level/preview telemetry; its poller
+	// unmaps it once ringStop closes
+	ring     *SharedRing
+	ringStop chan struct{}
+	
 	done chan struct{}
 }
 
+// sharedRingPollInterval is how often the shared-memory ring is drained
+const sharedRingPollInterval = 10 * time.Millisecond
+
 // NewController creates a new harness controller
 func NewController(binaryPath string) *Controller {
 	return &Controller{
@@ -96,6 +130,22 @@ func (c *Controller) SetOutputDir(dir string) {
 	c.outputDir = dir
 }
 
+// SetCourseDir sets the directory holding per-course vocabularies.
+// Takes effect on the next Start.
+func (c *Controller) SetCourseDir(dir string) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.courseDir = dir
+}
+
+// SetKeywordSpotting enables keyword highlights ("alongside" full decoding,
+// or "only" to skip it). Takes effect on the next Start.
+func (c *Controller) SetKeywordSpotting(mode string) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.kwsMode = mode
+}
+
 // OnEvent registers a handler for telemetry events
 func (c *Controller) OnEvent(handler EventHandler) {
 	c.handlersMu.Lock()
@@ -107,10 +157,39 @@ func (c *Controller) OnEvent(handler EventHandler) {
 func (c *Controller) Start() error {
 	c.mu.Lock()
 	defer c.mu.Unlock()
+
+	// A ring from an earlier harness must never be drained again
+	c.stopSharedRing()
+	
+	// High-rate telemetry goes through a shared-memory ring when available;
+	// the pipes then only carry commands and control events.
+	// The dashboard's level meter needs capture between sessions, so the
+	// harness stays in standby rather than parking the device.
+	args := []string{"-v", "--idle", "standby"}
+	if c.courseDir != "" {
+		args = append(args, "--courses", c.courseDir)
+	}
+	if c.kwsMode != "" {
+		args = append(args, "--kws", c.kwsMode)
+	}
+	ring, ringFile, err := NewSharedRing(DefaultSharedRingSize)
+	if err != nil {
+		log.Printf("Shared-memory telemetry unavailable, using pipe: %v", err)
+	} else {
+		args = append(args, "--shm-fd", "3") // First ExtraFiles entry
+		defer func() {
+			if c.ring != ring {
+				ring.Close() // Start failed before handing the ring to the poller
+			}
+		}()
+	}
 	
-	c.cmd = exec.Command(c.binaryPath, "-v")
+	c.cmd = exec.Command(c.binaryPath, args...)
+	if ringFile != nil {
+		c.cmd.ExtraFiles = []*os.File{ringFile}
+		defer ringFile.Close() // The child keeps its own descriptor
+	}
 	
-	var err error
 	c.stdin, err = c.cmd.StdinPipe()
 	if err != nil {
 		return fmt.Errorf("failed to get stdin pipe: %w", err)
@@ -131,14 +210,28 @@ func (c *Controller) Start() error {
 	}
 	
 	// Start the telemetry listener
-	go c.listenTelemetry()
+	go c.listenTelemetry(ring)
 	go c.logStderr()
+	if ring != nil {
+		c.ring = ring
+		c.ringStop = make(chan struct{})
+		go c.pollSharedRing(ring, c.ringStop)
+	}
 	
 	return nil
 }
 
-// listenTelemetry reads and processes JSON telemetry from stdout
-func (c *Controller) listenTelemetry() {
+// listenTelemetry reads and processes JSON telemetry from stdout. When the
+// harness exits it takes its shared-memory ring along.
+func (c *Controller) listenTelemetry(ring *SharedRing) {
+	defer func() {
+		c.mu.Lock()
+		defer c.mu.Unlock()
+		if ring != nil && c.ring == ring {
+			c.stopSharedRing()
+		}
+	}()
+
 	scanner := bufio.NewScanner(c.stdout)
 	
 	for scanner.Scan() {
@@ -163,11 +256,49 @@ func (c *Controller) listenTelemetry() {
 		c.processEvent(event)
 		
 		// Notify handlers
-		c.handlersMu.RLock()
-		for _, handler := range c.handlers {
-			handler(event)
+		c.dispatch(event)
+	}
+}
+
+// pollSharedRing drains binary telemetry from the shared-memory ring
+func (c *Controller) pollSharedRing(ring *SharedRing, stop <-chan struct{}) {
+	ticker := time.NewTicker(sharedRingPollInterval)
+	defer ticker.Stop()
+	defer ring.Close()
+	
+	for {
+		select {
+		case <-c.done:
+			return
+		case <-stop:
+			return
+		case <-ticker.C:
+			_, err := ring.Drain(func(event TelemetryEvent) {
+				c.processEvent(event)
+				c.dispatch(event)
+			})
+			if err != nil {
+				log.Printf("Shared-memory telemetry: %v", err)
+			}
 		}
-		c.handlersMu.RUnlock()
+	}
+}
+
+// stopSharedRing detaches the current ring. Caller holds c.mu.
+func (c *Controller) stopSharedRing() {
+	if c.ring != nil {
+		close(c.ringStop)
+		c.ring = nil
+		c.ringStop = nil
+	}
+}
+
+// dispatch notifies all registered handlers of an event
+func (c *Controller) dispatch(event TelemetryEvent) {
+	c.handlersMu.RLock()
+	defer c.handlersMu.RUnlock()
+	for _, handler := range c.handlers {
+		handler(event)
 	}
 }
 
@@ -256,6 +387,28 @@ func (c *Controller) Status() error {
 	return c.sendCommand(CmdStatus)
 }
 
+// Subscribe sets which events the harness sends and at what rates,
+// e.g. Subscribe("txt", "level=30", "partial=off")
+func (c *Controller) Subscribe(spec ...string) error {
+	return c.sendCommand(CmdSubscribe, spec...)
+}
+
+// SetEngine selects the transcription backend by name ("pocketsphinx",
+// "whisper", ...) for the next recording.
+func (c *Controller) SetEngine(name string) error {
+	return c.sendCommand(CmdEngine, name)
+}
+
+// SetCourse switches the harness to a course's vocabulary; an empty ID
+// selects the generic model. Mid-recording the switch happens at the next
+// utterance boundary.
+func (c *Controller) SetCourse(courseID string) error {
+	if courseID == "" {
+		return c.sendCommand(CmdCourse)
+	}
+	return c.sendCommand(CmdCourse, courseID)
+}
+
 // Terminate kills the harness process
 func (c *Controller) Terminate() {
 	close(c.done)
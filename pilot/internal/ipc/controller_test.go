@@ -36,6 +36,14 @@ func TestEventHandler(t *testing.T) {
 		Event: EventStatus,
 		State: "recording",
 	})
+	c.dispatch(TelemetryEvent{
+		Event: EventStatus,
+		State: "recording",
+	})
+
+	if !eventReceived {
+		t.Error("Expected handler to receive the event")
+	}
 	
 	if !c.IsRecording() {
 		t.Error("Expected IsRecording to be true after 'recording' status")
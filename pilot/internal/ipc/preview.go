@@ -0,0 +1,37 @@
+package ipc
+
+// WaveColumn is one decimated pixel column of the waveform preview
+type WaveColumn struct {
+	Min float32
+	Max float32
+	RMS float32
+}
+
+// waveColumnBytes is the packed size of a column: int8 min, int8 max, uint8 rms
+const waveColumnBytes = 3
+
+// DecodeWaveform unpacks the payload of a "wave" event into columns
+func DecodeWaveform(data []byte) []WaveColumn {
+	columns := make([]WaveColumn, 0, len(data)/waveColumnBytes)
+	for i := 0; i+waveColumnBytes <= len(data); i += waveColumnBytes {
+		columns = append(columns, WaveColumn{
+			Min: float32(int8(data[i])) / 127,
+			Max: float32(int8(data[i+1])) / 127,
+			RMS: float32(data[i+2]) / 255,
+		})
+	}
+	return columns
+}
+
+// SplitSpectrum splits the payload of a "spec" event into per-slice band
+// intensities (0 = floor, 255 = full scale)
+func SplitSpectrum(data []byte, bins int) [][]byte {
+	if bins <= 0 {
+		return nil
+	}
+	slices := make([][]byte, 0, len(data)/bins)
+	for i := 0; i+bins <= len(data); i += bins {
+		slices = append(slices, data[i:i+bins])
+	}
+	return slices
+}
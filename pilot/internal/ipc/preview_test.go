@@ -0,0 +1,34 @@
+package ipc
+
+import (
+	"encoding/json"
+	"testing"
+)
+
+func TestDecodeWaveform(t *testing.T) {
+	// min -127, max 127, rms 255 followed by a trailing partial column
+	columns := DecodeWaveform([]byte{0x81, 0x7f, 0xff, 0x00})
+
+	if len(columns) != 1 {
+		t.Fatalf("Expected 1 column, got %d", len(columns))
+	}
+	if columns[0].Min != -1 || columns[0].Max != 1 || columns[0].RMS != 1 {
+		t.Errorf("Unexpected column %+v", columns[0])
+	}
+}
+
+func TestSpectrumEventDecoding(t *testing.T) {
+	var event TelemetryEvent
+	line := `{"evt":"spec","bins":2,"data":"AAEC/w=="}`
+	if err := json.Unmarshal([]byte(line), &event); err != nil {
+		t.Fatalf("Unmarshal failed: %v", err)
+	}
+
+	slices := SplitSpectrum(event.Data, event.Bins)
+	if len(slices) != 2 {
+		t.Fatalf("Expected 2 slices, got %d", len(slices))
+	}
+	if slices[1][1] != 0xff {
+		t.Errorf("Expected last band 255, got %d", slices[1][1])
+	}
+}
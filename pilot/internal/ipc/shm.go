@@ -0,0 +1,151 @@
+package ipc
+
+import (
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"math"
+	"sync/atomic"
+	"unsafe"
+)
+
+// Shared-memory ring layout (must match harness/src/modules/shm.ixx)
+const (
+	shmMagic         = 0x48534E54 // "TNSH"
+	shmVersion       = 1
+	shmHeaderSize    = 256
+	shmWritePosOff   = 64
+	shmReadPosOff    = 128
+	shmDroppedOff    = 192
+	shmRecordHdrSize = 8
+
+	// DefaultSharedRingSize is the data capacity used for preview telemetry
+	DefaultSharedRingSize = 1 << 20
+)
+
+// Record types carried by the ring
+const (
+	recordPadding  = 0
+	recordLevel    = 1
+	recordWaveform = 2
+	recordSpectrum = 3
+)
+
+// SharedRing is the consumer side of the harness's SPSC telemetry ring.
+// The harness only ever advances the write index and the pilot only the
+// read index, so no locking is required across the process boundary.
+type SharedRing struct {
+	mem      []byte
+	capacity uint64
+	closer   func() error
+}
+
+// newSharedRing initializes a ring header over mem (header + capacity bytes)
+func newSharedRing(mem []byte) (*SharedRing, error) {
+	if len(mem) <= shmHeaderSize {
+		return nil, errors.New("shared ring too small")
+	}
+	capacity := uint64(len(mem) - shmHeaderSize)
+	if capacity&(capacity-1) != 0 {
+		return nil, errors.New("shared ring capacity must be a power of two")
+	}
+
+	binary.LittleEndian.PutUint32(mem[0:], shmMagic)
+	binary.LittleEndian.PutUint32(mem[4:], shmVersion)
+	binary.LittleEndian.PutUint64(mem[8:], capacity)
+	atomic.StoreUint64(indexAt(mem, shmWritePosOff), 0)
+	atomic.StoreUint64(indexAt(mem, shmReadPosOff), 0)
+	atomic.StoreUint64(indexAt(mem, shmDroppedOff), 0)
+
+	return &SharedRing{mem: mem, capacity: capacity}, nil
+}
+
+func indexAt(mem []byte, off int) *uint64 {
+	return (*uint64)(unsafe.Pointer(&mem[off]))
+}
+
+// Dropped returns how many records the harness discarded because the ring was full
+func (r *SharedRing) Dropped() uint64 {
+	return atomic.LoadUint64(indexAt(r.mem, shmDroppedOff))
+}
+
+// ErrRingCorrupt reports indices or a record header that cannot have come
+// from the harness; Drain skips everything pending when it sees one
+var ErrRingCorrupt = errors.New("shared ring corrupt")
+
+// Drain converts all pending records into telemetry events and releases
+// them. Event.Data aliases shared memory and is only valid during fn.
+// Records are validated before they are sliced: on a torn or corrupt one
+// the read index jumps to the write index and ErrRingCorrupt is returned.
+func (r *SharedRing) Drain(fn func(TelemetryEvent)) (int, error) {
+	data := r.mem[shmHeaderSize:]
+	readPos := atomic.LoadUint64(indexAt(r.mem, shmReadPosOff))
+	writePos := atomic.LoadUint64(indexAt(r.mem, shmWritePosOff))
+	count := 0
+
+	var err error
+	if writePos < readPos || writePos-readPos > r.capacity {
+		err = fmt.Errorf("%w: write index %d, read index %d", ErrRingCorrupt, writePos, readPos)
+	}
+	for err == nil && readPos < writePos {
+		off := readPos & (r.capacity - 1)
+		if readPos&7 != 0 || off+shmRecordHdrSize > r.capacity {
+			err = fmt.Errorf("%w: misaligned record at %d", ErrRingCorrupt, readPos)
+			break
+		}
+		size := uint64(binary.LittleEndian.Uint32(data[off:]))
+		kind := binary.LittleEndian.Uint16(data[off+4:])
+		span := (shmRecordHdrSize + size + 7) &^ 7
+		// Records never wrap: the harness pads to the end of the data area
+		if size > r.capacity-shmRecordHdrSize || off+shmRecordHdrSize+size > uint64(len(data)) ||
+			span > writePos-readPos {
+			err = fmt.Errorf("%w: %d-byte record at %d", ErrRingCorrupt, size, readPos)
+			break
+		}
+		payload := data[off+shmRecordHdrSize : off+shmRecordHdrSize+size]
+
+		if event, ok := decodeRecord(kind, payload); ok {
+			fn(event)
+			count++
+		}
+		readPos += span
+	}
+	if err != nil {
+		readPos = writePos
+	}
+
+	atomic.StoreUint64(indexAt(r.mem, shmReadPosOff), readPos)
+	return count, err
+}
+
+// decodeRecord maps a binary record onto the equivalent JSON event shape
+func decodeRecord(kind uint16, payload []byte) (TelemetryEvent, bool) {
+	switch kind {
+	case recordLevel:
+		if len(payload) < 4 {
+			return TelemetryEvent{}, false
+		}
+		db := math.Float32frombits(binary.LittleEndian.Uint32(payload))
+		return TelemetryEvent{Event: EventLevel, DB: float64(db)}, true
+	case recordWaveform, recordSpectrum:
+		if len(payload) < 4 {
+			return TelemetryEvent{}, false
+		}
+		count := int(binary.LittleEndian.Uint32(payload))
+		if kind == recordWaveform {
+			return TelemetryEvent{Event: EventWaveform, Cols: count, Data: payload[4:]}, true
+		}
+		return TelemetryEvent{Event: EventSpectrum, Bins: count, Data: payload[4:]}, true
+	}
+	return TelemetryEvent{}, false
+}
+
+// Close unmaps the ring
+func (r *SharedRing) Close() error {
+	if r.closer == nil {
+		return nil
+	}
+	err := r.closer()
+	r.closer = nil
+	return err
+}
@@ -0,0 +1,42 @@
+//go:build linux
+
+package ipc
+
+import (
+	"fmt"
+	"os"
+
+	"golang.org/x/sys/unix"
+)
+
+// NewSharedRing creates a memfd-backed ring with the given data capacity.
+// The returned file is handed to the harness as an inherited descriptor.
+func NewSharedRing(capacity int) (*SharedRing, *os.File, error) {
+	fd, err := unix.MemfdCreate("topnotch-telemetry", unix.MFD_CLOEXEC)
+	if err != nil {
+		return nil, nil, fmt.Errorf("memfd_create: %w", err)
+	}
+	file := os.NewFile(uintptr(fd), "topnotch-telemetry")
+
+	size := shmHeaderSize + capacity
+	if err := unix.Ftruncate(fd, int64(size)); err != nil {
+		file.Close()
+		return nil, nil, fmt.Errorf("ftruncate: %w", err)
+	}
+
+	mem, err := unix.Mmap(fd, 0, size, unix.PROT_READ|unix.PROT_WRITE, unix.MAP_SHARED)
+	if err != nil {
+		file.Close()
+		return nil, nil, fmt.Errorf("mmap: %w", err)
+	}
+
+	ring, err := newSharedRing(mem)
+	if err != nil {
+		unix.Munmap(mem)
+		file.Close()
+		return nil, nil, err
+	}
+	ring.closer = func() error { return unix.Munmap(mem) }
+
+	return ring, file, nil
+}
@@ -0,0 +1,13 @@
+//go:build !linux
+
+package ipc
+
+import (
+	"errors"
+	"os"
+)
+
+// NewSharedRing is only supported on Linux; callers fall back to the pipe
+func NewSharedRing(capacity int) (*SharedRing, *os.File, error) {
+	return nil, nil, errors.New("shared-memory telemetry requires Linux")
+}
@@ -0,0 +1,107 @@
+package ipc
+
+import (
+	"encoding/binary"
+	"errors"
+	"math"
+	"sync/atomic"
+	"testing"
+)
+
+// writeRecord mimics the harness producer (SharedRing::write) for tests
+func writeRecord(t *testing.T, mem []byte, kind uint16, payload []byte) {
+	t.Helper()
+	capacity := uint64(len(mem) - shmHeaderSize)
+	data := mem[shmHeaderSize:]
+	span := (shmRecordHdrSize + uint64(len(payload)) + 7) &^ 7
+
+	w := atomic.LoadUint64(indexAt(mem, shmWritePosOff))
+	off := w & (capacity - 1)
+	if contiguous := capacity - off; contiguous < span {
+		binary.LittleEndian.PutUint32(data[off:], uint32(contiguous-shmRecordHdrSize))
+		binary.LittleEndian.PutUint16(data[off+4:], recordPadding)
+		w += contiguous
+		off = 0
+	}
+
+	binary.LittleEndian.PutUint32(data[off:], uint32(len(payload)))
+	binary.LittleEndian.PutUint16(data[off+4:], kind)
+	copy(data[off+shmRecordHdrSize:], payload)
+	atomic.StoreUint64(indexAt(mem, shmWritePosOff), w+span)
+}
+
+func TestSharedRingDrain(t *testing.T) {
+	ring, err := newSharedRing(make([]byte, shmHeaderSize+4096))
+	if err != nil {
+		t.Fatalf("newSharedRing failed: %v", err)
+	}
+
+	level := make([]byte, 4)
+	binary.LittleEndian.PutUint32(level, math.Float32bits(-12.5))
+
+	wave := make([]byte, 4+1500)
+	binary.LittleEndian.PutUint32(wave, 500)
+
+	// Enough rounds to wrap the 4 KiB data area several times
+	for round := 0; round < 10; round++ {
+		writeRecord(t, ring.mem, recordLevel, level)
+		writeRecord(t, ring.mem, recordWaveform, wave)
+
+		var events []TelemetryEvent
+		n, err := ring.Drain(func(e TelemetryEvent) {
+			events = append(events, TelemetryEvent{Event: e.Event, DB: e.DB, Cols: e.Cols, Bins: e.Bins})
+		})
+
+		if err != nil || n != 2 || len(events) != 2 {
+			t.Fatalf("Round %d: expected 2 events, got %d (%v)", round, n, err)
+		}
+		if events[0].Event != EventLevel || events[0].DB != -12.5 {
+			t.Errorf("Round %d: unexpected level event %+v", round, events[0])
+		}
+		if events[1].Event != EventWaveform || events[1].Cols != 500 {
+			t.Errorf("Round %d: unexpected waveform event %+v", round, events[1])
+		}
+	}
+
+	if ring.Dropped() != 0 {
+		t.Errorf("Expected no drops, got %d", ring.Dropped())
+	}
+}
+
+func TestSharedRingRejectsBadSize(t *testing.T) {
+	if _, err := newSharedRing(make([]byte, shmHeaderSize+3000)); err == nil {
+		t.Error("Expected error for non power-of-two capacity")
+	}
+}
+
+func TestSharedRingSkipsCorruptRecords(t *testing.T) {
+	ring, err := newSharedRing(make([]byte, shmHeaderSize+4096))
+	if err != nil {
+		t.Fatalf("newSharedRing failed: %v", err)
+	}
+	level := make([]byte, 4)
+	binary.LittleEndian.PutUint32(level, math.Float32bits(-6))
+
+	// A header claiming more than the ring holds, then one that runs past
+	// the end of the data area
+	for _, size := range []uint32{1 << 30, 4096 - 16} {
+		writeRecord(t, ring.mem, recordLevel, level)
+		w := atomic.LoadUint64(indexAt(ring.mem, shmWritePosOff))
+		binary.LittleEndian.PutUint32(ring.mem[shmHeaderSize+w&4095:], size)
+		atomic.StoreUint64(indexAt(ring.mem, shmWritePosOff), w+8)
+
+		n, err := ring.Drain(func(TelemetryEvent) {})
+		if !errors.Is(err, ErrRingCorrupt) {
+			t.Fatalf("Size %d: expected ErrRingCorrupt, got %v after %d events", size, err, n)
+		}
+		if r := atomic.LoadUint64(indexAt(ring.mem, shmReadPosOff)); r != w+8 {
+			t.Errorf("Size %d: read index %d not moved to write index %d", size, r, w+8)
+		}
+	}
+
+	// The ring keeps working afterwards
+	writeRecord(t, ring.mem, recordLevel, level)
+	if n, err := ring.Drain(func(TelemetryEvent) {}); n != 1 || err != nil {
+		t.Errorf("Expected one event after resync, got %d (%v)", n, err)
+	}
+}
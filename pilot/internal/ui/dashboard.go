@@ -4,6 +4,7 @@ package ui
 import (
 	"fmt"
 	"image/color"
+	"strings"
 	"time"
 
 	"fyne.io/fyne/v2"
@@ -35,12 +36,17 @@ type Dashboard struct {
 
 	// Text areas
 	transcriptText *widget.Entry
+	segments       []transcriptSegment // Committed text, revised in place by rev events
+	transcriptCard *widget.Card
 	notesText      *widget.Entry
 
 	// Level meter
 	levelBar   *widget.ProgressBar
 	levelLabel *widget.Label
 
+	// Live waveform/spectrogram preview
+	preview *PreviewView
+
 	// Status
 	statusLabel   *widget.Label
 	durationLabel *widget.Label
@@ -211,7 +217,12 @@ func (d *Dashboard) buildMainArea() {
 	d.transcriptText.Wrapping = fyne.TextWrapWord
 	d.transcriptText.SetPlaceHolder("Transcription will appear here during recording...")
 
-	transcriptCard := widget.NewCard("Live Transcript", "", d.transcriptText)
+	// Partial hypotheses are shown as the card subtitle until finalized
+	d.transcriptCard = widget.NewCard("Live Transcript", "", d.transcriptText)
+
+	// Scrolling waveform and spectrogram above the transcript
+	d.preview = NewPreviewView()
+	previewCard := widget.NewCard("Live Audio", "", d.preview.Content())
 
 	// Notes editor
 	d.notesText = widget.NewMultiLineEntry()
@@ -222,7 +233,7 @@ func (d *Dashboard) buildMainArea() {
 
 	// Split view
 	d.mainArea = container.NewVSplit(
-		transcriptCard,
+		container.NewBorder(previewCard, nil, nil, nil, d.transcriptCard),
 		notesCard,
 	)
 }
@@ -233,17 +244,39 @@ func (d *Dashboard) setupEventHandlers() {
 		switch event.Event {
 		case ipc.EventText:
 			// Append transcribed text
-			current := d.transcriptText.Text
-			if current != "" {
-				current += " "
+			d.segments = append(d.segments, transcriptSegment{id: event.Seg, text: event.Body})
+			d.renderTranscript()
+			d.transcriptCard.SetSubTitle("")
+			
+		case ipc.EventRevision:
+			// The background pass produced better text for a segment
+			for i := range d.segments {
+				if d.segments[i].id == event.Seg {
+					d.segments[i].text = event.Body
+					d.renderTranscript()
+					break
+				}
 			}
-			d.transcriptText.SetText(current + event.Body)
+			
+		case ipc.EventPartial:
+			d.transcriptCard.SetSubTitle(event.Body)
+			
+		case ipc.EventKeyword:
+			// Latest highlight, with its offset into the recording
+			at := time.Duration(event.Time) * time.Millisecond
+			d.transcriptCard.SetTitle(fmt.Sprintf("Live Transcript  ★ %s at %s", event.Body, formatDuration(at)))
 			
 		case ipc.EventLevel:
 			// Update level meter
 			d.levelBar.SetValue(event.DB)
 			d.levelLabel.SetText(fmt.Sprintf("%.1f dB", event.DB))
 			
+		case ipc.EventWaveform:
+			d.preview.AddWaveform(ipc.DecodeWaveform(event.Data))
+			
+		case ipc.EventSpectrum:
+			d.preview.AddSpectrum(ipc.SplitSpectrum(event.Data, event.Bins))
+			
 		case ipc.EventStatus:
 			d.statusLabel.SetText(event.State)
 			d.updateButtonStates(event.State)
@@ -260,6 +293,21 @@ func (d *Dashboard) setupEventHandlers() {
 	})
 }
 
+// transcriptSegment is one committed piece of the live transcript
+type transcriptSegment struct {
+	id   uint64
+	text string
+}
+
+// renderTranscript shows the committed segments in order
+func (d *Dashboard) renderTranscript() {
+	texts := make([]string, len(d.segments))
+	for i, segment := range d.segments {
+		texts[i] = segment.text
+	}
+	d.transcriptText.SetText(strings.Join(texts, " "))
+}
+
 // updateDuration updates the duration display during recording
 func (d *Dashboard) updateDuration() {
 	ticker := time.NewTicker(time.Second)
@@ -270,15 +318,18 @@ func (d *Dashboard) updateDuration() {
 			return
 		}
 		
-		duration := time.Since(d.recordingStart)
-		hours := int(duration.Hours())
-		mins := int(duration.Minutes()) % 60
-		secs := int(duration.Seconds()) % 60
-		
-		d.durationLabel.SetText(fmt.Sprintf("%02d:%02d:%02d", hours, mins, secs))
+		d.durationLabel.SetText(formatDuration(time.Since(d.recordingStart)))
 	}
 }
 
+// formatDuration renders a recording offset as HH:MM:SS
+func formatDuration(duration time.Duration) string {
+	hours := int(duration.Hours())
+	mins := int(duration.Minutes()) % 60
+	secs := int(duration.Seconds()) % 60
+	return fmt.Sprintf("%02d:%02d:%02d", hours, mins, secs)
+}
+
 // updateButtonStates updates toolbar button states based on recording state
 func (d *Dashboard) updateButtonStates(state string) {
 	switch state {
@@ -309,8 +360,17 @@ func (d *Dashboard) onRecord() {
 	d.currentSession = sess
 	d.controller.SetOutputDir(d.sessManager.GetSessionDir(d.selectedCourse, sess.ID))
 	
-	// Clear transcript
+	// Clear transcript and preview
+	d.segments = nil
 	d.transcriptText.SetText("")
+	d.transcriptCard.SetTitle("Live Transcript")
+	d.transcriptCard.SetSubTitle("")
+	d.preview.Clear()
+	
+	// Load the course vocabulary before the first utterance
+	if err := d.controller.SetCourse(d.selectedCourse); err != nil {
+		d.ShowWarning("Failed to select course vocabulary: " + err.Error())
+	}
 	
 	// Start recording
 	if err := d.controller.StartRecording(); err != nil {
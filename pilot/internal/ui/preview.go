@@ -0,0 +1,117 @@
+package ui
+
+import (
+	"image/color"
+	"sync"
+
+	"fyne.io/fyne/v2"
+	"fyne.io/fyne/v2/canvas"
+	"fyne.io/fyne/v2/container"
+
+	"github.com/topnotchnotes/pilot/internal/ipc"
+)
+
+const (
+	previewColumns = 600 // 6s of waveform at 100 columns/s
+	previewSlices  = 150 // 6s of spectrogram at 25 slices/s
+)
+
+// PreviewView renders the scrolling waveform and spectrogram streamed by the harness
+type PreviewView struct {
+	mu      sync.Mutex
+	columns []ipc.WaveColumn
+	slices  [][]byte
+
+	waveform    *canvas.Raster
+	spectrogram *canvas.Raster
+	content     fyne.CanvasObject
+}
+
+// NewPreviewView creates an empty preview view
+func NewPreviewView() *PreviewView {
+	p := &PreviewView{}
+	p.waveform = canvas.NewRasterWithPixels(p.wavePixel)
+	p.waveform.SetMinSize(fyne.NewSize(200, 60))
+	p.spectrogram = canvas.NewRasterWithPixels(p.specPixel)
+	p.spectrogram.SetMinSize(fyne.NewSize(200, 60))
+	p.content = container.NewGridWithRows(2, p.waveform, p.spectrogram)
+	return p
+}
+
+// Content returns the canvas object for layout
+func (p *PreviewView) Content() fyne.CanvasObject { return p.content }
+
+// AddWaveform appends decoded waveform columns and redraws
+func (p *PreviewView) AddWaveform(columns []ipc.WaveColumn) {
+	p.mu.Lock()
+	p.columns = append(p.columns, columns...)
+	if over := len(p.columns) - previewColumns; over > 0 {
+		p.columns = append(p.columns[:0], p.columns[over:]...)
+	}
+	p.mu.Unlock()
+	p.waveform.Refresh()
+}
+
+// AddSpectrum appends spectrogram slices and redraws
+func (p *PreviewView) AddSpectrum(slices [][]byte) {
+	p.mu.Lock()
+	for _, s := range slices {
+		p.slices = append(p.slices, append([]byte(nil), s...))
+	}
+	if over := len(p.slices) - previewSlices; over > 0 {
+		p.slices = append(p.slices[:0], p.slices[over:]...)
+	}
+	p.mu.Unlock()
+	p.spectrogram.Refresh()
+}
+
+// Clear drops all buffered preview data
+func (p *PreviewView) Clear() {
+	p.mu.Lock()
+	p.columns = nil
+	p.slices = nil
+	p.mu.Unlock()
+	p.waveform.Refresh()
+	p.spectrogram.Refresh()
+}
+
+// wavePixel draws min/max as a light envelope with the RMS band on top
+func (p *PreviewView) wavePixel(x, y, w, h int) color.Color {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	// Right-align the newest column with the right edge
+	idx := len(p.columns) - previewColumns + x*previewColumns/max(w, 1)
+	if idx < 0 || idx >= len(p.columns) {
+		return color.Transparent
+	}
+	col := p.columns[idx]
+
+	// Map the row to an amplitude in [-1, 1]
+	amp := 1 - 2*float32(y)/float32(max(h-1, 1))
+	switch {
+	case amp >= -col.RMS && amp <= col.RMS:
+		return color.RGBA{R: 0x29, G: 0x79, B: 0xff, A: 0xff}
+	case amp >= col.Min && amp <= col.Max:
+		return color.RGBA{R: 0x90, G: 0xca, B: 0xf9, A: 0xff}
+	}
+	return color.Transparent
+}
+
+// specPixel draws the newest slice on the right, low bands at the bottom
+func (p *PreviewView) specPixel(x, y, w, h int) color.Color {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	idx := len(p.slices) - previewSlices + x*previewSlices/max(w, 1)
+	if idx < 0 || idx >= len(p.slices) {
+		return color.Transparent
+	}
+	slice := p.slices[idx]
+	if len(slice) == 0 {
+		return color.Transparent
+	}
+	band := (h - 1 - y) * len(slice) / max(h, 1)
+	v := slice[band]
+	return color.RGBA{R: v, G: v / 2, B: 0xff - v, A: 0xff}
+}
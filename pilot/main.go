@@ -42,6 +42,8 @@ func main() {
 
 	// Initialize the process controller (IPC with C++ harness)
 	controller := ipc.NewController(harnessPath)
+	controller.SetCourseDir(filepath.Join(getDataDir(), "courses"))
+	controller.SetKeywordSpotting("alongside")
 
 	// Create the main dashboard UI
 	dashboard := ui.NewDashboard(controller, sessManager)
@@ -79,6 +81,18 @@ func main() {
 		dashboard.ShowWarning("Harness not available. Recording will be simulated.")
 	}
 
+	// Only pay for meters and previews while the window is in front
+	a.Lifecycle().SetOnEnteredForeground(func() {
+		if err := controller.Subscribe(ipc.ForegroundSubscription...); err != nil {
+			log.Printf("Subscribe failed: %v", err)
+		}
+	})
+	a.Lifecycle().SetOnExitedForeground(func() {
+		if err := controller.Subscribe(ipc.BackgroundSubscription...); err != nil {
+			log.Printf("Subscribe failed: %v", err)
+		}
+	})
+
 	// Run the application
 	w.ShowAndRun()
 }
@@ -22,6 +22,7 @@ echo
 BUILD_HARNESS=true
 BUILD_PILOT=true
 BUILD_TYPE="Release"
+PRESET=""
 RUN_TESTS=false
 
 while [[ $# -gt 0 ]]; do
@@ -42,6 +43,11 @@ while [[ $# -gt 0 ]]; do
             RUN_TESTS=true
             shift
             ;;
+        --preset)
+            # One of harness/CMakePresets.json: release, release-lto, pgo, size...
+            PRESET="$2"
+            shift 2
+            ;;
         *)
             echo "Unknown option: $1"
             exit 1
@@ -55,6 +61,9 @@ if [ "$BUILD_HARNESS" = true ]; then
     
     HARNESS_DIR="$PROJECT_ROOT/harness"
     BUILD_DIR="$HARNESS_DIR/build"
+    if [ -n "$PRESET" ]; then
+        BUILD_DIR="$HARNESS_DIR/build/$PRESET"
+    fi
     
     # Check for required tools
     if ! command -v cmake &> /dev/null; then
@@ -62,18 +71,28 @@ if [ "$BUILD_HARNESS" = true ]; then
         exit 1
     fi
     
-    # Create build directory
-    mkdir -p "$BUILD_DIR"
-    cd "$BUILD_DIR"
-    
-    # Configure
-    echo "Configuring CMake..."
-    cmake .. -DCMAKE_BUILD_TYPE="$BUILD_TYPE" \
-             -DCMAKE_EXPORT_COMPILE_COMMANDS=ON
-    
-    # Build
-    echo "Building..."
-    cmake --build . --parallel $(nproc)
+    if [ -n "$PRESET" ]; then
+        # Configure and build from the preset
+        echo "Configuring CMake (preset $PRESET)..."
+        cd "$HARNESS_DIR"
+        cmake --preset "$PRESET"
+        echo "Building..."
+        cmake --build --preset "$PRESET" --parallel $(nproc)
+        cd "$BUILD_DIR"
+    else
+        # Create build directory
+        mkdir -p "$BUILD_DIR"
+        cd "$BUILD_DIR"
+
+        # Configure
+        echo "Configuring CMake..."
+        cmake .. -DCMAKE_BUILD_TYPE="$BUILD_TYPE" \
+                 -DCMAKE_EXPORT_COMPILE_COMMANDS=ON
+
+        # Build
+        echo "Building..."
+        cmake --build . --parallel $(nproc)
+    fi
     
     # Run tests if requested
     if [ "$RUN_TESTS" = true ]; then
@@ -122,7 +141,7 @@ fi
 # Copy harness to bin directory if both built
 if [ "$BUILD_HARNESS" = true ] && [ "$BUILD_PILOT" = true ]; then
     mkdir -p "$PROJECT_ROOT/bin"
-    cp "$PROJECT_ROOT/harness/build/harness" "$PROJECT_ROOT/bin/" 2>/dev/null || true
+    cp "$BUILD_DIR/harness" "$PROJECT_ROOT/bin/" 2>/dev/null || true
 fi
 
 echo -e "${GREEN}========================================${NC}"
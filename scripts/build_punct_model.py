@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Build the harness punctuation/truecasing table from a plain-text corpus.
+
+Usage: build_punct_model.py corpus.txt [more.txt ...] -o punctuation.tnpm
+
+The corpus should be ordinary punctuated, cased prose (lecture notes,
+transcripts, textbooks). For every word the table stores how often it is
+followed by a comma, ends a sentence, starts a sentence, or starts a
+question, plus its most common non-initial spelling when that is not all
+lowercase. The layout matches harness/src/modules/postprocess.ixx.
+"""
+
+import argparse
+import re
+import struct
+import sys
+from collections import Counter, defaultdict
+
+MAGIC = 0x4D504E54  # "TNPM"
+VERSION = 1
+TOKEN = re.compile(r"[A-Za-z0-9']+|[.,?!;:]")
+
+
+def fnv1a64(word: bytes) -> int:
+    h = 0xCBF29CE484222325
+    for b in word:
+        h ^= b
+        h = (h * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def fixed(count: int, total: int, smoothing: float) -> int:
+    p = count / (total + smoothing)
+    return max(0, min(65535, round(p * 65535)))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("corpus", nargs="+")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--min-count", type=int, default=3,
+                        help="drop words seen fewer times (default 3)")
+    parser.add_argument("--smoothing", type=float, default=2.0,
+                        help="add-k smoothing on the denominators (default 2)")
+    args = parser.parse_args()
+
+    total = Counter()
+    comma_after = Counter()
+    period_after = Counter()
+    sentence_start = Counter()
+    question_start = Counter()
+    spellings = defaultdict(Counter)
+
+    for name in args.corpus:
+        with open(name, encoding="utf-8", errors="replace") as f:
+            tokens = TOKEN.findall(f.read())
+
+        sentence_first = None
+        at_start = True
+        for i, tok in enumerate(tokens):
+            if not tok[0].isalnum():
+                continue
+            word = tok.lower()
+            total[word] += 1
+            if at_start:
+                sentence_start[word] += 1
+                sentence_first = word
+                at_start = False
+            else:
+                spellings[word][tok] += 1
+
+            nxt = tokens[i + 1] if i + 1 < len(tokens) else "."
+            if nxt in (",", ";", ":"):
+                comma_after[word] += 1
+            elif nxt in (".", "?", "!"):
+                period_after[word] += 1
+                if nxt == "?" and sentence_first:
+                    question_start[sentence_first] += 1
+                at_start = True
+
+    entries = []
+    strings = bytearray()
+    for word, count in total.items():
+        if count < args.min_count:
+            continue
+        cased = b""
+        if spellings[word]:
+            best, _ = spellings[word].most_common(1)[0]
+            if best != word:
+                cased = best.encode("utf-8")
+        starts = sentence_start[word]
+        entries.append((
+            fnv1a64(word.encode("utf-8")),
+            fixed(comma_after[word], count, args.smoothing),
+            fixed(period_after[word], count, args.smoothing),
+            fixed(starts, count, args.smoothing),
+            fixed(question_start[word], starts, args.smoothing),
+            len(strings),
+            len(cased),
+        ))
+        strings += cased
+
+    entries.sort()
+    with open(args.output, "wb") as out:
+        out.write(struct.pack("<IIII", MAGIC, VERSION, len(entries), len(strings)))
+        for h, comma, period, start, question, offset, length in entries:
+            out.write(struct.pack("<QHHHHIHH", h, comma, period, start, question,
+                                  offset, length, 0))
+        out.write(strings)
+
+    print(f"{len(entries)} words, {len(strings)} bytes of cased forms -> {args.output}",
+          file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
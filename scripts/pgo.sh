@@ -0,0 +1,63 @@
+#!/bin/bash
+# TopNotchNotes Profile-Guided Build
+# Instrumented build -> training run -> optimized ThinLTO build, then records
+# benchmark results for each preset so the gains are visible
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$SCRIPT_DIR/.."
+HARNESS_DIR="$PROJECT_ROOT/harness"
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+PROFDATA="${LLVM_PROFDATA:-$(command -v llvm-profdata-18 || command -v llvm-profdata || true)}"
+if [ -z "$PROFDATA" ]; then
+    echo -e "${RED}Error: llvm-profdata not found (set LLVM_PROFDATA)${NC}"
+    exit 1
+fi
+
+RESULTS="$HARNESS_DIR/build/bench-results.jsonl"
+PROFILE_DIR="$HARNESS_DIR/build/pgo-generate/profiles"
+
+cd "$HARNESS_DIR"
+
+# 1. Instrumented build
+echo -e "${YELLOW}[1/4] Building instrumented harness...${NC}"
+cmake --preset pgo-generate
+cmake --build --preset pgo-generate --parallel "$(nproc)"
+
+# 2. Training run: the synthetic benchmark workload (which also launches the
+#    harness for the startup benchmark) plus the test suite
+echo -e "${YELLOW}[2/4] Training run...${NC}"
+rm -rf "$PROFILE_DIR"
+mkdir -p "$PROFILE_DIR"
+export LLVM_PROFILE_FILE="$PROFILE_DIR/%p.profraw"
+build/pgo-generate/bench/harness_bench --all > /dev/null
+build/pgo-generate/tests/harness_tests --all > /dev/null
+unset LLVM_PROFILE_FILE
+
+"$PROFDATA" merge -o "$PROFILE_DIR/harness.profdata" "$PROFILE_DIR"/*.profraw
+
+# 3. Optimized build from the merged profile
+echo -e "${YELLOW}[3/4] Building with the profile...${NC}"
+cmake --preset pgo
+cmake --build --preset pgo --parallel "$(nproc)"
+
+# 4. Compare against the other release presets
+echo -e "${YELLOW}[4/4] Recording benchmarks to $RESULTS...${NC}"
+for preset in release release-lto size; do
+    cmake --preset "$preset" > /dev/null
+    cmake --build --preset "$preset" --parallel "$(nproc)"
+done
+for preset in release release-lto pgo size; do
+    "build/$preset/bench/harness_bench" --all --record "$RESULTS"
+done
+
+echo -e "${GREEN}✓ PGO build complete${NC}"
+echo "  Binary:  $HARNESS_DIR/build/pgo/harness"
+echo "  Results: $RESULTS"